@@ -0,0 +1,83 @@
+#ifndef AIPLAYER_H
+#define AIPLAYER_H
+
+#include "AlphaBetaEngine.h"
+#include "GameBoard.h"
+#include "LineEvaluator.h"
+#include "PositionDatabase.h"
+#include "Random.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Ordered from cheapest to strongest
+enum class Difficulty { EASY, MEDIUM, HARD };
+
+struct AiPlayerConfig {
+    // MEDIUM: a shallow search that sees immediate wins and threats but not forks
+    int mediumDepth = 2;
+    std::uint64_t mediumNodes = 20000;
+    // HARD on positions the database does not cover
+    SearchLimits hardLimits;
+
+    AiPlayerConfig() {
+        hardLimits.maxNodes = 0;
+        hardLimits.softMillis = 200;
+        hardLimits.hardMillis = 1000;
+    }
+};
+
+struct AiMove {
+    int row = -1;
+    int col = -1;
+    Difficulty difficulty = Difficulty::EASY;   // the tier that played, after the cap
+    std::uint64_t nodes = 0;                    // positions scored or searched
+    bool fromDatabase = false;
+};
+
+// Computer opponent for player-vs-AI games, in three tiers of falling cost:
+//   EASY    one ply: the move that most improves evaluate(), ties broken at
+//           random; it takes wins but never looks at the reply
+//   MEDIUM  AlphaBetaEngine limited to a few plies and nodes
+//   HARD    the solved PositionDatabase when it covers the position, otherwise
+//           AlphaBetaEngine with a time budget (which solves small boards)
+// setDifficultyCap() lowers every later move to at most that tier, so a
+// server under pressure can shed search without touching running games. The
+// cap may be set from any thread; chooseMove() is one call at a time per player.
+class AiPlayer {
+public:
+    // database is optional and must outlive the player
+    explicit AiPlayer(const PositionDatabase* database = nullptr, const AiPlayerConfig& config = AiPlayerConfig(),
+                      std::uint64_t seed = 1);
+    AiPlayer(const AiPlayer&) = delete;
+    AiPlayer& operator=(const AiPlayer&) = delete;
+
+    // player is the side to move; returns false if the game is over. Boards too
+    // large for PlayoutBoard are played at EASY whatever the difficulty.
+    bool chooseMove(const GameBoard& board, char player, Difficulty difficulty, AiMove& move);
+
+    void setDifficultyCap(Difficulty cap);
+    Difficulty difficultyCap() const;
+
+    // LineEvaluator's total for player, the score AlphaBetaEngine gives its
+    // horizon; +/-AlphaBetaEngine::WIN_SCORE once a line is complete
+    static int evaluate(const GameBoard& board, char player);
+
+    static const char* difficultyName(Difficulty difficulty);
+    // "easy", "medium" or "hard"
+    static bool parseDifficulty(const std::string& text, Difficulty& difficulty);
+
+private:
+    const PositionDatabase* database;
+    AiPlayerConfig config;
+    AlphaBetaEngine engine;
+    std::atomic<int> cap;
+    Random random;
+    LineEvaluator lines;   // reused by easyMove() while the board shape stays
+
+    bool easyMove(const GameBoard& board, char player, AiMove& move);
+    bool databaseMove(const GameBoard& board, char player, AiMove& move) const;
+    bool searchMove(const GameBoard& board, char player, const SearchLimits& limits, AiMove& move);
+};
+
+#endif // AIPLAYER_H
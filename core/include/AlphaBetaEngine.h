@@ -0,0 +1,96 @@
+#ifndef ALPHABETAENGINE_H
+#define ALPHABETAENGINE_H
+
+#include "GameBoard.h"
+#include "LineEvaluator.h"
+#include "PlayoutBoard.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Budget for one move. The clock is read once every CLOCK_CHECK_INTERVAL
+// nodes, not per node. No iteration starts after softMillis; hardMillis and
+// maxNodes abandon the running iteration, and the move of the last finished
+// one is returned. The first iteration always finishes, so there is always a
+// move. Zero disables a limit; with all of them zero the search runs until
+// the game is solved, which only small boards allow.
+struct SearchLimits {
+    std::int64_t softMillis = 0;
+    std::int64_t hardMillis = 0;
+    std::uint64_t maxNodes = 1000000;
+    int maxDepth = 0;
+};
+
+struct SearchResult {
+    int row = -1;
+    int col = -1;
+    // For the side to move; beyond +/-AlphaBetaEngine::WIN_THRESHOLD the game is decided
+    int score = 0;
+    int depth = 0;                        // plies of the last finished iteration
+    bool solved = false;                  // the score is exact, not a heuristic estimate
+    std::vector<int> principalVariation;  // cells (row * cols + col), this move first
+    std::uint64_t nodes = 0;
+    int researches = 0;                   // aspiration windows the score fell outside
+    std::int64_t elapsedMillis = 0;
+};
+
+// Iterative-deepening negamax with alpha-beta pruning for m,n,k boards. Each
+// iteration searches the previous principal variation first and, from depth
+// 3, starts with a narrow aspiration window around the previous score,
+// widening it only if the score falls outside. A transposition table keyed
+// by Zobrist hashes keeps bounds and best moves between iterations and
+// between calls. Positions at the horizon are scored by the open lines each
+// side still has, kept up to date move by move. On boards of more than
+// NEAR_MOVES_ABOVE cells only cells within two of a mark are searched.
+class AlphaBetaEngine {
+public:
+    static constexpr int WIN_SCORE = 1000000;
+    static constexpr int WIN_THRESHOLD = WIN_SCORE - PlayoutBoard::MAX_CELLS - 1;
+    static constexpr std::uint64_t CLOCK_CHECK_INTERVAL = 1024;
+    static constexpr int NEAR_MOVES_ABOVE = 25;
+
+    // The transposition table has 2^tableBits entries
+    explicit AlphaBetaEngine(int tableBits = 18, std::uint64_t seed = 0x9e3779b97f4a7c15ULL);
+    ~AlphaBetaEngine();
+    AlphaBetaEngine(const AlphaBetaEngine&) = delete;
+    AlphaBetaEngine& operator=(const AlphaBetaEngine&) = delete;
+
+    // player is the side to move; returns false if the game is over or the board is too large
+    bool chooseMove(const GameBoard& board, char player, const SearchLimits& limits, SearchResult& result);
+    // Forgets what earlier searches stored in the transposition table
+    void reset();
+
+private:
+    struct TableEntry {
+        std::uint64_t key = 0;
+        std::int32_t score = 0;
+        std::int16_t move = -1;
+        std::uint8_t depth = 0;
+        std::uint8_t flags = 0;   // bound kind, and whether the score is exact
+    };
+
+    struct Search;
+
+    PlayoutBoard board;
+    std::vector<TableEntry> table;
+    std::uint64_t tableMask;
+    std::vector<std::uint64_t> zobrist;   // two keys per cell, X then O
+    std::uint64_t sideKey;
+    std::uint64_t hash;
+    LineEvaluator lines;        // the horizon score, kept up to date move by move
+    std::vector<int> nearby;    // marks within two cells of each cell
+
+    void setUp(const GameBoard& position, char player);
+    bool place(int cell, char player);
+    void remove(int cell, char player);
+    void markNearby(int cell, int delta);
+    int evaluate(char toMove) const;
+    // Candidate cells, best first, packed as (ordering key << 10) | cell
+    void orderMoves(Search& search, int pvMove, int tableMove, std::vector<long long>& moves);
+    int negamax(Search& search, int depth, int ply, int alpha, int beta, char toMove);
+    void checkLimits(Search& search);
+    // Table cutoffs end a principal variation early; the table usually knows how it goes on
+    void extendLine(std::vector<int>& line, int depth, char player);
+};
+
+#endif // ALPHABETAENGINE_H
@@ -12,9 +12,13 @@ enum class GameResult {
     ONGOING
 };
 
+// An m,n,k game: a rows x cols grid won by winLength marks in a row. The
+// default constructor gives classic 3x3 Tic Tac Toe.
 class GameBoard {
 public:
     GameBoard();
+    // Non-positive sizes fall back to 3, as does a winLength longer than both sides
+    GameBoard(int rows, int cols, int winLength);
     void reset();
     bool makeMove(int row, int col, char player);
     char getCell(int row, int col) const;
@@ -24,9 +28,18 @@ public:
     std::vector<std::vector<char>> getBoard() const;
     void setBoard(const std::vector<std::vector<char>>& board);
 
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
+    int getWinLength() const { return winLength; }
+
 private:
     std::vector<std::vector<char>> board;
+    int rows;
+    int cols;
+    int winLength;
     static const int BOARD_SIZE = 3;
+
+    bool lineFrom(int row, int col, int dRow, int dCol) const;
 };
 
 #endif // GAMEBOARD_H
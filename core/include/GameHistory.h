@@ -2,12 +2,19 @@
 #define GAMEHISTORY_H
 
 #include "GameBoard.h"
+#include "StringInterner.h"
+#include "Timestamp.h"
 #include <vector>
 #include <string>
+#include <utility>
 #include <chrono>
 #include <iomanip>
 #include <sstream>
 #include <fstream>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <future>
 
 enum class GameMode {
     PLAYER_VS_PLAYER,
@@ -18,13 +25,13 @@ struct Move {
     int row;
     int col;
     char player;
-    std::string timestamp;
     int moveNumber;
+    EpochMillis time;   // 0 when the move was not timed
 
-    Move() : row(-1), col(-1), player(' '), moveNumber(-1) {}
-    Move(int r, int c, char p) : row(r), col(c), player(p), moveNumber(-1) {}
-    Move(int r, int c, char p, const std::string& time, int num)
-        : row(r), col(c), player(p), timestamp(time), moveNumber(num) {}
+    Move() : row(-1), col(-1), player(' '), moveNumber(-1), time(0) {}
+    Move(int r, int c, char p) : row(r), col(c), player(p), moveNumber(-1), time(0) {}
+    Move(int r, int c, char p, EpochMillis t, int num)
+        : row(r), col(c), player(p), moveNumber(num), time(t) {}
 };
 
 struct GameRecord {
@@ -33,29 +40,213 @@ struct GameRecord {
     GameMode mode;
     GameResult result;
     std::vector<std::vector<char>> finalBoard;
-    std::string timestamp;
+    std::string timestamp;   // legacy text that did not parse as a time; GameHistory converts the rest
+    EpochMillis time = 0;    // preferred; when set, timestamp is left empty
     std::vector<Move> moves;
+    // Interned ids of player1/player2, shared with User::id; filled in by GameHistory
+    UserId player1Id = INVALID_USER_ID;
+    UserId player2Id = INVALID_USER_ID;
 
     GameRecord() = default;
     GameRecord(const std::string& p1, const std::string& p2, GameMode m, GameResult r,
-               const std::vector<std::vector<char>>& board, const std::string& time)
-        : player1(p1), player2(p2), mode(m), result(r), finalBoard(board), timestamp(time) {}
+               const std::vector<std::vector<char>>& board, const std::string& stamp)
+        : player1(p1), player2(p2), mode(m), result(r), finalBoard(board), timestamp(stamp) {}
+
+    // Text for display, in local time like the legacy stamps; epoch times are only formatted here
+    std::string displayTimestamp() const { return time != 0 ? formatLocalTimestamp(time) : timestamp; }
+};
+
+enum class ExportFormat {
+    CSV,      // header row, then one record per line
+    NDJSON    // one JSON object per line
+};
+
+// How long games stay in memory. Older ones are compacted into cold segment
+// files next to the history file and read back only when a query needs them.
+struct RetentionPolicy {
+    int hotDays = 0;   // 0 keeps every game in memory
+    // Compaction waits until this many games are due, so segments are not tiny
+    std::size_t minSegmentRecords = 1024;
+};
+
+// Ad-hoc query over player, mode and result; unset fields match every game.
+// Hot games are matched by ScanKernels over per-field columns.
+struct GameFilter {
+    UserId player = INVALID_USER_ID;   // either seat; INVALID_USER_ID matches anyone
+    bool matchMode = false;
+    GameMode mode = GameMode::PLAYER_VS_PLAYER;
+    bool matchResult = false;
+    GameResult result = GameResult::ONGOING;
+
+    bool matches(const GameRecord& record) const;
+};
+
+class OpeningBook;
+class PersistenceService;
+struct HistoryFileDictionary;
+struct HistoryVersion;
+struct HistoryContent;
+struct StoredGame;
+
+// An immutable view of a GameHistory as it was when snapshot() was called.
+// Taking one is a pointer copy and never waits for the writer; later
+// additions and compactions publish new versions and leave this one alone.
+// Safe to read from any thread, and cheap to copy.
+class HistorySnapshot {
+public:
+    HistorySnapshot() = default;
+
+    std::uint64_t size() const;   // cold and hot games
+    std::size_t hotGameCount() const;
+    std::vector<GameRecord> getAllGames() const;
+    std::vector<GameRecord> getUserGames(const std::string& username) const;
+    std::vector<GameRecord> findGames(const GameFilter& filter) const;
+    // Games with from <= time < to, oldest first; hot games are scanned
+    std::vector<GameRecord> getGamesBetween(EpochMillis from, EpochMillis to) const;
+
+private:
+    friend class GameHistory;
+    explicit HistorySnapshot(std::shared_ptr<const HistoryVersion> version) : version(std::move(version)) {}
+
+    std::shared_ptr<const HistoryVersion> version;
 };
 
 class GameHistory {
 public:
     GameHistory();
+    // An empty path keeps the history in memory only
+    explicit GameHistory(const std::string& historyFile);
+    // Finishes a running compaction
+    ~GameHistory();
+    GameHistory(const GameHistory&) = delete;
+    GameHistory& operator=(const GameHistory&) = delete;
+    // Appends and saves, unless a bulk load is in progress
     void addGameRecord(const GameRecord& record);
+    // Between beginBulk() and endBulk() additions are kept in memory only and
+    // the file is written once at the end. Calls nest.
+    void beginBulk();
+    void endBulk();
+    bool inBulk() const { return bulkDepth > 0; }
+    // Appends a range of records, interning names and feeding the opening book
+    // in one pass, then appends just the new records to the file
+    template <typename InputIt>
+    void addGameRecords(InputIt first, InputIt last);
     std::vector<GameRecord> getUserGames(const std::string& username);
     std::vector<GameRecord> getAllGames();
+    // Matching games in append order. Hot games are selected by column scans
+    // without expanding the others; cold segments are decoded and checked record by record.
+    std::vector<GameRecord> findGames(const GameFilter& filter);
+    std::size_t countGames(const GameFilter& filter);
+    // Games with from <= time < to, oldest first. Found by binary search over
+    // the time index, so only the matching slice is touched; records whose
+    // time is unknown are never returned.
+    std::vector<GameRecord> getGamesBetween(EpochMillis from, EpochMillis to);
+    std::vector<GameRecord> getGamesSince(EpochMillis since);
+    std::size_t countGamesBetween(EpochMillis from, EpochMillis to);
+    // Oldest and newest indexed time; false if no record has one
+    bool getTimeSpan(EpochMillis& oldest, EpochMillis& newest);
     void saveHistory();
     void loadHistory();
+    void exportRecords(std::ostream& out, ExportFormat format) const;
+    // Streams historyFile and its cold segments to out record by record, in the
+    // order a loaded GameHistory holds them, without loading one
+    static bool exportFile(const std::string& historyFile, std::ostream& out, ExportFormat format,
+                           std::size_t* exported = nullptr);
+    // Every record added afterwards is also counted in book; pass nullptr to detach
+    void setOpeningBook(OpeningBook* book) { openingBook = book; }
+    // File writes are queued on service instead of done on the caller's thread;
+    // service must outlive this history. Pass nullptr to write synchronously again.
+    void setPersistence(PersistenceService* service) { persistence = service; }
+    // Resolves true once every game added so far is synced to historyFile.
+    // False means a write failed; the file is rewritten whole by the next
+    // addition or call to durable(), so callers may simply ask again.
+    std::future<bool> durable();
+    // Additions check now and then whether games have left the hot window and
+    // start a compaction if enough have
+    void setRetentionPolicy(const RetentionPolicy& policy) { retention = policy; }
+    // Moves the leading games older than the hot window as of now into a new
+    // cold segment. The segment is written on a background thread; until it is
+    // on disk the games stay readable from memory. False if too few games are
+    // due, a compaction is already running or there is no history file.
+    bool compact(EpochMillis now = currentEpochMillis());
+    // Blocks until a running compaction has finished and been applied
+    void waitForCompaction();
+    std::size_t hotGameCount() const;
+    std::uint64_t coldGameCount() const;
+    // Rewrites of and appends to historyFile so far, queued ones included
+    std::uint64_t fileWrites() const { return writes; }
+    // Callable from any thread while another one adds games
+    HistorySnapshot snapshot() const;
 
 private:
-    std::vector<GameRecord> gameRecords;
+    struct TimeEntry {
+        EpochMillis time;
+        std::size_t record;   // position among the hot games
+    };
+
+    // Hot games live in append-only chunks. live is the writer's version; each
+    // change is published as an immutable copy that snapshots pick up, so
+    // readers share the chunks without locks. Written slots never change.
+    std::unique_ptr<HistoryVersion> live;
+    std::shared_ptr<const HistoryVersion> published;   // std::atomic_load/atomic_store only
+    std::shared_ptr<HistoryContent> content;
+    // Boards and move lists historyFile has spelled out so far
+    std::unique_ptr<HistoryFileDictionary> fileDictionary;
+    bool fileNeedsRewrite = false;
+    GameRecord scratch;   // reused by writeStored
+    // Timed records ordered by (time, position). Games arrive in time order, so
+    // additions are appended; an older one only marks the index for a re-sort
+    // before the next query.
+    std::vector<TimeEntry> timeIndex;
+    bool timeIndexSorted = true;
     std::string historyFile;
-    std::string getCurrentTimestamp();
+    OpeningBook* openingBook = nullptr;
+    PersistenceService* persistence = nullptr;
+    int bulkDepth = 0;
+    std::size_t persisted = 0;   // leading hot games known to be in historyFile
+    std::uint64_t writes = 0;
+    // Results of queued writes not yet looked at; a failed one forces a rewrite
+    std::vector<std::shared_future<bool>> pendingWrites;
+
+    RetentionPolicy retention;
+    std::size_t additionsSinceCheck = 0;
+    // Leading hot games compactor is writing to a segment. They stay hot, and
+    // their slots unchanged, until it has been joined.
+    std::size_t compacting = 0;
+    std::thread compactor;
+    std::atomic<bool> compactionDone{false};
+    bool compactionSucceeded = false;   // written by compactor, read after the join
     void loadHistoryIfNeeded();
+    void storeRecord(const GameRecord& record);
+    void publish();
+    void writeStored(std::ostream& out, const StoredGame& game);
+    void indexTime(std::size_t position);
+    void sortTimeIndex();
+    // [begin, end) positions in timeIndex of the entries with from <= time < to
+    std::pair<std::size_t, std::size_t> timeSlice(EpochMillis from, EpochMillis to);
+    void appendPending();
+    // Forgets finished writes, flagging a rewrite if one failed
+    void checkWrites();
+    std::string segmentPath(std::size_t segment) const;
+    void loadColdSegments();
+    void maybeCompact(std::size_t added);
+    void pollCompaction();
+    void finishCompaction();
+    void rebuildTimeIndex();
 };
 
+template <typename InputIt>
+void GameHistory::addGameRecords(InputIt first, InputIt last) {
+    std::size_t added = 0;
+    for (; first != last; ++first) {
+        storeRecord(*first);
+        added++;
+    }
+    publish();
+    if (bulkDepth == 0) {
+        appendPending();
+        maybeCompact(added);
+    }
+}
+
 #endif // GAMEHISTORY_H
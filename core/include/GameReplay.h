@@ -0,0 +1,69 @@
+#ifndef GAMEREPLAY_H
+#define GAMEREPLAY_H
+
+#include "GameBoard.h"
+#include "GameHistory.h"
+#include "ThreadPool.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class ReplayError {
+    NONE,
+    BAD_PLAYER,       // move by someone other than 'X' or 'O'
+    ILLEGAL_MOVE,     // off the board or onto a taken cell
+    WRONG_TURN,       // same player moved twice in a row
+    MOVE_AFTER_END    // move recorded after the game was already decided
+};
+
+// Replays one recorded game. Every move is checked with GameBoard's rules
+// once, while the per-ply positions are stored as a pair of 9-bit masks, so
+// seeking to any ply afterwards is constant time.
+class GameReplay {
+public:
+    GameReplay();
+    explicit GameReplay(const GameRecord& record);
+
+    // Returns false if a move breaks the rules; the plies before it stay seekable
+    bool load(const GameRecord& record);
+
+    bool isValid() const { return error == ReplayError::NONE; }
+    ReplayError getError() const { return error; }
+    // Index of the offending move, or -1
+    int getErrorPly() const { return errorPly; }
+
+    // Number of moves replayed; positions exist for plies 0..plyCount()
+    int plyCount() const { return static_cast<int>(positions.size()) - 1; }
+    GameBoard positionAt(int ply) const;
+    char cellAt(int ply, int row, int col) const;
+    GameResult resultAt(int ply) const;
+    GameResult finalResult() const { return resultAt(plyCount()); }
+
+private:
+    struct Position {
+        std::uint16_t x;
+        std::uint16_t o;
+    };
+
+    std::vector<Position> positions;
+    ReplayError error;
+    int errorPly;
+
+    const Position& at(int ply) const;
+};
+
+// Replays many games in parallel for batch analysis
+class ReplayEngine {
+public:
+    // threadCount == 0 picks one worker per hardware thread
+    explicit ReplayEngine(std::size_t threadCount = 0);
+
+    std::vector<GameReplay> replayAll(const std::vector<GameRecord>& records);
+    // Indices of records containing an illegal move
+    std::vector<std::size_t> findInvalid(const std::vector<GameRecord>& records);
+
+private:
+    ThreadPool pool;
+};
+
+#endif // GAMEREPLAY_H
@@ -0,0 +1,137 @@
+#ifndef GAMESESSIONENGINE_H
+#define GAMESESSIONENGINE_H
+
+#include "GameBoard.h"
+#include "GameHistory.h"
+#include "ObjectPool.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using GameSessionId = std::uint64_t;
+
+enum class MoveStatus {
+    ACCEPTED,
+    GAME_FINISHED,   // move accepted and it ended the game
+    INVALID_MOVE,
+    NOT_YOUR_TURN,
+    UNKNOWN_SESSION
+};
+
+struct MoveReply {
+    GameSessionId session;
+    MoveStatus status;
+    GameResult result;
+
+    MoveReply() : session(0), status(MoveStatus::UNKNOWN_SESSION), result(GameResult::ONGOING) {}
+    MoveReply(GameSessionId id, MoveStatus s, GameResult r) : session(id), status(s), result(r) {}
+};
+
+// One live game hosted by the engine
+struct GameSession {
+    GameSessionId id;
+    GameBoard board;
+    std::string player1;
+    std::string player2;
+    GameMode mode;
+    char nextPlayer;
+    std::vector<Move> moves;
+
+    GameSession() : id(0), mode(GameMode::PLAYER_VS_PLAYER), nextPlayer('X') {}
+};
+
+// Hosts many concurrent games. Sessions are partitioned across worker
+// threads by id, so each session is only ever touched by its own worker and
+// needs no locking. Commands are queued per worker and drained in batches by
+// that worker's event loop; finished games are handed to GameHistory once per
+// batch.
+//
+// Sessions and finished records come from per-worker pools and are recycled
+// when a game ends, so once the pools have grown to the working set, game
+// churn through the callback transport does no heap allocation (player names
+// longer than the small-string buffer are the exception).
+class GameSessionEngine {
+public:
+    using MoveCallback = std::function<void(const MoveReply&)>;
+
+    // workerCount == 0 starts one worker per hardware thread. Each worker
+    // preallocates room for reservedGamesPerWorker concurrent games.
+    explicit GameSessionEngine(std::size_t workerCount = 0, GameHistory* history = nullptr,
+                               std::size_t reservedGamesPerWorker = 1024);
+    ~GameSessionEngine();
+    GameSessionEngine(const GameSessionEngine&) = delete;
+    GameSessionEngine& operator=(const GameSessionEngine&) = delete;
+
+    GameSessionId createGame(const std::string& player1, const std::string& player2, GameMode mode);
+    void submitMove(GameSessionId session, int row, int col, char player, MoveCallback callback);
+    // Convenience form; the future's shared state costs an allocation per move
+    std::future<MoveReply> submitMove(GameSessionId session, int row, int col, char player);
+    void abandonGame(GameSessionId session);
+
+    // Blocks until every command submitted before the call has been processed
+    void flush();
+
+    std::size_t activeGames() const { return liveGames.load(std::memory_order_relaxed); }
+    std::size_t completedGames() const { return finishedGames.load(std::memory_order_relaxed); }
+    std::size_t workerCount() const { return workers.size(); }
+
+private:
+    enum class CommandType { CREATE, MOVE, ABANDON, BARRIER };
+
+    struct Command {
+        CommandType type;
+        GameSessionId session;
+        int row;
+        int col;
+        char player;
+        GameMode mode;
+        std::string player1;
+        std::string player2;
+        MoveCallback callback;
+        std::shared_ptr<std::promise<void>> barrier;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::vector<Command> inbox;
+        std::thread thread;
+
+        // Everything below is only touched by the worker thread
+        std::pmr::unsynchronized_pool_resource memory;
+        ObjectPool<GameSession> sessionPool;
+        ObjectPool<GameRecord> recordPool;
+        std::pmr::unordered_map<GameSessionId, GameSession*> sessions;
+        std::vector<GameRecord*> finished;
+
+        explicit Worker(std::size_t reservedGames);
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::size_t reservedGames;
+    GameHistory* history;
+    std::mutex historyMutex;
+    std::atomic<GameSessionId> nextSessionId;
+    std::atomic<std::size_t> liveGames;
+    std::atomic<std::size_t> finishedGames;
+    std::atomic<bool> stopping;
+
+    Worker& workerFor(GameSessionId session);
+    void post(GameSessionId session, Command command);
+    void runWorker(Worker& worker);
+    void process(Worker& worker, Command& command);
+    MoveReply applyMove(Worker& worker, const Command& command);
+    void publishFinished(Worker& worker);
+};
+
+#endif // GAMESESSIONENGINE_H
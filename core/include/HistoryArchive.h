@@ -0,0 +1,61 @@
+#ifndef HISTORYARCHIVE_H
+#define HISTORYARCHIVE_H
+
+#include "GameHistory.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ArchiveBlockInfo {
+    std::uint64_t offset = 0;        // from the start of the file
+    std::uint64_t size = 0;          // encoded bytes
+    std::uint64_t firstRecord = 0;   // id of the block's first record
+    std::uint32_t count = 0;
+    // Range of the block's epoch times; both 0 if no record in it is timed
+    EpochMillis minTime = 0;
+    EpochMillis maxTime = 0;
+};
+
+// Read-only, compressed store for old history. Records are cut into blocks
+// that decode on their own: each block lists its player names once and
+// stores every record as name references, a delta-coded time, a packed
+// board and MoveCodec moves, so a typical game takes a third of its text
+// size. An index at the end of the file gives each block's offset, record
+// ids and time range, so a lookup reads only the blocks it needs. Record ids
+// are positions in the archive, starting at 0.
+class HistoryArchive {
+public:
+    static constexpr std::size_t DEFAULT_BLOCK_RECORDS = 1024;
+
+    HistoryArchive();
+
+    // Creates or overwrites path; false on an I/O failure
+    static bool write(const std::string& path, const std::vector<GameRecord>& records,
+                      std::size_t blockRecords = DEFAULT_BLOCK_RECORDS);
+
+    // Reads only the index; false if path is missing or not an archive
+    bool open(const std::string& path);
+    bool isOpen() const { return !path.empty(); }
+    std::uint64_t recordCount() const { return total; }
+    const std::vector<ArchiveBlockInfo>& blocks() const { return index; }
+
+    bool readRecord(std::uint64_t id, GameRecord& record);
+    // Appends records [first, first + count), clipped to the archive
+    bool readRange(std::uint64_t first, std::uint64_t count, std::vector<GameRecord>& records);
+    // Appends timed records with from <= time < to, in archive order
+    bool readTimeRange(EpochMillis from, EpochMillis to, std::vector<GameRecord>& records);
+
+private:
+    std::string path;
+    std::vector<ArchiveBlockInfo> index;
+    std::uint64_t total;
+    // The last decoded block, so neighbouring lookups do not decode it again
+    std::size_t cachedBlock;
+    std::vector<GameRecord> cached;
+
+    bool loadBlock(std::size_t block);
+    std::size_t blockFor(std::uint64_t id) const;
+};
+
+#endif // HISTORYARCHIVE_H
@@ -0,0 +1,57 @@
+#ifndef LINEEVALUATOR_H
+#define LINEEVALUATOR_H
+
+#include "GameBoard.h"
+#include <vector>
+
+// Static evaluation shared by the engines. Every run of winLength cells is a
+// window; a window only one side has marked is worth 4^(marks-1) to that side
+// (at most 2^MAX_WEIGHT_SHIFT), one both sides have marked is dead. The
+// counts and their sum are kept up to date move by move, so scoring a
+// position or the gain of a move reads only the windows it touches.
+class LineEvaluator {
+public:
+    static constexpr int MAX_WEIGHT_SHIFT = 12;
+
+    LineEvaluator();
+    // Recomputes the windows for a new shape; false if it is the current one
+    bool reshape(int rows, int cols, int winLength);
+    // reshape() to board and take its marks
+    void load(const GameBoard& board);
+    // Forgets every mark, keeping the shape
+    void clear();
+    void add(int cell, char player);
+    void remove(int cell, char player);
+
+    // Sum of window values, positive favouring X
+    long long total() const { return sum; }
+    // Windows a side has filled
+    int lines(char player) const { return player == 'X' ? linesX : linesO; }
+    // Change in total() for player from a mark on the empty cell, and
+    // completesLine if it wins
+    long long gain(int cell, char player, bool& completesLine) const;
+    // How much the windows through cell are still worth to both sides; for move ordering
+    long long openness(int cell) const;
+
+    int rows() const { return rowCount; }
+    int cols() const { return colCount; }
+    int winLength() const { return length; }
+    long long weight(int marks) const { return weights[marks]; }
+
+private:
+    int rowCount;
+    int colCount;
+    int length;
+    std::vector<std::vector<int>> cellWindows;
+    std::vector<int> windowX;
+    std::vector<int> windowO;
+    std::vector<long long> weights;   // by marks in a window that only one side has used
+    long long sum;
+    int linesX;
+    int linesO;
+
+    long long windowValue(int window) const;
+    void count(int cell, char player, int delta);
+};
+
+#endif // LINEEVALUATOR_H
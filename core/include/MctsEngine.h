@@ -0,0 +1,81 @@
+#ifndef MCTSENGINE_H
+#define MCTSENGINE_H
+
+#include "GameBoard.h"
+#include "PlayoutBoard.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Search budget for one move. Whichever limit is reached first ends the
+// search; a zero disables that limit, but at least one must be set.
+struct MctsLimits {
+    std::uint64_t maxIterations = 10000;
+    std::int64_t maxMillis = 0;
+};
+
+struct MctsResult {
+    int row = -1;
+    int col = -1;
+    std::uint64_t iterations = 0;      // playouts run by this search
+    std::uint64_t reusedVisits = 0;    // visits inherited from the previous search's tree
+    double expectedScore = 0.0;        // chosen move's average result for the mover, ties count half
+};
+
+// Monte Carlo Tree Search for m,n,k boards too large for exhaustive search.
+// Selection uses UCT; playouts are uniformly random on a PlayoutBoard. With
+// more than one thread, all threads share one tree and mark the path they
+// are exploring with a virtual loss so they spread out. The tree is kept
+// between calls and reused when the next position follows from the last one.
+// One search at a time per engine.
+class MctsEngine {
+public:
+    // threadCount == 0 picks one thread per hardware thread
+    explicit MctsEngine(std::size_t threadCount = 1, double exploration = 1.4,
+                        std::uint64_t seed = 0x9e3779b97f4a7c15ULL);
+    ~MctsEngine();
+    MctsEngine(const MctsEngine&) = delete;
+    MctsEngine& operator=(const MctsEngine&) = delete;
+
+    // player is the side to move; returns false if the game is over or the board is too large
+    bool chooseMove(const GameBoard& board, char player, const MctsLimits& limits, MctsResult& result);
+    // Drops the saved tree
+    void reset();
+
+private:
+    struct Node {
+        Node* parent;
+        int move;                  // cell that led here, -1 at the root
+        char player;               // who played move
+        int terminal;              // NOT_TERMINAL, or the outcome for player
+        std::atomic<std::uint32_t> visits;
+        std::atomic<std::uint32_t> virtualLoss;
+        std::atomic<std::uint64_t> halfPoints;   // 2 per win for player, 1 per tie
+        std::mutex mutex;                        // guards the expansion fields below
+        int expandOffset;
+        int scanned;
+        std::vector<std::unique_ptr<Node>> children;
+
+        Node(Node* parent, int move, char player, int offset);
+    };
+
+    struct Search;
+
+    std::size_t threadCount;
+    double exploration;
+    std::uint64_t seed;
+    std::uint64_t searches;
+    ThreadPool pool;
+    std::unique_ptr<Node> root;
+    PlayoutBoard rootBoard;
+    char rootPlayer;   // side to move at the root
+
+    bool reuseTree(const PlayoutBoard& board, char player);
+    void runSearch(Search& search, std::uint64_t threadSeed);
+};
+
+#endif // MCTSENGINE_H
@@ -0,0 +1,160 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+// Build with -DGAME_CORE_METRICS=1 (CMake option ENABLE_METRICS) to compile
+// the instrumentation points in; otherwise they expand to nothing.
+#ifndef GAME_CORE_METRICS
+#define GAME_CORE_METRICS 0
+#endif
+
+enum class Metric {
+    MAKE_MOVE,
+    CHECK_WIN,
+    AI_SEARCH,
+    SAVE_HISTORY,
+    LOAD_HISTORY,
+    SAVE_USERS,
+    LOAD_USERS
+};
+
+// Log-linear latency histogram in nanoseconds: 16 linear sub-buckets per
+// power of two, so any recorded value is within 1/16 of its bucket's bounds.
+struct LatencyHistogram {
+    static constexpr int SUB_BUCKET_BITS = 4;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int MAX_BITS = 40;   // values are clamped below 2^40 ns, about 18 minutes
+    static constexpr int BUCKET_COUNT = (MAX_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    static int bucketFor(std::uint64_t nanos);
+    static std::uint64_t lowerBound(int bucket);
+    static std::uint64_t upperBound(int bucket);
+};
+
+struct MetricSnapshot {
+    std::uint64_t calls = 0;      // every instrumented call
+    std::uint64_t timed = 0;      // calls whose latency was recorded
+    std::uint64_t totalNanos = 0; // sum over timed calls
+    std::vector<std::uint64_t> buckets;
+
+    // Upper bound of the bucket holding quantile q (0..1) of the timed calls
+    std::uint64_t percentile(double q) const;
+};
+
+struct MetricsSnapshot {
+    static constexpr int METRIC_COUNT = static_cast<int>(Metric::LOAD_USERS) + 1;
+    std::array<MetricSnapshot, METRIC_COUNT> metrics;
+
+    const MetricSnapshot& operator[](Metric metric) const { return metrics[static_cast<int>(metric)]; }
+};
+
+// Process-wide counters and histograms. Each thread writes only its own
+// block of relaxed atomics, so recording never takes a lock or contends on a
+// cache line; snapshot() sums the blocks. Blocks of finished threads are
+// reused by new ones, keeping their counts. The cheapest operations
+// (makeMove, checkWin) count every call but time one call in SAMPLE_PERIOD,
+// since reading the clock costs more than the operation itself.
+class MetricsRegistry {
+public:
+    static constexpr std::uint32_t SAMPLE_PERIOD = 64;
+
+    static MetricsRegistry& shared();
+    static const char* name(Metric metric);
+
+    void count(Metric metric);
+    void record(Metric metric, std::uint64_t nanos);
+    // True once every SAMPLE_PERIOD calls on the calling thread
+    bool sampleThisCall();
+
+    MetricsSnapshot snapshot() const;
+    // Prometheus text exposition format: a counter and a histogram per operation
+    void writePrometheus(std::ostream& out) const;
+    // Zeroes everything; counts recorded concurrently may survive
+    void reset();
+
+private:
+    friend class MetricsTimer;
+
+    struct ThreadBlock {
+        std::atomic<std::uint64_t> calls[MetricsSnapshot::METRIC_COUNT];
+        std::atomic<std::uint64_t> timed[MetricsSnapshot::METRIC_COUNT];
+        std::atomic<std::uint64_t> totalNanos[MetricsSnapshot::METRIC_COUNT];
+        std::atomic<std::uint64_t> buckets[MetricsSnapshot::METRIC_COUNT][LatencyHistogram::BUCKET_COUNT];
+        std::uint32_t sampleTick = 0;   // owner thread only
+
+        ThreadBlock();
+    };
+    struct ThreadSlot;
+
+    MetricsRegistry() = default;
+
+    // A plain pointer keeps the per-call thread-local lookup free of init guards
+    static inline thread_local ThreadBlock* current = nullptr;
+
+    mutable std::mutex mutex;   // guards blocks and idle, not the counters
+    std::vector<std::unique_ptr<ThreadBlock>> blocks;
+    std::vector<ThreadBlock*> idle;
+
+    static ThreadBlock& localBlock() { return current != nullptr ? *current : attachThread(); }
+    static ThreadBlock& attachThread();
+    static void bump(std::atomic<std::uint64_t>& counter, std::uint64_t amount);
+    static void recordInto(ThreadBlock& block, int metric, std::uint64_t nanos);
+    ThreadBlock* claimBlock();
+    void releaseBlock(ThreadBlock* block);
+};
+
+// Only the owning thread writes a block, so a load and a store replace the read-modify-write
+inline void MetricsRegistry::bump(std::atomic<std::uint64_t>& counter, std::uint64_t amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+// Counts a call and, if timed, records how long the enclosing scope took.
+// Inline so an instrumented call costs one thread-local load and a store.
+class MetricsTimer {
+public:
+    // sampled: time only one call in MetricsRegistry::SAMPLE_PERIOD
+    MetricsTimer(Metric metric, bool sampled)
+        : block(MetricsRegistry::localBlock()), metric(static_cast<int>(metric)) {
+        timed = !sampled || block.sampleTick++ % MetricsRegistry::SAMPLE_PERIOD == 0;
+        if (timed) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+    ~MetricsTimer() {
+        if (!timed) {
+            MetricsRegistry::bump(block.calls[metric], 1);
+            return;
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        MetricsRegistry::recordInto(
+            block, metric,
+            static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+    MetricsTimer(const MetricsTimer&) = delete;
+    MetricsTimer& operator=(const MetricsTimer&) = delete;
+
+private:
+    MetricsRegistry::ThreadBlock& block;
+    int metric;
+    bool timed;
+    std::chrono::steady_clock::time_point start;
+};
+
+#if GAME_CORE_METRICS
+#define GAME_METRICS_TIMED(metric) MetricsTimer gameMetricsTimer(metric, false)
+#define GAME_METRICS_SAMPLED(metric) MetricsTimer gameMetricsTimer(metric, true)
+#else
+#define GAME_METRICS_TIMED(metric) ((void)0)
+#define GAME_METRICS_SAMPLED(metric) ((void)0)
+#endif
+
+#endif // METRICS_H
@@ -0,0 +1,37 @@
+#ifndef MOVECODEC_H
+#define MOVECODEC_H
+
+#include "GameHistory.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Compact binary form of a move list. Each move is one byte holding the cell
+// index (row * columns + col) in the low 7 bits and the player in the top bit
+// (clear for 'X', set for 'O'), followed by the time since the previous move
+// as a zigzag varint. Untimed moves cost two bytes, timed ones rarely more
+// than four.
+class MoveCodec {
+public:
+    static constexpr int MAX_CELLS = 128;
+
+    static bool packMove(const Move& move, std::uint8_t& packed, int columns = 3);
+    static Move unpackMove(std::uint8_t packed, int columns = 3);
+
+    // LEB128 varints; signed values are zigzag-mapped first
+    static void appendVarint(std::string& out, std::uint64_t value);
+    static bool readVarint(const std::string& in, std::size_t& pos, std::uint64_t& value);
+    static void appendSignedVarint(std::string& out, std::int64_t value);
+    static bool readSignedVarint(const std::string& in, std::size_t& pos, std::int64_t& value);
+
+    // Appends a move count followed by the packed moves; the first move's time
+    // is stored relative to baseTime. Untimed moves come back carrying the
+    // previous move's time (baseTime for the first). Fails if a move cannot be packed.
+    static bool encodeMoves(const std::vector<Move>& moves, EpochMillis baseTime, std::string& out,
+                            int columns = 3);
+    static bool decodeMoves(const std::string& in, std::size_t& pos, EpochMillis baseTime,
+                            std::vector<Move>& moves, int columns = 3);
+};
+
+#endif // MOVECODEC_H
@@ -0,0 +1,67 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <utility>
+
+// Unbounded multi-producer, single-consumer queue (Vyukov). push() is one
+// atomic exchange and never blocks; pop() may only be called from one thread
+// at a time. A pop() racing a push() can miss that element until the push
+// finishes linking it, so consumers must not treat "empty" as final.
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue();
+    ~MpscQueue();
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(T value);
+    bool pop(T& value);
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        T value;
+    };
+
+    std::atomic<Node*> head;   // last pushed; written by producers
+    Node* tail;                // already consumed stub; owned by the consumer
+};
+
+template <typename T>
+MpscQueue<T>::MpscQueue() {
+    Node* stub = new Node();
+    head.store(stub);
+    tail = stub;
+}
+
+template <typename T>
+MpscQueue<T>::~MpscQueue() {
+    T ignored;
+    while (pop(ignored)) {
+    }
+    delete tail;
+}
+
+template <typename T>
+void MpscQueue<T>::push(T value) {
+    Node* node = new Node();
+    node->value = std::move(value);
+    Node* previous = head.exchange(node);
+    previous->next.store(node, std::memory_order_release);
+}
+
+template <typename T>
+bool MpscQueue<T>::pop(T& value) {
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+        return false;
+    }
+    value = std::move(next->value);
+    delete tail;
+    tail = next;
+    return true;
+}
+
+#endif // MPSCQUEUE_H
@@ -0,0 +1,107 @@
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+// Recycles objects of one type. Objects are built a slab at a time from a
+// polymorphic memory resource and handed back on release() without being
+// destroyed, so their own buffers (strings, vectors) keep their capacity for
+// the next user. Once the pool has grown to its working size, acquire() and
+// release() never touch the allocator. Not thread-safe; give each thread its own.
+template <typename T>
+class ObjectPool {
+public:
+    using Initializer = std::function<void(T&)>;
+
+    // initializer runs once on every object the pool creates, e.g. to reserve buffers
+    explicit ObjectPool(std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+                        Initializer initializer = nullptr, std::size_t slabSize = 64);
+    ~ObjectPool();
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // Returns a recycled object in whatever state it was released in
+    T* acquire();
+    void release(T* object);
+    // Grows the pool until at least count objects exist
+    void reserve(std::size_t count);
+
+    std::size_t capacity() const { return created; }
+    std::size_t available() const { return freeList.size(); }
+
+private:
+    std::pmr::memory_resource* resource;
+    Initializer initializer;
+    std::size_t slabSize;
+    std::size_t created;
+    std::pmr::vector<T*> slabs;
+    std::pmr::vector<T*> freeList;
+
+    void addSlab();
+};
+
+template <typename T>
+ObjectPool<T>::ObjectPool(std::pmr::memory_resource* resource, Initializer initializer,
+                          std::size_t slabSize)
+    : resource(resource),
+      initializer(std::move(initializer)),
+      slabSize(slabSize == 0 ? 1 : slabSize),
+      created(0),
+      slabs(resource),
+      freeList(resource) {}
+
+template <typename T>
+ObjectPool<T>::~ObjectPool() {
+    for (T* slab : slabs) {
+        for (std::size_t i = 0; i < slabSize; i++) {
+            slab[i].~T();
+        }
+        resource->deallocate(slab, sizeof(T) * slabSize, alignof(T));
+    }
+}
+
+template <typename T>
+void ObjectPool<T>::addSlab() {
+    T* slab = static_cast<T*>(resource->allocate(sizeof(T) * slabSize, alignof(T)));
+    for (std::size_t i = 0; i < slabSize; i++) {
+        new (slab + i) T();
+        if (initializer) {
+            initializer(slab[i]);
+        }
+    }
+    slabs.push_back(slab);
+    created += slabSize;
+    // Room for every object up front, so release() never reallocates
+    freeList.reserve(created);
+    for (std::size_t i = slabSize; i > 0; i--) {
+        freeList.push_back(slab + i - 1);
+    }
+}
+
+template <typename T>
+T* ObjectPool<T>::acquire() {
+    if (freeList.empty()) {
+        addSlab();
+    }
+    T* object = freeList.back();
+    freeList.pop_back();
+    return object;
+}
+
+template <typename T>
+void ObjectPool<T>::release(T* object) {
+    freeList.push_back(object);
+}
+
+template <typename T>
+void ObjectPool<T>::reserve(std::size_t count) {
+    while (created < count) {
+        addSlab();
+    }
+}
+
+#endif // OBJECTPOOL_H
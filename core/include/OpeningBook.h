@@ -0,0 +1,72 @@
+#ifndef OPENINGBOOK_H
+#define OPENINGBOOK_H
+
+#include "GameHistory.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <vector>
+
+// Outcomes of the recorded games that passed through a position
+struct OpeningStats {
+    std::uint64_t games = 0;
+    std::uint64_t firstPlayerWins = 0;
+    std::uint64_t secondPlayerWins = 0;
+    std::uint64_t ties = 0;
+};
+
+struct OpeningContinuation {
+    Move move;
+    OpeningStats stats;
+    // Share of these games the player making the move went on to win, ties counting half
+    double score;
+};
+
+// Trie of recorded move sequences with win/loss/tie counts at every node.
+// Sequences are folded under the board's eight rotations and reflections
+// (each game is stored in its lexicographically smallest orientation), so
+// symmetric openings share their statistics. Outcomes are kept relative to
+// the first and second player, since recorded games do not all start with 'X'.
+class OpeningBook {
+public:
+    OpeningBook();
+
+    // Counts a finished game; unfinished or illegal games are ignored
+    bool addGame(const GameRecord& record);
+    // Replaces the contents with the given games, building partial tries in parallel
+    void build(const std::vector<GameRecord>& records, std::size_t threadCount = 0);
+    void clear();
+
+    // Games that started with this sequence, in any orientation
+    OpeningStats statsAfter(const std::vector<Move>& moves) const;
+    // One entry per empty cell that has been played from this position, best score first
+    std::vector<OpeningContinuation> continuations(const std::vector<Move>& moves) const;
+    // The continuation with the best score among those seen in at least minGames games
+    bool bestMove(const std::vector<Move>& moves, Move& move, std::uint64_t minGames = 1) const;
+
+    std::size_t nodeCount() const;
+    std::uint64_t gameCount() const;
+
+private:
+    static constexpr std::uint32_t NO_CHILD = 0;
+
+    struct Node {
+        std::array<std::uint32_t, 9> children;
+        std::uint32_t firstPlayerWins;
+        std::uint32_t secondPlayerWins;
+        std::uint32_t ties;
+
+        Node() : firstPlayerWins(0), secondPlayerWins(0), ties(0) { children.fill(NO_CHILD); }
+    };
+
+    std::vector<Node> nodes;
+    mutable std::shared_mutex mutex;
+
+    void insertLocked(const std::vector<int>& canonical, int outcome);
+    void mergeLocked(std::uint32_t target, const OpeningBook& source, std::uint32_t from);
+    std::uint32_t findLocked(const std::vector<int>& canonical) const;
+    OpeningStats statsOf(std::uint32_t node) const;
+};
+
+#endif // OPENINGBOOK_H
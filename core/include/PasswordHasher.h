@@ -0,0 +1,92 @@
+#ifndef PASSWORDHASHER_H
+#define PASSWORDHASHER_H
+
+#include "ThreadPool.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <string>
+
+// Salted, memory-hard password hashing (Balloon hashing over SHA-256).
+// Encoded hashes are self-describing, so the cost parameters can be raised
+// later without invalidating stored passwords:
+//   $balloon-sha256$s=<spaceCost>,t=<timeCost>$<salt hex>$<hash hex>
+class PasswordHasher {
+public:
+    struct Params {
+        std::uint32_t spaceCost;  // number of 32-byte blocks kept in memory
+        std::uint32_t timeCost;   // mixing rounds over the buffer
+
+        Params() : spaceCost(4096), timeCost(3) {}
+        Params(std::uint32_t space, std::uint32_t time) : spaceCost(space), timeCost(time) {}
+    };
+
+    // Costs outside these bounds are refused, when hashing and when parsing alike
+    static constexpr std::uint32_t MAX_SPACE_COST = 1u << 24;
+    static constexpr std::uint32_t MAX_TIME_COST = 1000;
+    static bool validParams(const Params& params);
+
+    // Empty if params are not valid
+    static std::string hashPassword(const std::string& password, const Params& params = Params());
+    static bool verifyPassword(const std::string& password, const std::string& encoded);
+    static bool isEncodedHash(const std::string& value);
+
+    // Compares every byte regardless of where the first mismatch is
+    static bool constantTimeEquals(const std::string& a, const std::string& b);
+
+    // Empty if params are not valid
+    static std::string derive(const std::string& password, const std::string& salt,
+                              const Params& params);
+};
+
+// A stored credential in fixed space, so a user record carries no heap string
+// for it. Balloon hashes are unpacked into their costs, salt and digest; any
+// other credential (a hash made by the client, or a legacy value) is kept as
+// its SHA-256 and can only be compared against, not recovered.
+struct PasswordDigest {
+    static constexpr std::size_t SALT_BYTES = 16;
+    static constexpr std::size_t HASH_BYTES = 32;
+
+    enum class Kind : std::uint8_t { NONE, BALLOON, OPAQUE };
+
+    Kind kind;
+    PasswordHasher::Params params;
+    std::array<std::uint8_t, SALT_BYTES> salt;
+    std::array<std::uint8_t, HASH_BYTES> hash;
+
+    PasswordDigest() : kind(Kind::NONE), params(0, 0), salt(), hash() {}
+
+    // From what insertUser() callers pass: an encoded Balloon hash or any other credential
+    static PasswordDigest fromCredential(const std::string& credential);
+    // Inverse of toString(); a raw credential from an older file is taken as-is
+    static PasswordDigest fromStored(const std::string& stored);
+
+    // The encoded Balloon hash, or "$sha256$<hex>" for an opaque credential
+    std::string toString() const;
+    // Constant time; true if credential is the one this digest was made from
+    bool matches(const std::string& credential) const;
+    // Derives password with the stored salt and costs; always false unless Balloon
+    bool verify(const std::string& password) const;
+};
+
+// Runs password hashing on dedicated workers so that key derivation never
+// blocks game threads; throughput scales with the number of workers.
+class AsyncPasswordHasher {
+public:
+    explicit AsyncPasswordHasher(std::size_t threadCount = 0,
+                                 const PasswordHasher::Params& params = PasswordHasher::Params());
+
+    // Resolves to an empty string if the hasher was given invalid params
+    std::future<std::string> hashAsync(const std::string& password);
+    std::future<bool> verifyAsync(const std::string& password, const std::string& encoded);
+    std::future<bool> verifyAsync(const std::string& password, const PasswordDigest& digest);
+
+    const PasswordHasher::Params& getParams() const { return params; }
+
+private:
+    PasswordHasher::Params params;
+    ThreadPool pool;
+};
+
+#endif // PASSWORDHASHER_H
@@ -0,0 +1,78 @@
+#ifndef PERSISTENCESERVICE_H
+#define PERSISTENCESERVICE_H
+
+#include "MpscQueue.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+// Moves file writes off the caller's thread. Callers hand over the bytes to
+// write and return at once; a background writer drains the queue in batches,
+// merges the jobs of each batch per file (a replace drops everything queued
+// for that file before it, appends are concatenated) and writes each file
+// once. Replacements go through a temporary file and a rename, so readers
+// never see a half-written file. Every job resolves a future with whether
+// its bytes are on disk: files are fsynced, and after a rename so is their
+// directory. A replace may also hand over a function that produces the bytes:
+// the writer calls it when it writes the batch, so a structure saved after
+// every change is serialized once per batch instead of once per change.
+class PersistenceService {
+public:
+    PersistenceService();
+    // Writes everything still queued before returning
+    ~PersistenceService();
+    PersistenceService(const PersistenceService&) = delete;
+    PersistenceService& operator=(const PersistenceService&) = delete;
+
+    std::future<bool> append(const std::string& path, std::string data);
+    std::future<bool> replace(const std::string& path, std::string data);
+    // Called on the writer thread, at most once per batch; it must synchronize
+    // with whoever changes what it reads, and stay callable until the job resolves
+    std::future<bool> replaceWith(const std::string& path, std::function<std::string()> snapshot);
+    // Resolves once every job submitted before it has been written; false if any failed
+    std::future<bool> flush();
+    // The same wait, answering for one file: false while a write to path has
+    // failed and no replace of the whole file has succeeded since
+    std::future<bool> flush(const std::string& path);
+
+    std::uint64_t batchesWritten() const { return batches.load(std::memory_order_relaxed); }
+    std::uint64_t filesWritten() const { return files.load(std::memory_order_relaxed); }
+
+private:
+    enum class JobType { APPEND, REPLACE, BARRIER };
+
+    struct Job {
+        JobType type = JobType::BARRIER;
+        std::string path;
+        std::string data;
+        std::function<std::string()> snapshot;
+        std::shared_ptr<std::promise<bool>> done;
+    };
+
+    MpscQueue<Job> queue;
+    std::mutex mutex;   // only for sleeping and waking the writer
+    std::condition_variable wake;
+    std::atomic<bool> sleeping;
+    std::atomic<bool> stopping;
+    std::atomic<std::uint64_t> batches;
+    std::atomic<std::uint64_t> files;
+    // Writer thread only
+    bool failedSinceBarrier;
+    std::unordered_set<std::string> damagedPaths;
+    std::thread writer;
+
+    std::future<bool> submit(JobType type, const std::string& path, std::string data,
+                             std::function<std::string()> snapshot = nullptr);
+    void run();
+    void writeBatch(std::vector<Job>& batch);
+};
+
+#endif // PERSISTENCESERVICE_H
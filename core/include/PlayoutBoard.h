@@ -0,0 +1,49 @@
+#ifndef PLAYOUTBOARD_H
+#define PLAYOUTBOARD_H
+
+#include "GameBoard.h"
+#include <cstdint>
+
+// Fixed-capacity board for search and random playouts. Cells live in plain
+// arrays, so copies and moves never allocate, and an unordered list of empty
+// cells gives O(1) random move selection and O(1) undo. Win detection only
+// looks at the lines through the last move.
+class PlayoutBoard {
+public:
+    static constexpr int MAX_CELLS = 1024;
+
+    PlayoutBoard();
+    // Copies a GameBoard; boards larger than MAX_CELLS are not supported
+    explicit PlayoutBoard(const GameBoard& board);
+    static bool fits(const GameBoard& board);
+    static char opponent(char player) { return (player == 'X') ? 'O' : 'X'; }
+
+    int rows() const { return rowCount; }
+    int cols() const { return colCount; }
+    int cellCount() const { return rowCount * colCount; }
+    int winLength() const { return lineLength; }
+
+    char cell(int index) const { return cells[index]; }
+    bool isEmpty(int index) const { return cells[index] == ' '; }
+    int emptyCount() const { return empties; }
+    // The i-th empty cell; the order changes as moves are played and undone
+    int emptyCell(int i) const { return emptyList[i]; }
+
+    // Places player on an empty cell and returns true if that completes a line
+    bool play(int index, char player);
+    void undo(int index);
+    bool makesLine(int index) const;
+    // Result of the position, scanning the whole board
+    GameResult result() const;
+
+private:
+    int rowCount;
+    int colCount;
+    int lineLength;
+    int empties;
+    char cells[MAX_CELLS];
+    std::int16_t emptyList[MAX_CELLS];
+    std::int16_t emptySlot[MAX_CELLS];
+};
+
+#endif // PLAYOUTBOARD_H
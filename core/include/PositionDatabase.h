@@ -0,0 +1,117 @@
+#ifndef POSITIONDATABASE_H
+#define POSITIONDATABASE_H
+
+#include "GameBoard.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Outcome for the player to move when both sides play perfectly
+enum class PositionValue { LOSS, DRAW, WIN };
+
+struct PositionEntry {
+    PositionValue value = PositionValue::DRAW;
+    int bestMove = -1;   // cell index (row * cols + col); -1 once the game is over
+    // Plies until the game ends; wins are taken as fast and losses put off as long as possible.
+    // For a heuristic entry, plies until the search that valued it stopped looking.
+    int depth = 0;
+    // The value rests on a depth-limited search beyond maxDepth and is an estimate
+    bool heuristic = false;
+};
+
+struct PositionDatabaseConfig {
+    int rows = 3;
+    int cols = 3;
+    int winLength = 3;
+    // Positions with more marks than this are not visited: those with exactly
+    // maxDepth marks are valued by a depth-limited search instead. -1 solves all
+    int maxDepth = -1;
+    // Node budget of each of those searches
+    std::uint64_t horizonNodes = 100000;
+    // The solver gives up after this many distinct positions
+    std::size_t maxPositions = 50000000;
+};
+
+struct PositionDatabaseStats {
+    std::uint64_t solved = 0;    // distinct positions up to symmetry
+    std::uint64_t written = 0;
+    std::uint64_t heuristic = 0; // written entries whose value is an estimate
+    std::uint64_t fileBytes = 0;
+};
+
+// Solved positions of one m,n,k game with X moving first, for services that
+// want answers without linking the engine or searching. generate() solves
+// every reachable position of up to maxDepth marks and writes one entry per
+// position up to the board's symmetries (eight for square boards, four
+// otherwise). Positions of exactly maxDepth marks are handed to a budgeted
+// AlphaBetaEngine search; where it cannot prove the result, its score stands
+// in for the value, and entries that depend on such a score are flagged
+// heuristic. The file is read in place through a memory map, and its layout
+// is fixed so other languages can do the same; all integers are little-endian:
+//
+//   header   64 bytes: "TTTPOSD2", u32 rows, cols, winLength, i32 maxDepth,
+//            u64 slotCount, bucketCount, positionCount, zero padding
+//   keys     u64[slotCount]; 0xFFFFFFFFFFFFFFFF marks an empty slot
+//   entries  u16[slotCount]: value in bits 0-1 (0 loss, 1 draw, 2 win),
+//            best move in bits 2-8 (127 if none), depth in bits 9-14,
+//            heuristic flag in bit 15
+//   seeds    u32[bucketCount], after padding to a multiple of 4 bytes
+//
+// A key holds cell i (row-major) in bits 2i and 2i+1: 0 empty, 1 X, 2 O.
+// Stored keys are the smallest over the symmetries, and best moves are in
+// that orientation. A key can only be at slot
+// mixSeed(key ^ seeds[mixSeed(key) % bucketCount]) % slotCount (mixSeed is
+// in Random.h), so a lookup reads one seed, one key and one entry.
+// Boards of up to 32 cells are supported. "TTTPOSD1" files have the same
+// layout without heuristic entries and are still read.
+class PositionDatabase {
+public:
+    static constexpr int MAX_CELLS = 32;
+
+    PositionDatabase();
+    ~PositionDatabase();
+    PositionDatabase(const PositionDatabase&) = delete;
+    PositionDatabase& operator=(const PositionDatabase&) = delete;
+
+    // False if the board is too large, the solver runs past maxPositions or path cannot be written
+    static bool generate(const std::string& path, const PositionDatabaseConfig& config,
+                         PositionDatabaseStats* stats = nullptr);
+
+    // Maps path read-only; false if it is missing or not a position database
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+
+    int rows() const { return rowCount; }
+    int cols() const { return colCount; }
+    int winLength() const { return lineLength; }
+    int maxDepth() const { return depthLimit; }
+    std::uint64_t positionCount() const { return positions; }
+
+    // A board with more O's than X's is read as a game O opened; otherwise X
+    // moved first. False for boards of another size and for positions that
+    // cannot arise or were not written.
+    bool lookup(const GameBoard& board, PositionEntry& entry) const;
+    // key in any orientation, with X to move first as in the file
+    bool lookupKey(std::uint64_t key, PositionEntry& entry) const;
+
+private:
+    const unsigned char* data;
+    std::size_t size;
+    bool mapped;
+    std::vector<unsigned char> buffer;   // the file's bytes where it cannot be mapped
+    int rowCount;
+    int colCount;
+    int lineLength;
+    int depthLimit;
+    std::uint64_t slots;
+    std::uint64_t buckets;
+    std::uint64_t positions;
+    // symmetries[s][i]: where cell i goes under symmetry s
+    std::vector<std::vector<int>> symmetries;
+
+    bool findSlot(std::uint64_t canonical, std::uint16_t& packed) const;
+};
+
+#endif // POSITIONDATABASE_H
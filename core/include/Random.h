@@ -0,0 +1,42 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+// Deterministic generators for search, self-play and table layouts, where
+// a seed must reproduce the same run. Nothing here is fit for secrets;
+// session tokens and salts come from std::random_device.
+
+// xorshift64*: cheap, allocation-free and good enough for random playouts
+class Random {
+public:
+    explicit Random(std::uint64_t seed) : state(seed ? seed : 0x2545f4914f6cdd1dULL) {}
+    std::uint64_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545f4914f6cdd1dULL;
+    }
+    int below(int bound) { return static_cast<int>(next() % static_cast<std::uint64_t>(bound)); }
+
+private:
+    std::uint64_t state;
+};
+
+// The splitmix64 step: a bijection that spreads nearby values over all 64
+// bits, for deriving independent seeds and for hashing keys
+inline std::uint64_t mixSeed(std::uint64_t value) {
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+// splitmix64 as a sequence: the next value from state, advancing it
+inline std::uint64_t splitMix(std::uint64_t& state) {
+    std::uint64_t value = mixSeed(state);
+    state += 0x9e3779b97f4a7c15ULL;
+    return value;
+}
+
+#endif // RANDOM_H
@@ -0,0 +1,68 @@
+#ifndef SCANKERNELS_H
+#define SCANKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Equality scans over plain integer columns, for filters no index covers.
+// Results are selection bitmaps: bit (i % 64) of word i / 64 is set when row
+// i matches. Every select call overwrites bitmapWords(rows) words and leaves
+// the bits past the last row clear, so bitmaps of the same rows can be
+// combined word by word. The widest instruction set the CPU supports is
+// picked once, at startup; results do not depend on it.
+class ScanKernels {
+public:
+    enum class Level { SCALAR, SSE2, AVX2 };
+
+    static Level level();
+    // Caps the instruction set used, e.g. to compare paths; returns the level now in use
+    static Level setLevel(Level requested);
+    static Level supportedLevel();
+
+    static std::size_t bitmapWords(std::size_t rows) { return (rows + 63) / 64; }
+
+    static void selectEqual(const std::uint32_t* column, std::size_t rows, std::uint32_t value,
+                            std::uint64_t* bits);
+    static void selectEqual(const std::uint8_t* column, std::size_t rows, std::uint8_t value,
+                            std::uint64_t* bits);
+    // Rows where either column holds value, e.g. a player in either seat
+    static void selectEither(const std::uint32_t* first, const std::uint32_t* second, std::size_t rows,
+                             std::uint32_t value, std::uint64_t* bits);
+
+    static void selectAll(std::size_t rows, std::uint64_t* bits);
+    static void intersect(std::uint64_t* bits, const std::uint64_t* other, std::size_t words);
+    static std::size_t count(const std::uint64_t* bits, std::size_t words);
+
+    // Calls visit(row) for every set bit, in row order
+    template <typename Visitor>
+    static void forEachSelected(const std::uint64_t* bits, std::size_t words, Visitor visit);
+
+private:
+    static int lowestBit(std::uint64_t word);
+};
+
+inline int ScanKernels::lowestBit(std::uint64_t word) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(word);
+#else
+    int bit = 0;
+    while ((word & 1) == 0) {
+        word >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+template <typename Visitor>
+void ScanKernels::forEachSelected(const std::uint64_t* bits, std::size_t words, Visitor visit) {
+    for (std::size_t w = 0; w < words; w++) {
+        std::uint64_t word = bits[w];
+        while (word != 0) {
+            visit(w * 64 + static_cast<std::size_t>(lowestBit(word)));
+            word &= word - 1;
+        }
+    }
+}
+
+#endif // SCANKERNELS_H
@@ -0,0 +1,82 @@
+#ifndef SELFPLAY_H
+#define SELFPLAY_H
+
+#include "AiPlayer.h"
+#include "GameBoard.h"
+#include "GameHistory.h"
+#include "ThreadPool.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class PolicyKind {
+    RANDOM,   // uniformly random legal move
+    GREEDY,   // wins if it can, otherwise blocks, otherwise random
+    MCTS,     // MctsEngine with a fixed playout budget
+    AI        // AiPlayer at a fixed difficulty
+};
+
+struct SelfPlayPolicy {
+    std::string name;   // also the player name in recorded games
+    PolicyKind kind = PolicyKind::RANDOM;
+    std::uint64_t iterations = 200;   // MCTS playouts per move
+    Difficulty difficulty = Difficulty::EASY;   // AI tier
+
+    SelfPlayPolicy() = default;
+    SelfPlayPolicy(const std::string& n, PolicyKind k, std::uint64_t i = 200)
+        : name(n), kind(k), iterations(i) {}
+};
+
+struct SelfPlayConfig {
+    int rows = 3;
+    int cols = 3;
+    int winLength = 3;
+    std::size_t games = 1000;
+    std::uint64_t seed = 1;
+};
+
+struct PolicyStats {
+    std::string name;
+    std::uint64_t games = 0;
+    std::uint64_t wins = 0;
+    std::uint64_t losses = 0;
+    std::uint64_t ties = 0;
+    std::uint64_t gamesAsFirst = 0;
+    std::uint64_t winsAsFirst = 0;
+
+    double winRate() const { return games == 0 ? 0.0 : static_cast<double>(wins) / games; }
+};
+
+struct SelfPlayReport {
+    std::vector<PolicyStats> policies;   // same order as the policies passed in
+    std::uint64_t games = 0;
+    std::uint64_t recorded = 0;          // games written to history
+    std::int64_t elapsedMillis = 0;
+};
+
+// Plays AI policies against each other across a thread pool. Game i pairs
+// the policies by cycling through every ordered pair (a single policy plays
+// itself, and each such game is counted once, from the first mover's side),
+// so each matchup is played equally often with both colours. Random
+// and greedy games depend only on the seed and the game index, never on the
+// thread count. Finished games are buffered per chunk and handed to
+// GameHistory in one bulk load; history only stores 3x3 boards, so games on
+// other sizes are summarized but not recorded.
+class SelfPlay {
+public:
+    // threadCount == 0 picks one thread per hardware thread
+    explicit SelfPlay(std::size_t threadCount = 0);
+
+    SelfPlayReport run(const std::vector<SelfPlayPolicy>& policies, const SelfPlayConfig& config,
+                       GameHistory* history = nullptr);
+
+    // Parses "random", "greedy", "mcts[:iterations]", "easy", "medium" or "hard";
+    // returns false on anything else
+    static bool parsePolicy(const std::string& text, SelfPlayPolicy& policy);
+
+private:
+    ThreadPool pool;
+};
+
+#endif // SELFPLAY_H
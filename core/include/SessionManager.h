@@ -0,0 +1,76 @@
+#ifndef SESSIONMANAGER_H
+#define SESSIONMANAGER_H
+
+#include "StringInterner.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+class UserHashTable;
+
+// Opaque 128-bit random session token
+struct SessionToken {
+    std::uint64_t high;
+    std::uint64_t low;
+
+    SessionToken() : high(0), low(0) {}
+    SessionToken(std::uint64_t h, std::uint64_t l) : high(h), low(l) {}
+
+    bool isValid() const { return high != 0 || low != 0; }
+    bool operator==(const SessionToken& other) const {
+        return high == other.high && low == other.low;
+    }
+    bool operator!=(const SessionToken& other) const { return !(*this == other); }
+
+    std::string toString() const;
+    static bool fromString(const std::string& text, SessionToken& token);
+};
+
+// Issues session tokens after authentication and resolves them back to the
+// user id. Sessions live in a fixed-size table probed at a handful of slots
+// picked by the token bits, so resolve() never locks or allocates; each slot
+// is guarded by a sequence counter that readers validate. When every slot a
+// token may use is taken, the session closest to expiry is evicted.
+class SessionManager {
+public:
+    // Milliseconds on a monotonic clock; replaceable for tests
+    using Clock = std::function<std::int64_t()>;
+
+    explicit SessionManager(std::size_t capacity = 65536, std::int64_t ttlMillis = 30 * 60 * 1000,
+                            Clock clock = Clock());
+
+    SessionToken createSession(UserId user);
+    // Authenticates against the user table and opens a session on success
+    bool openSession(UserHashTable& users, const std::string& username,
+                     const std::string& passwordHash, SessionToken& token);
+
+    bool resolve(const SessionToken& token, UserId& user) const;
+    void revoke(const SessionToken& token);
+    std::size_t activeSessions() const;
+
+private:
+    static constexpr std::size_t PROBE_LENGTH = 4;
+
+    struct Slot {
+        std::atomic<std::uint64_t> sequence{0};  // odd while a writer owns the slot
+        std::atomic<std::uint64_t> high{0};
+        std::atomic<std::uint64_t> low{0};
+        std::atomic<UserId> user{INVALID_USER_ID};
+        std::atomic<std::int64_t> expiresAt{0};
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::size_t mask;
+    std::int64_t ttlMillis;
+    Clock clock;
+
+    std::int64_t now() const;
+    bool lockSlot(Slot& slot, std::uint64_t& sequence);
+    static void unlockSlot(Slot& slot, std::uint64_t sequence);
+    static SessionToken randomToken();
+};
+
+#endif // SESSIONMANAGER_H
@@ -0,0 +1,31 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Incremental SHA-256 (FIPS 180-4).
+class Sha256 {
+public:
+    using Digest = std::array<std::uint8_t, 32>;
+
+    Sha256();
+    void update(const void* data, std::size_t size);
+    void update(const std::string& data) { update(data.data(), data.size()); }
+    Digest finish();
+
+    static Digest hash(const std::string& data);
+    static std::string toHex(const std::uint8_t* data, std::size_t size);
+
+private:
+    std::array<std::uint32_t, 8> state;
+    std::array<std::uint8_t, 64> block;
+    std::size_t blockUsed;
+    std::uint64_t totalBytes;
+
+    void compress(const std::uint8_t* chunk);
+};
+
+#endif // SHA256_H
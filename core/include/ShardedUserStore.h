@@ -0,0 +1,147 @@
+#ifndef SHARDEDUSERSTORE_H
+#define SHARDEDUSERSTORE_H
+
+#include "UserManager.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// One partition of the user base. Shards exchange whole User records by value
+// because a shard may live in another process.
+class UserShard {
+public:
+    virtual ~UserShard() = default;
+    virtual bool insertUser(const User& user) = 0;
+    virtual bool authenticateUser(const std::string& username, const std::string& passwordHash) = 0;
+    virtual bool userExists(const std::string& username) = 0;
+    virtual bool removeUser(const std::string& username) = 0;
+    virtual bool getUser(const std::string& username, User& user) = 0;
+    virtual bool updateUser(const std::string& username, const User& user) = 0;
+    virtual std::vector<User> getAllUsers() = 0;
+    // Rebalancing moves users in batches, each costing the shard one save.
+    // insertUsers returns the names it stored; a user missing from it was not moved.
+    virtual std::vector<std::string> insertUsers(const std::vector<User>& users) = 0;
+    virtual std::size_t removeUsers(const std::vector<std::string>& usernames) = 0;
+};
+
+// Shard backed by a UserHashTable in this process, persisted to its own file.
+class LocalUserShard : public UserShard {
+public:
+    explicit LocalUserShard(const std::string& usersFile);
+
+    bool insertUser(const User& user) override;
+    bool authenticateUser(const std::string& username, const std::string& passwordHash) override;
+    bool userExists(const std::string& username) override;
+    bool removeUser(const std::string& username) override;
+    bool getUser(const std::string& username, User& user) override;
+    bool updateUser(const std::string& username, const User& user) override;
+    std::vector<User> getAllUsers() override;
+    std::vector<std::string> insertUsers(const std::vector<User>& users) override;
+    std::size_t removeUsers(const std::vector<std::string>& usernames) override;
+
+private:
+    UserHashTable table;
+};
+
+// Shard served by a forked child process that owns a LocalUserShard. Requests
+// travel over a socket pair as length-prefixed frames.
+//
+// The child is not exec'd: it keeps running this program's code and uses the
+// process-wide StringInterner and metrics, whose locks fork() copies in
+// whatever state other threads left them. Shards must therefore be spawned
+// while the process is still single-threaded, before any ThreadPool,
+// PersistenceService, session engine or compaction starts.
+class ProcessUserShard : public UserShard {
+public:
+    // Returns nullptr if the child process could not be started, or if the
+    // process already runs other threads (checked where /proc allows it).
+    static std::unique_ptr<ProcessUserShard> spawn(const std::string& usersFile);
+    ~ProcessUserShard() override;
+
+    bool insertUser(const User& user) override;
+    bool authenticateUser(const std::string& username, const std::string& passwordHash) override;
+    bool userExists(const std::string& username) override;
+    bool removeUser(const std::string& username) override;
+    bool getUser(const std::string& username, User& user) override;
+    bool updateUser(const std::string& username, const User& user) override;
+    std::vector<User> getAllUsers() override;
+    std::vector<std::string> insertUsers(const std::vector<User>& users) override;
+    std::size_t removeUsers(const std::vector<std::string>& usernames) override;
+
+    int processId() const { return pid; }
+
+private:
+    ProcessUserShard(int fd, int pid);
+    bool call(const std::vector<std::string>& request, std::vector<std::string>& reply);
+
+    int fd;
+    int pid;
+    std::mutex mutex;
+};
+
+// Consistent hash ring with virtual nodes. Adding a shard only takes over the
+// key ranges next to its own points, so roughly 1/n of the keys move.
+class ConsistentHashRing {
+public:
+    explicit ConsistentHashRing(int virtualNodes = 64);
+
+    // Ring points derive from the shard name, so a shard keeps its key ranges
+    // even when its index changes
+    void addShard(int shard, const std::string& shardName);
+    void removeShard(int shard);
+    int shardFor(const std::string& key) const;
+    bool empty() const { return ring.empty(); }
+
+    // Stable across processes and builds, unlike std::hash
+    static std::uint64_t hashKey(const std::string& key);
+
+private:
+    int virtualNodes;
+    std::vector<std::pair<std::uint64_t, int>> ring;
+};
+
+// Routes user operations to the shard owning each username and migrates users
+// when shards join or leave.
+class ShardedUserStore {
+public:
+    using ShardFactory = std::function<std::unique_ptr<UserShard>(const std::string& shardName)>;
+
+    explicit ShardedUserStore(ShardFactory factory);
+
+    // Shards persisted as "<filePrefix><shardName>.dat" in this process
+    static ShardFactory localShards(const std::string& filePrefix);
+    // Same file layout, each shard served by its own child process; add every
+    // shard before the process starts threads (see ProcessUserShard)
+    static ShardFactory processShards(const std::string& filePrefix);
+
+    // Users change shards only once every one of them has a copy at its new
+    // shard; otherwise the copies are undone, the store is left as it was and
+    // the call returns false. The last shard cannot be removed.
+    bool addShard(const std::string& shardName);
+    bool removeShard(const std::string& shardName);
+    std::vector<std::string> getShardNames() const;
+    std::string shardFor(const std::string& username) const;
+
+    bool insertUser(const std::string& username, const std::string& passwordHash);
+    bool authenticateUser(const std::string& username, const std::string& passwordHash);
+    bool userExists(const std::string& username);
+    void removeUser(const std::string& username);
+    bool getUser(const std::string& username, User& user);
+    void updateUser(const std::string& username, const User& user);
+    std::vector<std::string> getAllUsers();
+
+private:
+    ShardFactory factory;
+    ConsistentHashRing ring;
+    std::vector<std::string> shardNames;
+    std::vector<std::unique_ptr<UserShard>> shards;
+
+    UserShard* route(const std::string& username) const;
+    int findShard(const std::string& shardName) const;
+};
+
+#endif // SHARDEDUSERSTORE_H
@@ -0,0 +1,47 @@
+#ifndef STRINGINTERNER_H
+#define STRINGINTERNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using UserId = std::uint32_t;
+constexpr UserId INVALID_USER_ID = 0xFFFFFFFFu;
+
+// Maps names (or any other byte strings) to dense integer ids. Name bytes
+// are copied once into large arena chunks, so interning a name costs no
+// per-name heap allocation and the returned views stay valid for the
+// lifetime of the interner.
+class StringInterner {
+public:
+    StringInterner();
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+
+    UserId intern(std::string_view name);
+    UserId find(std::string_view name) const;
+    std::string_view name(UserId id) const;
+    std::size_t size() const;
+
+    // Process-wide instance shared by user tables and game history so that
+    // a player's id is the same everywhere.
+    static StringInterner& shared();
+
+private:
+    static constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> chunks;
+    std::vector<std::unique_ptr<char[]>> largeChunks;
+    std::size_t chunkUsed;
+    std::vector<std::string_view> names;
+    std::unordered_map<std::string_view, UserId> ids;
+    mutable std::shared_mutex mutex;
+
+    std::string_view store(std::string_view name);
+};
+
+#endif // STRINGINTERNER_H
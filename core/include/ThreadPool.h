@@ -0,0 +1,55 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Fixed set of worker threads draining a shared task queue. Used to keep
+// CPU-heavy work (key derivation, batch analysis) off the caller's thread.
+class ThreadPool {
+public:
+    // threadCount == 0 picks one worker per hardware thread
+    explicit ThreadPool(std::size_t threadCount = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <typename F>
+    std::future<std::invoke_result_t<F>> submit(F task);
+
+    std::size_t size() const { return workers.size(); }
+
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable ready;
+    bool stopping;
+
+    void workerLoop();
+};
+
+template <typename F>
+std::future<std::invoke_result_t<F>> ThreadPool::submit(F task) {
+    using Result = std::invoke_result_t<F>;
+    // std::function needs a copyable callable, so the packaged task is shared
+    auto packaged = std::make_shared<std::packaged_task<Result()>>(std::move(task));
+    std::future<Result> future = packaged->get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.emplace([packaged]() { (*packaged)(); });
+    }
+    ready.notify_one();
+    return future;
+}
+
+#endif // THREADPOOL_H
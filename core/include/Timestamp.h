@@ -0,0 +1,26 @@
+#ifndef TIMESTAMP_H
+#define TIMESTAMP_H
+
+#include <cstdint>
+#include <string>
+
+// Milliseconds since the Unix epoch, UTC. Times are stored and compared as
+// integers and only turned into text when something is displayed.
+using EpochMillis = std::int64_t;
+
+EpochMillis currentEpochMillis();
+
+// "YYYY-MM-DD HH:MM:SS" in UTC, without going through the C locale or time zone
+std::string formatTimestamp(EpochMillis time);
+
+// The same format in the process's local time zone, which is how the
+// original text history files spelled their stamps
+std::string formatLocalTimestamp(EpochMillis time);
+
+// Parses the format written by formatTimestamp(); the text is read as UTC
+bool parseTimestamp(const std::string& text, EpochMillis& time);
+// Reads the text as local time, daylight saving included, inverting
+// formatLocalTimestamp(); legacy history stamps must come through here
+bool parseLocalTimestamp(const std::string& text, EpochMillis& time);
+
+#endif // TIMESTAMP_H
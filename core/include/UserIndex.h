@@ -0,0 +1,78 @@
+#ifndef USERINDEX_H
+#define USERINDEX_H
+
+#include "StringInterner.h"
+#include <cstddef>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct User;
+
+// Ordered views over the user table: usernames in lexical order for prefix
+// search, and win counts / win rates in descending order for leaderboards.
+// All queries run in O(log n + k). Username keys are views into the shared
+// interner, so the index does not copy names.
+class UserIndex {
+public:
+    // Players need at least minRatedGames games to appear in the win-rate board
+    explicit UserIndex(int minRatedGames = 1);
+
+    void addUser(const User& user);
+    void updateUser(const User& user);
+    void removeUser(const User& user);
+    void clear();
+
+    std::vector<std::string> searchPrefix(const std::string& prefix, std::size_t limit) const;
+    std::vector<std::string> topByWins(std::size_t k) const;
+    std::vector<std::string> topByWinRate(std::size_t k) const;
+    std::size_t size() const { return names.size(); }
+
+private:
+    struct Stats {
+        int wins;
+        int played;
+    };
+
+    // Descending by wins, then ascending by name
+    struct WinsKey {
+        int wins;
+        std::string_view name;
+        bool operator<(const WinsKey& other) const {
+            if (wins != other.wins) {
+                return wins > other.wins;
+            }
+            return name < other.name;
+        }
+    };
+
+    // Descending by win rate, ties broken by more wins, then by name
+    struct RateKey {
+        double rate;
+        int wins;
+        std::string_view name;
+        bool operator<(const RateKey& other) const {
+            if (rate != other.rate) {
+                return rate > other.rate;
+            }
+            if (wins != other.wins) {
+                return wins > other.wins;
+            }
+            return name < other.name;
+        }
+    };
+
+    int minRatedGames;
+    std::set<std::string_view> names;
+    std::set<WinsKey> byWins;
+    std::set<RateKey> byWinRate;
+    std::unordered_map<UserId, Stats> stats;
+
+    void insertRanks(std::string_view name, const Stats& entry);
+    void eraseRanks(std::string_view name, const Stats& entry);
+    static RateKey rateKey(std::string_view name, const Stats& entry);
+};
+
+#endif // USERINDEX_H
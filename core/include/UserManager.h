@@ -1,47 +1,120 @@
 #ifndef USERMANAGER_H
 #define USERMANAGER_H
 
+#include "StringInterner.h"
+#include "PasswordHasher.h"
+#include "UserIndex.h"
 #include <string>
+#include <string_view>
 #include <vector>
-#include <list>
+#include <deque>
+#include <cstdint>
 #include <fstream>
 #include <sstream>
 #include <functional>
+#include <future>
+#include <mutex>
 
+class PersistenceService;
+
+// The username lives only in the shared StringInterner; a record holds its id
+// and a fixed-size password digest, so it owns no heap memory.
 struct User {
-    std::string username;
-    std::string passwordHash;
+    UserId id;
+    PasswordDigest password;
     int gamesPlayed;
     int gamesWon;
     int gamesLost;
     int gamesTied;
 
-    User() : gamesPlayed(0), gamesWon(0), gamesLost(0), gamesTied(0) {}
-    User(const std::string& user, const std::string& pass)
-        : username(user), passwordHash(pass), gamesPlayed(0), gamesWon(0), gamesLost(0), gamesTied(0) {}
+    User() : id(INVALID_USER_ID), gamesPlayed(0), gamesWon(0), gamesLost(0), gamesTied(0) {}
+    // Interns username in StringInterner::shared()
+    User(const std::string& username, const PasswordDigest& password);
+
+    std::string_view name() const { return StringInterner::shared().name(id); }
 };
 
 class UserHashTable {
 private:
-    static const int BUCKET_SIZE = 100;
-    std::list<std::pair<std::string, User>> table[BUCKET_SIZE];
+    static constexpr std::uint32_t NO_SLOT = 0xFFFFFFFFu;
 
-    int hashFunction(const std::string& key);
+    // Usernames are interned once; the id indexes straight into slotById, so a
+    // lookup is one interner probe instead of a bucket walk with string compares.
+    // Records live in a deque so pointers from getUser() stay valid, and the
+    // slots of removed users are reused.
+    StringInterner& names;
+    std::string usersFile;
+    PasswordHasher::Params passwordParams;
+    // Verified against when the user does not exist; hashed with passwordParams
+    PasswordDigest unknownUser;
+    std::deque<User> records;
+    std::vector<std::uint32_t> slotById;
+    std::vector<std::uint32_t> freeSlots;
+    UserIndex index;
+    PersistenceService* persistence = nullptr;
+    // The writer serializes records on its own thread: changes to records and
+    // snapshotQueued hold recordsMutex, and at most one snapshot is queued
+    std::mutex recordsMutex;
+    bool snapshotQueued = false;
+    // The last save, so a failed one is noticed and repeated
+    std::shared_future<bool> lastSave;
+    bool saveFailed = false;
+    std::uint64_t writes = 0;
+
+    std::uint32_t findSlot(const std::string& username) const;
+    std::uint32_t slotOf(UserId id) const;
+    void storeUser(const User& user);
+    void eraseUser(std::uint32_t slot);
+    void writeUsers(std::ostream& out) const;
+    std::string snapshotUsers();
 
 public:
     UserHashTable();
+    // An empty path keeps the table in memory only
+    explicit UserHashTable(const std::string& usersFile);
     ~UserHashTable();
 
     bool insertUser(const std::string& username, const std::string& passwordHash);
     bool authenticateUser(const std::string& username, const std::string& passwordHash);
+
+    // Plain-text password entry points: the table derives and stores a salted
+    // hash itself. The async variant runs the derivation on the hasher's workers.
+    bool registerUser(const std::string& username, const std::string& password);
+    bool verifyPassword(const std::string& username, const std::string& password);
+    std::future<bool> verifyPasswordAsync(const std::string& username, const std::string& password,
+                                          AsyncPasswordHasher& hasher);
+    // False, keeping the current params, if params are not PasswordHasher::validParams()
+    bool setPasswordParams(const PasswordHasher::Params& params);
+
     bool userExists(const std::string& username);
     void removeUser(const std::string& username);
+    // Batch forms for moving users between tables: one save for the whole
+    // batch. Taken names are skipped on insert, statistics come along with the
+    // records. insertUsers returns the names it stored, removeUsers how many
+    // users it removed.
+    std::vector<std::string> insertUsers(const std::vector<User>& users);
+    std::size_t removeUsers(const std::vector<std::string>& usernames);
     User* getUser(const std::string& username);
     void updateUser(const std::string& username, const User& user);
     std::vector<std::string> getAllUsers();
+
+    // Ordered queries; rankings reflect the statistics last passed to updateUser()
+    std::vector<std::string> searchUsers(const std::string& prefix, std::size_t limit);
+    std::vector<std::string> getTopByWins(std::size_t k);
+    std::vector<std::string> getTopByWinRate(std::size_t k);
+
     void loadUsers();
     void saveUsers();
+    // Saves started so far, queued ones included
+    std::uint64_t fileWrites() const { return writes; }
     void clear();
+    // Saves are serialized and written by service, once per batch however many
+    // changes it covers; it must outlive the table. Records must then only be
+    // changed through the table, not through getUser() pointers.
+    void setPersistence(PersistenceService* service) { persistence = service; }
+    // Resolves true once the table as it is now is synced to usersFile; a failed
+    // save is repeated here first, so false only means this attempt failed too
+    std::future<bool> durable();
 };
 
 #endif // USERMANAGER_H
@@ -0,0 +1,164 @@
+#include "AiPlayer.h"
+#include "PlayoutBoard.h"
+#include "Random.h"
+#include <algorithm>
+
+namespace {
+
+// Same scale as AlphaBetaEngine's horizon scores
+const long long MAX_SCORE = AlphaBetaEngine::WIN_THRESHOLD / 2;
+
+char sideToMove(const GameBoard& board) {
+    int xs = 0;
+    int os = 0;
+    for (int r = 0; r < board.getRows(); r++) {
+        for (int c = 0; c < board.getCols(); c++) {
+            char mark = board.getCell(r, c);
+            xs += (mark == 'X');
+            os += (mark == 'O');
+        }
+    }
+    return (xs > os) ? 'O' : 'X';
+}
+
+}  // namespace
+
+AiPlayer::AiPlayer(const PositionDatabase* database, const AiPlayerConfig& config, std::uint64_t seed)
+    : database(database),
+      config(config),
+      engine(16, mixSeed(seed)),
+      cap(static_cast<int>(Difficulty::HARD)),
+      random(seed) {}
+
+void AiPlayer::setDifficultyCap(Difficulty difficulty) {
+    cap.store(static_cast<int>(difficulty), std::memory_order_relaxed);
+}
+
+Difficulty AiPlayer::difficultyCap() const {
+    return static_cast<Difficulty>(cap.load(std::memory_order_relaxed));
+}
+
+bool AiPlayer::chooseMove(const GameBoard& board, char player, Difficulty difficulty, AiMove& move) {
+    move = AiMove();
+    if ((player != 'X' && player != 'O') || board.checkWin() != GameResult::ONGOING) {
+        return false;
+    }
+    Difficulty tier = std::min(difficulty, difficultyCap());
+    // The searching tiers work on a PlayoutBoard; anything larger gets the static evaluation
+    if (tier != Difficulty::EASY && !PlayoutBoard::fits(board)) {
+        tier = Difficulty::EASY;
+    }
+    move.difficulty = tier;
+
+    switch (tier) {
+        case Difficulty::HARD:
+            return databaseMove(board, player, move) || searchMove(board, player, config.hardLimits, move);
+        case Difficulty::MEDIUM: {
+            SearchLimits limits;
+            limits.maxDepth = config.mediumDepth;
+            limits.maxNodes = config.mediumNodes;
+            return searchMove(board, player, limits, move);
+        }
+        case Difficulty::EASY:
+            break;
+    }
+    return easyMove(board, player, move);
+}
+
+int AiPlayer::evaluate(const GameBoard& board, char player) {
+    LineEvaluator lines;
+    lines.load(board);
+    if (lines.lines(player) > 0) {
+        return AlphaBetaEngine::WIN_SCORE;
+    }
+    if (lines.lines(PlayoutBoard::opponent(player)) > 0) {
+        return -AlphaBetaEngine::WIN_SCORE;
+    }
+    long long total = (player == 'X') ? lines.total() : -lines.total();
+    return static_cast<int>(std::max(-MAX_SCORE, std::min(MAX_SCORE, total)));
+}
+
+bool AiPlayer::easyMove(const GameBoard& board, char player, AiMove& move) {
+    lines.load(board);
+    long long best = 0;
+    int ties = 0;
+    int chosen = -1;
+    for (int cell = 0; cell < lines.rows() * lines.cols(); cell++) {
+        char mark = board.getCell(cell / lines.cols(), cell % lines.cols());
+        if (mark == 'X' || mark == 'O') {
+            continue;
+        }
+        // Change in evaluate() from a mark here: only the windows through the cell move
+        bool wins;
+        long long gain = lines.gain(cell, player, wins);
+        if (wins) {
+            gain += AlphaBetaEngine::WIN_SCORE;
+        }
+        move.nodes++;
+
+        if (chosen == -1 || gain > best) {
+            best = gain;
+            chosen = cell;
+            ties = 1;
+        } else if (gain == best && random.below(++ties) == 0) {
+            // Reservoir sampling keeps every tied move equally likely
+            chosen = cell;
+        }
+    }
+    if (chosen == -1) {
+        return false;
+    }
+    move.row = chosen / lines.cols();
+    move.col = chosen % lines.cols();
+    return true;
+}
+
+bool AiPlayer::databaseMove(const GameBoard& board, char player, AiMove& move) const {
+    if (database == nullptr || !database->isOpen() || board.getRows() != database->rows() ||
+        board.getCols() != database->cols() || board.getWinLength() != database->winLength()) {
+        return false;
+    }
+    // The database infers the side to move from the marks; another answer would be for the wrong side
+    PositionEntry entry;
+    if (sideToMove(board) != player || !database->lookup(board, entry) || entry.bestMove < 0) {
+        return false;
+    }
+    move.row = entry.bestMove / board.getCols();
+    move.col = entry.bestMove % board.getCols();
+    move.nodes = 1;
+    move.fromDatabase = true;
+    return true;
+}
+
+bool AiPlayer::searchMove(const GameBoard& board, char player, const SearchLimits& limits, AiMove& move) {
+    SearchResult result;
+    if (!engine.chooseMove(board, player, limits, result)) {
+        return false;
+    }
+    move.row = result.row;
+    move.col = result.col;
+    move.nodes = result.nodes;
+    return true;
+}
+
+const char* AiPlayer::difficultyName(Difficulty difficulty) {
+    switch (difficulty) {
+        case Difficulty::EASY:
+            return "easy";
+        case Difficulty::MEDIUM:
+            return "medium";
+        case Difficulty::HARD:
+            return "hard";
+    }
+    return "easy";
+}
+
+bool AiPlayer::parseDifficulty(const std::string& text, Difficulty& difficulty) {
+    for (Difficulty candidate : {Difficulty::EASY, Difficulty::MEDIUM, Difficulty::HARD}) {
+        if (text == difficultyName(candidate)) {
+            difficulty = candidate;
+            return true;
+        }
+    }
+    return false;
+}
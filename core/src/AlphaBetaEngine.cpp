@@ -0,0 +1,377 @@
+#include "AlphaBetaEngine.h"
+#include "Metrics.h"
+#include "Random.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+
+namespace {
+
+const int INFINITE_SCORE = AlphaBetaEngine::WIN_SCORE + 1;
+// Horizon scores stay well clear of the win scores
+const int MAX_HEURISTIC = AlphaBetaEngine::WIN_THRESHOLD / 2;
+const int ASPIRATION_WINDOW = 64;
+
+const std::uint8_t EXACT_BOUND = 0;
+const std::uint8_t LOWER_BOUND = 1;
+const std::uint8_t UPPER_BOUND = 2;
+const std::uint8_t BOUND_MASK = 3;
+const std::uint8_t INEXACT = 4;
+
+const long long PV_KEY = 1LL << 50;
+const long long TABLE_KEY = PV_KEY - 1;
+const int CELL_BITS = 10;
+const long long CELL_MASK = (1LL << CELL_BITS) - 1;
+
+// Win scores count plies from the root; the table keeps them relative to the node
+int toTable(int score, int ply) {
+    if (score > AlphaBetaEngine::WIN_THRESHOLD) {
+        return score + ply;
+    }
+    if (score < -AlphaBetaEngine::WIN_THRESHOLD) {
+        return score - ply;
+    }
+    return score;
+}
+
+int fromTable(int score, int ply) {
+    if (score > AlphaBetaEngine::WIN_THRESHOLD) {
+        return score - ply;
+    }
+    if (score < -AlphaBetaEngine::WIN_THRESHOLD) {
+        return score + ply;
+    }
+    return score;
+}
+
+}  // namespace
+
+struct AlphaBetaEngine::Search {
+    SearchLimits limits;
+    std::chrono::steady_clock::time_point start;
+    std::uint64_t nodes = 0;
+    std::uint64_t nextCheck = 0;
+    bool abortable = false;   // the first iteration always finishes
+    bool aborted = false;
+    bool inexact = false;     // a score below the current node came from the heuristic
+    bool followPv = false;
+    std::vector<int> previousPv;
+    int stride = 0;
+    std::vector<int> pv;      // the line from ply p is at pv[p * stride], pvLength[p] long
+    std::vector<int> pvLength;
+    std::vector<std::vector<long long>> moves;   // one list per ply, reused
+
+    std::int64_t elapsedMillis() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start)
+            .count();
+    }
+    bool overBudget() const {
+        return (limits.maxNodes != 0 && nodes >= limits.maxNodes) ||
+               (limits.hardMillis > 0 && elapsedMillis() >= limits.hardMillis);
+    }
+};
+
+AlphaBetaEngine::AlphaBetaEngine(int tableBits, std::uint64_t seed)
+    : table(std::size_t(1) << std::max(1, std::min(tableBits, 30))),
+      tableMask(table.size() - 1),
+      zobrist(2 * PlayoutBoard::MAX_CELLS),
+      hash(0) {
+    for (auto& key : zobrist) {
+        key = splitMix(seed);
+    }
+    sideKey = splitMix(seed);
+}
+
+AlphaBetaEngine::~AlphaBetaEngine() = default;
+
+void AlphaBetaEngine::reset() {
+    std::fill(table.begin(), table.end(), TableEntry());
+}
+
+void AlphaBetaEngine::setUp(const GameBoard& position, char player) {
+    board = PlayoutBoard(position);
+    // Cell indices mean something else on another board
+    if (lines.reshape(board.rows(), board.cols(), board.winLength())) {
+        reset();
+    } else {
+        lines.clear();
+    }
+
+    nearby.assign(board.cellCount(), 0);
+    hash = (player == 'O') ? sideKey : 0;
+    for (int cell = 0; cell < board.cellCount(); cell++) {
+        char mark = board.cell(cell);
+        if (mark != 'X' && mark != 'O') {
+            continue;
+        }
+        lines.add(cell, mark);
+        markNearby(cell, 1);
+        hash ^= zobrist[2 * cell + (mark == 'O')];
+    }
+}
+
+bool AlphaBetaEngine::place(int cell, char player) {
+    lines.add(cell, player);
+    markNearby(cell, 1);
+    hash ^= zobrist[2 * cell + (player == 'O')] ^ sideKey;
+    return board.play(cell, player);
+}
+
+void AlphaBetaEngine::remove(int cell, char player) {
+    board.undo(cell);
+    lines.remove(cell, player);
+    markNearby(cell, -1);
+    hash ^= zobrist[2 * cell + (player == 'O')] ^ sideKey;
+}
+
+void AlphaBetaEngine::markNearby(int cell, int delta) {
+    int rows = board.rows();
+    int cols = board.cols();
+    int row = cell / cols;
+    int col = cell % cols;
+    for (int r = std::max(0, row - 2); r <= std::min(rows - 1, row + 2); r++) {
+        for (int c = std::max(0, col - 2); c <= std::min(cols - 1, col + 2); c++) {
+            nearby[r * cols + c] += delta;
+        }
+    }
+}
+
+int AlphaBetaEngine::evaluate(char toMove) const {
+    long long score = std::max<long long>(-MAX_HEURISTIC, std::min<long long>(MAX_HEURISTIC, lines.total()));
+    return static_cast<int>(toMove == 'X' ? score : -score);
+}
+
+void AlphaBetaEngine::orderMoves(Search& search, int pvMove, int tableMove, std::vector<long long>& moves) {
+    moves.clear();
+    int rows = board.rows();
+    int cols = board.cols();
+    bool nearOnly = board.cellCount() > NEAR_MOVES_ABOVE;
+    bool empty = board.emptyCount() == board.cellCount();
+    for (int i = 0; i < board.emptyCount(); i++) {
+        int cell = board.emptyCell(i);
+        int row = cell / cols;
+        int col = cell % cols;
+        if (nearOnly && (empty ? (row != rows / 2 || col != cols / 2) : nearby[cell] == 0)) {
+            continue;
+        }
+        long long key;
+        if (cell == pvMove) {
+            key = PV_KEY;
+        } else if (cell == tableMove) {
+            key = TABLE_KEY;
+        } else {
+            // Cells in many open lines, for either side, then central cells
+            key = rows + cols - std::abs(2 * row - rows + 1) - std::abs(2 * col - cols + 1);
+            key += 16LL * lines.openness(cell);
+        }
+        moves.push_back((key << CELL_BITS) | cell);
+    }
+    if (moves.size() < static_cast<std::size_t>(board.emptyCount())) {
+        search.inexact = true;
+    }
+    std::sort(moves.begin(), moves.end(), std::greater<long long>());
+}
+
+void AlphaBetaEngine::checkLimits(Search& search) {
+    search.nextCheck = search.nodes + CLOCK_CHECK_INTERVAL;
+    if (search.limits.maxNodes != 0) {
+        search.nextCheck = std::min(search.nextCheck, search.limits.maxNodes);
+    }
+    if (search.abortable && search.overBudget()) {
+        search.aborted = true;
+    }
+}
+
+int AlphaBetaEngine::negamax(Search& search, int depth, int ply, int alpha, int beta, char toMove) {
+    if (++search.nodes >= search.nextCheck) {
+        checkLimits(search);
+    }
+    int pvMove = -1;
+    if (search.followPv) {
+        search.followPv = false;
+        if (static_cast<std::size_t>(ply) < search.previousPv.size()) {
+            pvMove = search.previousPv[ply];
+        }
+    }
+    search.pvLength[ply] = 0;
+    if (search.aborted || board.emptyCount() == 0) {
+        return 0;
+    }
+    if (depth == 0) {
+        search.inexact = true;
+        return evaluate(toMove);
+    }
+
+    int tableMove = -1;
+    TableEntry& entry = table[hash & tableMask];
+    if (entry.key == hash) {
+        tableMove = entry.move;
+        if (ply > 0 && entry.depth >= depth) {
+            int score = fromTable(entry.score, ply);
+            int bound = entry.flags & BOUND_MASK;
+            if (bound == EXACT_BOUND || (bound == LOWER_BOUND && score >= beta) ||
+                (bound == UPPER_BOUND && score <= alpha)) {
+                search.inexact = search.inexact || (entry.flags & INEXACT) != 0;
+                return score;
+            }
+        }
+    }
+
+    bool outerInexact = search.inexact;
+    search.inexact = false;
+    std::vector<long long>& moves = search.moves[ply];
+    orderMoves(search, pvMove, tableMove, moves);
+
+    int alphaStart = alpha;
+    int best = -INFINITE_SCORE;
+    int bestMove = -1;
+    char next = PlayoutBoard::opponent(toMove);
+    int* line = &search.pv[ply * search.stride];
+    for (long long packed : moves) {
+        int cell = static_cast<int>(packed & CELL_MASK);
+        int score;
+        int childLength = 0;
+        if (place(cell, toMove)) {
+            score = WIN_SCORE - (ply + 1);
+        } else {
+            search.followPv = (cell == pvMove);
+            score = -negamax(search, depth - 1, ply + 1, -beta, -alpha, next);
+            childLength = search.pvLength[ply + 1];
+        }
+        remove(cell, toMove);
+        if (search.aborted) {
+            return 0;
+        }
+
+        if (score > best) {
+            best = score;
+            bestMove = cell;
+            if (score > alpha) {
+                alpha = score;
+                line[0] = cell;
+                std::copy(&search.pv[(ply + 1) * search.stride], &search.pv[(ply + 1) * search.stride] + childLength,
+                          line + 1);
+                search.pvLength[ply] = childLength + 1;
+            }
+        }
+        if (alpha >= beta) {
+            break;
+        }
+    }
+
+    bool inexact = search.inexact;
+    search.inexact = outerInexact || inexact;
+    entry.key = hash;
+    entry.score = toTable(best, ply);
+    entry.move = static_cast<std::int16_t>(bestMove);
+    entry.depth = static_cast<std::uint8_t>(std::min(depth, 255));
+    entry.flags = (best <= alphaStart ? UPPER_BOUND : best >= beta ? LOWER_BOUND : EXACT_BOUND) |
+                  (inexact ? INEXACT : 0);
+    return best;
+}
+
+void AlphaBetaEngine::extendLine(std::vector<int>& line, int depth, char player) {
+    std::vector<int> played;
+    char toMove = player;
+    bool over = false;
+    for (int cell : line) {
+        over = place(cell, toMove);
+        played.push_back(cell);
+        toMove = PlayoutBoard::opponent(toMove);
+    }
+    while (!over && static_cast<int>(line.size()) < depth && board.emptyCount() > 0) {
+        const TableEntry& entry = table[hash & tableMask];
+        if (entry.key != hash || entry.move < 0 || !board.isEmpty(entry.move)) {
+            break;
+        }
+        line.push_back(entry.move);
+        over = place(entry.move, toMove);
+        played.push_back(entry.move);
+        toMove = PlayoutBoard::opponent(toMove);
+    }
+    for (auto cell = played.rbegin(); cell != played.rend(); ++cell) {
+        toMove = PlayoutBoard::opponent(toMove);
+        remove(*cell, toMove);
+    }
+}
+
+bool AlphaBetaEngine::chooseMove(const GameBoard& position, char player, const SearchLimits& limits,
+                                 SearchResult& result) {
+    GAME_METRICS_TIMED(Metric::AI_SEARCH);
+    result = SearchResult();
+    if (!PlayoutBoard::fits(position) || (player != 'X' && player != 'O')) {
+        return false;
+    }
+    setUp(position, player);
+    if (board.result() != GameResult::ONGOING) {
+        return false;
+    }
+
+    Search search;
+    search.limits = limits;
+    search.start = std::chrono::steady_clock::now();
+    checkLimits(search);
+    int deepest = board.emptyCount();
+    if (limits.maxDepth > 0) {
+        deepest = std::min(deepest, limits.maxDepth);
+    }
+
+    for (int depth = 1; depth <= deepest; depth++) {
+        search.abortable = depth > 1;
+        if (search.abortable && search.overBudget()) {
+            break;
+        }
+        search.stride = depth + 1;
+        search.pv.assign(search.stride * search.stride, -1);
+        search.pvLength.assign(search.stride, 0);
+        search.moves.resize(search.stride);
+
+        // Expect about the previous score; a win or loss is not worth guessing around
+        int previous = result.score;
+        int alpha = -INFINITE_SCORE;
+        int beta = INFINITE_SCORE;
+        int delta = ASPIRATION_WINDOW;
+        if (depth >= 3 && std::abs(previous) < WIN_THRESHOLD) {
+            alpha = previous - delta;
+            beta = previous + delta;
+        }
+        int score;
+        while (true) {
+            search.followPv = true;
+            search.inexact = false;
+            score = negamax(search, depth, 0, alpha, beta, player);
+            if (search.aborted || (score > alpha && score < beta)) {
+                break;
+            }
+            // Widen the side that failed, straight to the limit when a win or loss is in sight
+            result.researches++;
+            delta *= 4;
+            if (score <= alpha) {
+                alpha = std::abs(score) >= WIN_THRESHOLD ? -INFINITE_SCORE : std::max(-INFINITE_SCORE, score - delta);
+            } else {
+                beta = std::abs(score) >= WIN_THRESHOLD ? INFINITE_SCORE : std::min(INFINITE_SCORE, score + delta);
+            }
+        }
+        if (search.aborted) {
+            break;
+        }
+
+        int cols = board.cols();
+        result.row = search.pv[0] / cols;
+        result.col = search.pv[0] % cols;
+        result.score = score;
+        result.depth = depth;
+        result.solved = !search.inexact || std::abs(score) > WIN_THRESHOLD;
+        result.principalVariation.assign(search.pv.begin(), search.pv.begin() + search.pvLength[0]);
+        extendLine(result.principalVariation, depth, player);
+        search.previousPv = result.principalVariation;
+        if (result.solved || (limits.softMillis > 0 && search.elapsedMillis() >= limits.softMillis)) {
+            break;
+        }
+    }
+
+    result.nodes = search.nodes;
+    result.elapsedMillis = search.elapsedMillis();
+    return true;
+}
@@ -1,17 +1,28 @@
 #include "../include/GameBoard.h"
+#include "Metrics.h"
  
-GameBoard::GameBoard() : board(BOARD_SIZE, std::vector<char>(BOARD_SIZE, ' ')) {}
+GameBoard::GameBoard() : GameBoard(BOARD_SIZE, BOARD_SIZE, BOARD_SIZE) {}
+
+GameBoard::GameBoard(int rows, int cols, int winLength)
+    : rows(rows > 0 ? rows : BOARD_SIZE), cols(cols > 0 ? cols : BOARD_SIZE), winLength(winLength) {
+    int longest = (this->rows > this->cols) ? this->rows : this->cols;
+    if (this->winLength <= 0 || this->winLength > longest) {
+        this->winLength = (longest < BOARD_SIZE) ? longest : BOARD_SIZE;
+    }
+    board.assign(this->rows, std::vector<char>(this->cols, ' '));
+}
 
 void GameBoard::reset() {
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        for (int j = 0; j < BOARD_SIZE; j++) {
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
             board[i][j] = ' ';
         }
     }
 }
 
 bool GameBoard::makeMove(int row, int col, char player) {
-    if (row >= 0 && row < BOARD_SIZE && col >= 0 && col < BOARD_SIZE && board[row][col] == ' ') {
+    GAME_METRICS_SAMPLED(Metric::MAKE_MOVE);
+    if (row >= 0 && row < rows && col >= 0 && col < cols && board[row][col] == ' ') {
         board[row][col] = player;
         return true;
     }
@@ -19,33 +30,46 @@ bool GameBoard::makeMove(int row, int col, char player) {
 }
 
 char GameBoard::getCell(int row, int col) const {
-    if (row >= 0 && row < BOARD_SIZE && col >= 0 && col < BOARD_SIZE) {
+    if (row >= 0 && row < rows && col >= 0 && col < cols) {
         return board[row][col];
     }
     return ' ';
 }
 
-GameResult GameBoard::checkWin() const {
-    // Check rows
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        if (board[i][0] != ' ' && board[i][0] == board[i][1] && board[i][1] == board[i][2]) {
-            return (board[i][0] == 'X') ? GameResult::PLAYER1_WIN : GameResult::PLAYER2_WIN;
-        }
+// True if winLength equal marks start at (row, col) and run in direction (dRow, dCol)
+bool GameBoard::lineFrom(int row, int col, int dRow, int dCol) const {
+    char first = board[row][col];
+    if (first == ' ') {
+        return false;
     }
-
-    // Check columns
-    for (int j = 0; j < BOARD_SIZE; j++) {
-        if (board[0][j] != ' ' && board[0][j] == board[1][j] && board[1][j] == board[2][j]) {
-            return (board[0][j] == 'X') ? GameResult::PLAYER1_WIN : GameResult::PLAYER2_WIN;
+    for (int step = 1; step < winLength; step++) {
+        if (board[row + step * dRow][col + step * dCol] != first) {
+            return false;
         }
     }
+    return true;
+}
 
-    // Check diagonals
-    if (board[0][0] != ' ' && board[0][0] == board[1][1] && board[1][1] == board[2][2]) {
-        return (board[0][0] == 'X') ? GameResult::PLAYER1_WIN : GameResult::PLAYER2_WIN;
-    }
-    if (board[0][2] != ' ' && board[0][2] == board[1][1] && board[1][1] == board[2][0]) {
-        return (board[0][2] == 'X') ? GameResult::PLAYER1_WIN : GameResult::PLAYER2_WIN;
+GameResult GameBoard::checkWin() const {
+    GAME_METRICS_SAMPLED(Metric::CHECK_WIN);
+    // Lines are checked rows first, then columns, then both diagonals, so a
+    // board holding lines for both players reports the same winner as before
+    const int DIRECTIONS[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+    for (const auto& direction : DIRECTIONS) {
+        int dRow = direction[0];
+        int dCol = direction[1];
+        int lastRow = rows - 1 - (winLength - 1) * dRow;
+        for (int i = 0; i <= lastRow; i++) {
+            for (int j = 0; j < cols; j++) {
+                int endCol = j + (winLength - 1) * dCol;
+                if (endCol < 0 || endCol >= cols) {
+                    continue;
+                }
+                if (lineFrom(i, j, dRow, dCol)) {
+                    return (board[i][j] == 'X') ? GameResult::PLAYER1_WIN : GameResult::PLAYER2_WIN;
+                }
+            }
+        }
     }
 
     // Check for tie
@@ -57,8 +81,8 @@ GameResult GameBoard::checkWin() const {
 }
 
 bool GameBoard::isFull() const {
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        for (int j = 0; j < BOARD_SIZE; j++) {
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
             if (board[i][j] == ' ') {
                 return false;
             }
@@ -69,8 +93,8 @@ bool GameBoard::isFull() const {
 
 std::vector<std::pair<int, int>> GameBoard::getAvailableMoves() const {
     std::vector<std::pair<int, int>> moves;
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        for (int j = 0; j < BOARD_SIZE; j++) {
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
             if (board[i][j] == ' ') {
                 moves.push_back({i, j});
             }
@@ -84,7 +108,13 @@ std::vector<std::vector<char>> GameBoard::getBoard() const {
 }
 
 void GameBoard::setBoard(const std::vector<std::vector<char>>& newBoard) {
-    if (newBoard.size() == BOARD_SIZE && newBoard[0].size() == BOARD_SIZE) {
-        board = newBoard;
+    if (static_cast<int>(newBoard.size()) != rows) {
+        return;
+    }
+    for (const auto& row : newBoard) {
+        if (static_cast<int>(row.size()) != cols) {
+            return;
+        }
     }
+    board = newBoard;
 }
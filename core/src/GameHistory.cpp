@@ -1,127 +1,1352 @@
 #include "GameHistory.h"
+#include "HistoryArchive.h"
+#include "Metrics.h"
+#include "MoveCodec.h"
+#include "OpeningBook.h"
+#include "PersistenceService.h"
+#include "ScanKernels.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string_view>
 
-GameHistory::GameHistory() : historyFile("game_history.dat") {
+// Boards and move lists already spelled out in a history file, in file order.
+// Readers and writers intern the same keys in the same order, so ids agree.
+struct HistoryFileDictionary {
+    StringInterner boards;
+    StringInterner moveSequences;
+};
+
+// Distinct boards, move lists and legacy stamps of the games in memory. Only
+// ever grows, so every version of the history can share it.
+struct HistoryContent {
+    StringInterner boards;
+    StringInterner moveSequences;
+    StringInterner timestamps;
+};
+
+constexpr std::uint32_t NO_TIMESTAMP = 0xFFFFFFFFu;
+
+// What the hot tier keeps per game: names, boards, move lists and legacy
+// stamps are ids into dictionaries that hold each distinct value once, so a
+// game costs a few dozen bytes and repeated AI games share everything but
+// their times. Records are expanded back into GameRecords on the way out.
+struct StoredGame {
+    UserId player1Id = INVALID_USER_ID;
+    UserId player2Id = INVALID_USER_ID;
+    std::uint32_t boardId = 0;
+    std::uint32_t movesId = 0;
+    std::uint32_t timestampId = NO_TIMESTAMP;
+    GameMode mode = GameMode::PLAYER_VS_PLAYER;
+    GameResult result = GameResult::ONGOING;
+    EpochMillis time = 0;
+    std::string moveTimes;   // zigzag varint deltas; empty when no move is timed
+};
+
+struct ColdSegment {
+    std::string path;   // a HistoryArchive
+    std::uint64_t records = 0;
+    // Range of the segment's epoch times; both 0 if no game in it is timed
+    EpochMillis minTime = 0;
+    EpochMillis maxTime = 0;
+};
+
+constexpr std::size_t CHUNK_RECORDS = 1024;
+
+struct RecordChunk {
+    StoredGame games[CHUNK_RECORDS];
+    // The filterable fields again, one array each, for ScanKernels
+    UserId player1[CHUNK_RECORDS];
+    UserId player2[CHUNK_RECORDS];
+    std::uint8_t mode[CHUNK_RECORDS];
+    std::uint8_t result[CHUNK_RECORDS];
+};
+
+// One state of the history. Chunks are shared between versions: a slot is
+// written once, before any version whose range covers it is published, and
+// never again. Adding a chunk or dropping leading ones copies only the list
+// of chunk pointers, and new segments copy only the segment list.
+struct HistoryVersion {
+    std::shared_ptr<const std::vector<std::shared_ptr<RecordChunk>>> chunks =
+        std::make_shared<std::vector<std::shared_ptr<RecordChunk>>>();
+    std::size_t begin = 0;   // slots counted from the start of the first chunk
+    std::size_t end = 0;
+    // Oldest games first; every cold game is older in append order than every hot one
+    std::shared_ptr<const std::vector<ColdSegment>> cold = std::make_shared<std::vector<ColdSegment>>();
+    std::shared_ptr<const HistoryContent> content;
+
+    std::size_t size() const { return end - begin; }
+    const StoredGame& at(std::size_t position) const {
+        std::size_t slot = begin + position;
+        return (*chunks)[slot / CHUNK_RECORDS]->games[slot % CHUNK_RECORDS];
+    }
+};
+
+namespace {
+
+// Records stamped with an epoch time write "@<millis>" in the timestamp field
+const char EPOCH_PREFIX = '@';
+// Packed move lists are written as "~<base64 of the MoveCodec bytes>"
+const char PACKED_MOVES_PREFIX = '~';
+// A board or move list already written earlier in the same file is written as
+// "#<id>" or "=<id>[:<base64 of the move time deltas>]", ids counting the
+// distinct boards and move lists in the order the file first spells them out
+const char BOARD_REFERENCE_PREFIX = '#';
+const char MOVES_REFERENCE_PREFIX = '=';
+const char MOVE_TIMES_SEPARATOR = ':';
+// Once games have been compacted the file starts with "!<count>": how many
+// games the cold segments held when it was written. A segment renamed into
+// place by a compaction that died before trimming the file pushes the cold
+// total past it, and loading skips that many leading records instead of
+// serving them twice.
+const char COLD_WATERMARK_PREFIX = '!';
+
+const EpochMillis MILLIS_PER_DAY = 86400000;
+// Additions between two looks at whether a compaction is due
+const std::size_t COMPACTION_CHECK_INTERVAL = 64;
+
+const char BASE64_DIGITS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Unpadded base64, which keeps '|', ';' and newlines out of the field
+std::string toBase64(const std::string& bytes) {
+    std::string text;
+    text.reserve((bytes.size() * 4 + 2) / 3);
+    std::uint32_t buffer = 0;
+    int bits = 0;
+    for (char c : bytes) {
+        buffer = (buffer << 8) | static_cast<std::uint8_t>(c);
+        bits += 8;
+        while (bits >= 6) {
+            bits -= 6;
+            text += BASE64_DIGITS[(buffer >> bits) & 0x3f];
+        }
+    }
+    if (bits > 0) {
+        text += BASE64_DIGITS[(buffer << (6 - bits)) & 0x3f];
+    }
+    return text;
+}
+
+bool fromBase64(const std::string& text, std::size_t start, std::string& bytes) {
+    bytes.clear();
+    std::uint32_t buffer = 0;
+    int bits = 0;
+    for (std::size_t i = start; i < text.size(); i++) {
+        char c = text[i];
+        int value;
+        if (c >= 'A' && c <= 'Z') {
+            value = c - 'A';
+        } else if (c >= 'a' && c <= 'z') {
+            value = c - 'a' + 26;
+        } else if (c >= '0' && c <= '9') {
+            value = c - '0' + 52;
+        } else if (c == '+') {
+            value = 62;
+        } else if (c == '/') {
+            value = 63;
+        } else {
+            return false;
+        }
+        buffer = (buffer << 6) | static_cast<std::uint32_t>(value);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            bytes += static_cast<char>((buffer >> bits) & 0xff);
+        }
+    }
+    return true;
+}
+
+// Legacy text stamps become epoch times, so every parseable record sorts and
+// range-queries as an integer. They were written with std::localtime, so they
+// are read back in the local zone.
+void normalizeTime(GameRecord& record) {
+    EpochMillis time = 0;
+    if (record.time == 0 && !record.timestamp.empty() && parseLocalTimestamp(record.timestamp, time) &&
+        time != 0) {
+        record.time = time;
+        record.timestamp.clear();
+    }
+}
+
+// File-side key of a move list: 'P' and the MoveCodec cell bytes, or 'T' and
+// the readable form for lists the codec cannot pack. Times are not part of it.
+bool packedCells(const std::vector<Move>& moves, std::string& cells) {
+    cells.assign(1, 'P');
+    for (const auto& move : moves) {
+        std::uint8_t packed;
+        if (!MoveCodec::packMove(move, packed)) {
+            return false;
+        }
+        cells += static_cast<char>(packed);
+    }
+    return true;
+}
+
+std::string textMoves(const std::vector<Move>& moves) {
+    std::string text;
+    for (const auto& move : moves) {
+        text += std::to_string(move.row) + ',' + std::to_string(move.col) + ',' + move.player + ';';
+    }
+    return text;
+}
+
+void parseTextMoves(const std::string& movesStr, std::vector<Move>& moves) {
+    std::istringstream moveStream(movesStr);
+    std::string moveToken;
+
+    while (std::getline(moveStream, moveToken, ';')) {
+        if (!moveToken.empty()) {
+            std::istringstream moveDetails(moveToken);
+            std::string detail;
+            std::vector<std::string> moveData;
+
+            while (std::getline(moveDetails, detail, ',')) {
+                moveData.push_back(detail);
+            }
+
+            if (moveData.size() == 3) {
+                Move move(std::stoi(moveData[0]), std::stoi(moveData[1]), moveData[2][0]);
+                moves.push_back(move);
+            }
+        }
+    }
+}
+
+void writeRecord(std::ostream& file, const GameRecord& record, HistoryFileDictionary& dictionary) {
+    file << record.player1 << "|" << record.player2 << "|"
+         << static_cast<int>(record.mode) << "|" << static_cast<int>(record.result) << "|";
+    if (record.time != 0) {
+        file << EPOCH_PREFIX << record.time << "|";
+    } else {
+        file << record.timestamp << "|";
+    }
+
+    std::string board;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            board += record.finalBoard[i][j];
+        }
+    }
+    std::size_t knownBoards = dictionary.boards.size();
+    UserId boardId = dictionary.boards.intern(board);
+    if (boardId < knownBoards) {
+        file << BOARD_REFERENCE_PREFIX << boardId;
+    } else {
+        file << board;
+    }
+    file << "|";
+
+    std::string cells;
+    bool packable = packedCells(record.moves, cells);
+    std::string text = packable ? std::string() : textMoves(record.moves);
+    std::size_t knownSequences = dictionary.moveSequences.size();
+    UserId sequenceId = dictionary.moveSequences.intern(packable ? cells : 'T' + text);
+    if (sequenceId < knownSequences) {
+        file << MOVES_REFERENCE_PREFIX << sequenceId;
+        // Only the times are new; they are left out when no move adds one
+        std::string deltas;
+        EpochMillis previous = record.time;
+        bool timed = false;
+        for (const auto& move : record.moves) {
+            EpochMillis time = move.time != 0 ? move.time : previous;
+            timed = timed || time != previous;
+            MoveCodec::appendSignedVarint(deltas, time - previous);
+            previous = time;
+        }
+        if (packable && timed) {
+            file << MOVE_TIMES_SEPARATOR << toBase64(deltas);
+        }
+    } else if (packable) {
+        std::string packed;
+        MoveCodec::encodeMoves(record.moves, record.time, packed);
+        file << PACKED_MOVES_PREFIX << toBase64(packed);
+    } else {
+        // Moves the codec cannot represent keep the readable form
+        file << text;
+    }
+    file << "\n";
+}
+
+// Parses one line of the history file; false if it has too few fields or
+// refers to a board or move list the file has not defined
+bool parseRecord(const std::string& line, GameRecord& record, HistoryFileDictionary& dictionary) {
+    std::istringstream iss(line);
+    std::string token;
+    std::vector<std::string> tokens;
+    while (std::getline(iss, token, '|')) {
+        tokens.push_back(token);
+    }
+    if (tokens.size() < 6) {
+        return false;
+    }
+
+    record.player1 = tokens[0];
+    record.player2 = tokens[1];
+    record.mode = static_cast<GameMode>(std::stoi(tokens[2]));
+    record.result = static_cast<GameResult>(std::stoi(tokens[3]));
+    if (!tokens[4].empty() && tokens[4][0] == EPOCH_PREFIX) {
+        record.time = std::stoll(tokens[4].substr(1));
+    } else {
+        record.timestamp = tokens[4];
+        normalizeTime(record);
+    }
+
+    // A raw board is always nine cells; anything shorter is a reference
+    std::string boardStr = tokens[5];
+    if (boardStr.size() != 9 && !boardStr.empty() && boardStr[0] == BOARD_REFERENCE_PREFIX) {
+        UserId boardId = static_cast<UserId>(std::stoul(boardStr.substr(1)));
+        if (boardId >= dictionary.boards.size()) {
+            return false;
+        }
+        boardStr = std::string(dictionary.boards.name(boardId));
+    } else {
+        dictionary.boards.intern(boardStr);
+    }
+    record.finalBoard.resize(3, std::vector<char>(3));
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            record.finalBoard[i][j] = boardStr[i * 3 + j];
+        }
+    }
+
+    if (tokens.size() <= 6 || tokens[6].empty()) {
+        return true;
+    }
+    const std::string& movesStr = tokens[6];
+    if (movesStr[0] == MOVES_REFERENCE_PREFIX) {
+        std::size_t separator = movesStr.find(MOVE_TIMES_SEPARATOR);
+        UserId sequenceId = static_cast<UserId>(std::stoul(movesStr.substr(1, separator - 1)));
+        if (sequenceId >= dictionary.moveSequences.size()) {
+            return false;
+        }
+        std::string_view key = dictionary.moveSequences.name(sequenceId);
+        if (key[0] == 'T') {
+            parseTextMoves(std::string(key.substr(1)), record.moves);
+            return true;
+        }
+        std::string deltas;
+        if (separator != std::string::npos) {
+            fromBase64(movesStr, separator + 1, deltas);
+        }
+        std::size_t pos = 0;
+        EpochMillis previous = record.time;
+        for (std::size_t i = 1; i < key.size(); i++) {
+            Move move = MoveCodec::unpackMove(static_cast<std::uint8_t>(key[i]));
+            std::int64_t delta = 0;
+            if (pos < deltas.size()) {
+                MoveCodec::readSignedVarint(deltas, pos, delta);
+            }
+            previous += delta;
+            move.time = previous;
+            record.moves.push_back(move);
+        }
+    } else if (movesStr[0] == PACKED_MOVES_PREFIX) {
+        std::string packed;
+        std::size_t pos = 0;
+        if (fromBase64(movesStr, 1, packed)) {
+            MoveCodec::decodeMoves(packed, pos, record.time, record.moves);
+        }
+        std::string cells;
+        packedCells(record.moves, cells);
+        dictionary.moveSequences.intern(cells);
+    } else {
+        parseTextMoves(movesStr, record.moves);
+        dictionary.moveSequences.intern('T' + movesStr);
+    }
+    return true;
+}
+
+const char* modeName(GameMode mode) {
+    return mode == GameMode::PLAYER_VS_AI ? "PLAYER_VS_AI" : "PLAYER_VS_PLAYER";
+}
+
+const char* resultName(GameResult result) {
+    switch (result) {
+        case GameResult::PLAYER1_WIN: return "PLAYER1_WIN";
+        case GameResult::PLAYER2_WIN: return "PLAYER2_WIN";
+        case GameResult::AI_WIN: return "AI_WIN";
+        case GameResult::HUMAN_WIN: return "HUMAN_WIN";
+        case GameResult::TIE: return "TIE";
+        case GameResult::ONGOING: break;
+    }
+    return "ONGOING";
+}
+
+// Quotes the field only when it holds a separator, quote or line break
+void writeCsvField(std::ostream& out, const std::string& field) {
+    if (field.find_first_of(",\"\r\n") == std::string::npos) {
+        out << field;
+        return;
+    }
+    out << '"';
+    for (char c : field) {
+        if (c == '"') {
+            out << '"';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+void writeJsonString(std::ostream& out, const std::string& text) {
+    const char HEX[] = "0123456789abcdef";
+    out << '"';
+    for (char c : text) {
+        unsigned char byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (byte < 0x20) {
+            out << "\\u00" << HEX[byte >> 4] << HEX[byte & 0xf];
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+// Empty cells become '-' so the board survives tools that trim whitespace
+std::string boardText(const GameRecord& record) {
+    std::string text;
+    for (const auto& row : record.finalBoard) {
+        for (char cell : row) {
+            text += (cell == ' ') ? '-' : cell;
+        }
+    }
+    return text;
+}
+
+void exportRecord(std::ostream& out, const GameRecord& record, ExportFormat format) {
+    if (format == ExportFormat::CSV) {
+        writeCsvField(out, record.player1);
+        out << ',';
+        writeCsvField(out, record.player2);
+        out << ',' << modeName(record.mode) << ',' << resultName(record.result) << ','
+            << record.time << ',';
+        writeCsvField(out, record.displayTimestamp());
+        out << ',' << boardText(record) << ',';
+        std::string moves;
+        for (const auto& move : record.moves) {
+            moves += std::to_string(move.row) + ',' + std::to_string(move.col) + ',' + move.player + ';';
+        }
+        writeCsvField(out, moves);
+        out << '\n';
+        return;
+    }
+
+    out << "{\"player1\":";
+    writeJsonString(out, record.player1);
+    out << ",\"player2\":";
+    writeJsonString(out, record.player2);
+    out << ",\"mode\":\"" << modeName(record.mode) << "\",\"result\":\"" << resultName(record.result)
+        << "\",\"time\":" << record.time << ",\"timestamp\":";
+    writeJsonString(out, record.displayTimestamp());
+    out << ",\"board\":";
+    writeJsonString(out, boardText(record));
+    out << ",\"moves\":[";
+    for (std::size_t i = 0; i < record.moves.size(); i++) {
+        const Move& move = record.moves[i];
+        out << (i == 0 ? "" : ",") << "{\"row\":" << move.row << ",\"col\":" << move.col
+            << ",\"player\":";
+        writeJsonString(out, std::string(1, move.player));
+        out << ",\"time\":" << move.time << '}';
+    }
+    out << "]}\n";
+}
+
+void writeExportHeader(std::ostream& out, ExportFormat format) {
+    if (format == ExportFormat::CSV) {
+        out << "player1,player2,mode,result,time,timestamp,board,moves\n";
+    }
+}
+
+// In-memory keys are exact: a row count and each row's length and cells
+std::string boardKey(const std::vector<std::vector<char>>& board) {
+    std::string key(1, static_cast<char>(board.size()));
+    for (const auto& row : board) {
+        key += static_cast<char>(row.size());
+        key.append(row.begin(), row.end());
+    }
+    return key;
+}
+
+void readBoardKey(std::string_view key, std::vector<std::vector<char>>& board) {
+    std::size_t rows = key.empty() ? 0 : static_cast<std::uint8_t>(key[0]);
+    board.resize(rows);
+    std::size_t pos = 1;
+    for (auto& row : board) {
+        std::size_t cells = static_cast<std::uint8_t>(key[pos++]);
+        row.assign(key.begin() + pos, key.begin() + pos + cells);
+        pos += cells;
+    }
+}
+
+// 'P' and the packed cells when every move packs and is unnumbered, 'N' when
+// the moves are numbered 1, 2, ..., and otherwise 'R' with every field raw
+std::string movesKey(const std::vector<Move>& moves) {
+    std::string key;
+    bool numbered = true;
+    bool unnumbered = true;
+    for (std::size_t i = 0; i < moves.size(); i++) {
+        numbered = numbered && moves[i].moveNumber == static_cast<int>(i) + 1;
+        unnumbered = unnumbered && moves[i].moveNumber == -1;
+    }
+    if ((numbered || unnumbered) && packedCells(moves, key)) {
+        key[0] = numbered && !moves.empty() ? 'N' : 'P';
+        return key;
+    }
+    key.assign(1, 'R');
+    for (const auto& move : moves) {
+        MoveCodec::appendSignedVarint(key, move.row);
+        MoveCodec::appendSignedVarint(key, move.col);
+        key += move.player;
+        MoveCodec::appendSignedVarint(key, move.moveNumber);
+    }
+    return key;
+}
+
+void readMovesKey(std::string_view key, std::vector<Move>& moves) {
+    moves.clear();
+    if (key.empty()) {
+        return;
+    }
+    if (key[0] != 'R') {
+        for (std::size_t i = 1; i < key.size(); i++) {
+            moves.push_back(MoveCodec::unpackMove(static_cast<std::uint8_t>(key[i])));
+            if (key[0] == 'N') {
+                moves.back().moveNumber = static_cast<int>(i);
+            }
+        }
+        return;
+    }
+    std::string raw(key.substr(1));
+    std::size_t pos = 0;
+    std::int64_t row, col, number;
+    while (pos < raw.size() && MoveCodec::readSignedVarint(raw, pos, row) &&
+           MoveCodec::readSignedVarint(raw, pos, col) && pos < raw.size()) {
+        char player = raw[pos++];
+        if (!MoveCodec::readSignedVarint(raw, pos, number)) {
+            break;
+        }
+        moves.push_back(Move(static_cast<int>(row), static_cast<int>(col), player, 0,
+                             static_cast<int>(number)));
+    }
+}
+
+void expandInto(const HistoryContent& content, const StoredGame& game, GameRecord& record) {
+    StringInterner& names = StringInterner::shared();
+    record.player1.assign(names.name(game.player1Id));
+    record.player2.assign(names.name(game.player2Id));
+    record.player1Id = game.player1Id;
+    record.player2Id = game.player2Id;
+    record.mode = game.mode;
+    record.result = game.result;
+    record.time = game.time;
+    record.timestamp.clear();
+    if (game.timestampId != NO_TIMESTAMP) {
+        record.timestamp.assign(content.timestamps.name(game.timestampId));
+    }
+    readBoardKey(content.boards.name(game.boardId), record.finalBoard);
+    readMovesKey(content.moveSequences.name(game.movesId), record.moves);
+    std::size_t pos = 0;
+    EpochMillis previous = game.time;
+    for (auto& move : record.moves) {
+        std::int64_t delta = 0;
+        if (!game.moveTimes.empty() && MoveCodec::readSignedVarint(game.moveTimes, pos, delta)) {
+            move.time = previous + delta;
+            previous = move.time;
+        }
+    }
+}
+
+GameRecord expand(const HistoryContent& content, const StoredGame& game) {
+    GameRecord record;
+    expandInto(content, game, record);
+    return record;
+}
+
+void internNames(std::vector<GameRecord>& games, std::size_t first) {
+    StringInterner& names = StringInterner::shared();
+    for (std::size_t i = first; i < games.size(); i++) {
+        games[i].player1Id = names.intern(games[i].player1);
+        games[i].player2Id = names.intern(games[i].player2);
+    }
+}
+
+// Appends every game of segment to games, with player ids filled in
+void readColdSegment(const ColdSegment& segment, std::vector<GameRecord>& games) {
+    HistoryArchive archive;
+    std::size_t first = games.size();
+    if (archive.open(segment.path) && archive.readRange(0, segment.records, games)) {
+        internNames(games, first);
+    }
+}
+
+// Appends the cold games with from <= time < to; segments outside the window
+// are skipped without being opened
+void readColdTimeRange(const std::vector<ColdSegment>& cold, EpochMillis from, EpochMillis to,
+                       std::vector<GameRecord>& games) {
+    std::size_t first = games.size();
+    for (const auto& segment : cold) {
+        if (segment.maxTime != 0 && segment.minTime < to && segment.maxTime >= from) {
+            HistoryArchive archive;
+            if (archive.open(segment.path)) {
+                archive.readTimeRange(from, to, games);
+            }
+        }
+    }
+    internNames(games, first);
+}
+
+// Calls visit(position) for every hot game of version that filter matches, in order
+template <typename Visitor>
+void scanHot(const HistoryVersion& version, const GameFilter& filter, Visitor visit) {
+    constexpr std::size_t WORDS = CHUNK_RECORDS / 64;
+    std::uint64_t bits[WORDS];
+    std::uint64_t other[WORDS];
+    for (std::size_t first = 0; first < version.end; first += CHUNK_RECORDS) {
+        const RecordChunk& chunk = *(*version.chunks)[first / CHUNK_RECORDS];
+        // Only slots below end are read, so the writer may fill the rest meanwhile
+        std::size_t rows = std::min(CHUNK_RECORDS, version.end - first);
+        std::size_t words = ScanKernels::bitmapWords(rows);
+        if (filter.player != INVALID_USER_ID) {
+            ScanKernels::selectEither(chunk.player1, chunk.player2, rows, filter.player, bits);
+        } else {
+            ScanKernels::selectAll(rows, bits);
+        }
+        if (filter.matchMode) {
+            ScanKernels::selectEqual(chunk.mode, rows, static_cast<std::uint8_t>(filter.mode), other);
+            ScanKernels::intersect(bits, other, words);
+        }
+        if (filter.matchResult) {
+            ScanKernels::selectEqual(chunk.result, rows, static_cast<std::uint8_t>(filter.result), other);
+            ScanKernels::intersect(bits, other, words);
+        }
+        ScanKernels::forEachSelected(bits, words, [&](std::size_t row) {
+            if (first + row >= version.begin) {
+                visit(first + row - version.begin);
+            }
+        });
+    }
+}
+
+std::vector<GameRecord> findInVersion(const HistoryVersion& version, const GameFilter& filter) {
+    std::vector<GameRecord> games;
+    std::vector<GameRecord> cold;
+    for (const auto& segment : *version.cold) {
+        cold.clear();
+        readColdSegment(segment, cold);
+        for (auto& record : cold) {
+            if (filter.matches(record)) {
+                games.push_back(std::move(record));
+            }
+        }
+    }
+    scanHot(version, filter, [&](std::size_t position) {
+        games.push_back(expand(*version.content, version.at(position)));
+    });
+    return games;
+}
+
+std::uint64_t coldRecords(const std::vector<ColdSegment>& cold) {
+    std::uint64_t count = 0;
+    for (const auto& segment : cold) {
+        count += segment.records;
+    }
+    return count;
+}
+
+std::string coldSegmentPath(const std::string& historyFile, std::size_t segment) {
+    return historyFile + ".cold" + std::to_string(segment);
+}
+
+// Reads the watermark line, if any, and returns how many leading records of
+// the file the cold segments already hold
+std::uint64_t leadingColdRecords(std::istream& file, std::uint64_t cold) {
+    std::string line;
+    if (file.peek() == COLD_WATERMARK_PREFIX && std::getline(file, line)) {
+        std::uint64_t watermark = std::strtoull(line.c_str() + 1, nullptr, 10);
+        return cold > watermark ? cold - watermark : 0;
+    }
+    return cold;
+}
+
+}  // namespace
+
+std::uint64_t HistorySnapshot::size() const {
+    return version ? coldRecords(*version->cold) + version->size() : 0;
+}
+
+std::size_t HistorySnapshot::hotGameCount() const {
+    return version ? version->size() : 0;
+}
+
+std::vector<GameRecord> HistorySnapshot::getAllGames() const {
+    std::vector<GameRecord> games;
+    if (!version) {
+        return games;
+    }
+    games.reserve(size());
+    for (const auto& segment : *version->cold) {
+        readColdSegment(segment, games);
+    }
+    for (std::size_t i = 0; i < version->size(); i++) {
+        games.push_back(expand(*version->content, version->at(i)));
+    }
+    return games;
+}
+
+std::vector<GameRecord> HistorySnapshot::getUserGames(const std::string& username) const {
+    GameFilter filter;
+    filter.player = StringInterner::shared().find(username);
+    if (filter.player == INVALID_USER_ID) {
+        return {};
+    }
+    return findGames(filter);
+}
+
+std::vector<GameRecord> HistorySnapshot::findGames(const GameFilter& filter) const {
+    return version ? findInVersion(*version, filter) : std::vector<GameRecord>();
+}
+
+std::vector<GameRecord> HistorySnapshot::getGamesBetween(EpochMillis from, EpochMillis to) const {
+    std::vector<GameRecord> games;
+    if (!version || from >= to) {
+        return games;
+    }
+    readColdTimeRange(*version->cold, from, to, games);
+    for (std::size_t i = 0; i < version->size(); i++) {
+        const StoredGame& game = version->at(i);
+        if (game.time != 0 && game.time >= from && game.time < to) {
+            games.push_back(expand(*version->content, game));
+        }
+    }
+    std::stable_sort(games.begin(), games.end(),
+                     [](const GameRecord& a, const GameRecord& b) { return a.time < b.time; });
+    return games;
+}
+
+GameHistory::GameHistory() : GameHistory("game_history.dat") {}
+
+GameHistory::GameHistory(const std::string& historyFile)
+    : live(std::make_unique<HistoryVersion>()),
+      content(std::make_shared<HistoryContent>()),
+      fileDictionary(std::make_unique<HistoryFileDictionary>()),
+      historyFile(historyFile) {
+    live->content = content;
     loadHistory();
+    publish();
+}
+
+GameHistory::~GameHistory() {
+    if (compactor.joinable()) {
+        finishCompaction();
+    }
 }
 
 void GameHistory::addGameRecord(const GameRecord& record) {
-    gameRecords.push_back(record);
-    saveHistory();
+    storeRecord(record);
+    publish();
+    if (bulkDepth > 0) {
+        return;
+    }
+    // With a background writer only the new record is handed over
+    if (persistence != nullptr) {
+        appendPending();
+    } else {
+        saveHistory();
+    }
+    maybeCompact(1);
+}
+
+void GameHistory::beginBulk() {
+    bulkDepth++;
+}
+
+void GameHistory::endBulk() {
+    if (bulkDepth == 0) {
+        return;
+    }
+    if (--bulkDepth == 0) {
+        appendPending();
+        maybeCompact(0);
+    }
+}
+
+bool GameFilter::matches(const GameRecord& record) const {
+    return (player == INVALID_USER_ID || record.player1Id == player || record.player2Id == player) &&
+           (!matchMode || record.mode == mode) && (!matchResult || record.result == result);
 }
 
 std::vector<GameRecord> GameHistory::getUserGames(const std::string& username) {
-    std::vector<GameRecord> userGames;
-    for (const auto& record : gameRecords) {
-        if (record.player1 == username || record.player2 == username) {
-            userGames.push_back(record);
-        }
+    GameFilter filter;
+    filter.player = StringInterner::shared().find(username);
+    if (filter.player == INVALID_USER_ID) {
+        return {};
+    }
+    return findGames(filter);
+}
+
+std::vector<GameRecord> GameHistory::findGames(const GameFilter& filter) {
+    return findInVersion(*live, filter);
+}
+
+std::size_t GameHistory::countGames(const GameFilter& filter) {
+    std::size_t count = 0;
+    scanHot(*live, filter, [&count](std::size_t) { count++; });
+    std::vector<GameRecord> cold;
+    for (const auto& segment : *live->cold) {
+        cold.clear();
+        readColdSegment(segment, cold);
+        count += static_cast<std::size_t>(std::count_if(
+            cold.begin(), cold.end(), [&filter](const GameRecord& record) { return filter.matches(record); }));
     }
-    return userGames;
+    return count;
 }
 
 std::vector<GameRecord> GameHistory::getAllGames() {
-    return gameRecords;
+    std::vector<GameRecord> games;
+    games.reserve(coldGameCount() + live->size());
+    for (const auto& segment : *live->cold) {
+        readColdSegment(segment, games);
+    }
+    for (std::size_t i = 0; i < live->size(); i++) {
+        games.push_back(expand(*content, live->at(i)));
+    }
+    return games;
+}
+
+std::vector<GameRecord> GameHistory::getGamesBetween(EpochMillis from, EpochMillis to) {
+    std::vector<GameRecord> games;
+    if (from >= to) {
+        return games;
+    }
+    readColdTimeRange(*live->cold, from, to, games);
+    bool older = !games.empty();
+
+    auto slice = timeSlice(from, to);
+    games.reserve(games.size() + slice.second - slice.first);
+    for (std::size_t i = slice.first; i < slice.second; i++) {
+        games.push_back(expand(*content, live->at(timeIndex[i].record)));
+    }
+    if (older) {
+        std::stable_sort(games.begin(), games.end(),
+                         [](const GameRecord& a, const GameRecord& b) { return a.time < b.time; });
+    }
+    return games;
+}
+
+std::vector<GameRecord> GameHistory::getGamesSince(EpochMillis since) {
+    return getGamesBetween(since, std::numeric_limits<EpochMillis>::max());
+}
+
+std::size_t GameHistory::countGamesBetween(EpochMillis from, EpochMillis to) {
+    auto slice = timeSlice(from, to);
+    std::size_t count = slice.second - slice.first;
+    if (from >= to || live->cold->empty()) {
+        return count;
+    }
+    std::vector<GameRecord> cold;
+    for (const auto& segment : *live->cold) {
+        if (segment.maxTime != 0 && segment.minTime < to && segment.maxTime >= from) {
+            HistoryArchive archive;
+            cold.clear();
+            if (archive.open(segment.path) && archive.readTimeRange(from, to, cold)) {
+                count += cold.size();
+            }
+        }
+    }
+    return count;
+}
+
+bool GameHistory::getTimeSpan(EpochMillis& oldest, EpochMillis& newest) {
+    sortTimeIndex();
+    bool found = !timeIndex.empty();
+    if (found) {
+        oldest = timeIndex.front().time;
+        newest = timeIndex.back().time;
+    }
+    auto include = [&](EpochMillis low, EpochMillis high) {
+        oldest = found ? std::min(oldest, low) : low;
+        newest = found ? std::max(newest, high) : high;
+        found = true;
+    };
+    for (const auto& segment : *live->cold) {
+        if (segment.maxTime != 0) {
+            include(segment.minTime, segment.maxTime);
+        }
+    }
+    return found;
 }
 
 void GameHistory::saveHistory() {
+    if (historyFile.empty()) {
+        return;
+    }
+    GAME_METRICS_TIMED(Metric::SAVE_HISTORY);
+    writes++;
+    // A rewrite spells every board and move list out again from the start
+    fileDictionary = std::make_unique<HistoryFileDictionary>();
+    std::uint64_t cold = coldRecords(*live->cold);
+    if (persistence != nullptr) {
+        std::ostringstream contents;
+        if (cold > 0) {
+            contents << COLD_WATERMARK_PREFIX << cold << '\n';
+        }
+        for (std::size_t i = 0; i < live->size(); i++) {
+            writeStored(contents, live->at(i));
+        }
+        // The whole file supersedes whatever earlier writes did or did not get in
+        pendingWrites.clear();
+        pendingWrites.push_back(persistence->replace(historyFile, contents.str()).share());
+        persisted = live->size();
+        fileNeedsRewrite = false;
+        return;
+    }
     std::ofstream file(historyFile);
     if (!file.is_open()) {
+        fileNeedsRewrite = true;
         return;
     }
+    if (cold > 0) {
+        file << COLD_WATERMARK_PREFIX << cold << '\n';
+    }
 
-    for (const auto& record : gameRecords) {
-        file << record.player1 << "|" << record.player2 << "|"
-             << static_cast<int>(record.mode) << "|" << static_cast<int>(record.result) << "|"
-             << record.timestamp << "|";
+    for (std::size_t i = 0; i < live->size(); i++) {
+        writeStored(file, live->at(i));
+    }
 
-        for (int i = 0; i < 3; i++) {
-            for (int j = 0; j < 3; j++) {
-                file << record.finalBoard[i][j];
-            }
+    file.close();
+    fileNeedsRewrite = !file;
+    if (file) {
+        persisted = live->size();
+    }
+}
+
+void GameHistory::appendPending() {
+    if (historyFile.empty() || persisted >= live->size()) {
+        return;
+    }
+    checkWrites();
+    // After a failed append the dictionary may name entries the file never got
+    if (fileNeedsRewrite) {
+        saveHistory();
+        return;
+    }
+    GAME_METRICS_TIMED(Metric::SAVE_HISTORY);
+    writes++;
+    // Everything before persisted is already on disk, so one sequential append suffices
+    if (persistence != nullptr) {
+        std::ostringstream tail;
+        for (std::size_t i = persisted; i < live->size(); i++) {
+            writeStored(tail, live->at(i));
         }
-        file << "|";
+        pendingWrites.push_back(persistence->append(historyFile, tail.str()).share());
+        persisted = live->size();
+        return;
+    }
+    std::ofstream file(historyFile, std::ios::app);
+    if (!file.is_open()) {
+        fileNeedsRewrite = true;
+        return;
+    }
+    for (std::size_t i = persisted; i < live->size(); i++) {
+        writeStored(file, live->at(i));
+    }
+    file.close();
+    if (file) {
+        persisted = live->size();
+    } else {
+        fileNeedsRewrite = true;
+    }
+}
 
-        for (const auto& move : record.moves) {
-            file << move.row << "," << move.col << "," << move.player << ";";
+void GameHistory::checkWrites() {
+    std::size_t kept = 0;
+    for (auto& write : pendingWrites) {
+        if (write.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            pendingWrites[kept++] = write;
+        } else if (!write.get()) {
+            fileNeedsRewrite = true;
         }
-        file << "\n";
     }
+    pendingWrites.resize(kept);
+}
 
-    file.close();
+std::future<bool> GameHistory::durable() {
+    if (historyFile.empty()) {
+        std::promise<bool> done;
+        done.set_value(true);
+        return done.get_future();
+    }
+    checkWrites();
+    if (fileNeedsRewrite) {
+        saveHistory();
+    } else {
+        appendPending();
+    }
+    if (persistence != nullptr) {
+        return persistence->flush(historyFile);
+    }
+    std::promise<bool> done;
+    done.set_value(!fileNeedsRewrite && persisted >= live->size());
+    return done.get_future();
 }
 
 void GameHistory::loadHistory() {
+    if (historyFile.empty()) {
+        return;
+    }
+    GAME_METRICS_TIMED(Metric::LOAD_HISTORY);
+    loadColdSegments();
+    fileDictionary = std::make_unique<HistoryFileDictionary>();
     std::ifstream file(historyFile);
     if (!file.is_open()) {
+        publish();
         return;
     }
 
     std::string line;
+    std::uint64_t skip = leadingColdRecords(file, coldRecords(*live->cold));
+    bool skipped = skip > 0;
     while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string token;
-        std::vector<std::string> tokens;
-
-        while (std::getline(iss, token, '|')) {
-            tokens.push_back(token);
-        }
-
-        if (tokens.size() >= 6) {
-            GameRecord record;
-            record.player1 = tokens[0];
-            record.player2 = tokens[1];
-            record.mode = static_cast<GameMode>(std::stoi(tokens[2]));
-            record.result = static_cast<GameResult>(std::stoi(tokens[3]));
-            record.timestamp = tokens[4];
-
-            std::string boardStr = tokens[5];
-            record.finalBoard.resize(3, std::vector<char>(3));
-            for (int i = 0; i < 3; i++) {
-                for (int j = 0; j < 3; j++) {
-                    record.finalBoard[i][j] = boardStr[i * 3 + j];
-                }
+        GameRecord record;
+        // Skipped records are still parsed, since later ones may refer to their boards and moves
+        if (parseRecord(line, record, *fileDictionary)) {
+            if (skip > 0) {
+                skip--;
+                continue;
             }
-
-            if (tokens.size() > 6) {
-                std::string movesStr = tokens[6];
-                std::istringstream moveStream(movesStr);
-                std::string moveToken;
-
-                while (std::getline(moveStream, moveToken, ';')) {
-                    if (!moveToken.empty()) {
-                        std::istringstream moveDetails(moveToken);
-                        std::string detail;
-                        std::vector<std::string> moveData;
-
-                        while (std::getline(moveDetails, detail, ',')) {
-                            moveData.push_back(detail);
-                        }
-
-                        if (moveData.size() == 3) {
-                            Move move(std::stoi(moveData[0]), std::stoi(moveData[1]), moveData[2][0]);
-                            record.moves.push_back(move);
-                        }
-                    }
-                }
-            }
-
-            gameRecords.push_back(record);
+            storeRecord(record);
         }
     }
 
     file.close();
+    persisted = live->size();
+    publish();
+    // Finish the cut-down the interrupted compaction never got to
+    if (skipped) {
+        saveHistory();
+    }
 }
 
-std::string GameHistory::getCurrentTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-    return ss.str();
+void GameHistory::exportRecords(std::ostream& out, ExportFormat format) const {
+    writeExportHeader(out, format);
+    std::vector<GameRecord> cold;
+    for (const auto& segment : *live->cold) {
+        cold.clear();
+        readColdSegment(segment, cold);
+        for (const auto& record : cold) {
+            exportRecord(out, record, format);
+        }
+    }
+    GameRecord record;
+    for (std::size_t i = 0; i < live->size(); i++) {
+        expandInto(*content, live->at(i), record);
+        exportRecord(out, record, format);
+    }
+}
+
+bool GameHistory::exportFile(const std::string& historyFile, std::ostream& out, ExportFormat format,
+                             std::size_t* exported) {
+    std::ifstream file(historyFile);
+    if (!file.is_open()) {
+        return false;
+    }
+    writeExportHeader(out, format);
+    std::size_t count = 0;
+
+    // Compacted games first, one archive block at a time
+    std::uint64_t cold = 0;
+    HistoryArchive archive;
+    std::vector<GameRecord> block;
+    for (std::size_t segment = 0; archive.open(coldSegmentPath(historyFile, segment)); segment++) {
+        for (const auto& info : archive.blocks()) {
+            block.clear();
+            archive.readRange(info.firstRecord, info.count, block);
+            for (const auto& record : block) {
+                exportRecord(out, record, format);
+            }
+            count += block.size();
+        }
+        cold += archive.recordCount();
+    }
+
+    std::string line;
+    GameRecord record;
+    std::uint64_t skip = leadingColdRecords(file, cold);
+    // One record at a time; only the file's distinct boards and move lists are kept
+    HistoryFileDictionary dictionary;
+    while (std::getline(file, line)) {
+        record.moves.clear();
+        record.time = 0;
+        record.timestamp.clear();
+        if (parseRecord(line, record, dictionary)) {
+            if (skip > 0) {
+                skip--;
+                continue;
+            }
+            exportRecord(out, record, format);
+            count++;
+        }
+    }
+    if (exported != nullptr) {
+        *exported = count;
+    }
+    return static_cast<bool>(out);
 }
 
 void GameHistory::loadHistoryIfNeeded() {
-    if (gameRecords.empty()) {
+    if (live->size() == 0) {
         loadHistory();
     }
 }
+
+void GameHistory::storeRecord(const GameRecord& record) {
+    StoredGame game;
+    StringInterner& names = StringInterner::shared();
+    game.player1Id = names.intern(record.player1);
+    game.player2Id = names.intern(record.player2);
+    game.boardId = content->boards.intern(boardKey(record.finalBoard));
+    game.movesId = content->moveSequences.intern(movesKey(record.moves));
+    game.mode = record.mode;
+    game.result = record.result;
+    game.time = record.time;
+    if (game.time == 0 && !record.timestamp.empty()) {
+        EpochMillis time = 0;
+        if (parseLocalTimestamp(record.timestamp, time) && time != 0) {
+            game.time = time;
+        } else {
+            game.timestampId = content->timestamps.intern(record.timestamp);
+        }
+    }
+    EpochMillis previous = game.time;
+    bool timed = false;
+    std::string deltas;
+    for (const auto& move : record.moves) {
+        timed = timed || move.time != 0;
+        MoveCodec::appendSignedVarint(deltas, move.time - previous);
+        previous = move.time;
+    }
+    if (timed) {
+        game.moveTimes = std::move(deltas);
+    }
+
+    // The slot lies past every published version's end, so no reader sees it yet
+    if (live->end % CHUNK_RECORDS == 0) {
+        auto chunks = std::make_shared<std::vector<std::shared_ptr<RecordChunk>>>(*live->chunks);
+        chunks->push_back(std::make_shared<RecordChunk>());
+        live->chunks = std::move(chunks);
+    }
+    RecordChunk& chunk = *(*live->chunks)[live->end / CHUNK_RECORDS];
+    std::size_t slot = live->end % CHUNK_RECORDS;
+    chunk.player1[slot] = game.player1Id;
+    chunk.player2[slot] = game.player2Id;
+    chunk.mode[slot] = static_cast<std::uint8_t>(game.mode);
+    chunk.result[slot] = static_cast<std::uint8_t>(game.result);
+    chunk.games[slot] = std::move(game);
+    live->end++;
+    indexTime(live->size() - 1);
+    if (openingBook != nullptr) {
+        openingBook->addGame(record);
+    }
+}
+
+void GameHistory::publish() {
+    std::atomic_store(&published, std::shared_ptr<const HistoryVersion>(std::make_shared<HistoryVersion>(*live)));
+}
+
+HistorySnapshot GameHistory::snapshot() const {
+    return HistorySnapshot(std::atomic_load(&published));
+}
+
+void GameHistory::writeStored(std::ostream& out, const StoredGame& game) {
+    // Reusing one record keeps a rewrite of the whole file free of per-game allocations
+    expandInto(*content, game, scratch);
+    writeRecord(out, scratch, *fileDictionary);
+}
+
+void GameHistory::indexTime(std::size_t position) {
+    EpochMillis time = live->at(position).time;
+    if (time == 0) {
+        return;
+    }
+    if (!timeIndex.empty() && time < timeIndex.back().time) {
+        timeIndexSorted = false;
+    }
+    timeIndex.push_back({time, position});
+}
+
+void GameHistory::sortTimeIndex() {
+    if (timeIndexSorted) {
+        return;
+    }
+    std::sort(timeIndex.begin(), timeIndex.end(), [](const TimeEntry& a, const TimeEntry& b) {
+        return a.time != b.time ? a.time < b.time : a.record < b.record;
+    });
+    timeIndexSorted = true;
+}
+
+std::pair<std::size_t, std::size_t> GameHistory::timeSlice(EpochMillis from, EpochMillis to) {
+    sortTimeIndex();
+    if (from >= to) {
+        return {0, 0};
+    }
+    auto before = [](const TimeEntry& entry, EpochMillis time) { return entry.time < time; };
+    auto first = std::lower_bound(timeIndex.begin(), timeIndex.end(), from, before);
+    auto last = std::lower_bound(first, timeIndex.end(), to, before);
+    return {static_cast<std::size_t>(first - timeIndex.begin()),
+            static_cast<std::size_t>(last - timeIndex.begin())};
+}
+
+std::size_t GameHistory::hotGameCount() const {
+    return live->size();
+}
+
+std::uint64_t GameHistory::coldGameCount() const {
+    return coldRecords(*live->cold);
+}
+
+bool GameHistory::compact(EpochMillis now) {
+    if (historyFile.empty() || retention.hotDays <= 0 || bulkDepth > 0) {
+        return false;
+    }
+    pollCompaction();
+    if (compactor.joinable()) {
+        return false;
+    }
+    // Only a leading run moves, so segments keep the append order. Untimed
+    // games predate timestamps and count as old.
+    EpochMillis cutoff = now - retention.hotDays * MILLIS_PER_DAY;
+    std::size_t due = 0;
+    while (due < live->size() && live->at(due).time < cutoff) {
+        due++;
+    }
+    if (due == 0 || due < retention.minSegmentRecords) {
+        return false;
+    }
+    // The games must be in the file before it can be cut down to the hot ones
+    appendPending();
+    if (persisted < live->size()) {
+        return false;
+    }
+
+    // The writer only fills slots past the current end, so the thread reads
+    // the due games from this version while additions carry on
+    compacting = due;
+    std::shared_ptr<const HistoryVersion> version = std::make_shared<HistoryVersion>(*live);
+    std::string path = segmentPath(live->cold->size());
+    compactionDone = false;
+    compactor = std::thread([this, version, due, path]() {
+        std::string temporary = path + ".tmp";
+        std::vector<GameRecord> records;
+        records.reserve(due);
+        for (std::size_t i = 0; i < due; i++) {
+            records.push_back(expand(*version->content, version->at(i)));
+        }
+        compactionSucceeded = HistoryArchive::write(temporary, records) &&
+                              std::rename(temporary.c_str(), path.c_str()) == 0;
+        if (!compactionSucceeded) {
+            std::remove(temporary.c_str());
+        }
+        compactionDone.store(true, std::memory_order_release);
+    });
+    return true;
+}
+
+void GameHistory::waitForCompaction() {
+    if (compactor.joinable()) {
+        finishCompaction();
+    }
+}
+
+std::string GameHistory::segmentPath(std::size_t segment) const {
+    return coldSegmentPath(historyFile, segment);
+}
+
+void GameHistory::loadColdSegments() {
+    auto cold = std::make_shared<std::vector<ColdSegment>>();
+    HistoryArchive archive;
+    // Segments are numbered from 0 without gaps
+    while (archive.open(segmentPath(cold->size()))) {
+        ColdSegment segment;
+        segment.path = segmentPath(cold->size());
+        segment.records = archive.recordCount();
+        for (const auto& block : archive.blocks()) {
+            if (block.maxTime == 0) {
+                continue;
+            }
+            segment.minTime = segment.maxTime == 0 ? block.minTime : std::min(segment.minTime, block.minTime);
+            segment.maxTime = std::max(segment.maxTime, block.maxTime);
+        }
+        cold->push_back(segment);
+    }
+    live->cold = std::move(cold);
+}
+
+void GameHistory::maybeCompact(std::size_t added) {
+    if (retention.hotDays <= 0) {
+        return;
+    }
+    pollCompaction();
+    additionsSinceCheck += added;
+    if (additionsSinceCheck < COMPACTION_CHECK_INTERVAL) {
+        return;
+    }
+    additionsSinceCheck = 0;
+    compact(currentEpochMillis());
+}
+
+void GameHistory::pollCompaction() {
+    if (compactor.joinable() && compactionDone.load(std::memory_order_acquire)) {
+        finishCompaction();
+    }
+}
+
+void GameHistory::finishCompaction() {
+    compactor.join();
+    std::size_t moved = compacting;
+    compacting = 0;
+    if (!compactionSucceeded) {
+        return;
+    }
+    ColdSegment segment;
+    segment.path = segmentPath(live->cold->size());
+    segment.records = moved;
+    for (std::size_t i = 0; i < moved; i++) {
+        EpochMillis time = live->at(i).time;
+        if (time == 0) {
+            continue;
+        }
+        segment.minTime = segment.maxTime == 0 ? time : std::min(segment.minTime, time);
+        segment.maxTime = std::max(segment.maxTime, time);
+    }
+    auto cold = std::make_shared<std::vector<ColdSegment>>(*live->cold);
+    cold->push_back(segment);
+    live->cold = std::move(cold);
+
+    // Chunks that only held moved games are released once no snapshot uses them
+    live->begin += moved;
+    std::size_t dropped = live->begin / CHUNK_RECORDS;
+    if (dropped > 0) {
+        live->chunks = std::make_shared<std::vector<std::shared_ptr<RecordChunk>>>(
+            live->chunks->begin() + dropped, live->chunks->end());
+        live->begin -= dropped * CHUNK_RECORDS;
+        live->end -= dropped * CHUNK_RECORDS;
+    }
+    persisted -= moved;
+    rebuildTimeIndex();
+    publish();
+    // Drops the moved games from the hot file now that the segment holds them.
+    // Until this lands the file's watermark tells loadHistory() to skip them.
+    saveHistory();
+}
+
+void GameHistory::rebuildTimeIndex() {
+    timeIndex.clear();
+    timeIndexSorted = true;
+    for (std::size_t i = 0; i < live->size(); i++) {
+        indexTime(i);
+    }
+}
@@ -0,0 +1,159 @@
+#include "GameReplay.h"
+#include <algorithm>
+#include <future>
+
+namespace {
+
+const int SIZE = 3;
+const std::uint16_t FULL_BOARD = 0x1ff;
+const std::uint16_t WIN_LINES[] = {
+    0x007, 0x038, 0x1c0,   // rows
+    0x049, 0x092, 0x124,   // columns
+    0x111, 0x054           // diagonals
+};
+
+bool hasLine(std::uint16_t cells) {
+    for (std::uint16_t line : WIN_LINES) {
+        if ((cells & line) == line) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Splits records into a few chunks per worker so uneven games even out
+template <typename Fn>
+void forEachChunk(ThreadPool& pool, std::size_t count, Fn work) {
+    std::size_t chunks = std::max<std::size_t>(1, std::min(count, pool.size() * 4));
+    std::size_t chunkSize = (count + chunks - 1) / chunks;
+    std::vector<std::future<void>> pending;
+    for (std::size_t begin = 0; begin < count; begin += chunkSize) {
+        std::size_t end = std::min(count, begin + chunkSize);
+        pending.push_back(pool.submit([&work, begin, end]() { work(begin, end); }));
+    }
+    for (auto& done : pending) {
+        done.get();
+    }
+}
+
+}  // namespace
+
+GameReplay::GameReplay() : positions(1, Position{0, 0}), error(ReplayError::NONE), errorPly(-1) {}
+
+GameReplay::GameReplay(const GameRecord& record) : GameReplay() {
+    load(record);
+}
+
+bool GameReplay::load(const GameRecord& record) {
+    positions.assign(1, Position{0, 0});
+    positions.reserve(record.moves.size() + 1);
+    error = ReplayError::NONE;
+    errorPly = -1;
+
+    GameBoard board;
+    char previous = ' ';
+    for (std::size_t i = 0; i < record.moves.size(); i++) {
+        const Move& move = record.moves[i];
+        if (move.player != 'X' && move.player != 'O') {
+            error = ReplayError::BAD_PLAYER;
+        } else if (move.player == previous) {
+            error = ReplayError::WRONG_TURN;
+        } else if (board.checkWin() != GameResult::ONGOING) {
+            error = ReplayError::MOVE_AFTER_END;
+        } else if (!board.makeMove(move.row, move.col, move.player)) {
+            error = ReplayError::ILLEGAL_MOVE;
+        }
+        if (error != ReplayError::NONE) {
+            errorPly = static_cast<int>(i);
+            return false;
+        }
+
+        Position next = positions.back();
+        std::uint16_t bit = static_cast<std::uint16_t>(1u << (move.row * SIZE + move.col));
+        if (move.player == 'X') {
+            next.x |= bit;
+        } else {
+            next.o |= bit;
+        }
+        positions.push_back(next);
+        previous = move.player;
+    }
+    return true;
+}
+
+const GameReplay::Position& GameReplay::at(int ply) const {
+    int clamped = std::max(0, std::min(ply, plyCount()));
+    return positions[static_cast<std::size_t>(clamped)];
+}
+
+GameBoard GameReplay::positionAt(int ply) const {
+    const Position& position = at(ply);
+    std::vector<std::vector<char>> cells(SIZE, std::vector<char>(SIZE, ' '));
+    for (int cell = 0; cell < SIZE * SIZE; cell++) {
+        if (position.x & (1u << cell)) {
+            cells[cell / SIZE][cell % SIZE] = 'X';
+        } else if (position.o & (1u << cell)) {
+            cells[cell / SIZE][cell % SIZE] = 'O';
+        }
+    }
+    GameBoard board;
+    board.setBoard(cells);
+    return board;
+}
+
+char GameReplay::cellAt(int ply, int row, int col) const {
+    if (row < 0 || row >= SIZE || col < 0 || col >= SIZE) {
+        return ' ';
+    }
+    const Position& position = at(ply);
+    unsigned bit = 1u << (row * SIZE + col);
+    if (position.x & bit) {
+        return 'X';
+    }
+    return (position.o & bit) ? 'O' : ' ';
+}
+
+GameResult GameReplay::resultAt(int ply) const {
+    const Position& position = at(ply);
+    // A validated replay never has lines for both players
+    if (hasLine(position.x)) {
+        return GameResult::PLAYER1_WIN;
+    }
+    if (hasLine(position.o)) {
+        return GameResult::PLAYER2_WIN;
+    }
+    if ((position.x | position.o) == FULL_BOARD) {
+        return GameResult::TIE;
+    }
+    return GameResult::ONGOING;
+}
+
+ReplayEngine::ReplayEngine(std::size_t threadCount) : pool(threadCount) {}
+
+std::vector<GameReplay> ReplayEngine::replayAll(const std::vector<GameRecord>& records) {
+    std::vector<GameReplay> replays(records.size());
+    forEachChunk(pool, records.size(), [&records, &replays](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            replays[i].load(records[i]);
+        }
+    });
+    return replays;
+}
+
+std::vector<std::size_t> ReplayEngine::findInvalid(const std::vector<GameRecord>& records) {
+    std::vector<char> invalid(records.size(), 0);
+    forEachChunk(pool, records.size(), [&records, &invalid](std::size_t begin, std::size_t end) {
+        GameReplay replay;
+        for (std::size_t i = begin; i < end; i++) {
+            invalid[i] = replay.load(records[i]) ? 0 : 1;
+        }
+    });
+
+    std::vector<std::size_t> indices;
+    for (std::size_t i = 0; i < invalid.size(); i++) {
+        if (invalid[i]) {
+            indices.push_back(i);
+        }
+    }
+    return indices;
+}
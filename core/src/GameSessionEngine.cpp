@@ -0,0 +1,252 @@
+#include "GameSessionEngine.h"
+namespace {
+
+const int BOARD_CELLS = 9;
+const std::size_t NAME_CAPACITY = 32;
+
+void prepareSession(GameSession& session) {
+    session.player1.reserve(NAME_CAPACITY);
+    session.player2.reserve(NAME_CAPACITY);
+    session.moves.reserve(BOARD_CELLS);
+}
+
+void prepareRecord(GameRecord& record) {
+    record.player1.reserve(NAME_CAPACITY);
+    record.player2.reserve(NAME_CAPACITY);
+    record.finalBoard.assign(3, std::vector<char>(3, ' '));
+    record.moves.reserve(BOARD_CELLS);
+}
+
+}  // namespace
+
+GameSessionEngine::Worker::Worker(std::size_t reservedGames)
+    : sessionPool(&memory, prepareSession),
+      recordPool(&memory, prepareRecord),
+      sessions(&memory) {
+    sessionPool.reserve(reservedGames);
+    recordPool.reserve(reservedGames);
+    sessions.reserve(reservedGames);
+    finished.reserve(reservedGames);
+    inbox.reserve(reservedGames);
+}
+
+GameSessionEngine::GameSessionEngine(std::size_t workerCount, GameHistory* history,
+                                     std::size_t reservedGamesPerWorker)
+    : reservedGames(reservedGamesPerWorker),
+      history(history), nextSessionId(1), liveGames(0), finishedGames(0), stopping(false) {
+    if (workerCount == 0) {
+        workerCount = std::thread::hardware_concurrency();
+        if (workerCount == 0) {
+            workerCount = 1;
+        }
+    }
+
+    for (std::size_t i = 0; i < workerCount; i++) {
+        workers.push_back(std::make_unique<Worker>(reservedGames));
+    }
+    for (auto& worker : workers) {
+        Worker* raw = worker.get();
+        worker->thread = std::thread([this, raw]() { runWorker(*raw); });
+    }
+}
+
+GameSessionEngine::~GameSessionEngine() {
+    stopping = true;
+    for (auto& worker : workers) {
+        // Taking the lock orders the flag against a worker about to sleep
+        { std::lock_guard<std::mutex> lock(worker->mutex); }
+        worker->ready.notify_one();
+        worker->thread.join();
+    }
+}
+
+GameSessionEngine::Worker& GameSessionEngine::workerFor(GameSessionId session) {
+    return *workers[session % workers.size()];
+}
+
+void GameSessionEngine::post(GameSessionId session, Command command) {
+    Worker& worker = workerFor(session);
+    bool wasEmpty;
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        wasEmpty = worker.inbox.empty();
+        worker.inbox.push_back(std::move(command));
+    }
+    // A non-empty inbox means the worker is already awake or about to drain it
+    if (wasEmpty) {
+        worker.ready.notify_one();
+    }
+}
+
+GameSessionId GameSessionEngine::createGame(const std::string& player1, const std::string& player2,
+                                            GameMode mode) {
+    GameSessionId id = nextSessionId.fetch_add(1, std::memory_order_relaxed);
+    Command command{CommandType::CREATE, id, -1, -1, ' ', mode, player1, player2, nullptr, nullptr};
+    liveGames.fetch_add(1, std::memory_order_relaxed);
+    post(id, std::move(command));
+    return id;
+}
+
+void GameSessionEngine::submitMove(GameSessionId session, int row, int col, char player,
+                                   MoveCallback callback) {
+    Command command{CommandType::MOVE, session, row, col, player, GameMode::PLAYER_VS_PLAYER,
+                    std::string(), std::string(), std::move(callback), nullptr};
+    post(session, std::move(command));
+}
+
+std::future<MoveReply> GameSessionEngine::submitMove(GameSessionId session, int row, int col,
+                                                     char player) {
+    auto promise = std::make_shared<std::promise<MoveReply>>();
+    std::future<MoveReply> future = promise->get_future();
+    submitMove(session, row, col, player,
+               [promise](const MoveReply& reply) { promise->set_value(reply); });
+    return future;
+}
+
+void GameSessionEngine::abandonGame(GameSessionId session) {
+    Command command{CommandType::ABANDON, session, -1, -1, ' ', GameMode::PLAYER_VS_PLAYER,
+                    std::string(), std::string(), nullptr, nullptr};
+    post(session, std::move(command));
+}
+
+void GameSessionEngine::flush() {
+    std::vector<std::future<void>> pending;
+    for (std::size_t i = 0; i < workers.size(); i++) {
+        auto barrier = std::make_shared<std::promise<void>>();
+        pending.push_back(barrier->get_future());
+        Command command{CommandType::BARRIER, i, -1, -1, ' ', GameMode::PLAYER_VS_PLAYER,
+                        std::string(), std::string(), nullptr, barrier};
+        post(i, std::move(command));
+    }
+    for (auto& done : pending) {
+        done.wait();
+    }
+}
+
+void GameSessionEngine::runWorker(Worker& worker) {
+    std::vector<Command> batch;
+    batch.reserve(reservedGames);
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            worker.ready.wait(lock, [this, &worker]() { return stopping || !worker.inbox.empty(); });
+            if (worker.inbox.empty()) {
+                return;
+            }
+            // Take the whole inbox at once; producers keep appending to a fresh vector
+            batch.swap(worker.inbox);
+        }
+
+        for (auto& command : batch) {
+            process(worker, command);
+        }
+        batch.clear();
+        publishFinished(worker);
+    }
+}
+
+void GameSessionEngine::process(Worker& worker, Command& command) {
+    switch (command.type) {
+        case CommandType::CREATE: {
+            GameSession* session = worker.sessionPool.acquire();
+            session->id = command.session;
+            // assign() rather than move keeps the pooled string's buffer
+            session->player1.assign(command.player1);
+            session->player2.assign(command.player2);
+            session->mode = command.mode;
+            session->nextPlayer = 'X';
+            session->board.reset();
+            session->moves.clear();
+            worker.sessions.emplace(command.session, session);
+            break;
+        }
+        case CommandType::MOVE: {
+            MoveReply reply = applyMove(worker, command);
+            if (command.callback) {
+                command.callback(reply);
+            }
+            break;
+        }
+        case CommandType::ABANDON: {
+            auto it = worker.sessions.find(command.session);
+            if (it != worker.sessions.end()) {
+                worker.sessionPool.release(it->second);
+                worker.sessions.erase(it);
+                liveGames.fetch_sub(1, std::memory_order_relaxed);
+            }
+            break;
+        }
+        case CommandType::BARRIER:
+            // Finished games are published before the barrier releases its waiter
+            publishFinished(worker);
+            command.barrier->set_value();
+            break;
+    }
+}
+
+MoveReply GameSessionEngine::applyMove(Worker& worker, const Command& command) {
+    auto it = worker.sessions.find(command.session);
+    if (it == worker.sessions.end()) {
+        return MoveReply(command.session, MoveStatus::UNKNOWN_SESSION, GameResult::ONGOING);
+    }
+
+    GameSession& session = *it->second;
+    if (command.player != session.nextPlayer) {
+        return MoveReply(command.session, MoveStatus::NOT_YOUR_TURN, GameResult::ONGOING);
+    }
+    if (!session.board.makeMove(command.row, command.col, command.player)) {
+        return MoveReply(command.session, MoveStatus::INVALID_MOVE, GameResult::ONGOING);
+    }
+
+    session.moves.push_back(Move(command.row, command.col, command.player, currentEpochMillis(),
+                                 static_cast<int>(session.moves.size()) + 1));
+    session.nextPlayer = (command.player == 'X') ? 'O' : 'X';
+
+    GameResult result = session.board.checkWin();
+    if (result == GameResult::ONGOING) {
+        return MoveReply(command.session, MoveStatus::ACCEPTED, result);
+    }
+
+    // Copy into a recycled record; every buffer it needs is already reserved
+    GameRecord* record = worker.recordPool.acquire();
+    record->player1.assign(session.player1);
+    record->player2.assign(session.player2);
+    record->mode = session.mode;
+    record->result = result;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            record->finalBoard[i][j] = session.board.getCell(i, j);
+        }
+    }
+    record->time = session.moves.back().time;
+    record->timestamp.clear();
+    record->moves.assign(session.moves.begin(), session.moves.end());
+    record->player1Id = INVALID_USER_ID;
+    record->player2Id = INVALID_USER_ID;
+    worker.finished.push_back(record);
+
+    worker.sessionPool.release(&session);
+    worker.sessions.erase(it);
+    liveGames.fetch_sub(1, std::memory_order_relaxed);
+    finishedGames.fetch_add(1, std::memory_order_relaxed);
+    return MoveReply(command.session, MoveStatus::GAME_FINISHED, result);
+}
+
+void GameSessionEngine::publishFinished(Worker& worker) {
+    if (worker.finished.empty()) {
+        return;
+    }
+    if (history != nullptr) {
+        std::lock_guard<std::mutex> lock(historyMutex);
+        // One append to the history file per batch rather than a save per game
+        history->beginBulk();
+        for (GameRecord* record : worker.finished) {
+            history->addGameRecord(*record);
+        }
+        history->endBulk();
+    }
+    for (GameRecord* record : worker.finished) {
+        worker.recordPool.release(record);
+    }
+    worker.finished.clear();
+}
@@ -0,0 +1,441 @@
+#include "HistoryArchive.h"
+#include "MoveCodec.h"
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <unordered_map>
+
+namespace {
+
+const char FILE_MAGIC[8] = {'T', 'T', 'T', 'A', 'R', 'C', 'H', '1'};
+const char INDEX_MAGIC[8] = {'T', 'T', 'T', 'A', 'I', 'D', 'X', '1'};
+const std::size_t MAGIC_SIZE = sizeof(FILE_MAGIC);
+const std::size_t FOOTER_SIZE = 8 + MAGIC_SIZE;
+const std::size_t NO_BLOCK = std::numeric_limits<std::size_t>::max();
+
+// Per-record flags
+const std::uint8_t TEXT_TIMESTAMP = 1;   // legacy timestamp string follows
+const std::uint8_t RAW_BOARD = 2;        // board is not a plain 3x3 of ' ', 'X', 'O'
+const std::uint8_t RAW_MOVES = 4;        // moves MoveCodec cannot pack
+
+void appendString(std::string& out, const std::string& text) {
+    MoveCodec::appendVarint(out, text.size());
+    out += text;
+}
+
+bool readString(const std::string& in, std::size_t& pos, std::string& text) {
+    std::uint64_t length;
+    if (!MoveCodec::readVarint(in, pos, length) || length > in.size() - pos) {
+        return false;
+    }
+    text.assign(in, pos, static_cast<std::size_t>(length));
+    pos += static_cast<std::size_t>(length);
+    return true;
+}
+
+int cellCode(char cell) {
+    return cell == ' ' ? 0 : (cell == 'X' ? 1 : (cell == 'O' ? 2 : -1));
+}
+
+bool packBoard(const std::vector<std::vector<char>>& board, std::uint32_t& packed) {
+    if (board.size() != 3) {
+        return false;
+    }
+    packed = 0;
+    for (int r = 0; r < 3; r++) {
+        if (board[r].size() != 3) {
+            return false;
+        }
+        for (int c = 0; c < 3; c++) {
+            int code = cellCode(board[r][c]);
+            if (code < 0) {
+                return false;
+            }
+            packed |= static_cast<std::uint32_t>(code) << (2 * (r * 3 + c));
+        }
+    }
+    return true;
+}
+
+void encodeRecord(const GameRecord& record, const std::unordered_map<std::string, std::uint64_t>& names,
+                  EpochMillis previousTime, std::string& out) {
+    std::uint32_t board = 0;
+    std::string moves;
+    std::uint8_t flags = 0;
+    if (record.time == 0 && !record.timestamp.empty()) {
+        flags |= TEXT_TIMESTAMP;
+    }
+    if (!packBoard(record.finalBoard, board)) {
+        flags |= RAW_BOARD;
+    }
+    if (!MoveCodec::encodeMoves(record.moves, record.time, moves)) {
+        flags |= RAW_MOVES;
+    }
+
+    out += static_cast<char>(flags);
+    MoveCodec::appendVarint(out, names.at(record.player1));
+    MoveCodec::appendVarint(out, names.at(record.player2));
+    out += static_cast<char>(static_cast<int>(record.mode) | (static_cast<int>(record.result) << 4));
+    MoveCodec::appendSignedVarint(out, record.time - previousTime);
+    if (flags & TEXT_TIMESTAMP) {
+        appendString(out, record.timestamp);
+    }
+
+    if (flags & RAW_BOARD) {
+        MoveCodec::appendVarint(out, record.finalBoard.size());
+        for (const auto& row : record.finalBoard) {
+            appendString(out, std::string(row.begin(), row.end()));
+        }
+    } else {
+        out += static_cast<char>(board & 0xff);
+        out += static_cast<char>((board >> 8) & 0xff);
+        out += static_cast<char>((board >> 16) & 0xff);
+    }
+
+    if (flags & RAW_MOVES) {
+        MoveCodec::appendVarint(out, record.moves.size());
+        for (const auto& move : record.moves) {
+            MoveCodec::appendSignedVarint(out, move.row);
+            MoveCodec::appendSignedVarint(out, move.col);
+            out += move.player;
+            MoveCodec::appendSignedVarint(out, move.moveNumber);
+            MoveCodec::appendSignedVarint(out, move.time);
+        }
+    } else {
+        out += moves;
+    }
+}
+
+bool decodeRecord(const std::string& in, std::size_t& pos, const std::vector<std::string>& names,
+                  EpochMillis previousTime, GameRecord& record) {
+    if (pos + 1 > in.size()) {
+        return false;
+    }
+    std::uint8_t flags = static_cast<std::uint8_t>(in[pos++]);
+    std::uint64_t player1;
+    std::uint64_t player2;
+    if (!MoveCodec::readVarint(in, pos, player1) || !MoveCodec::readVarint(in, pos, player2) ||
+        player1 >= names.size() || player2 >= names.size() || pos >= in.size()) {
+        return false;
+    }
+    record.player1 = names[static_cast<std::size_t>(player1)];
+    record.player2 = names[static_cast<std::size_t>(player2)];
+    std::uint8_t modeAndResult = static_cast<std::uint8_t>(in[pos++]);
+    record.mode = static_cast<GameMode>(modeAndResult & 0x0f);
+    record.result = static_cast<GameResult>(modeAndResult >> 4);
+
+    std::int64_t delta;
+    if (!MoveCodec::readSignedVarint(in, pos, delta)) {
+        return false;
+    }
+    record.time = previousTime + delta;
+    record.timestamp.clear();
+    if ((flags & TEXT_TIMESTAMP) && !readString(in, pos, record.timestamp)) {
+        return false;
+    }
+
+    if (flags & RAW_BOARD) {
+        std::uint64_t rows;
+        if (!MoveCodec::readVarint(in, pos, rows) || rows > in.size() - pos) {
+            return false;
+        }
+        record.finalBoard.assign(static_cast<std::size_t>(rows), std::vector<char>());
+        std::string row;
+        for (auto& cells : record.finalBoard) {
+            if (!readString(in, pos, row)) {
+                return false;
+            }
+            cells.assign(row.begin(), row.end());
+        }
+    } else {
+        if (pos + 3 > in.size()) {
+            return false;
+        }
+        std::uint32_t board = static_cast<std::uint8_t>(in[pos]) |
+                              (static_cast<std::uint32_t>(static_cast<std::uint8_t>(in[pos + 1])) << 8) |
+                              (static_cast<std::uint32_t>(static_cast<std::uint8_t>(in[pos + 2])) << 16);
+        pos += 3;
+        const char CELLS[4] = {' ', 'X', 'O', ' '};
+        record.finalBoard.assign(3, std::vector<char>(3, ' '));
+        for (int i = 0; i < 9; i++) {
+            record.finalBoard[i / 3][i % 3] = CELLS[(board >> (2 * i)) & 3];
+        }
+    }
+
+    if (!(flags & RAW_MOVES)) {
+        return MoveCodec::decodeMoves(in, pos, record.time, record.moves);
+    }
+    std::uint64_t count;
+    if (!MoveCodec::readVarint(in, pos, count) || count > in.size() - pos) {
+        return false;
+    }
+    record.moves.clear();
+    for (std::uint64_t i = 0; i < count; i++) {
+        std::int64_t row;
+        std::int64_t col;
+        std::int64_t number;
+        std::int64_t time;
+        if (!MoveCodec::readSignedVarint(in, pos, row) || !MoveCodec::readSignedVarint(in, pos, col) ||
+            pos >= in.size()) {
+            return false;
+        }
+        char player = in[pos++];
+        if (!MoveCodec::readSignedVarint(in, pos, number) || !MoveCodec::readSignedVarint(in, pos, time)) {
+            return false;
+        }
+        record.moves.push_back(Move(static_cast<int>(row), static_cast<int>(col), player, time,
+                                    static_cast<int>(number)));
+    }
+    return true;
+}
+
+// Block layout: name count, names, record count, records
+std::string encodeBlock(const std::vector<GameRecord>& records, std::size_t begin, std::size_t end,
+                        ArchiveBlockInfo& info) {
+    std::unordered_map<std::string, std::uint64_t> ids;
+    std::vector<const std::string*> names;
+    for (std::size_t i = begin; i < end; i++) {
+        for (const std::string* name : {&records[i].player1, &records[i].player2}) {
+            if (ids.emplace(*name, names.size()).second) {
+                names.push_back(name);
+            }
+        }
+    }
+
+    std::string block;
+    MoveCodec::appendVarint(block, names.size());
+    for (const std::string* name : names) {
+        appendString(block, *name);
+    }
+    MoveCodec::appendVarint(block, end - begin);
+
+    bool timed = false;
+    EpochMillis previous = 0;
+    for (std::size_t i = begin; i < end; i++) {
+        const GameRecord& record = records[i];
+        encodeRecord(record, ids, previous, block);
+        previous = record.time;
+        if (record.time != 0) {
+            info.minTime = timed ? std::min(info.minTime, record.time) : record.time;
+            info.maxTime = timed ? std::max(info.maxTime, record.time) : record.time;
+            timed = true;
+        }
+    }
+    info.count = static_cast<std::uint32_t>(end - begin);
+    return block;
+}
+
+void appendFixed64(std::string& out, std::uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out += static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+std::uint64_t readFixed64(const char* in) {
+    std::uint64_t value = 0;
+    for (int i = 7; i >= 0; i--) {
+        value = (value << 8) | static_cast<std::uint8_t>(in[i]);
+    }
+    return value;
+}
+
+}  // namespace
+
+HistoryArchive::HistoryArchive() : total(0), cachedBlock(NO_BLOCK) {}
+
+bool HistoryArchive::write(const std::string& path, const std::vector<GameRecord>& records,
+                           std::size_t blockRecords) {
+    if (blockRecords == 0) {
+        blockRecords = DEFAULT_BLOCK_RECORDS;
+    }
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(FILE_MAGIC, MAGIC_SIZE);
+
+    std::string indexBytes;
+    std::uint64_t offset = MAGIC_SIZE;
+    MoveCodec::appendVarint(indexBytes, (records.size() + blockRecords - 1) / blockRecords);
+    for (std::size_t begin = 0; begin < records.size(); begin += blockRecords) {
+        ArchiveBlockInfo info;
+        std::string block = encodeBlock(records, begin, std::min(records.size(), begin + blockRecords), info);
+        file.write(block.data(), static_cast<std::streamsize>(block.size()));
+
+        MoveCodec::appendVarint(indexBytes, offset);
+        MoveCodec::appendVarint(indexBytes, block.size());
+        MoveCodec::appendVarint(indexBytes, info.count);
+        MoveCodec::appendSignedVarint(indexBytes, info.minTime);
+        MoveCodec::appendSignedVarint(indexBytes, info.maxTime - info.minTime);
+        offset += block.size();
+    }
+
+    appendFixed64(indexBytes, offset);
+    indexBytes.append(INDEX_MAGIC, MAGIC_SIZE);
+    file.write(indexBytes.data(), static_cast<std::streamsize>(indexBytes.size()));
+    file.close();
+    return static_cast<bool>(file);
+}
+
+bool HistoryArchive::open(const std::string& archivePath) {
+    path.clear();
+    index.clear();
+    total = 0;
+    cachedBlock = NO_BLOCK;
+    cached.clear();
+
+    std::ifstream file(archivePath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::uint64_t fileSize = static_cast<std::uint64_t>(file.tellg());
+    if (fileSize < MAGIC_SIZE + FOOTER_SIZE) {
+        return false;
+    }
+    char header[MAGIC_SIZE];
+    char footer[FOOTER_SIZE];
+    file.seekg(0);
+    file.read(header, MAGIC_SIZE);
+    file.seekg(static_cast<std::streamoff>(fileSize - FOOTER_SIZE));
+    file.read(footer, FOOTER_SIZE);
+    if (!file || !std::equal(header, header + MAGIC_SIZE, FILE_MAGIC) ||
+        !std::equal(footer + 8, footer + FOOTER_SIZE, INDEX_MAGIC)) {
+        return false;
+    }
+    std::uint64_t indexOffset = readFixed64(footer);
+    if (indexOffset < MAGIC_SIZE || indexOffset > fileSize - FOOTER_SIZE) {
+        return false;
+    }
+
+    std::string bytes(static_cast<std::size_t>(fileSize - FOOTER_SIZE - indexOffset), '\0');
+    file.seekg(static_cast<std::streamoff>(indexOffset));
+    file.read(&bytes[0], static_cast<std::streamsize>(bytes.size()));
+    if (!file) {
+        return false;
+    }
+
+    std::size_t pos = 0;
+    std::uint64_t blockCount;
+    if (!MoveCodec::readVarint(bytes, pos, blockCount) || blockCount > bytes.size()) {
+        return false;
+    }
+    std::vector<ArchiveBlockInfo> blocks;
+    std::uint64_t records = 0;
+    for (std::uint64_t b = 0; b < blockCount; b++) {
+        ArchiveBlockInfo info;
+        std::uint64_t count;
+        std::int64_t span;
+        if (!MoveCodec::readVarint(bytes, pos, info.offset) || !MoveCodec::readVarint(bytes, pos, info.size) ||
+            !MoveCodec::readVarint(bytes, pos, count) || !MoveCodec::readSignedVarint(bytes, pos, info.minTime) ||
+            !MoveCodec::readSignedVarint(bytes, pos, span) || info.offset + info.size > indexOffset) {
+            return false;
+        }
+        info.count = static_cast<std::uint32_t>(count);
+        info.maxTime = info.minTime + span;
+        info.firstRecord = records;
+        records += count;
+        blocks.push_back(info);
+    }
+
+    path = archivePath;
+    index = std::move(blocks);
+    total = records;
+    return true;
+}
+
+std::size_t HistoryArchive::blockFor(std::uint64_t id) const {
+    auto it = std::upper_bound(index.begin(), index.end(), id,
+                               [](std::uint64_t value, const ArchiveBlockInfo& info) {
+                                   return value < info.firstRecord;
+                               });
+    return static_cast<std::size_t>(it - index.begin()) - 1;
+}
+
+bool HistoryArchive::loadBlock(std::size_t block) {
+    if (block == cachedBlock) {
+        return true;
+    }
+    const ArchiveBlockInfo& info = index[block];
+    std::ifstream file(path, std::ios::binary);
+    std::string bytes(static_cast<std::size_t>(info.size), '\0');
+    file.seekg(static_cast<std::streamoff>(info.offset));
+    file.read(&bytes[0], static_cast<std::streamsize>(bytes.size()));
+    if (!file) {
+        return false;
+    }
+
+    std::size_t pos = 0;
+    std::uint64_t nameCount;
+    if (!MoveCodec::readVarint(bytes, pos, nameCount) || nameCount > bytes.size()) {
+        return false;
+    }
+    std::vector<std::string> names(static_cast<std::size_t>(nameCount));
+    for (auto& name : names) {
+        if (!readString(bytes, pos, name)) {
+            return false;
+        }
+    }
+    std::uint64_t count;
+    if (!MoveCodec::readVarint(bytes, pos, count) || count != info.count) {
+        return false;
+    }
+
+    cachedBlock = NO_BLOCK;
+    cached.resize(static_cast<std::size_t>(count));
+    EpochMillis previous = 0;
+    for (auto& record : cached) {
+        if (!decodeRecord(bytes, pos, names, previous, record)) {
+            return false;
+        }
+        previous = record.time;
+    }
+    cachedBlock = block;
+    return true;
+}
+
+bool HistoryArchive::readRecord(std::uint64_t id, GameRecord& record) {
+    if (id >= total) {
+        return false;
+    }
+    std::size_t block = blockFor(id);
+    if (!loadBlock(block)) {
+        return false;
+    }
+    record = cached[static_cast<std::size_t>(id - index[block].firstRecord)];
+    return true;
+}
+
+bool HistoryArchive::readRange(std::uint64_t first, std::uint64_t count, std::vector<GameRecord>& records) {
+    std::uint64_t end = std::min(total, first + std::min(count, total));
+    for (std::uint64_t id = first; id < end;) {
+        std::size_t block = blockFor(id);
+        if (!loadBlock(block)) {
+            return false;
+        }
+        const ArchiveBlockInfo& info = index[block];
+        std::uint64_t blockEnd = std::min(end, info.firstRecord + info.count);
+        records.insert(records.end(), cached.begin() + static_cast<std::ptrdiff_t>(id - info.firstRecord),
+                       cached.begin() + static_cast<std::ptrdiff_t>(blockEnd - info.firstRecord));
+        id = blockEnd;
+    }
+    return true;
+}
+
+bool HistoryArchive::readTimeRange(EpochMillis from, EpochMillis to, std::vector<GameRecord>& records) {
+    for (std::size_t block = 0; block < index.size(); block++) {
+        const ArchiveBlockInfo& info = index[block];
+        // Blocks without timed records, or entirely outside the window, are never read
+        if (info.maxTime == 0 || info.maxTime < from || info.minTime >= to) {
+            continue;
+        }
+        if (!loadBlock(block)) {
+            return false;
+        }
+        for (const auto& record : cached) {
+            if (record.time != 0 && record.time >= from && record.time < to) {
+                records.push_back(record);
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,125 @@
+#include "LineEvaluator.h"
+#include <algorithm>
+
+LineEvaluator::LineEvaluator() : rowCount(0), colCount(0), length(0), sum(0), linesX(0), linesO(0) {}
+
+bool LineEvaluator::reshape(int rows, int cols, int winLength) {
+    if (rows == rowCount && cols == colCount && winLength == length) {
+        return false;
+    }
+    rowCount = rows;
+    colCount = cols;
+    length = winLength;
+    int windowCount = 0;
+    cellWindows.assign(rows * cols, std::vector<int>());
+    const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+    for (const auto& direction : directions) {
+        for (int r = 0; r < rows; r++) {
+            for (int c = 0; c < cols; c++) {
+                int endRow = r + direction[0] * (length - 1);
+                int endCol = c + direction[1] * (length - 1);
+                if (endRow >= rows || endCol < 0 || endCol >= cols) {
+                    continue;
+                }
+                for (int i = 0; i < length; i++) {
+                    cellWindows[(r + direction[0] * i) * cols + c + direction[1] * i].push_back(windowCount);
+                }
+                windowCount++;
+            }
+        }
+    }
+    windowX.assign(windowCount, 0);
+    windowO.assign(windowCount, 0);
+    // A window's worth grows fourfold with each mark in it
+    weights.assign(length + 1, 0);
+    for (int n = 1; n <= length; n++) {
+        weights[n] = 1LL << std::min(2 * (n - 1), MAX_WEIGHT_SHIFT);
+    }
+    sum = 0;
+    linesX = 0;
+    linesO = 0;
+    return true;
+}
+
+void LineEvaluator::load(const GameBoard& board) {
+    if (!reshape(board.getRows(), board.getCols(), board.getWinLength())) {
+        clear();
+    }
+    for (int r = 0; r < rowCount; r++) {
+        for (int c = 0; c < colCount; c++) {
+            char mark = board.getCell(r, c);
+            if (mark == 'X' || mark == 'O') {
+                add(r * colCount + c, mark);
+            }
+        }
+    }
+}
+
+void LineEvaluator::clear() {
+    std::fill(windowX.begin(), windowX.end(), 0);
+    std::fill(windowO.begin(), windowO.end(), 0);
+    sum = 0;
+    linesX = 0;
+    linesO = 0;
+}
+
+void LineEvaluator::add(int cell, char player) {
+    count(cell, player, 1);
+}
+
+void LineEvaluator::remove(int cell, char player) {
+    count(cell, player, -1);
+}
+
+void LineEvaluator::count(int cell, char player, int delta) {
+    std::vector<int>& counts = (player == 'X') ? windowX : windowO;
+    int& lines = (player == 'X') ? linesX : linesO;
+    for (int window : cellWindows[cell]) {
+        sum -= windowValue(window);
+        lines -= (counts[window] == length);
+        counts[window] += delta;
+        lines += (counts[window] == length);
+        sum += windowValue(window);
+    }
+}
+
+long long LineEvaluator::windowValue(int window) const {
+    // A window both sides have marked can no longer become a line
+    if (windowO[window] == 0) {
+        return weights[windowX[window]];
+    }
+    if (windowX[window] == 0) {
+        return -weights[windowO[window]];
+    }
+    return 0;
+}
+
+long long LineEvaluator::gain(int cell, char player, bool& completesLine) const {
+    const std::vector<int>& own = (player == 'X') ? windowX : windowO;
+    const std::vector<int>& theirs = (player == 'X') ? windowO : windowX;
+    long long total = 0;
+    completesLine = false;
+    for (int window : cellWindows[cell]) {
+        if (theirs[window] == 0) {
+            completesLine = completesLine || own[window] + 1 == length;
+            total += weights[own[window] + 1] - weights[own[window]];
+        } else if (own[window] == 0) {
+            // Taking a cell of the opponent's window kills it
+            total += weights[theirs[window]];
+        }
+    }
+    return total;
+}
+
+long long LineEvaluator::openness(int cell) const {
+    long long total = 0;
+    for (int window : cellWindows[cell]) {
+        if (windowO[window] == 0) {
+            total += weights[windowX[window]] + 1;
+        }
+        if (windowX[window] == 0) {
+            total += weights[windowO[window]] + 1;
+        }
+    }
+    return total;
+}
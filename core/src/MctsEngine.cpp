@@ -0,0 +1,267 @@
+#include "MctsEngine.h"
+#include "Metrics.h"
+#include "Random.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
+
+namespace {
+
+const int NOT_TERMINAL = -1;
+// Outcomes in half points for the player who made the move
+const int LOSS = 0;
+const int TIE = 1;
+const int WIN = 2;
+
+// Plays random moves to the end; returns the outcome for lastMover
+int randomPlayout(PlayoutBoard& board, char toMove, char lastMover, Random& random) {
+    while (board.emptyCount() > 0) {
+        int cell = board.emptyCell(random.below(board.emptyCount()));
+        if (board.play(cell, toMove)) {
+            return toMove == lastMover ? WIN : LOSS;
+        }
+        toMove = PlayoutBoard::opponent(toMove);
+    }
+    return TIE;
+}
+
+}  // namespace
+
+struct MctsEngine::Search {
+    MctsLimits limits;
+    std::chrono::steady_clock::time_point deadline;
+    std::atomic<std::uint64_t> started{0};
+    std::atomic<std::uint64_t> completed{0};
+    std::atomic<bool> stop{false};
+};
+
+MctsEngine::Node::Node(Node* parent, int move, char player, int offset)
+    : parent(parent),
+      move(move),
+      player(player),
+      terminal(NOT_TERMINAL),
+      visits(0),
+      virtualLoss(0),
+      halfPoints(0),
+      expandOffset(offset),
+      scanned(0) {}
+
+MctsEngine::MctsEngine(std::size_t threadCount, double exploration, std::uint64_t seed)
+    : threadCount(threadCount == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threadCount),
+      exploration(exploration),
+      seed(seed),
+      searches(0),
+      pool(this->threadCount),
+      rootPlayer('X') {}
+
+MctsEngine::~MctsEngine() = default;
+
+void MctsEngine::reset() {
+    root.reset();
+}
+
+bool MctsEngine::reuseTree(const PlayoutBoard& board, char player) {
+    if (!root || board.rows() != rootBoard.rows() || board.cols() != rootBoard.cols() ||
+        board.winLength() != rootBoard.winLength()) {
+        return false;
+    }
+
+    // Cells filled since the saved root, in the order they must have been played
+    int played[2] = {-1, -1};
+    int count = 0;
+    for (int index = 0; index < board.cellCount(); index++) {
+        char before = rootBoard.cell(index);
+        char after = board.cell(index);
+        if (before == after) {
+            continue;
+        }
+        if (before != ' ' || count == 2) {
+            return false;
+        }
+        int turn = (after == rootPlayer) ? 0 : 1;
+        if (after != 'X' && after != 'O') {
+            return false;
+        }
+        if (played[turn] != -1) {
+            return false;
+        }
+        played[turn] = index;
+        count++;
+    }
+    // Either nothing, one move by the root player, or one move each
+    if ((count == 0 && player != rootPlayer) || (count == 1 && (played[0] == -1 || player == rootPlayer)) ||
+        (count == 2 && player != rootPlayer)) {
+        return false;
+    }
+
+    for (int i = 0; i < count; i++) {
+        std::unique_ptr<Node> next;
+        for (auto& child : root->children) {
+            if (child->move == played[i]) {
+                next = std::move(child);
+                break;
+            }
+        }
+        if (!next) {
+            return false;
+        }
+        next->parent = nullptr;
+        root = std::move(next);
+    }
+    return true;
+}
+
+bool MctsEngine::chooseMove(const GameBoard& board, char player, const MctsLimits& limits,
+                            MctsResult& result) {
+    GAME_METRICS_TIMED(Metric::AI_SEARCH);
+    result = MctsResult();
+    if (!PlayoutBoard::fits(board) || (limits.maxIterations == 0 && limits.maxMillis <= 0)) {
+        return false;
+    }
+    PlayoutBoard position(board);
+    if (position.result() != GameResult::ONGOING) {
+        return false;
+    }
+
+    if (!reuseTree(position, player)) {
+        root.reset(new Node(nullptr, -1, PlayoutBoard::opponent(player), 0));
+    }
+    rootBoard = position;
+    rootPlayer = player;
+    result.reusedVisits = root->visits.load();
+
+    Search search;
+    search.limits = limits;
+    search.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(limits.maxMillis);
+    std::vector<std::future<void>> workers;
+    for (std::size_t i = 0; i < threadCount; i++) {
+        std::uint64_t threadSeed = mixSeed(seed ^ mixSeed(searches * threadCount + i));
+        workers.push_back(pool.submit([this, &search, threadSeed]() { runSearch(search, threadSeed); }));
+    }
+    for (auto& worker : workers) {
+        worker.get();
+    }
+    searches++;
+
+    // The most visited move is the most robust choice
+    const Node* best = nullptr;
+    for (const auto& child : root->children) {
+        if (best == nullptr || child->visits > best->visits ||
+            (child->visits == best->visits && child->halfPoints > best->halfPoints)) {
+            best = child.get();
+        }
+    }
+    if (best == nullptr) {
+        return false;
+    }
+    result.row = best->move / position.cols();
+    result.col = best->move % position.cols();
+    result.iterations = search.completed.load();
+    std::uint32_t visits = best->visits.load();
+    result.expectedScore = visits ? static_cast<double>(best->halfPoints.load()) / (2.0 * visits) : 0.0;
+    return true;
+}
+
+void MctsEngine::runSearch(Search& search, std::uint64_t threadSeed) {
+    Random random(threadSeed);
+    PlayoutBoard board;
+    std::uint64_t local = 0;
+
+    while (!search.stop.load(std::memory_order_relaxed)) {
+        if (search.limits.maxIterations != 0 &&
+            search.started.fetch_add(1, std::memory_order_relaxed) >= search.limits.maxIterations) {
+            break;
+        }
+        // Reading the clock every iteration would cost more than a small playout
+        if (search.limits.maxMillis > 0 && (local++ & 31) == 0 &&
+            std::chrono::steady_clock::now() >= search.deadline) {
+            search.stop = true;
+            break;
+        }
+
+        board = rootBoard;
+        Node* node = root.get();
+        char toMove = rootPlayer;
+        int outcome;
+
+        // Selection and expansion
+        while (true) {
+            if (node->terminal != NOT_TERMINAL) {
+                outcome = node->terminal;
+                break;
+            }
+
+            Node* next = nullptr;
+            bool expanded = false;
+            {
+                std::lock_guard<std::mutex> lock(node->mutex);
+                int cells = board.cellCount();
+                while (node->scanned < cells) {
+                    int cell = (node->expandOffset + node->scanned) % cells;
+                    node->scanned++;
+                    if (!board.isEmpty(cell)) {
+                        continue;
+                    }
+                    auto child = std::make_unique<Node>(node, cell, toMove, random.below(cells));
+                    if (board.play(cell, toMove)) {
+                        child->terminal = WIN;
+                    } else if (board.emptyCount() == 0) {
+                        child->terminal = TIE;
+                    }
+                    next = child.get();
+                    node->children.push_back(std::move(child));
+                    expanded = true;
+                    break;
+                }
+
+                if (next == nullptr) {
+                    double parentVisits = node->visits.load() + node->virtualLoss.load();
+                    double logParent = std::log(parentVisits > 1 ? parentVisits : 1.0);
+                    double bestValue = -1.0;
+                    for (const auto& child : node->children) {
+                        double visits = child->visits.load() + child->virtualLoss.load();
+                        // Virtual losses count as visits that scored nothing
+                        double value = visits == 0
+                                           ? 1e9
+                                           : child->halfPoints.load() / (2.0 * visits) +
+                                                 exploration * std::sqrt(logParent / visits);
+                        if (value > bestValue) {
+                            bestValue = value;
+                            next = child.get();
+                        }
+                    }
+                    if (next != nullptr) {
+                        board.play(next->move, toMove);
+                    }
+                }
+            }
+            // Leaving here rather than inside the lock keeps outcome set on every way out
+            if (next == nullptr) {
+                outcome = TIE;   // unreachable: a full board is always terminal
+                break;
+            }
+
+            next->virtualLoss++;
+            node = next;
+            toMove = PlayoutBoard::opponent(toMove);
+            if (expanded) {
+                outcome = node->terminal != NOT_TERMINAL
+                              ? node->terminal
+                              : randomPlayout(board, toMove, node->player, random);
+                break;
+            }
+        }
+
+        // Backpropagation, flipping the outcome at each level
+        for (Node* n = node; n != nullptr; n = n->parent) {
+            n->visits++;
+            n->halfPoints += static_cast<std::uint64_t>(outcome);
+            if (n->parent != nullptr) {
+                n->virtualLoss--;
+            }
+            outcome = WIN - outcome;
+        }
+        search.completed++;
+    }
+}
@@ -0,0 +1,213 @@
+#include "Metrics.h"
+
+namespace {
+
+const int METRIC_COUNT = MetricsSnapshot::METRIC_COUNT;
+// Prometheus buckets sit on powers of two from 256ns to about 69s
+const int FIRST_EXPORTED_BIT = 8;
+const int LAST_EXPORTED_BIT = 36;
+
+int highestBit(std::uint64_t value) {
+    int bit = 0;
+    while (value >>= 1) {
+        bit++;
+    }
+    return bit;
+}
+
+}  // namespace
+
+int LatencyHistogram::bucketFor(std::uint64_t nanos) {
+    const std::uint64_t LIMIT = (std::uint64_t(1) << MAX_BITS) - 1;
+    if (nanos > LIMIT) {
+        nanos = LIMIT;
+    }
+    if (nanos < static_cast<std::uint64_t>(SUB_BUCKETS)) {
+        return static_cast<int>(nanos);
+    }
+    int shift = highestBit(nanos) - SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKETS + static_cast<int>((nanos >> shift) & (SUB_BUCKETS - 1));
+}
+
+std::uint64_t LatencyHistogram::lowerBound(int bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return static_cast<std::uint64_t>(bucket);
+    }
+    int shift = bucket / SUB_BUCKETS - 1;
+    return static_cast<std::uint64_t>(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+}
+
+std::uint64_t LatencyHistogram::upperBound(int bucket) {
+    int shift = bucket < SUB_BUCKETS ? 0 : bucket / SUB_BUCKETS - 1;
+    return lowerBound(bucket) + (std::uint64_t(1) << shift);
+}
+
+std::uint64_t MetricSnapshot::percentile(double q) const {
+    if (timed == 0 || buckets.empty()) {
+        return 0;
+    }
+    q = q < 0.0 ? 0.0 : (q > 1.0 ? 1.0 : q);
+    std::uint64_t target = static_cast<std::uint64_t>(q * static_cast<double>(timed) + 0.5);
+    if (target == 0) {
+        target = 1;
+    }
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < buckets.size(); i++) {
+        seen += buckets[i];
+        if (seen >= target) {
+            return LatencyHistogram::upperBound(static_cast<int>(i));
+        }
+    }
+    return LatencyHistogram::upperBound(static_cast<int>(buckets.size()) - 1);
+}
+
+MetricsRegistry::ThreadBlock::ThreadBlock() {
+    for (int m = 0; m < METRIC_COUNT; m++) {
+        calls[m].store(0, std::memory_order_relaxed);
+        timed[m].store(0, std::memory_order_relaxed);
+        totalNanos[m].store(0, std::memory_order_relaxed);
+        for (auto& bucket : buckets[m]) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+// Hands the thread's block back when the thread exits
+struct MetricsRegistry::ThreadSlot {
+    ThreadBlock* block = nullptr;
+    ~ThreadSlot() {
+        if (block != nullptr) {
+            MetricsRegistry::shared().releaseBlock(block);
+        }
+    }
+};
+
+MetricsRegistry& MetricsRegistry::shared() {
+    static MetricsRegistry instance;
+    return instance;
+}
+
+const char* MetricsRegistry::name(Metric metric) {
+    switch (metric) {
+        case Metric::MAKE_MOVE: return "make_move";
+        case Metric::CHECK_WIN: return "check_win";
+        case Metric::AI_SEARCH: return "ai_search";
+        case Metric::SAVE_HISTORY: return "save_history";
+        case Metric::LOAD_HISTORY: return "load_history";
+        case Metric::SAVE_USERS: return "save_users";
+        case Metric::LOAD_USERS: return "load_users";
+    }
+    return "unknown";
+}
+
+MetricsRegistry::ThreadBlock& MetricsRegistry::attachThread() {
+    thread_local ThreadSlot slot;
+    slot.block = shared().claimBlock();
+    current = slot.block;
+    return *current;
+}
+
+MetricsRegistry::ThreadBlock* MetricsRegistry::claimBlock() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!idle.empty()) {
+        ThreadBlock* block = idle.back();
+        idle.pop_back();
+        return block;
+    }
+    blocks.push_back(std::make_unique<ThreadBlock>());
+    return blocks.back().get();
+}
+
+void MetricsRegistry::releaseBlock(ThreadBlock* block) {
+    std::lock_guard<std::mutex> lock(mutex);
+    idle.push_back(block);
+}
+
+void MetricsRegistry::count(Metric metric) {
+    bump(localBlock().calls[static_cast<int>(metric)], 1);
+}
+
+void MetricsRegistry::record(Metric metric, std::uint64_t nanos) {
+    recordInto(localBlock(), static_cast<int>(metric), nanos);
+}
+
+void MetricsRegistry::recordInto(ThreadBlock& block, int m, std::uint64_t nanos) {
+    bump(block.calls[m], 1);
+    bump(block.timed[m], 1);
+    bump(block.totalNanos[m], nanos);
+    bump(block.buckets[m][LatencyHistogram::bucketFor(nanos)], 1);
+}
+
+bool MetricsRegistry::sampleThisCall() {
+    ThreadBlock& block = localBlock();
+    return block.sampleTick++ % SAMPLE_PERIOD == 0;
+}
+
+MetricsSnapshot MetricsRegistry::snapshot() const {
+    MetricsSnapshot result;
+    for (auto& metric : result.metrics) {
+        metric.buckets.assign(LatencyHistogram::BUCKET_COUNT, 0);
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& block : blocks) {
+        for (int m = 0; m < METRIC_COUNT; m++) {
+            MetricSnapshot& metric = result.metrics[m];
+            metric.calls += block->calls[m].load(std::memory_order_relaxed);
+            metric.timed += block->timed[m].load(std::memory_order_relaxed);
+            metric.totalNanos += block->totalNanos[m].load(std::memory_order_relaxed);
+            for (int b = 0; b < LatencyHistogram::BUCKET_COUNT; b++) {
+                metric.buckets[b] += block->buckets[m][b].load(std::memory_order_relaxed);
+            }
+        }
+    }
+    return result;
+}
+
+void MetricsRegistry::writePrometheus(std::ostream& out) const {
+    MetricsSnapshot totals = snapshot();
+
+    out << "# HELP game_core_operations_total Instrumented calls per operation.\n"
+        << "# TYPE game_core_operations_total counter\n";
+    for (int m = 0; m < METRIC_COUNT; m++) {
+        out << "game_core_operations_total{operation=\"" << name(static_cast<Metric>(m)) << "\"} "
+            << totals.metrics[m].calls << "\n";
+    }
+
+    out << "# HELP game_core_operation_latency_seconds Latency of timed calls per operation.\n"
+        << "# TYPE game_core_operation_latency_seconds histogram\n";
+    for (int m = 0; m < METRIC_COUNT; m++) {
+        const MetricSnapshot& metric = totals.metrics[m];
+        const char* operation = name(static_cast<Metric>(m));
+        std::uint64_t cumulative = 0;
+        int bucket = 0;
+        for (int bit = FIRST_EXPORTED_BIT; bit <= LAST_EXPORTED_BIT; bit++) {
+            // Buckets below this index hold values under 2^bit ns
+            int end = (bit - LatencyHistogram::SUB_BUCKET_BITS + 1) * LatencyHistogram::SUB_BUCKETS;
+            for (; bucket < end; bucket++) {
+                cumulative += metric.buckets[bucket];
+            }
+            out << "game_core_operation_latency_seconds_bucket{operation=\"" << operation << "\",le=\""
+                << static_cast<double>(std::uint64_t(1) << bit) / 1e9 << "\"} " << cumulative << "\n";
+        }
+        out << "game_core_operation_latency_seconds_bucket{operation=\"" << operation
+            << "\",le=\"+Inf\"} " << metric.timed << "\n"
+            << "game_core_operation_latency_seconds_sum{operation=\"" << operation << "\"} "
+            << static_cast<double>(metric.totalNanos) / 1e9 << "\n"
+            << "game_core_operation_latency_seconds_count{operation=\"" << operation << "\"} "
+            << metric.timed << "\n";
+    }
+}
+
+void MetricsRegistry::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& block : blocks) {
+        for (int m = 0; m < METRIC_COUNT; m++) {
+            block->calls[m].store(0, std::memory_order_relaxed);
+            block->timed[m].store(0, std::memory_order_relaxed);
+            block->totalNanos[m].store(0, std::memory_order_relaxed);
+            for (auto& bucket : block->buckets[m]) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+}
@@ -0,0 +1,107 @@
+#include "MoveCodec.h"
+
+namespace {
+
+const std::uint8_t PLAYER_O_BIT = 0x80;
+const std::uint8_t CELL_MASK = 0x7f;
+
+}  // namespace
+
+bool MoveCodec::packMove(const Move& move, std::uint8_t& packed, int columns) {
+    if (move.row < 0 || move.col < 0 || move.col >= columns ||
+        (move.player != 'X' && move.player != 'O')) {
+        return false;
+    }
+    int cell = move.row * columns + move.col;
+    if (cell >= MAX_CELLS) {
+        return false;
+    }
+    packed = static_cast<std::uint8_t>(cell) | (move.player == 'O' ? PLAYER_O_BIT : 0);
+    return true;
+}
+
+Move MoveCodec::unpackMove(std::uint8_t packed, int columns) {
+    int cell = packed & CELL_MASK;
+    return Move(cell / columns, cell % columns, (packed & PLAYER_O_BIT) ? 'O' : 'X');
+}
+
+void MoveCodec::appendVarint(std::string& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+bool MoveCodec::readVarint(const std::string& in, std::size_t& pos, std::uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= in.size()) {
+            return false;
+        }
+        std::uint8_t byte = static_cast<std::uint8_t>(in[pos++]);
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void MoveCodec::appendSignedVarint(std::string& out, std::int64_t value) {
+    appendVarint(out, (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+}
+
+bool MoveCodec::readSignedVarint(const std::string& in, std::size_t& pos, std::int64_t& value) {
+    std::uint64_t raw;
+    if (!readVarint(in, pos, raw)) {
+        return false;
+    }
+    value = static_cast<std::int64_t>(raw >> 1) ^ -static_cast<std::int64_t>(raw & 1);
+    return true;
+}
+
+bool MoveCodec::encodeMoves(const std::vector<Move>& moves, EpochMillis baseTime, std::string& out,
+                            int columns) {
+    std::size_t start = out.size();
+    appendVarint(out, moves.size());
+    EpochMillis previous = baseTime;
+    for (const auto& move : moves) {
+        std::uint8_t packed;
+        if (!packMove(move, packed, columns)) {
+            out.resize(start);
+            return false;
+        }
+        out += static_cast<char>(packed);
+        // Untimed moves repeat the previous time so their delta costs one byte
+        EpochMillis time = move.time != 0 ? move.time : previous;
+        appendSignedVarint(out, time - previous);
+        previous = time;
+    }
+    return true;
+}
+
+bool MoveCodec::decodeMoves(const std::string& in, std::size_t& pos, EpochMillis baseTime,
+                            std::vector<Move>& moves, int columns) {
+    std::uint64_t count;
+    if (!readVarint(in, pos, count) || count > in.size() - pos) {
+        return false;
+    }
+    moves.clear();
+    moves.reserve(static_cast<std::size_t>(count));
+    EpochMillis previous = baseTime;
+    for (std::uint64_t i = 0; i < count; i++) {
+        if (pos >= in.size()) {
+            return false;
+        }
+        Move move = unpackMove(static_cast<std::uint8_t>(in[pos++]), columns);
+        std::int64_t delta;
+        if (!readSignedVarint(in, pos, delta)) {
+            return false;
+        }
+        previous += delta;
+        move.time = previous;
+        moves.push_back(move);
+    }
+    return true;
+}
@@ -0,0 +1,277 @@
+#include "OpeningBook.h"
+#include "GameReplay.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+const int SIZE = 3;
+const int CELLS = SIZE * SIZE;
+
+enum Outcome { FIRST_PLAYER_WIN, SECOND_PLAYER_WIN, TIE };
+
+// Where a cell lands under each of the board's eight symmetries
+int transformCell(int transform, int cell) {
+    int r = cell / SIZE;
+    int c = cell % SIZE;
+    int last = SIZE - 1;
+    switch (transform) {
+        case 0: return r * SIZE + c;
+        case 1: return c * SIZE + (last - r);            // rotate 90
+        case 2: return (last - r) * SIZE + (last - c);   // rotate 180
+        case 3: return (last - c) * SIZE + r;            // rotate 270
+        case 4: return r * SIZE + (last - c);            // mirror left-right
+        case 5: return (last - r) * SIZE + c;            // mirror top-bottom
+        case 6: return c * SIZE + r;                     // main diagonal
+        default: return (last - c) * SIZE + (last - r);  // anti-diagonal
+    }
+}
+
+bool toCells(const std::vector<Move>& moves, std::vector<int>& cells) {
+    cells.clear();
+    for (const auto& move : moves) {
+        if (move.row < 0 || move.row >= SIZE || move.col < 0 || move.col >= SIZE) {
+            return false;
+        }
+        cells.push_back(move.row * SIZE + move.col);
+    }
+    return true;
+}
+
+// Smallest of the eight images of the sequence. Because the comparison is
+// lexicographic, the canonical form of a prefix is a prefix of the canonical
+// form of any longer sequence, which is what lets the trie share nodes.
+std::vector<int> canonicalize(const std::vector<int>& cells) {
+    std::vector<int> best(cells);
+    std::vector<int> image(cells.size());
+    for (int transform = 1; transform < 8; transform++) {
+        for (std::size_t i = 0; i < cells.size(); i++) {
+            image[i] = transformCell(transform, cells[i]);
+        }
+        if (image < best) {
+            best.swap(image);
+            image.resize(cells.size());
+        }
+    }
+    return best;
+}
+
+}  // namespace
+
+OpeningBook::OpeningBook() : nodes(1) {}
+
+bool OpeningBook::addGame(const GameRecord& record) {
+    GameReplay replay(record);
+    if (!replay.isValid() || record.moves.empty()) {
+        return false;
+    }
+
+    // The outcome comes from the final position: a line belongs to whoever moved last
+    int outcome;
+    GameResult result = replay.finalResult();
+    if (result == GameResult::TIE) {
+        outcome = TIE;
+    } else if (result == GameResult::ONGOING) {
+        return false;
+    } else {
+        outcome = (record.moves.size() % 2 == 1) ? FIRST_PLAYER_WIN : SECOND_PLAYER_WIN;
+    }
+
+    std::vector<int> cells;
+    toCells(record.moves, cells);
+    std::vector<int> canonical = canonicalize(cells);
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    insertLocked(canonical, outcome);
+    return true;
+}
+
+void OpeningBook::insertLocked(const std::vector<int>& canonical, int outcome) {
+    std::uint32_t node = 0;
+    for (std::size_t depth = 0;; depth++) {
+        Node& current = nodes[node];
+        if (outcome == FIRST_PLAYER_WIN) {
+            current.firstPlayerWins++;
+        } else if (outcome == SECOND_PLAYER_WIN) {
+            current.secondPlayerWins++;
+        } else {
+            current.ties++;
+        }
+        if (depth == canonical.size()) {
+            return;
+        }
+
+        int cell = canonical[depth];
+        std::uint32_t child = nodes[node].children[cell];
+        if (child == NO_CHILD) {
+            child = static_cast<std::uint32_t>(nodes.size());
+            nodes[node].children[cell] = child;
+            nodes.emplace_back();   // may reallocate, so no references are held across it
+        }
+        node = child;
+    }
+}
+
+void OpeningBook::build(const std::vector<GameRecord>& records, std::size_t threadCount) {
+    ThreadPool pool(threadCount);
+    std::size_t chunks = std::max<std::size_t>(1, std::min(records.size(), pool.size()));
+    std::size_t chunkSize = (records.size() + chunks - 1) / chunks;
+
+    // Each worker fills a private trie; the partial tries are merged at the end
+    std::vector<std::unique_ptr<OpeningBook>> partials;
+    std::vector<std::future<void>> pending;
+    for (std::size_t begin = 0; begin < records.size(); begin += chunkSize) {
+        std::size_t end = std::min(records.size(), begin + chunkSize);
+        partials.push_back(std::make_unique<OpeningBook>());
+        OpeningBook* partial = partials.back().get();
+        pending.push_back(pool.submit([&records, partial, begin, end]() {
+            for (std::size_t i = begin; i < end; i++) {
+                partial->addGame(records[i]);
+            }
+        }));
+    }
+    for (auto& done : pending) {
+        done.get();
+    }
+
+    OpeningBook merged;
+    for (const auto& partial : partials) {
+        merged.mergeLocked(0, *partial, 0);
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    nodes.swap(merged.nodes);
+}
+
+void OpeningBook::mergeLocked(std::uint32_t target, const OpeningBook& source, std::uint32_t from) {
+    const Node& incoming = source.nodes[from];
+    nodes[target].firstPlayerWins += incoming.firstPlayerWins;
+    nodes[target].secondPlayerWins += incoming.secondPlayerWins;
+    nodes[target].ties += incoming.ties;
+
+    for (int cell = 0; cell < CELLS; cell++) {
+        std::uint32_t sourceChild = incoming.children[cell];
+        if (sourceChild == NO_CHILD) {
+            continue;
+        }
+        std::uint32_t child = nodes[target].children[cell];
+        if (child == NO_CHILD) {
+            child = static_cast<std::uint32_t>(nodes.size());
+            nodes[target].children[cell] = child;
+            nodes.emplace_back();
+        }
+        mergeLocked(child, source, sourceChild);
+    }
+}
+
+void OpeningBook::clear() {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    nodes.assign(1, Node());
+}
+
+std::uint32_t OpeningBook::findLocked(const std::vector<int>& canonical) const {
+    std::uint32_t node = 0;
+    for (int cell : canonical) {
+        node = nodes[node].children[cell];
+        if (node == NO_CHILD) {
+            return NO_CHILD;
+        }
+    }
+    return node;
+}
+
+OpeningStats OpeningBook::statsOf(std::uint32_t node) const {
+    OpeningStats stats;
+    const Node& current = nodes[node];
+    stats.firstPlayerWins = current.firstPlayerWins;
+    stats.secondPlayerWins = current.secondPlayerWins;
+    stats.ties = current.ties;
+    stats.games = stats.firstPlayerWins + stats.secondPlayerWins + stats.ties;
+    return stats;
+}
+
+OpeningStats OpeningBook::statsAfter(const std::vector<Move>& moves) const {
+    std::vector<int> cells;
+    if (!toCells(moves, cells)) {
+        return OpeningStats();
+    }
+    std::vector<int> canonical = canonicalize(cells);
+
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::uint32_t node = findLocked(canonical);
+    // The root is the only node reachable by an empty sequence
+    if (node == NO_CHILD && !canonical.empty()) {
+        return OpeningStats();
+    }
+    return statsOf(node);
+}
+
+std::vector<OpeningContinuation> OpeningBook::continuations(const std::vector<Move>& moves) const {
+    std::vector<OpeningContinuation> result;
+    std::vector<int> cells;
+    if (!toCells(moves, cells)) {
+        return result;
+    }
+
+    bool taken[CELLS] = {};
+    for (int cell : cells) {
+        taken[cell] = true;
+    }
+    bool firstPlayerMoves = cells.size() % 2 == 0;
+    char player = moves.empty() ? 'X' : (moves.back().player == 'X' ? 'O' : 'X');
+
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    for (int cell = 0; cell < CELLS; cell++) {
+        if (taken[cell]) {
+            continue;
+        }
+        // Canonicalize each extended sequence on its own so moves that are
+        // symmetric in this position all find the shared node
+        cells.push_back(cell);
+        std::uint32_t node = findLocked(canonicalize(cells));
+        cells.pop_back();
+        if (node == NO_CHILD) {
+            continue;
+        }
+
+        OpeningContinuation entry;
+        entry.move = Move(cell / SIZE, cell % SIZE, player);
+        entry.stats = statsOf(node);
+        std::uint64_t wins = firstPlayerMoves ? entry.stats.firstPlayerWins : entry.stats.secondPlayerWins;
+        entry.score = (static_cast<double>(wins) + 0.5 * static_cast<double>(entry.stats.ties)) /
+                      static_cast<double>(entry.stats.games);
+        result.push_back(entry);
+    }
+
+    std::stable_sort(result.begin(), result.end(),
+                     [](const OpeningContinuation& a, const OpeningContinuation& b) {
+                         if (a.score != b.score) {
+                             return a.score > b.score;
+                         }
+                         return a.stats.games > b.stats.games;
+                     });
+    return result;
+}
+
+bool OpeningBook::bestMove(const std::vector<Move>& moves, Move& move, std::uint64_t minGames) const {
+    for (const auto& entry : continuations(moves)) {
+        if (entry.stats.games >= minGames) {
+            move = entry.move;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::size_t OpeningBook::nodeCount() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return nodes.size();
+}
+
+std::uint64_t OpeningBook::gameCount() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return statsOf(0).games;
+}
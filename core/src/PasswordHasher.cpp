@@ -0,0 +1,299 @@
+#include "PasswordHasher.h"
+#include "Sha256.h"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+const char* const SCHEME = "$balloon-sha256$";
+const char* const OPAQUE_SCHEME = "$sha256$";
+const std::size_t SALT_BYTES = PasswordDigest::SALT_BYTES;
+const int DELTA = 3;  // random blocks mixed into each block per round
+
+void hashCounter(Sha256& sha, std::uint64_t counter) {
+    std::uint8_t bytes[8];
+    for (int i = 0; i < 8; i++) {
+        bytes[i] = static_cast<std::uint8_t>(counter >> (8 * i));
+    }
+    sha.update(bytes, sizeof(bytes));
+}
+
+std::string randomSalt() {
+    std::random_device device;
+    std::string salt(SALT_BYTES, '\0');
+    for (auto& byte : salt) {
+        byte = static_cast<char>(device() & 0xff);
+    }
+    return salt;
+}
+
+bool fromHex(const std::string& hex, std::string& bytes) {
+    if (hex.size() % 2 != 0) {
+        return false;
+    }
+    bytes.clear();
+    for (std::size_t i = 0; i < hex.size(); i += 2) {
+        int value = 0;
+        for (std::size_t j = i; j < i + 2; j++) {
+            char c = hex[j];
+            value <<= 4;
+            if (c >= '0' && c <= '9') {
+                value |= c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                value |= c - 'a' + 10;
+            } else {
+                return false;
+            }
+        }
+        bytes.push_back(static_cast<char>(value));
+    }
+    return true;
+}
+
+bool parseEncoded(const std::string& encoded, PasswordHasher::Params& params, std::string& salt,
+                  std::string& hash) {
+    std::string scheme(SCHEME);
+    if (encoded.compare(0, scheme.size(), scheme) != 0) {
+        return false;
+    }
+
+    std::istringstream iss(encoded.substr(scheme.size()));
+    std::string paramStr, saltHex, hashHex;
+    if (!std::getline(iss, paramStr, '$') || !std::getline(iss, saltHex, '$') ||
+        !std::getline(iss, hashHex)) {
+        return false;
+    }
+
+    unsigned long space = 0, time = 0;
+    if (std::sscanf(paramStr.c_str(), "s=%lu,t=%lu", &space, &time) != 2 ||
+        space > PasswordHasher::MAX_SPACE_COST || time > PasswordHasher::MAX_TIME_COST) {
+        return false;
+    }
+    params = PasswordHasher::Params(static_cast<std::uint32_t>(space),
+                                    static_cast<std::uint32_t>(time));
+    if (!PasswordHasher::validParams(params)) {
+        return false;
+    }
+    return fromHex(saltHex, salt) && fromHex(hashHex, hash);
+}
+
+template <std::size_t N>
+bool copyBytes(const std::string& bytes, std::array<std::uint8_t, N>& out) {
+    if (bytes.size() != N) {
+        return false;
+    }
+    std::copy(bytes.begin(), bytes.end(), out.begin());
+    return true;
+}
+
+template <std::size_t N>
+void diffBytes(const std::array<std::uint8_t, N>& a, const std::array<std::uint8_t, N>& b,
+               unsigned char& diff) {
+    for (std::size_t i = 0; i < N; i++) {
+        diff |= a[i] ^ b[i];
+    }
+}
+
+PasswordDigest opaqueDigest(const std::string& credential) {
+    PasswordDigest digest;
+    digest.kind = PasswordDigest::Kind::OPAQUE;
+    digest.hash = Sha256::hash(credential);
+    return digest;
+}
+
+}  // namespace
+
+bool PasswordHasher::validParams(const Params& params) {
+    return params.spaceCost >= 1 && params.spaceCost <= MAX_SPACE_COST && params.timeCost >= 1 &&
+           params.timeCost <= MAX_TIME_COST;
+}
+
+std::string PasswordHasher::derive(const std::string& password, const std::string& salt,
+                                   const Params& params) {
+    if (!validParams(params)) {
+        return std::string();
+    }
+    const std::uint32_t space = params.spaceCost;
+    std::vector<Sha256::Digest> buffer(space);
+    std::uint64_t counter = 0;
+
+    // Expand: fill the buffer with a hash chain seeded by password and salt
+    Sha256 first;
+    hashCounter(first, counter++);
+    first.update(password);
+    first.update(salt);
+    buffer[0] = first.finish();
+    for (std::uint32_t m = 1; m < space; m++) {
+        Sha256 sha;
+        hashCounter(sha, counter++);
+        sha.update(buffer[m - 1].data(), buffer[m - 1].size());
+        buffer[m] = sha.finish();
+    }
+
+    // Mix: each block absorbs its predecessor and DELTA pseudo-randomly chosen blocks
+    for (std::uint32_t t = 0; t < params.timeCost; t++) {
+        for (std::uint32_t m = 0; m < space; m++) {
+            const Sha256::Digest& previous = buffer[(m + space - 1) % space];
+            Sha256 sha;
+            hashCounter(sha, counter++);
+            sha.update(previous.data(), previous.size());
+            sha.update(buffer[m].data(), buffer[m].size());
+            buffer[m] = sha.finish();
+
+            for (int i = 0; i < DELTA; i++) {
+                Sha256 indexSha;
+                hashCounter(indexSha, t);
+                hashCounter(indexSha, m);
+                hashCounter(indexSha, static_cast<std::uint64_t>(i));
+                Sha256::Digest indexBlock = indexSha.finish();
+
+                Sha256 pick;
+                hashCounter(pick, counter++);
+                pick.update(salt);
+                pick.update(indexBlock.data(), indexBlock.size());
+                Sha256::Digest picked = pick.finish();
+                std::uint64_t other = 0;
+                for (int b = 0; b < 8; b++) {
+                    other |= static_cast<std::uint64_t>(picked[b]) << (8 * b);
+                }
+                other %= space;
+
+                Sha256 mix;
+                hashCounter(mix, counter++);
+                mix.update(buffer[m].data(), buffer[m].size());
+                mix.update(buffer[other].data(), buffer[other].size());
+                buffer[m] = mix.finish();
+            }
+        }
+    }
+
+    const Sha256::Digest& last = buffer[space - 1];
+    return std::string(reinterpret_cast<const char*>(last.data()), last.size());
+}
+
+std::string PasswordHasher::hashPassword(const std::string& password, const Params& params) {
+    if (!validParams(params)) {
+        return std::string();
+    }
+    std::string salt = randomSalt();
+    PasswordDigest digest;
+    digest.kind = PasswordDigest::Kind::BALLOON;
+    digest.params = params;
+    copyBytes(salt, digest.salt);
+    copyBytes(derive(password, salt, params), digest.hash);
+    return digest.toString();
+}
+
+bool PasswordHasher::verifyPassword(const std::string& password, const std::string& encoded) {
+    Params params;
+    std::string salt, expected;
+    if (!parseEncoded(encoded, params, salt, expected)) {
+        return false;
+    }
+    return constantTimeEquals(derive(password, salt, params), expected);
+}
+
+bool PasswordHasher::isEncodedHash(const std::string& value) {
+    Params params;
+    std::string salt, hash;
+    return parseEncoded(value, params, salt, hash);
+}
+
+bool PasswordHasher::constantTimeEquals(const std::string& a, const std::string& b) {
+    // Only the length is allowed to leak; the content comparison never exits early
+    unsigned char diff = (a.size() == b.size()) ? 0 : 1;
+    std::size_t length = std::max(a.size(), b.size());
+    for (std::size_t i = 0; i < length; i++) {
+        unsigned char x = (i < a.size()) ? static_cast<unsigned char>(a[i]) : 0;
+        unsigned char y = (i < b.size()) ? static_cast<unsigned char>(b[i]) : 0;
+        diff |= x ^ y;
+    }
+    return diff == 0;
+}
+
+PasswordDigest PasswordDigest::fromCredential(const std::string& credential) {
+    PasswordHasher::Params encodedParams;
+    std::string saltBytes, hashBytes;
+    PasswordDigest digest;
+    if (parseEncoded(credential, encodedParams, saltBytes, hashBytes) &&
+        copyBytes(saltBytes, digest.salt) && copyBytes(hashBytes, digest.hash)) {
+        digest.kind = Kind::BALLOON;
+        digest.params = encodedParams;
+        return digest;
+    }
+    // Includes Balloon hashes whose salt or digest has another size
+    return opaqueDigest(credential);
+}
+
+PasswordDigest PasswordDigest::fromStored(const std::string& stored) {
+    std::string scheme(OPAQUE_SCHEME);
+    std::string hashBytes;
+    PasswordDigest digest;
+    if (stored.compare(0, scheme.size(), scheme) == 0 &&
+        fromHex(stored.substr(scheme.size()), hashBytes) && copyBytes(hashBytes, digest.hash)) {
+        digest.kind = Kind::OPAQUE;
+        return digest;
+    }
+    return fromCredential(stored);
+}
+
+std::string PasswordDigest::toString() const {
+    std::ostringstream oss;
+    if (kind == Kind::BALLOON) {
+        oss << SCHEME << "s=" << params.spaceCost << ",t=" << params.timeCost << "$"
+            << Sha256::toHex(salt.data(), salt.size()) << "$";
+    } else if (kind == Kind::OPAQUE) {
+        oss << OPAQUE_SCHEME;
+    } else {
+        return std::string();
+    }
+    oss << Sha256::toHex(hash.data(), hash.size());
+    return oss.str();
+}
+
+bool PasswordDigest::matches(const std::string& credential) const {
+    PasswordDigest other = fromCredential(credential);
+    unsigned char diff = (kind != Kind::NONE && other.kind == kind &&
+                          other.params.spaceCost == params.spaceCost &&
+                          other.params.timeCost == params.timeCost) ? 0 : 1;
+    diffBytes(salt, other.salt, diff);
+    diffBytes(hash, other.hash, diff);
+    return diff == 0;
+}
+
+bool PasswordDigest::verify(const std::string& password) const {
+    if (kind != Kind::BALLOON) {
+        return false;
+    }
+    std::string derived =
+        PasswordHasher::derive(password, std::string(salt.begin(), salt.end()), params);
+    return PasswordHasher::constantTimeEquals(derived, std::string(hash.begin(), hash.end()));
+}
+
+AsyncPasswordHasher::AsyncPasswordHasher(std::size_t threadCount,
+                                         const PasswordHasher::Params& params)
+    : params(params), pool(threadCount) {}
+
+std::future<std::string> AsyncPasswordHasher::hashAsync(const std::string& password) {
+    PasswordHasher::Params taskParams = params;
+    return pool.submit([password, taskParams]() {
+        return PasswordHasher::hashPassword(password, taskParams);
+    });
+}
+
+std::future<bool> AsyncPasswordHasher::verifyAsync(const std::string& password,
+                                                   const std::string& encoded) {
+    return pool.submit([password, encoded]() {
+        return PasswordHasher::verifyPassword(password, encoded);
+    });
+}
+
+std::future<bool> AsyncPasswordHasher::verifyAsync(const std::string& password,
+                                                   const PasswordDigest& digest) {
+    return pool.submit([password, digest]() {
+        return digest.verify(password);
+    });
+}
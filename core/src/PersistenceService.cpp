@@ -0,0 +1,229 @@
+#include "PersistenceService.h"
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// What one batch leaves in one file
+struct FileWrite {
+    std::string path;
+    bool replace = false;
+    std::string data;
+    // Produces data when the file is written; only the last replace's is kept
+    std::function<std::string()> snapshot;
+    bool ok = false;
+};
+
+// Writes data to path and does not return true before it is on disk
+bool writeDurably(const std::string& path, const std::string& data, bool append) {
+#ifdef _WIN32
+    std::ofstream file(path, (append ? std::ios::app : std::ios::trunc) | std::ios::binary);
+    file << data;
+    file.close();
+    return static_cast<bool>(file);
+#else
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC), 0644);
+    if (fd < 0) {
+        return false;
+    }
+    const char* next = data.data();
+    std::size_t left = data.size();
+    while (left > 0) {
+        ssize_t written = ::write(fd, next, left);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ::close(fd);
+            return false;
+        }
+        next += written;
+        left -= static_cast<std::size_t>(written);
+    }
+    bool synced = ::fsync(fd) == 0;
+    return ::close(fd) == 0 && synced;
+#endif
+}
+
+// A rename only survives a crash once the directory holding it is synced too
+bool syncDirectoryOf(const std::string& path) {
+#ifdef _WIN32
+    (void)path;
+    return true;
+#else
+    std::size_t slash = path.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int fd = ::open(directory.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+#endif
+}
+
+bool writeFile(const FileWrite& write) {
+    if (!write.replace) {
+        return writeDurably(write.path, write.data, true);
+    }
+    std::string temporary = write.path + ".tmp";
+    if (!writeDurably(temporary, write.data, false)) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return std::rename(temporary.c_str(), write.path.c_str()) == 0 && syncDirectoryOf(write.path);
+}
+
+}  // namespace
+
+PersistenceService::PersistenceService()
+    : sleeping(false), stopping(false), batches(0), files(0), failedSinceBarrier(false) {
+    writer = std::thread([this]() { run(); });
+}
+
+PersistenceService::~PersistenceService() {
+    stopping = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sleeping = false;
+    }
+    wake.notify_one();
+    writer.join();
+}
+
+std::future<bool> PersistenceService::append(const std::string& path, std::string data) {
+    return submit(JobType::APPEND, path, std::move(data));
+}
+
+std::future<bool> PersistenceService::replace(const std::string& path, std::string data) {
+    return submit(JobType::REPLACE, path, std::move(data));
+}
+
+std::future<bool> PersistenceService::replaceWith(const std::string& path,
+                                                  std::function<std::string()> snapshot) {
+    return submit(JobType::REPLACE, path, std::string(), std::move(snapshot));
+}
+
+std::future<bool> PersistenceService::flush() {
+    return submit(JobType::BARRIER, std::string(), std::string());
+}
+
+std::future<bool> PersistenceService::flush(const std::string& path) {
+    return submit(JobType::BARRIER, path, std::string());
+}
+
+std::future<bool> PersistenceService::submit(JobType type, const std::string& path, std::string data,
+                                             std::function<std::string()> snapshot) {
+    Job job;
+    job.type = type;
+    job.path = path;
+    job.data = std::move(data);
+    job.snapshot = std::move(snapshot);
+    job.done = std::make_shared<std::promise<bool>>();
+    std::future<bool> future = job.done->get_future();
+    queue.push(std::move(job));
+    // Only a writer that announced it is going to sleep needs the lock and a notify
+    if (sleeping.exchange(false)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        wake.notify_one();
+    }
+    return future;
+}
+
+void PersistenceService::run() {
+    std::vector<Job> batch;
+    Job job;
+    while (true) {
+        while (queue.pop(job)) {
+            batch.push_back(std::move(job));
+        }
+        if (!batch.empty()) {
+            writeBatch(batch);
+            batch.clear();
+            continue;
+        }
+
+        sleeping = true;
+        // A push that landed after the drain but before the flag was set is caught here
+        if (queue.pop(job)) {
+            sleeping = false;
+            batch.push_back(std::move(job));
+            continue;
+        }
+        if (stopping) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [this]() { return !sleeping || stopping; });
+    }
+}
+
+void PersistenceService::writeBatch(std::vector<Job>& batch) {
+    std::vector<FileWrite> pending;
+    std::vector<std::size_t> target(batch.size(), 0);
+    for (std::size_t i = 0; i < batch.size(); i++) {
+        Job& job = batch[i];
+        if (job.type == JobType::BARRIER) {
+            continue;
+        }
+        std::size_t index = 0;
+        while (index < pending.size() && pending[index].path != job.path) {
+            index++;
+        }
+        if (index == pending.size()) {
+            pending.emplace_back();
+            pending.back().path = job.path;
+        }
+        FileWrite& write = pending[index];
+        if (job.type == JobType::REPLACE) {
+            write.replace = true;
+            write.data = std::move(job.data);
+            write.snapshot = std::move(job.snapshot);
+        } else {
+            // An append lands after the replace it follows, so that one is taken now
+            if (write.snapshot) {
+                write.data = write.snapshot();
+                write.snapshot = nullptr;
+            }
+            write.data += job.data;
+        }
+        target[i] = index;
+    }
+
+    for (auto& write : pending) {
+        if (write.snapshot) {
+            write.data = write.snapshot();
+        }
+        write.ok = writeFile(write);
+        // A whole new copy repairs whatever earlier failures left out
+        if (!write.ok) {
+            damagedPaths.insert(write.path);
+        } else if (write.replace) {
+            damagedPaths.erase(write.path);
+        }
+    }
+    batches.fetch_add(1, std::memory_order_relaxed);
+    files.fetch_add(pending.size(), std::memory_order_relaxed);
+
+    for (std::size_t i = 0; i < batch.size(); i++) {
+        Job& job = batch[i];
+        if (job.type == JobType::BARRIER && !job.path.empty()) {
+            job.done->set_value(damagedPaths.count(job.path) == 0);
+            continue;
+        }
+        if (job.type == JobType::BARRIER) {
+            job.done->set_value(!failedSinceBarrier);
+            failedSinceBarrier = false;
+            continue;
+        }
+        bool ok = pending[target[i]].ok;
+        failedSinceBarrier = failedSinceBarrier || !ok;
+        job.done->set_value(ok);
+    }
+}
@@ -0,0 +1,78 @@
+#include "PlayoutBoard.h"
+
+PlayoutBoard::PlayoutBoard() : PlayoutBoard(GameBoard()) {}
+
+PlayoutBoard::PlayoutBoard(const GameBoard& board)
+    : rowCount(board.getRows()), colCount(board.getCols()), lineLength(board.getWinLength()), empties(0) {
+    if (!fits(board)) {
+        rowCount = 0;
+        colCount = 0;
+        return;
+    }
+    for (int r = 0; r < rowCount; r++) {
+        for (int c = 0; c < colCount; c++) {
+            int index = r * colCount + c;
+            cells[index] = board.getCell(r, c);
+            if (cells[index] == ' ') {
+                emptySlot[index] = static_cast<std::int16_t>(empties);
+                emptyList[empties++] = static_cast<std::int16_t>(index);
+            }
+        }
+    }
+}
+
+bool PlayoutBoard::fits(const GameBoard& board) {
+    return board.getRows() * board.getCols() <= MAX_CELLS;
+}
+
+bool PlayoutBoard::play(int index, char player) {
+    cells[index] = player;
+    // Swap the last empty cell into the freed slot
+    int slot = emptySlot[index];
+    int last = emptyList[--empties];
+    emptyList[slot] = static_cast<std::int16_t>(last);
+    emptySlot[last] = static_cast<std::int16_t>(slot);
+    return makesLine(index);
+}
+
+void PlayoutBoard::undo(int index) {
+    cells[index] = ' ';
+    emptySlot[index] = static_cast<std::int16_t>(empties);
+    emptyList[empties++] = static_cast<std::int16_t>(index);
+}
+
+bool PlayoutBoard::makesLine(int index) const {
+    const int DIRECTIONS[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+    char player = cells[index];
+    if (player == ' ') {
+        return false;
+    }
+    int row = index / colCount;
+    int col = index % colCount;
+    for (const auto& direction : DIRECTIONS) {
+        int run = 1;
+        for (int sign = -1; sign <= 1; sign += 2) {
+            int r = row + sign * direction[0];
+            int c = col + sign * direction[1];
+            while (r >= 0 && r < rowCount && c >= 0 && c < colCount &&
+                   cells[r * colCount + c] == player) {
+                run++;
+                r += sign * direction[0];
+                c += sign * direction[1];
+            }
+        }
+        if (run >= lineLength) {
+            return true;
+        }
+    }
+    return false;
+}
+
+GameResult PlayoutBoard::result() const {
+    for (int index = 0; index < cellCount(); index++) {
+        if (makesLine(index)) {
+            return (cells[index] == 'X') ? GameResult::PLAYER1_WIN : GameResult::PLAYER2_WIN;
+        }
+    }
+    return empties == 0 ? GameResult::TIE : GameResult::ONGOING;
+}
@@ -0,0 +1,555 @@
+#include "PositionDatabase.h"
+#include "AlphaBetaEngine.h"
+#include "LineEvaluator.h"
+#include "PlayoutBoard.h"
+#include "Random.h"
+#include <algorithm>
+#include <fstream>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char FILE_MAGIC[8] = {'T', 'T', 'T', 'P', 'O', 'S', 'D', '2'};
+// Files without heuristic entries, read the same way
+const char FIRST_VERSION = '1';
+const std::size_t HEADER_SIZE = 64;
+const std::uint64_t EMPTY_SLOT = ~0ULL;
+const int NO_MOVE = 127;
+const int MAX_PACKED_DEPTH = 63;
+const std::uint16_t HEURISTIC_BIT = 1u << 15;
+// A bucket whose keys find no free slots within this many seeds fails the build
+const std::uint32_t MAX_SEED = 1u << 24;
+
+std::uint16_t packEntry(PositionValue value, int move, int depth, bool heuristic = false) {
+    return static_cast<std::uint16_t>(static_cast<int>(value) | (move << 2) |
+                                      (std::min(depth, MAX_PACKED_DEPTH) << 9) |
+                                      (heuristic ? HEURISTIC_BIT : 0));
+}
+
+PositionValue valueOf(std::uint16_t packed) {
+    return static_cast<PositionValue>(packed & 3);
+}
+
+int moveOf(std::uint16_t packed) {
+    return (packed >> 2) & 0x7F;
+}
+
+int depthOf(std::uint16_t packed) {
+    return (packed >> 9) & MAX_PACKED_DEPTH;
+}
+
+bool isHeuristic(std::uint16_t packed) {
+    return (packed & HEURISTIC_BIT) != 0;
+}
+
+// Proven wins first and proven losses last, estimates in between; an
+// estimated draw may hide a loss, so a proven one is preferred
+int rankOf(PositionValue value, bool heuristic) {
+    switch (value) {
+    case PositionValue::WIN:
+        return heuristic ? 4 : 5;
+    case PositionValue::DRAW:
+        return heuristic ? 2 : 3;
+    default:
+        return heuristic ? 1 : 0;
+    }
+}
+
+void appendFixed(std::string& out, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out += static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+std::uint64_t readFixed(const unsigned char* in, int bytes) {
+    std::uint64_t value = 0;
+    for (int i = bytes - 1; i >= 0; i--) {
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+// Dihedral symmetries of a rows x cols grid that keep its shape
+std::vector<std::vector<int>> boardSymmetries(int rows, int cols) {
+    std::vector<std::vector<int>> symmetries;
+    int transforms = (rows == cols) ? 8 : 4;
+    for (int t = 0; t < transforms; t++) {
+        std::vector<int> map(static_cast<std::size_t>(rows * cols));
+        for (int r = 0; r < rows; r++) {
+            for (int c = 0; c < cols; c++) {
+                int row = (t & 1) ? rows - 1 - r : r;
+                int col = (t & 2) ? cols - 1 - c : c;
+                // Square boards add the transposed versions of the first four
+                if (t & 4) {
+                    std::swap(row, col);
+                }
+                map[static_cast<std::size_t>(r * cols + c)] = row * cols + col;
+            }
+        }
+        symmetries.push_back(map);
+    }
+    return symmetries;
+}
+
+// Smallest key over the symmetries, and the symmetry that gives it
+std::uint64_t canonicalKey(std::uint64_t key, const std::vector<std::vector<int>>& symmetries,
+                           std::size_t& symmetry) {
+    std::uint64_t best = EMPTY_SLOT;
+    for (std::size_t s = 0; s < symmetries.size(); s++) {
+        std::uint64_t mapped = 0;
+        for (std::size_t i = 0; i < symmetries[s].size(); i++) {
+            mapped |= ((key >> (2 * i)) & 3) << (2 * symmetries[s][i]);
+        }
+        if (mapped < best) {
+            best = mapped;
+            symmetry = s;
+        }
+    }
+    return best;
+}
+
+// Memoized negamax that visits every reachable position of up to horizon
+// marks; no move is pruned, since each position reached must be written.
+// Positions on the horizon are valued by an AlphaBetaEngine search, which
+// solves them outright on small boards. keys[s] is the current position
+// under symmetry s, kept up to date move by move.
+class Solver {
+public:
+    Solver(const PositionDatabaseConfig& config, const std::vector<std::vector<int>>& symmetries)
+        : board(GameBoard(config.rows, config.cols, config.winLength)),
+          symmetries(symmetries),
+          keys(symmetries.size(), 0),
+          limit(config.maxPositions),
+          exceeded(false),
+          horizon(config.maxDepth) {
+        horizonLimits.maxNodes = config.horizonNodes;
+        // An unproven lead counts as a win once it is worth more than a line one mark short
+        LineEvaluator lines;
+        lines.reshape(config.rows, config.cols, config.winLength);
+        margin = static_cast<int>(lines.weight(config.winLength - 1));
+    }
+
+    bool run() {
+        solve('X');
+        return !exceeded;
+    }
+
+    std::unordered_map<std::uint64_t, std::uint16_t> solved;
+
+private:
+    PlayoutBoard board;
+    const std::vector<std::vector<int>>& symmetries;
+    std::vector<std::uint64_t> keys;
+    std::size_t limit;
+    bool exceeded;
+    int horizon;
+    AlphaBetaEngine engine;
+    SearchLimits horizonLimits;
+    int margin;
+
+    std::uint64_t canonical(std::size_t& symmetry) const {
+        symmetry = 0;
+        for (std::size_t s = 1; s < keys.size(); s++) {
+            if (keys[s] < keys[symmetry]) {
+                symmetry = s;
+            }
+        }
+        return keys[symmetry];
+    }
+
+    void place(int cell, std::uint64_t code) {
+        for (std::size_t s = 0; s < keys.size(); s++) {
+            keys[s] ^= code << (2 * symmetries[s][static_cast<std::size_t>(cell)]);
+        }
+    }
+
+    void remember(std::uint64_t key, std::uint16_t packed) {
+        if (solved.size() >= limit) {
+            exceeded = true;
+            return;
+        }
+        solved.emplace(key, packed);
+    }
+
+    GameBoard position() const {
+        std::vector<std::vector<char>> cells(static_cast<std::size_t>(board.rows()),
+                                             std::vector<char>(static_cast<std::size_t>(board.cols())));
+        for (int cell = 0; cell < board.cellCount(); cell++) {
+            cells[static_cast<std::size_t>(cell / board.cols())][static_cast<std::size_t>(cell % board.cols())] =
+                board.cell(cell);
+        }
+        GameBoard game(board.rows(), board.cols(), board.winLength());
+        game.setBoard(cells);
+        return game;
+    }
+
+    // The position has no line yet and an empty cell
+    std::uint16_t searchHorizon(char toMove, std::size_t symmetry) {
+        SearchResult result;
+        engine.chooseMove(position(), toMove, horizonLimits, result);
+        int move = symmetries[symmetry][static_cast<std::size_t>(result.row * board.cols() + result.col)];
+        if (result.score > AlphaBetaEngine::WIN_THRESHOLD) {
+            return packEntry(PositionValue::WIN, move, AlphaBetaEngine::WIN_SCORE - result.score);
+        }
+        if (result.score < -AlphaBetaEngine::WIN_THRESHOLD) {
+            return packEntry(PositionValue::LOSS, move, AlphaBetaEngine::WIN_SCORE + result.score);
+        }
+        if (result.solved) {
+            // Only a full board is drawn
+            return packEntry(PositionValue::DRAW, move, board.emptyCount());
+        }
+        PositionValue value = (result.score > margin) ? PositionValue::WIN
+                              : (result.score < -margin) ? PositionValue::LOSS : PositionValue::DRAW;
+        return packEntry(value, move, result.depth, true);
+    }
+
+    // The position has no line yet
+    std::uint16_t solve(char toMove) {
+        std::size_t symmetry;
+        std::uint64_t key = canonical(symmetry);
+        auto found = solved.find(key);
+        if (found != solved.end()) {
+            return found->second;
+        }
+        if (board.emptyCount() == 0) {
+            std::uint16_t draw = packEntry(PositionValue::DRAW, NO_MOVE, 0);
+            remember(key, draw);
+            return draw;
+        }
+        if (horizon >= 0 && board.cellCount() - board.emptyCount() >= horizon) {
+            std::uint16_t estimate = searchHorizon(toMove, symmetry);
+            remember(key, estimate);
+            return estimate;
+        }
+
+        std::uint64_t code = (toMove == 'X') ? 1 : 2;
+        char next = PlayoutBoard::opponent(toMove);
+        PositionValue bestValue = PositionValue::LOSS;
+        bool bestHeuristic = false;
+        int bestDepth = -1;
+        int bestCell = -1;
+        bool anyHeuristic = false;
+        for (int cell = 0; cell < board.cellCount() && !exceeded; cell++) {
+            if (!board.isEmpty(cell)) {
+                continue;
+            }
+            place(cell, code);
+            std::uint16_t child;
+            if (board.play(cell, toMove)) {
+                // The opponent faces a finished game
+                child = packEntry(PositionValue::LOSS, NO_MOVE, 0);
+                std::size_t childSymmetry;
+                std::uint64_t childKey = canonical(childSymmetry);
+                if (solved.find(childKey) == solved.end()) {
+                    remember(childKey, child);
+                }
+            } else {
+                child = solve(next);
+            }
+            board.undo(cell);
+            place(cell, code);
+
+            PositionValue value = static_cast<PositionValue>(2 - static_cast<int>(valueOf(child)));
+            bool heuristic = isHeuristic(child);
+            int depth = depthOf(child) + 1;
+            int rank = rankOf(value, heuristic);
+            int bestRank = rankOf(bestValue, bestHeuristic);
+            bool same = rank == bestRank;
+            bool better = bestCell < 0 || rank > bestRank ||
+                          (same && value == PositionValue::WIN && depth < bestDepth) ||
+                          (same && value == PositionValue::LOSS && depth > bestDepth);
+            if (better) {
+                bestValue = value;
+                bestHeuristic = heuristic;
+                bestDepth = depth;
+                bestCell = cell;
+            }
+            anyHeuristic = anyHeuristic || heuristic;
+        }
+        if (exceeded) {
+            return packEntry(PositionValue::DRAW, NO_MOVE, 0);
+        }
+        // Only a proven win stands on its own; any other value could be beaten by an estimated move
+        bool heuristic = bestHeuristic || (anyHeuristic && bestValue != PositionValue::WIN);
+        std::uint16_t packed = packEntry(bestValue, symmetries[symmetry][static_cast<std::size_t>(bestCell)],
+                                         bestDepth, heuristic);
+        remember(key, packed);
+        return packed;
+    }
+};
+
+// Hash and displace: buckets are placed largest first, each trying seeds
+// until all of its keys land in free slots
+bool buildSlots(const std::vector<std::uint64_t>& keys, std::uint64_t slotCount, std::uint64_t bucketCount,
+                std::vector<std::uint32_t>& seeds, std::vector<std::uint64_t>& slotKeys) {
+    std::vector<std::vector<std::uint64_t>> buckets(static_cast<std::size_t>(bucketCount));
+    for (std::uint64_t key : keys) {
+        buckets[static_cast<std::size_t>(mixSeed(key) % bucketCount)].push_back(key);
+    }
+    std::vector<std::size_t> order(buckets.size());
+    for (std::size_t b = 0; b < order.size(); b++) {
+        order[b] = b;
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::size_t a, std::size_t b) { return buckets[a].size() > buckets[b].size(); });
+
+    seeds.assign(static_cast<std::size_t>(bucketCount), 0);
+    slotKeys.assign(static_cast<std::size_t>(slotCount), EMPTY_SLOT);
+    std::vector<std::uint64_t> taken;
+    for (std::size_t b : order) {
+        if (buckets[b].empty()) {
+            break;
+        }
+        std::uint32_t seed = 0;
+        for (; seed < MAX_SEED; seed++) {
+            taken.clear();
+            bool fits = true;
+            for (std::uint64_t key : buckets[b]) {
+                std::uint64_t slot = mixSeed(key ^ seed) % slotCount;
+                if (slotKeys[static_cast<std::size_t>(slot)] != EMPTY_SLOT ||
+                    std::find(taken.begin(), taken.end(), slot) != taken.end()) {
+                    fits = false;
+                    break;
+                }
+                taken.push_back(slot);
+            }
+            if (fits) {
+                break;
+            }
+        }
+        if (seed == MAX_SEED) {
+            return false;
+        }
+        seeds[b] = seed;
+        for (std::size_t i = 0; i < taken.size(); i++) {
+            slotKeys[static_cast<std::size_t>(taken[i])] = buckets[b][i];
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+PositionDatabase::PositionDatabase()
+    : data(nullptr), size(0), mapped(false), rowCount(0), colCount(0), lineLength(0), depthLimit(-1),
+      slots(0), buckets(0), positions(0) {}
+
+PositionDatabase::~PositionDatabase() {
+    close();
+}
+
+bool PositionDatabase::generate(const std::string& path, const PositionDatabaseConfig& config,
+                                PositionDatabaseStats* stats) {
+    GameBoard shape(config.rows, config.cols, config.winLength);
+    if (shape.getRows() * shape.getCols() > MAX_CELLS) {
+        return false;
+    }
+    PositionDatabaseConfig normalized = config;
+    normalized.rows = shape.getRows();
+    normalized.cols = shape.getCols();
+    normalized.winLength = shape.getWinLength();
+    std::vector<std::vector<int>> symmetries = boardSymmetries(normalized.rows, normalized.cols);
+
+    Solver solver(normalized, symmetries);
+    if (!solver.run()) {
+        return false;
+    }
+    std::vector<std::uint64_t> keys;
+    keys.reserve(solver.solved.size());
+    for (const auto& position : solver.solved) {
+        keys.push_back(position.first);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    // About 90% full, so every bucket finds room after a few seeds
+    std::uint64_t slotCount = keys.size() + keys.size() / 8 + 1;
+    std::uint64_t bucketCount = keys.size() / 4 + 1;
+    std::vector<std::uint32_t> seeds;
+    std::vector<std::uint64_t> slotKeys;
+    if (!buildSlots(keys, slotCount, bucketCount, seeds, slotKeys)) {
+        return false;
+    }
+
+    std::string bytes(FILE_MAGIC, sizeof(FILE_MAGIC));
+    appendFixed(bytes, static_cast<std::uint64_t>(normalized.rows), 4);
+    appendFixed(bytes, static_cast<std::uint64_t>(normalized.cols), 4);
+    appendFixed(bytes, static_cast<std::uint64_t>(normalized.winLength), 4);
+    appendFixed(bytes, static_cast<std::uint32_t>(config.maxDepth < 0 ? -1 : config.maxDepth), 4);
+    appendFixed(bytes, slotCount, 8);
+    appendFixed(bytes, bucketCount, 8);
+    appendFixed(bytes, keys.size(), 8);
+    bytes.resize(HEADER_SIZE, '\0');
+    for (std::uint64_t key : slotKeys) {
+        appendFixed(bytes, key, 8);
+    }
+    for (std::uint64_t key : slotKeys) {
+        appendFixed(bytes, key == EMPTY_SLOT ? 0 : solver.solved[key], 2);
+    }
+    bytes.resize((bytes.size() + 3) / 4 * 4, '\0');
+    for (std::uint32_t seed : seeds) {
+        appendFixed(bytes, seed, 4);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    file.close();
+    if (stats != nullptr) {
+        stats->solved = solver.solved.size();
+        stats->written = keys.size();
+        stats->heuristic = 0;
+        for (const auto& position : solver.solved) {
+            stats->heuristic += isHeuristic(position.second);
+        }
+        stats->fileBytes = bytes.size();
+    }
+    return static_cast<bool>(file);
+}
+
+bool PositionDatabase::open(const std::string& path) {
+    close();
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(HEADER_SIZE)) {
+        ::close(fd);
+        return false;
+    }
+    void* map = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    data = static_cast<const unsigned char*>(map);
+    size = static_cast<std::size_t>(info.st_size);
+    mapped = true;
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open() || static_cast<std::size_t>(file.tellg()) < HEADER_SIZE) {
+        return false;
+    }
+    buffer.resize(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    if (!file) {
+        buffer.clear();
+        return false;
+    }
+    data = buffer.data();
+    size = buffer.size();
+#endif
+
+    rowCount = static_cast<int>(readFixed(data + 8, 4));
+    colCount = static_cast<int>(readFixed(data + 12, 4));
+    lineLength = static_cast<int>(readFixed(data + 16, 4));
+    depthLimit = static_cast<std::int32_t>(static_cast<std::uint32_t>(readFixed(data + 20, 4)));
+    slots = readFixed(data + 24, 8);
+    buckets = readFixed(data + 32, 8);
+    positions = readFixed(data + 40, 8);
+    // Sizes are checked one by one so corrupt counts cannot overflow the total
+    std::uint64_t room = size - HEADER_SIZE;
+    bool valid = std::equal(FILE_MAGIC, FILE_MAGIC + sizeof(FILE_MAGIC) - 1, data) &&
+                 (data[7] == FILE_MAGIC[7] || data[7] == FIRST_VERSION) && rowCount > 0 &&
+                 colCount > 0 && rowCount <= MAX_CELLS && colCount <= MAX_CELLS &&
+                 rowCount * colCount <= MAX_CELLS && slots > 0 && buckets > 0 &&
+                 positions <= slots && slots <= room / 10 && (slots * 10 + 3) / 4 * 4 <= room &&
+                 buckets <= (room - (slots * 10 + 3) / 4 * 4) / 4;
+    if (!valid) {
+        close();
+        return false;
+    }
+    symmetries = boardSymmetries(rowCount, colCount);
+    return true;
+}
+
+void PositionDatabase::close() {
+#ifndef _WIN32
+    if (mapped) {
+        munmap(const_cast<unsigned char*>(data), size);
+    }
+#endif
+    data = nullptr;
+    size = 0;
+    mapped = false;
+    buffer.clear();
+    slots = 0;
+    buckets = 0;
+    positions = 0;
+}
+
+bool PositionDatabase::lookup(const GameBoard& board, PositionEntry& entry) const {
+    if (!isOpen() || board.getRows() != rowCount || board.getCols() != colCount) {
+        return false;
+    }
+    int xs = 0;
+    int os = 0;
+    for (int r = 0; r < rowCount; r++) {
+        for (int c = 0; c < colCount; c++) {
+            char cell = board.getCell(r, c);
+            xs += cell == 'X';
+            os += cell == 'O';
+        }
+    }
+    // Games O opened are looked up with the marks swapped
+    char first = (os > xs) ? 'O' : 'X';
+    std::uint64_t key = 0;
+    for (int r = 0; r < rowCount; r++) {
+        for (int c = 0; c < colCount; c++) {
+            char cell = board.getCell(r, c);
+            std::uint64_t code = (cell == ' ') ? 0 : (cell == first ? 1 : (cell == 'X' || cell == 'O' ? 2 : 3));
+            if (code == 3) {
+                return false;
+            }
+            key |= code << (2 * (r * colCount + c));
+        }
+    }
+    return lookupKey(key, entry);
+}
+
+bool PositionDatabase::lookupKey(std::uint64_t key, PositionEntry& entry) const {
+    if (!isOpen()) {
+        return false;
+    }
+    std::size_t symmetry = 0;
+    std::uint64_t canonical = canonicalKey(key, symmetries, symmetry);
+    std::uint16_t packed;
+    if (!findSlot(canonical, packed)) {
+        return false;
+    }
+    entry.value = valueOf(packed);
+    entry.depth = depthOf(packed);
+    entry.heuristic = isHeuristic(packed);
+    entry.bestMove = -1;
+    int move = moveOf(packed);
+    if (move != NO_MOVE) {
+        const auto& map = symmetries[symmetry];
+        entry.bestMove = static_cast<int>(std::find(map.begin(), map.end(), move) - map.begin());
+    }
+    return true;
+}
+
+bool PositionDatabase::findSlot(std::uint64_t canonical, std::uint16_t& packed) const {
+    const unsigned char* keys = data + HEADER_SIZE;
+    const unsigned char* entries = keys + slots * 8;
+    const unsigned char* seeds = data + HEADER_SIZE + (slots * 10 + 3) / 4 * 4;
+    std::uint64_t bucket = mixSeed(canonical) % buckets;
+    std::uint64_t seed = readFixed(seeds + bucket * 4, 4);
+    std::uint64_t slot = mixSeed(canonical ^ seed) % slots;
+    if (readFixed(keys + slot * 8, 8) != canonical) {
+        return false;
+    }
+    packed = static_cast<std::uint16_t>(readFixed(entries + slot * 2, 2));
+    return true;
+}
@@ -0,0 +1,278 @@
+#include "ScanKernels.h"
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define SCAN_KERNELS_SSE2 1
+#include <immintrin.h>
+// AVX2 code is compiled per function and only run when the CPU has it, so
+// the library needs no -mavx2
+#if defined(__GNUC__)
+#define SCAN_KERNELS_AVX2 1
+#endif
+#endif
+
+namespace {
+
+// Every kernel below fills `words` whole words; the public functions finish
+// a partial last word with the scalar ones.
+
+template <typename T>
+std::uint64_t equalWord(const T* column, std::size_t rows, T value) {
+    std::uint64_t word = 0;
+    for (std::size_t i = 0; i < rows; i++) {
+        word |= static_cast<std::uint64_t>(column[i] == value) << i;
+    }
+    return word;
+}
+
+std::uint64_t eitherWord(const std::uint32_t* first, const std::uint32_t* second, std::size_t rows,
+                         std::uint32_t value) {
+    std::uint64_t word = 0;
+    for (std::size_t i = 0; i < rows; i++) {
+        word |= static_cast<std::uint64_t>(first[i] == value || second[i] == value) << i;
+    }
+    return word;
+}
+
+template <typename T>
+void equalScalar(const T* column, std::size_t words, T value, std::uint64_t* bits) {
+    for (std::size_t w = 0; w < words; w++) {
+        bits[w] = equalWord(column + w * 64, 64, value);
+    }
+}
+
+void eitherScalar(const std::uint32_t* first, const std::uint32_t* second, std::size_t words,
+                  std::uint32_t value, std::uint64_t* bits) {
+    for (std::size_t w = 0; w < words; w++) {
+        bits[w] = eitherWord(first + w * 64, second + w * 64, 64, value);
+    }
+}
+
+#if defined(SCAN_KERNELS_SSE2)
+
+void equal32Sse2(const std::uint32_t* column, std::size_t words, std::uint32_t value, std::uint64_t* bits) {
+    const __m128i needle = _mm_set1_epi32(static_cast<int>(value));
+    for (std::size_t w = 0; w < words; w++) {
+        const std::uint32_t* rows = column + w * 64;
+        std::uint64_t word = 0;
+        for (int j = 0; j < 64; j += 4) {
+            __m128i cells = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows + j));
+            int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(cells, needle)));
+            word |= static_cast<std::uint64_t>(mask) << j;
+        }
+        bits[w] = word;
+    }
+}
+
+void either32Sse2(const std::uint32_t* first, const std::uint32_t* second, std::size_t words,
+                  std::uint32_t value, std::uint64_t* bits) {
+    const __m128i needle = _mm_set1_epi32(static_cast<int>(value));
+    for (std::size_t w = 0; w < words; w++) {
+        std::uint64_t word = 0;
+        for (int j = 0; j < 64; j += 4) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + w * 64 + j));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(second + w * 64 + j));
+            __m128i hit = _mm_or_si128(_mm_cmpeq_epi32(a, needle), _mm_cmpeq_epi32(b, needle));
+            word |= static_cast<std::uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(hit))) << j;
+        }
+        bits[w] = word;
+    }
+}
+
+void equal8Sse2(const std::uint8_t* column, std::size_t words, std::uint8_t value, std::uint64_t* bits) {
+    const __m128i needle = _mm_set1_epi8(static_cast<char>(value));
+    for (std::size_t w = 0; w < words; w++) {
+        std::uint64_t word = 0;
+        for (int j = 0; j < 64; j += 16) {
+            __m128i cells = _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + w * 64 + j));
+            auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(cells, needle)));
+            word |= static_cast<std::uint64_t>(mask) << j;
+        }
+        bits[w] = word;
+    }
+}
+
+#endif
+
+#if defined(SCAN_KERNELS_AVX2)
+
+__attribute__((target("avx2"))) void equal32Avx2(const std::uint32_t* column, std::size_t words,
+                                                  std::uint32_t value, std::uint64_t* bits) {
+    const __m256i needle = _mm256_set1_epi32(static_cast<int>(value));
+    for (std::size_t w = 0; w < words; w++) {
+        const std::uint32_t* rows = column + w * 64;
+        std::uint64_t word = 0;
+        for (int j = 0; j < 64; j += 8) {
+            __m256i cells = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows + j));
+            int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(cells, needle)));
+            word |= static_cast<std::uint64_t>(mask) << j;
+        }
+        bits[w] = word;
+    }
+}
+
+__attribute__((target("avx2"))) void either32Avx2(const std::uint32_t* first, const std::uint32_t* second,
+                                                   std::size_t words, std::uint32_t value, std::uint64_t* bits) {
+    const __m256i needle = _mm256_set1_epi32(static_cast<int>(value));
+    for (std::size_t w = 0; w < words; w++) {
+        std::uint64_t word = 0;
+        for (int j = 0; j < 64; j += 8) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + w * 64 + j));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(second + w * 64 + j));
+            __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi32(a, needle), _mm256_cmpeq_epi32(b, needle));
+            word |= static_cast<std::uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(hit))) << j;
+        }
+        bits[w] = word;
+    }
+}
+
+__attribute__((target("avx2"))) void equal8Avx2(const std::uint8_t* column, std::size_t words,
+                                                 std::uint8_t value, std::uint64_t* bits) {
+    const __m256i needle = _mm256_set1_epi8(static_cast<char>(value));
+    for (std::size_t w = 0; w < words; w++) {
+        std::uint64_t word = 0;
+        for (int j = 0; j < 64; j += 32) {
+            __m256i cells = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column + w * 64 + j));
+            auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(cells, needle)));
+            word |= static_cast<std::uint64_t>(mask) << j;
+        }
+        bits[w] = word;
+    }
+}
+
+#endif
+
+ScanKernels::Level detectLevel() {
+#if defined(SCAN_KERNELS_AVX2)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return ScanKernels::Level::AVX2;
+    }
+#endif
+#if defined(SCAN_KERNELS_SSE2)
+    return ScanKernels::Level::SSE2;
+#else
+    return ScanKernels::Level::SCALAR;
+#endif
+}
+
+std::atomic<ScanKernels::Level>& activeLevel() {
+    static std::atomic<ScanKernels::Level> level{ScanKernels::supportedLevel()};
+    return level;
+}
+
+}  // namespace
+
+ScanKernels::Level ScanKernels::supportedLevel() {
+    static const Level supported = detectLevel();
+    return supported;
+}
+
+ScanKernels::Level ScanKernels::level() {
+    return activeLevel().load(std::memory_order_relaxed);
+}
+
+ScanKernels::Level ScanKernels::setLevel(Level requested) {
+    Level level = requested < supportedLevel() ? requested : supportedLevel();
+    activeLevel().store(level, std::memory_order_relaxed);
+    return level;
+}
+
+void ScanKernels::selectEqual(const std::uint32_t* column, std::size_t rows, std::uint32_t value,
+                              std::uint64_t* bits) {
+    std::size_t words = rows / 64;
+    switch (level()) {
+#if defined(SCAN_KERNELS_AVX2)
+    case Level::AVX2:
+        equal32Avx2(column, words, value, bits);
+        break;
+#endif
+#if defined(SCAN_KERNELS_SSE2)
+    case Level::SSE2:
+        equal32Sse2(column, words, value, bits);
+        break;
+#endif
+    default:
+        equalScalar(column, words, value, bits);
+        break;
+    }
+    if (rows % 64 != 0) {
+        bits[words] = equalWord(column + words * 64, rows % 64, value);
+    }
+}
+
+void ScanKernels::selectEqual(const std::uint8_t* column, std::size_t rows, std::uint8_t value,
+                              std::uint64_t* bits) {
+    std::size_t words = rows / 64;
+    switch (level()) {
+#if defined(SCAN_KERNELS_AVX2)
+    case Level::AVX2:
+        equal8Avx2(column, words, value, bits);
+        break;
+#endif
+#if defined(SCAN_KERNELS_SSE2)
+    case Level::SSE2:
+        equal8Sse2(column, words, value, bits);
+        break;
+#endif
+    default:
+        equalScalar(column, words, value, bits);
+        break;
+    }
+    if (rows % 64 != 0) {
+        bits[words] = equalWord(column + words * 64, rows % 64, value);
+    }
+}
+
+void ScanKernels::selectEither(const std::uint32_t* first, const std::uint32_t* second, std::size_t rows,
+                               std::uint32_t value, std::uint64_t* bits) {
+    std::size_t words = rows / 64;
+    switch (level()) {
+#if defined(SCAN_KERNELS_AVX2)
+    case Level::AVX2:
+        either32Avx2(first, second, words, value, bits);
+        break;
+#endif
+#if defined(SCAN_KERNELS_SSE2)
+    case Level::SSE2:
+        either32Sse2(first, second, words, value, bits);
+        break;
+#endif
+    default:
+        eitherScalar(first, second, words, value, bits);
+        break;
+    }
+    if (rows % 64 != 0) {
+        bits[words] = eitherWord(first + words * 64, second + words * 64, rows % 64, value);
+    }
+}
+
+void ScanKernels::selectAll(std::size_t rows, std::uint64_t* bits) {
+    std::size_t words = rows / 64;
+    for (std::size_t w = 0; w < words; w++) {
+        bits[w] = ~0ULL;
+    }
+    if (rows % 64 != 0) {
+        bits[words] = (1ULL << (rows % 64)) - 1;
+    }
+}
+
+void ScanKernels::intersect(std::uint64_t* bits, const std::uint64_t* other, std::size_t words) {
+    for (std::size_t w = 0; w < words; w++) {
+        bits[w] &= other[w];
+    }
+}
+
+std::size_t ScanKernels::count(const std::uint64_t* bits, std::size_t words) {
+    std::size_t total = 0;
+    for (std::size_t w = 0; w < words; w++) {
+#if defined(__GNUC__)
+        total += static_cast<std::size_t>(__builtin_popcountll(bits[w]));
+#else
+        for (std::uint64_t word = bits[w]; word != 0; word &= word - 1) {
+            total++;
+        }
+#endif
+    }
+    return total;
+}
@@ -0,0 +1,307 @@
+#include "SelfPlay.h"
+#include "MctsEngine.h"
+#include "PlayoutBoard.h"
+#include "Random.h"
+#include "Timestamp.h"
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace {
+
+int greedyMove(PlayoutBoard& board, char player, Random& random) {
+    int count = board.emptyCount();
+    // play()/undo() reorder the empty list, so work from a copy
+    std::int16_t empties[PlayoutBoard::MAX_CELLS];
+    for (int i = 0; i < count; i++) {
+        empties[i] = static_cast<std::int16_t>(board.emptyCell(i));
+    }
+
+    int block = -1;
+    for (int i = 0; i < count; i++) {
+        int cell = empties[i];
+        bool wins = board.play(cell, player);
+        board.undo(cell);
+        if (wins) {
+            return cell;
+        }
+        if (block == -1) {
+            if (board.play(cell, PlayoutBoard::opponent(player))) {
+                block = cell;
+            }
+            board.undo(cell);
+        }
+    }
+    return block != -1 ? block : empties[random.below(count)];
+}
+
+struct ChunkResult {
+    std::vector<PolicyStats> stats;
+    std::vector<GameRecord> records;
+};
+
+// Plays games [begin, end); each chunk owns its engines and record buffer
+class ChunkPlayer {
+public:
+    ChunkPlayer(const std::vector<SelfPlayPolicy>& policies,
+                const std::vector<std::pair<int, int>>& pairings, const SelfPlayConfig& config,
+                const GameBoard& start, bool record)
+        : policies(policies), pairings(pairings), config(config), start(start), mirror(start),
+          record(record), engines(policies.size()), players(policies.size()) {
+        for (const auto& policy : policies) {
+            needsMirror = needsMirror || policy.kind == PolicyKind::MCTS || policy.kind == PolicyKind::AI;
+        }
+    }
+
+    ChunkResult play(std::size_t begin, std::size_t end) {
+        ChunkResult result;
+        result.stats.resize(policies.size());
+        if (record) {
+            result.records.reserve(end - begin);
+        }
+        EpochMillis stamp = currentEpochMillis();
+        for (std::size_t game = begin; game < end; game++) {
+            playGame(game, stamp, result);
+        }
+        return result;
+    }
+
+private:
+    const std::vector<SelfPlayPolicy>& policies;
+    const std::vector<std::pair<int, int>>& pairings;
+    const SelfPlayConfig& config;
+    const GameBoard& start;
+    GameBoard mirror;
+    bool record;
+    bool needsMirror = false;
+    std::vector<std::unique_ptr<MctsEngine>> engines;
+    std::vector<std::unique_ptr<AiPlayer>> players;
+    std::vector<Move> moves;
+
+    int chooseCell(int policyIndex, PlayoutBoard& board, char player, Random& random) {
+        const SelfPlayPolicy& policy = policies[policyIndex];
+        switch (policy.kind) {
+            case PolicyKind::GREEDY:
+                return greedyMove(board, player, random);
+            case PolicyKind::MCTS: {
+                auto& engine = engines[policyIndex];
+                if (!engine) {
+                    engine = std::make_unique<MctsEngine>(1, 1.4, random.next());
+                }
+                MctsLimits limits;
+                limits.maxIterations = std::max<std::uint64_t>(1, policy.iterations);
+                MctsResult found;
+                if (engine->chooseMove(mirror, player, limits, found)) {
+                    return found.row * board.cols() + found.col;
+                }
+                break;
+            }
+            case PolicyKind::AI: {
+                auto& ai = players[policyIndex];
+                if (!ai) {
+                    ai = std::make_unique<AiPlayer>(nullptr, AiPlayerConfig(), random.next());
+                }
+                AiMove found;
+                if (ai->chooseMove(mirror, player, policy.difficulty, found)) {
+                    return found.row * board.cols() + found.col;
+                }
+                break;
+            }
+            case PolicyKind::RANDOM:
+                break;
+        }
+        return board.emptyCell(random.below(board.emptyCount()));
+    }
+
+    void playGame(std::size_t game, EpochMillis stamp, ChunkResult& out) {
+        const auto& pairing = pairings[game % pairings.size()];
+        Random random(mixSeed(config.seed + game));
+        PlayoutBoard board(start);
+        if (needsMirror) {
+            mirror.reset();
+            for (auto& engine : engines) {
+                if (engine) {
+                    engine->reset();
+                }
+            }
+        }
+        moves.clear();
+
+        char toMove = 'X';
+        GameResult result = GameResult::TIE;
+        while (board.emptyCount() > 0) {
+            int policyIndex = (toMove == 'X') ? pairing.first : pairing.second;
+            int cell = chooseCell(policyIndex, board, toMove, random);
+            int row = cell / board.cols();
+            int col = cell % board.cols();
+            bool line = board.play(cell, toMove);
+            if (needsMirror) {
+                mirror.makeMove(row, col, toMove);
+            }
+            if (record) {
+                moves.push_back(Move(row, col, toMove, stamp, static_cast<int>(moves.size()) + 1));
+            }
+            if (line) {
+                result = (toMove == 'X') ? GameResult::PLAYER1_WIN : GameResult::PLAYER2_WIN;
+                break;
+            }
+            toMove = PlayoutBoard::opponent(toMove);
+        }
+
+        PolicyStats& first = out.stats[pairing.first];
+        PolicyStats& second = out.stats[pairing.second];
+        // A policy playing itself is one player: the game counts once, as first mover
+        bool selfPairing = pairing.first == pairing.second;
+        first.games++;
+        first.gamesAsFirst++;
+        if (!selfPairing) {
+            second.games++;
+        }
+        if (result == GameResult::PLAYER1_WIN) {
+            first.wins++;
+            first.winsAsFirst++;
+            if (!selfPairing) {
+                second.losses++;
+            }
+        } else if (result == GameResult::PLAYER2_WIN) {
+            if (!selfPairing) {
+                second.wins++;
+            }
+            first.losses++;
+        } else {
+            first.ties++;
+            if (!selfPairing) {
+                second.ties++;
+            }
+        }
+
+        if (record) {
+            std::vector<std::vector<char>> finalBoard(3, std::vector<char>(3, ' '));
+            for (int r = 0; r < 3; r++) {
+                for (int c = 0; c < 3; c++) {
+                    finalBoard[r][c] = board.cell(r * 3 + c);
+                }
+            }
+            out.records.emplace_back(policies[pairing.first].name, policies[pairing.second].name,
+                                     GameMode::PLAYER_VS_PLAYER, result, finalBoard, std::string());
+            out.records.back().time = stamp;
+            out.records.back().moves = moves;
+        }
+    }
+};
+
+}  // namespace
+
+SelfPlay::SelfPlay(std::size_t threadCount) : pool(threadCount) {}
+
+SelfPlayReport SelfPlay::run(const std::vector<SelfPlayPolicy>& policies, const SelfPlayConfig& config,
+                             GameHistory* history) {
+    SelfPlayReport report;
+    for (const auto& policy : policies) {
+        PolicyStats stats;
+        stats.name = policy.name;
+        report.policies.push_back(stats);
+    }
+    GameBoard start(config.rows, config.cols, config.winLength);
+    if (policies.empty() || config.games == 0 || !PlayoutBoard::fits(start)) {
+        return report;
+    }
+
+    // Every ordered pair of distinct policies, so both sides of a matchup get the first move
+    std::vector<std::pair<int, int>> pairings;
+    for (std::size_t a = 0; a < policies.size(); a++) {
+        for (std::size_t b = 0; b < policies.size(); b++) {
+            if (a != b) {
+                pairings.emplace_back(static_cast<int>(a), static_cast<int>(b));
+            }
+        }
+    }
+    if (pairings.empty()) {
+        pairings.emplace_back(0, 0);
+    }
+
+    bool record = history != nullptr && start.getRows() == 3 && start.getCols() == 3;
+    auto began = std::chrono::steady_clock::now();
+
+    std::size_t chunks = std::max<std::size_t>(1, std::min(config.games, pool.size() * 4));
+    std::size_t chunkSize = (config.games + chunks - 1) / chunks;
+    std::vector<std::future<ChunkResult>> pending;
+    for (std::size_t begin = 0; begin < config.games; begin += chunkSize) {
+        std::size_t end = std::min(config.games, begin + chunkSize);
+        pending.push_back(pool.submit([&, begin, end]() {
+            ChunkPlayer player(policies, pairings, config, start, record);
+            return player.play(begin, end);
+        }));
+    }
+
+    if (record) {
+        history->beginBulk();
+    }
+    for (auto& done : pending) {
+        ChunkResult chunk = done.get();
+        for (std::size_t i = 0; i < chunk.stats.size(); i++) {
+            PolicyStats& total = report.policies[i];
+            total.games += chunk.stats[i].games;
+            total.wins += chunk.stats[i].wins;
+            total.losses += chunk.stats[i].losses;
+            total.ties += chunk.stats[i].ties;
+            total.gamesAsFirst += chunk.stats[i].gamesAsFirst;
+            total.winsAsFirst += chunk.stats[i].winsAsFirst;
+        }
+        // Chunks are collected in order, so history ends up in game-index order
+        if (!chunk.records.empty()) {
+            history->addGameRecords(std::make_move_iterator(chunk.records.begin()),
+                                    std::make_move_iterator(chunk.records.end()));
+        }
+        report.recorded += chunk.records.size();
+    }
+    if (record) {
+        history->endBulk();
+    }
+
+    report.games = config.games;
+    report.elapsedMillis = std::chrono::duration_cast<std::chrono::milliseconds>(
+                               std::chrono::steady_clock::now() - began).count();
+    return report;
+}
+
+bool SelfPlay::parsePolicy(const std::string& text, SelfPlayPolicy& policy) {
+    if (text == "random") {
+        policy = SelfPlayPolicy(text, PolicyKind::RANDOM);
+        return true;
+    }
+    if (text == "greedy") {
+        policy = SelfPlayPolicy(text, PolicyKind::GREEDY);
+        return true;
+    }
+    Difficulty difficulty;
+    if (AiPlayer::parseDifficulty(text, difficulty)) {
+        policy = SelfPlayPolicy(text, PolicyKind::AI);
+        policy.difficulty = difficulty;
+        return true;
+    }
+    if (text.compare(0, 4, "mcts") != 0) {
+        return false;
+    }
+    std::uint64_t iterations = 200;
+    if (text.size() > 4) {
+        if (text[4] != ':' || text.size() == 5) {
+            return false;
+        }
+        iterations = 0;
+        for (std::size_t i = 5; i < text.size(); i++) {
+            if (text[i] < '0' || text[i] > '9' || iterations > 100000000) {
+                return false;
+            }
+            iterations = iterations * 10 + static_cast<std::uint64_t>(text[i] - '0');
+        }
+        if (iterations == 0) {
+            return false;
+        }
+    }
+    policy = SelfPlayPolicy(text, PolicyKind::MCTS, iterations);
+    return true;
+}
@@ -0,0 +1,192 @@
+#include "SessionManager.h"
+#include "UserManager.h"
+#include <chrono>
+#include <random>
+
+std::string SessionToken::toString() const {
+    static const char DIGITS[] = "0123456789abcdef";
+    std::string text(32, '0');
+    for (int i = 0; i < 16; i++) {
+        text[15 - i] = DIGITS[(high >> (4 * i)) & 0xf];
+        text[31 - i] = DIGITS[(low >> (4 * i)) & 0xf];
+    }
+    return text;
+}
+
+bool SessionToken::fromString(const std::string& text, SessionToken& token) {
+    if (text.size() != 32) {
+        return false;
+    }
+    std::uint64_t parts[2] = {0, 0};
+    for (std::size_t i = 0; i < 32; i++) {
+        char c = text[i];
+        std::uint64_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = static_cast<std::uint64_t>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            digit = static_cast<std::uint64_t>(c - 'a' + 10);
+        } else {
+            return false;
+        }
+        parts[i / 16] = (parts[i / 16] << 4) | digit;
+    }
+    token = SessionToken(parts[0], parts[1]);
+    return true;
+}
+
+SessionManager::SessionManager(std::size_t capacity, std::int64_t ttlMillis, Clock clock)
+    : ttlMillis(ttlMillis), clock(std::move(clock)) {
+    // Round up to a power of two so the slot index is a mask of the token bits
+    std::size_t size = PROBE_LENGTH;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    slots.reset(new Slot[size]);
+    mask = size - 1;
+}
+
+std::int64_t SessionManager::now() const {
+    if (clock) {
+        return clock();
+    }
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+bool SessionManager::lockSlot(Slot& slot, std::uint64_t& sequence) {
+    sequence = slot.sequence.load(std::memory_order_relaxed);
+    if (sequence & 1) {
+        return false;
+    }
+    return slot.sequence.compare_exchange_strong(sequence, sequence + 1,
+                                                 std::memory_order_acquire);
+}
+
+void SessionManager::unlockSlot(Slot& slot, std::uint64_t sequence) {
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+SessionToken SessionManager::randomToken() {
+    static thread_local std::random_device device;
+    SessionToken token;
+    do {
+        token.high = (static_cast<std::uint64_t>(device()) << 32) | device();
+        token.low = (static_cast<std::uint64_t>(device()) << 32) | device();
+    } while (!token.isValid());
+    return token;
+}
+
+SessionToken SessionManager::createSession(UserId user) {
+    SessionToken token = randomToken();
+    std::int64_t current = now();
+
+    while (true) {
+        // Prefer a free or expired slot, otherwise evict the session closest to expiry
+        std::size_t victim = token.low & mask;
+        std::int64_t victimExpiry = INT64_MAX;
+        for (std::size_t i = 0; i < PROBE_LENGTH; i++) {
+            std::size_t index = (token.low + i) & mask;
+            std::int64_t expiry = slots[index].expiresAt.load(std::memory_order_relaxed);
+            if (expiry <= current) {
+                victim = index;
+                victimExpiry = expiry;
+                break;
+            }
+            if (expiry < victimExpiry) {
+                victim = index;
+                victimExpiry = expiry;
+            }
+        }
+
+        Slot& slot = slots[victim];
+        std::uint64_t observedHigh = slot.high.load(std::memory_order_relaxed);
+        std::uint64_t observedLow = slot.low.load(std::memory_order_relaxed);
+        std::uint64_t sequence;
+        if (!lockSlot(slot, sequence)) {
+            continue;
+        }
+        // Another create may have taken the slot between the probe and the lock
+        if (slot.expiresAt.load(std::memory_order_relaxed) != victimExpiry ||
+            slot.high.load(std::memory_order_relaxed) != observedHigh ||
+            slot.low.load(std::memory_order_relaxed) != observedLow) {
+            unlockSlot(slot, sequence);
+            continue;
+        }
+        slot.high.store(token.high, std::memory_order_relaxed);
+        slot.low.store(token.low, std::memory_order_relaxed);
+        slot.user.store(user, std::memory_order_relaxed);
+        slot.expiresAt.store(current + ttlMillis, std::memory_order_relaxed);
+        unlockSlot(slot, sequence);
+        return token;
+    }
+}
+
+bool SessionManager::openSession(UserHashTable& users, const std::string& username,
+                                 const std::string& passwordHash, SessionToken& token) {
+    if (!users.authenticateUser(username, passwordHash)) {
+        return false;
+    }
+    token = createSession(users.getUser(username)->id);
+    return true;
+}
+
+bool SessionManager::resolve(const SessionToken& token, UserId& user) const {
+    if (!token.isValid()) {
+        return false;
+    }
+    std::int64_t current = now();
+
+    for (std::size_t i = 0; i < PROBE_LENGTH; i++) {
+        const Slot& slot = slots[(token.low + i) & mask];
+        while (true) {
+            std::uint64_t before = slot.sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;  // writer in progress; it only holds the slot for a few stores
+            }
+            std::uint64_t high = slot.high.load(std::memory_order_relaxed);
+            std::uint64_t low = slot.low.load(std::memory_order_relaxed);
+            UserId owner = slot.user.load(std::memory_order_relaxed);
+            std::int64_t expiry = slot.expiresAt.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != before) {
+                continue;
+            }
+
+            if (high == token.high && low == token.low && expiry > current) {
+                user = owner;
+                return true;
+            }
+            break;
+        }
+    }
+    return false;
+}
+
+void SessionManager::revoke(const SessionToken& token) {
+    for (std::size_t i = 0; i < PROBE_LENGTH; i++) {
+        Slot& slot = slots[(token.low + i) & mask];
+        std::uint64_t sequence;
+        while (!lockSlot(slot, sequence)) {
+        }
+        if (slot.high.load(std::memory_order_relaxed) == token.high &&
+            slot.low.load(std::memory_order_relaxed) == token.low) {
+            slot.high.store(0, std::memory_order_relaxed);
+            slot.low.store(0, std::memory_order_relaxed);
+            slot.user.store(INVALID_USER_ID, std::memory_order_relaxed);
+            slot.expiresAt.store(0, std::memory_order_relaxed);
+        }
+        unlockSlot(slot, sequence);
+    }
+}
+
+std::size_t SessionManager::activeSessions() const {
+    std::int64_t current = now();
+    std::size_t count = 0;
+    for (std::size_t i = 0; i <= mask; i++) {
+        if (slots[i].expiresAt.load(std::memory_order_relaxed) > current) {
+            count++;
+        }
+    }
+    return count;
+}
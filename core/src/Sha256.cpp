@@ -0,0 +1,135 @@
+#include "Sha256.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const std::uint32_t ROUND_CONSTANTS[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+    0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+    0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+    0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+    0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+    0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+    0xc67178f2};
+
+inline std::uint32_t rotr(std::uint32_t value, int bits) {
+    return (value >> bits) | (value << (32 - bits));
+}
+
+}  // namespace
+
+Sha256::Sha256()
+    : state{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab,
+            0x5be0cd19},
+      block{},
+      blockUsed(0),
+      totalBytes(0) {}
+
+void Sha256::update(const void* data, std::size_t size) {
+    const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+    totalBytes += size;
+
+    while (size > 0) {
+        std::size_t take = std::min(size, block.size() - blockUsed);
+        std::memcpy(block.data() + blockUsed, bytes, take);
+        blockUsed += take;
+        bytes += take;
+        size -= take;
+        if (blockUsed == block.size()) {
+            compress(block.data());
+            blockUsed = 0;
+        }
+    }
+}
+
+Sha256::Digest Sha256::finish() {
+    std::uint64_t bitLength = totalBytes * 8;
+
+    std::uint8_t padding = 0x80;
+    update(&padding, 1);
+    padding = 0;
+    while (blockUsed != 56) {
+        update(&padding, 1);
+    }
+
+    std::uint8_t lengthBytes[8];
+    for (int i = 0; i < 8; i++) {
+        lengthBytes[i] = static_cast<std::uint8_t>(bitLength >> (56 - 8 * i));
+    }
+    update(lengthBytes, 8);
+
+    Digest digest;
+    for (int i = 0; i < 8; i++) {
+        digest[i * 4] = static_cast<std::uint8_t>(state[i] >> 24);
+        digest[i * 4 + 1] = static_cast<std::uint8_t>(state[i] >> 16);
+        digest[i * 4 + 2] = static_cast<std::uint8_t>(state[i] >> 8);
+        digest[i * 4 + 3] = static_cast<std::uint8_t>(state[i]);
+    }
+    return digest;
+}
+
+Sha256::Digest Sha256::hash(const std::string& data) {
+    Sha256 sha;
+    sha.update(data);
+    return sha.finish();
+}
+
+std::string Sha256::toHex(const std::uint8_t* data, std::size_t size) {
+    static const char DIGITS[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(size * 2);
+    for (std::size_t i = 0; i < size; i++) {
+        hex.push_back(DIGITS[data[i] >> 4]);
+        hex.push_back(DIGITS[data[i] & 0x0f]);
+    }
+    return hex;
+}
+
+void Sha256::compress(const std::uint8_t* chunk) {
+    std::uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = (static_cast<std::uint32_t>(chunk[i * 4]) << 24) |
+               (static_cast<std::uint32_t>(chunk[i * 4 + 1]) << 16) |
+               (static_cast<std::uint32_t>(chunk[i * 4 + 2]) << 8) |
+               static_cast<std::uint32_t>(chunk[i * 4 + 3]);
+    }
+    for (int i = 16; i < 64; i++) {
+        std::uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        std::uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    std::uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    std::uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (int i = 0; i < 64; i++) {
+        std::uint32_t s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+        std::uint32_t ch = (e & f) ^ (~e & g);
+        std::uint32_t temp1 = h + s1 + ch + ROUND_CONSTANTS[i] + w[i];
+        std::uint32_t s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+        std::uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        std::uint32_t temp2 = s0 + maj;
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + temp1;
+        d = c;
+        c = b;
+        b = a;
+        a = temp1 + temp2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
@@ -0,0 +1,625 @@
+#include "ShardedUserStore.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// === LocalUserShard ===
+
+LocalUserShard::LocalUserShard(const std::string& usersFile) : table(usersFile) {}
+
+bool LocalUserShard::insertUser(const User& user) {
+    return table.insertUsers({user}).size() == 1;
+}
+
+bool LocalUserShard::authenticateUser(const std::string& username,
+                                      const std::string& passwordHash) {
+    return table.authenticateUser(username, passwordHash);
+}
+
+bool LocalUserShard::userExists(const std::string& username) {
+    return table.userExists(username);
+}
+
+bool LocalUserShard::removeUser(const std::string& username) {
+    if (!table.userExists(username)) {
+        return false;
+    }
+    table.removeUser(username);
+    return true;
+}
+
+bool LocalUserShard::getUser(const std::string& username, User& user) {
+    User* found = table.getUser(username);
+    if (found == nullptr) {
+        return false;
+    }
+    user = *found;
+    return true;
+}
+
+bool LocalUserShard::updateUser(const std::string& username, const User& user) {
+    if (!table.userExists(username)) {
+        return false;
+    }
+    table.updateUser(username, user);
+    return true;
+}
+
+std::vector<User> LocalUserShard::getAllUsers() {
+    std::vector<User> users;
+    for (const auto& username : table.getAllUsers()) {
+        users.push_back(*table.getUser(username));
+    }
+    return users;
+}
+
+std::vector<std::string> LocalUserShard::insertUsers(const std::vector<User>& users) {
+    return table.insertUsers(users);
+}
+
+std::size_t LocalUserShard::removeUsers(const std::vector<std::string>& usernames) {
+    return table.removeUsers(usernames);
+}
+
+// === ProcessUserShard ===
+
+namespace {
+
+std::vector<std::string> encodeUser(const User& user) {
+    return {std::string(user.name()),
+            user.password.toString(),
+            std::to_string(user.gamesPlayed),
+            std::to_string(user.gamesWon),
+            std::to_string(user.gamesLost),
+            std::to_string(user.gamesTied)};
+}
+
+bool decodeUser(const std::vector<std::string>& fields, size_t offset, User& user) {
+    if (fields.size() < offset + 6) {
+        return false;
+    }
+    user = User(fields[offset], PasswordDigest::fromStored(fields[offset + 1]));
+    user.gamesPlayed = std::stoi(fields[offset + 2]);
+    user.gamesWon = std::stoi(fields[offset + 3]);
+    user.gamesLost = std::stoi(fields[offset + 4]);
+    user.gamesTied = std::stoi(fields[offset + 5]);
+    return true;
+}
+
+#ifndef _WIN32
+
+// Parent-side socket ends. A freshly forked shard closes these so that it does
+// not keep its siblings' connections open.
+std::mutex& parentFdMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::vector<int>& parentFds() {
+    static std::vector<int> fds;
+    return fds;
+}
+
+// Threads of this process, or 0 where /proc does not say
+int threadCount() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 8, "Threads:") == 0) {
+            return std::atoi(line.c_str() + 8);
+        }
+    }
+    return 0;
+}
+
+bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = send(fd, data, size, MSG_NOSIGNAL);
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool readAll(int fd, char* data, size_t size) {
+    while (size > 0) {
+        ssize_t received = recv(fd, data, size, 0);
+        if (received <= 0) {
+            return false;
+        }
+        data += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+// Frame: field count, then each field as a length followed by its bytes
+bool writeFrame(int fd, const std::vector<std::string>& fields) {
+    std::string buffer;
+    uint32_t count = static_cast<uint32_t>(fields.size());
+    buffer.append(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const auto& field : fields) {
+        uint32_t length = static_cast<uint32_t>(field.size());
+        buffer.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        buffer.append(field);
+    }
+    return writeAll(fd, buffer.data(), buffer.size());
+}
+
+bool readFrame(int fd, std::vector<std::string>& fields) {
+    uint32_t count = 0;
+    if (!readAll(fd, reinterpret_cast<char*>(&count), sizeof(count))) {
+        return false;
+    }
+    fields.assign(count, std::string());
+    for (auto& field : fields) {
+        uint32_t length = 0;
+        if (!readAll(fd, reinterpret_cast<char*>(&length), sizeof(length))) {
+            return false;
+        }
+        field.resize(length);
+        if (length > 0 && !readAll(fd, &field[0], length)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<std::string> handleRequest(LocalUserShard& shard,
+                                       const std::vector<std::string>& request) {
+    const std::string& op = request[0];
+    User user;
+
+    if (op == "INSERT" && decodeUser(request, 1, user)) {
+        return {shard.insertUser(user) ? "1" : "0"};
+    }
+    if (op == "AUTH" && request.size() == 3) {
+        return {shard.authenticateUser(request[1], request[2]) ? "1" : "0"};
+    }
+    if (op == "EXISTS" && request.size() == 2) {
+        return {shard.userExists(request[1]) ? "1" : "0"};
+    }
+    if (op == "REMOVE" && request.size() == 2) {
+        return {shard.removeUser(request[1]) ? "1" : "0"};
+    }
+    if (op == "GET" && request.size() == 2) {
+        if (!shard.getUser(request[1], user)) {
+            return {"0"};
+        }
+        std::vector<std::string> reply = {"1"};
+        for (auto& field : encodeUser(user)) {
+            reply.push_back(std::move(field));
+        }
+        return reply;
+    }
+    if (op == "UPDATE" && decodeUser(request, 2, user)) {
+        return {shard.updateUser(request[1], user) ? "1" : "0"};
+    }
+    if (op == "INSERT_MANY") {
+        std::vector<User> users;
+        for (size_t offset = 1; decodeUser(request, offset, user); offset += 6) {
+            users.push_back(user);
+        }
+        std::vector<std::string> reply = {"1"};
+        for (auto& name : shard.insertUsers(users)) {
+            reply.push_back(std::move(name));
+        }
+        return reply;
+    }
+    if (op == "REMOVE_MANY") {
+        std::vector<std::string> usernames(request.begin() + 1, request.end());
+        return {"1", std::to_string(shard.removeUsers(usernames))};
+    }
+    if (op == "LIST") {
+        std::vector<std::string> reply = {"1"};
+        for (const auto& stored : shard.getAllUsers()) {
+            for (auto& field : encodeUser(stored)) {
+                reply.push_back(std::move(field));
+            }
+        }
+        return reply;
+    }
+    return {"0"};
+}
+
+void serveShard(int fd, const std::string& usersFile) {
+    LocalUserShard shard(usersFile);
+    std::vector<std::string> request;
+    while (readFrame(fd, request) && !request.empty() && request[0] != "QUIT") {
+        if (!writeFrame(fd, handleRequest(shard, request))) {
+            break;
+        }
+    }
+}
+
+#endif
+
+}  // namespace
+
+ProcessUserShard::ProcessUserShard(int fd, int pid) : fd(fd), pid(pid) {}
+
+std::unique_ptr<ProcessUserShard> ProcessUserShard::spawn(const std::string& usersFile) {
+#ifndef _WIN32
+    // Another thread could hold a lock the child needs; its copy would never be released
+    if (threadCount() > 1) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(parentFdMutex());
+
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        return nullptr;
+    }
+
+    pid_t child = fork();
+    if (child < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return nullptr;
+    }
+
+    if (child == 0) {
+        close(fds[0]);
+        for (int fd : parentFds()) {
+            close(fd);
+        }
+        serveShard(fds[1], usersFile);
+        close(fds[1]);
+        _exit(0);
+    }
+
+    close(fds[1]);
+    parentFds().push_back(fds[0]);
+    return std::unique_ptr<ProcessUserShard>(new ProcessUserShard(fds[0], child));
+#else
+    (void)usersFile;
+    return nullptr;
+#endif
+}
+
+ProcessUserShard::~ProcessUserShard() {
+#ifndef _WIN32
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        writeFrame(fd, {"QUIT"});
+    }
+    close(fd);
+    waitpid(pid, nullptr, 0);
+
+    std::lock_guard<std::mutex> lock(parentFdMutex());
+    auto& fds = parentFds();
+    fds.erase(std::remove(fds.begin(), fds.end(), fd), fds.end());
+#endif
+}
+
+bool ProcessUserShard::call(const std::vector<std::string>& request,
+                            std::vector<std::string>& reply) {
+#ifndef _WIN32
+    std::lock_guard<std::mutex> lock(mutex);
+    return writeFrame(fd, request) && readFrame(fd, reply) && !reply.empty() && reply[0] == "1";
+#else
+    (void)request;
+    (void)reply;
+    return false;
+#endif
+}
+
+bool ProcessUserShard::insertUser(const User& user) {
+    std::vector<std::string> request = {"INSERT"};
+    for (auto& field : encodeUser(user)) {
+        request.push_back(std::move(field));
+    }
+    std::vector<std::string> reply;
+    return call(request, reply);
+}
+
+bool ProcessUserShard::authenticateUser(const std::string& username,
+                                        const std::string& passwordHash) {
+    std::vector<std::string> reply;
+    return call({"AUTH", username, passwordHash}, reply);
+}
+
+bool ProcessUserShard::userExists(const std::string& username) {
+    std::vector<std::string> reply;
+    return call({"EXISTS", username}, reply);
+}
+
+bool ProcessUserShard::removeUser(const std::string& username) {
+    std::vector<std::string> reply;
+    return call({"REMOVE", username}, reply);
+}
+
+bool ProcessUserShard::getUser(const std::string& username, User& user) {
+    std::vector<std::string> reply;
+    return call({"GET", username}, reply) && decodeUser(reply, 1, user);
+}
+
+bool ProcessUserShard::updateUser(const std::string& username, const User& user) {
+    std::vector<std::string> request = {"UPDATE", username};
+    for (auto& field : encodeUser(user)) {
+        request.push_back(std::move(field));
+    }
+    std::vector<std::string> reply;
+    return call(request, reply);
+}
+
+std::vector<User> ProcessUserShard::getAllUsers() {
+    std::vector<User> users;
+    std::vector<std::string> reply;
+    if (!call({"LIST"}, reply)) {
+        return users;
+    }
+    for (size_t offset = 1; offset + 6 <= reply.size(); offset += 6) {
+        User user;
+        decodeUser(reply, offset, user);
+        users.push_back(user);
+    }
+    return users;
+}
+
+std::vector<std::string> ProcessUserShard::insertUsers(const std::vector<User>& users) {
+    std::vector<std::string> request = {"INSERT_MANY"};
+    for (const auto& user : users) {
+        for (auto& field : encodeUser(user)) {
+            request.push_back(std::move(field));
+        }
+    }
+    std::vector<std::string> reply;
+    if (!call(request, reply)) {
+        return {};
+    }
+    return std::vector<std::string>(reply.begin() + 1, reply.end());
+}
+
+std::size_t ProcessUserShard::removeUsers(const std::vector<std::string>& usernames) {
+    std::vector<std::string> request = {"REMOVE_MANY"};
+    request.insert(request.end(), usernames.begin(), usernames.end());
+    std::vector<std::string> reply;
+    return (call(request, reply) && reply.size() == 2) ? std::stoul(reply[1]) : 0;
+}
+
+// === ConsistentHashRing ===
+
+ConsistentHashRing::ConsistentHashRing(int virtualNodes) : virtualNodes(virtualNodes) {}
+
+std::uint64_t ConsistentHashRing::hashKey(const std::string& key) {
+    // FNV-1a followed by a 64-bit finalizer to spread nearby keys around the ring
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+void ConsistentHashRing::addShard(int shard, const std::string& shardName) {
+    for (int i = 0; i < virtualNodes; i++) {
+        std::string point = shardName + "#" + std::to_string(i);
+        ring.emplace_back(hashKey(point), shard);
+    }
+    std::sort(ring.begin(), ring.end());
+}
+
+void ConsistentHashRing::removeShard(int shard) {
+    ring.erase(std::remove_if(ring.begin(), ring.end(),
+                              [shard](const std::pair<std::uint64_t, int>& point) {
+                                  return point.second == shard;
+                              }),
+               ring.end());
+}
+
+int ConsistentHashRing::shardFor(const std::string& key) const {
+    if (ring.empty()) {
+        return -1;
+    }
+    std::uint64_t hash = hashKey(key);
+    auto it = std::lower_bound(ring.begin(), ring.end(), std::make_pair(hash, -1));
+    if (it == ring.end()) {
+        it = ring.begin();
+    }
+    return it->second;
+}
+
+// === ShardedUserStore ===
+
+ShardedUserStore::ShardedUserStore(ShardFactory factory) : factory(std::move(factory)) {}
+
+ShardedUserStore::ShardFactory ShardedUserStore::localShards(const std::string& filePrefix) {
+    return [filePrefix](const std::string& shardName) -> std::unique_ptr<UserShard> {
+        return std::make_unique<LocalUserShard>(filePrefix + shardName + ".dat");
+    };
+}
+
+ShardedUserStore::ShardFactory ShardedUserStore::processShards(const std::string& filePrefix) {
+    return [filePrefix](const std::string& shardName) -> std::unique_ptr<UserShard> {
+        return ProcessUserShard::spawn(filePrefix + shardName + ".dat");
+    };
+}
+
+int ShardedUserStore::findShard(const std::string& shardName) const {
+    for (size_t i = 0; i < shardNames.size(); i++) {
+        if (shardNames[i] == shardName) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool ShardedUserStore::addShard(const std::string& shardName) {
+    if (findShard(shardName) >= 0) {
+        return false;
+    }
+
+    std::unique_ptr<UserShard> shard = factory(shardName);
+    if (!shard) {
+        return false;
+    }
+
+    int index = static_cast<int>(shards.size());
+    shardNames.push_back(shardName);
+    shards.push_back(std::move(shard));
+    ring.addShard(index, shardName);
+
+    // Only users whose ring position now falls to the new shard have to move,
+    // one batch per old shard. Nobody leaves an old shard before all of them
+    // are stored at the new one.
+    std::vector<std::vector<std::string>> movingNames(static_cast<std::size_t>(index));
+    std::vector<std::string> copied;
+    bool complete = true;
+    for (int i = 0; i < index && complete; i++) {
+        std::vector<User> moving;
+        for (const auto& user : shards[i]->getAllUsers()) {
+            std::string name(user.name());
+            if (ring.shardFor(name) == index) {
+                moving.push_back(user);
+                movingNames[i].push_back(std::move(name));
+            }
+        }
+        if (!moving.empty()) {
+            std::vector<std::string> stored = shards[index]->insertUsers(moving);
+            complete = stored.size() == moving.size();
+            copied.insert(copied.end(), stored.begin(), stored.end());
+        }
+    }
+    if (!complete) {
+        if (!copied.empty()) {
+            shards[index]->removeUsers(copied);
+        }
+        ring.removeShard(index);
+        shards.pop_back();
+        shardNames.pop_back();
+        return false;
+    }
+    for (int i = 0; i < index; i++) {
+        if (!movingNames[i].empty()) {
+            shards[i]->removeUsers(movingNames[i]);
+        }
+    }
+    return true;
+}
+
+bool ShardedUserStore::removeShard(const std::string& shardName) {
+    int index = findShard(shardName);
+    // Its users would have nowhere to go
+    if (index < 0 || shards.size() == 1) {
+        return false;
+    }
+
+    // Shard indices shift, so the ring is rebuilt from the remaining shards
+    std::vector<UserShard*> remaining;
+    ConsistentHashRing remainingRing;
+    for (size_t i = 0; i < shards.size(); i++) {
+        if (static_cast<int>(i) != index) {
+            remainingRing.addShard(static_cast<int>(remaining.size()), shardNames[i]);
+            remaining.push_back(shards[i].get());
+        }
+    }
+
+    std::vector<std::vector<User>> moving(remaining.size());
+    std::vector<std::string> movingNames;
+    for (const auto& user : shards[index]->getAllUsers()) {
+        std::string name(user.name());
+        moving[remainingRing.shardFor(name)].push_back(user);
+        movingNames.push_back(std::move(name));
+    }
+    std::vector<std::vector<std::string>> copied(remaining.size());
+    bool complete = true;
+    for (size_t i = 0; i < remaining.size() && complete; i++) {
+        if (!moving[i].empty()) {
+            copied[i] = remaining[i]->insertUsers(moving[i]);
+            complete = copied[i].size() == moving[i].size();
+        }
+    }
+    if (!complete) {
+        // The leaving shard still has everyone, so only the copies are undone
+        for (size_t i = 0; i < remaining.size(); i++) {
+            if (!copied[i].empty()) {
+                remaining[i]->removeUsers(copied[i]);
+            }
+        }
+        return false;
+    }
+
+    std::unique_ptr<UserShard> leaving = std::move(shards[index]);
+    shards.erase(shards.begin() + index);
+    shardNames.erase(shardNames.begin() + index);
+    ring = remainingRing;
+    if (!movingNames.empty()) {
+        leaving->removeUsers(movingNames);
+    }
+    return true;
+}
+
+std::vector<std::string> ShardedUserStore::getShardNames() const {
+    return shardNames;
+}
+
+std::string ShardedUserStore::shardFor(const std::string& username) const {
+    int index = ring.shardFor(username);
+    return (index >= 0) ? shardNames[index] : std::string();
+}
+
+UserShard* ShardedUserStore::route(const std::string& username) const {
+    int index = ring.shardFor(username);
+    return (index >= 0) ? shards[index].get() : nullptr;
+}
+
+bool ShardedUserStore::insertUser(const std::string& username, const std::string& passwordHash) {
+    UserShard* shard = route(username);
+    return shard != nullptr && shard->insertUser(User(username, PasswordDigest::fromCredential(passwordHash)));
+}
+
+bool ShardedUserStore::authenticateUser(const std::string& username,
+                                        const std::string& passwordHash) {
+    UserShard* shard = route(username);
+    return shard != nullptr && shard->authenticateUser(username, passwordHash);
+}
+
+bool ShardedUserStore::userExists(const std::string& username) {
+    UserShard* shard = route(username);
+    return shard != nullptr && shard->userExists(username);
+}
+
+void ShardedUserStore::removeUser(const std::string& username) {
+    UserShard* shard = route(username);
+    if (shard != nullptr) {
+        shard->removeUser(username);
+    }
+}
+
+bool ShardedUserStore::getUser(const std::string& username, User& user) {
+    UserShard* shard = route(username);
+    return shard != nullptr && shard->getUser(username, user);
+}
+
+void ShardedUserStore::updateUser(const std::string& username, const User& user) {
+    UserShard* shard = route(username);
+    if (shard != nullptr) {
+        shard->updateUser(username, user);
+    }
+}
+
+std::vector<std::string> ShardedUserStore::getAllUsers() {
+    std::vector<std::string> users;
+    for (const auto& shard : shards) {
+        for (const auto& user : shard->getAllUsers()) {
+            users.emplace_back(user.name());
+        }
+    }
+    return users;
+}
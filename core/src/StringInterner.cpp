@@ -0,0 +1,74 @@
+#include "StringInterner.h"
+#include <cstring>
+#include <mutex>
+
+StringInterner::StringInterner() : chunkUsed(CHUNK_SIZE) {}
+
+UserId StringInterner::intern(std::string_view name) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(name);
+        if (it != ids.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto it = ids.find(name);
+    if (it != ids.end()) {
+        return it->second;
+    }
+
+    std::string_view stored = store(name);
+    UserId id = static_cast<UserId>(names.size());
+    names.push_back(stored);
+    ids.emplace(stored, id);
+    return id;
+}
+
+UserId StringInterner::find(std::string_view name) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = ids.find(name);
+    return (it != ids.end()) ? it->second : INVALID_USER_ID;
+}
+
+std::string_view StringInterner::name(UserId id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    if (id < names.size()) {
+        return names[id];
+    }
+    return {};
+}
+
+std::size_t StringInterner::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return names.size();
+}
+
+StringInterner& StringInterner::shared() {
+    static StringInterner instance;
+    return instance;
+}
+
+std::string_view StringInterner::store(std::string_view name) {
+    if (name.empty()) {
+        return std::string_view("", 0);
+    }
+
+    // Oversized names get a chunk of their own so the current chunk keeps its free space
+    if (name.size() > CHUNK_SIZE / 4) {
+        largeChunks.push_back(std::make_unique<char[]>(name.size()));
+        std::memcpy(largeChunks.back().get(), name.data(), name.size());
+        return std::string_view(largeChunks.back().get(), name.size());
+    }
+
+    if (chunkUsed + name.size() > CHUNK_SIZE) {
+        chunks.push_back(std::make_unique<char[]>(CHUNK_SIZE));
+        chunkUsed = 0;
+    }
+
+    char* dest = chunks.back().get() + chunkUsed;
+    std::memcpy(dest, name.data(), name.size());
+    chunkUsed += name.size();
+    return std::string_view(dest, name.size());
+}
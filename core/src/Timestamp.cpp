@@ -0,0 +1,157 @@
+#include "Timestamp.h"
+#include <chrono>
+#include <ctime>
+
+namespace {
+
+const std::int64_t MILLIS_PER_DAY = 86400000;
+
+// Proleptic Gregorian calendar conversions (H. Hinnant's days_from_civil/civil_from_days)
+std::int64_t daysFromCivil(std::int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2 ? 1 : 0;
+    std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+    unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<std::int64_t>(dayOfEra) - 719468;
+}
+
+void civilFromDays(std::int64_t days, std::int64_t& year, unsigned& month, unsigned& day) {
+    days += 719468;
+    std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    unsigned dayOfEra = static_cast<unsigned>(days - era * 146097);
+    unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    unsigned monthIndex = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    year = static_cast<std::int64_t>(yearOfEra) + era * 400 + (month <= 2 ? 1 : 0);
+}
+
+void appendDigits(std::string& out, std::int64_t value, int width) {
+    char digits[20];
+    for (int i = width - 1; i >= 0; i--) {
+        digits[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    out.append(digits, static_cast<std::size_t>(width));
+}
+
+bool readDigits(const std::string& text, std::size_t pos, int width, int& value) {
+    value = 0;
+    for (int i = 0; i < width; i++) {
+        char c = text[pos + static_cast<std::size_t>(i)];
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        value = value * 10 + (c - '0');
+    }
+    return true;
+}
+
+std::string formatFields(std::int64_t year, std::int64_t month, std::int64_t day, std::int64_t hour,
+                         std::int64_t minute, std::int64_t second) {
+    std::string text;
+    text.reserve(19);
+    appendDigits(text, year, 4);
+    text += '-';
+    appendDigits(text, month, 2);
+    text += '-';
+    appendDigits(text, day, 2);
+    text += ' ';
+    appendDigits(text, hour, 2);
+    text += ':';
+    appendDigits(text, minute, 2);
+    text += ':';
+    appendDigits(text, second, 2);
+    return text;
+}
+
+// "YYYY-MM-DD HH:MM:SS" into calendar fields, range-checked; no time zone applied
+bool readFields(const std::string& text, std::tm& fields) {
+    if (text.size() != 19 || text[4] != '-' || text[7] != '-' || text[10] != ' ' ||
+        text[13] != ':' || text[16] != ':') {
+        return false;
+    }
+    int year, month, day, hour, minute, second;
+    if (!readDigits(text, 0, 4, year) || !readDigits(text, 5, 2, month) ||
+        !readDigits(text, 8, 2, day) || !readDigits(text, 11, 2, hour) ||
+        !readDigits(text, 14, 2, minute) || !readDigits(text, 17, 2, second)) {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 ||
+        second > 60) {
+        return false;
+    }
+    fields.tm_year = year - 1900;
+    fields.tm_mon = month - 1;
+    fields.tm_mday = day;
+    fields.tm_hour = hour;
+    fields.tm_min = minute;
+    fields.tm_sec = second;
+    return true;
+}
+
+}  // namespace
+
+EpochMillis currentEpochMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+std::string formatTimestamp(EpochMillis time) {
+    std::int64_t days = time / MILLIS_PER_DAY;
+    std::int64_t millisOfDay = time % MILLIS_PER_DAY;
+    if (millisOfDay < 0) {
+        millisOfDay += MILLIS_PER_DAY;
+        days--;
+    }
+    std::int64_t year;
+    unsigned month, day;
+    civilFromDays(days, year, month, day);
+    std::int64_t seconds = millisOfDay / 1000;
+    return formatFields(year, month, day, seconds / 3600, (seconds / 60) % 60, seconds % 60);
+}
+
+std::string formatLocalTimestamp(EpochMillis time) {
+    std::time_t seconds = static_cast<std::time_t>(time / 1000 - (time % 1000 < 0 ? 1 : 0));
+    std::tm fields{};
+#ifdef _WIN32
+    if (localtime_s(&fields, &seconds) != 0) {
+        return formatTimestamp(time);
+    }
+#else
+    if (localtime_r(&seconds, &fields) == nullptr) {
+        return formatTimestamp(time);
+    }
+#endif
+    return formatFields(fields.tm_year + 1900, fields.tm_mon + 1, fields.tm_mday, fields.tm_hour, fields.tm_min,
+                        fields.tm_sec);
+}
+
+bool parseTimestamp(const std::string& text, EpochMillis& time) {
+    std::tm fields{};
+    if (!readFields(text, fields)) {
+        return false;
+    }
+    std::int64_t days = daysFromCivil(fields.tm_year + 1900, static_cast<unsigned>(fields.tm_mon + 1),
+                                      static_cast<unsigned>(fields.tm_mday));
+    time = days * MILLIS_PER_DAY + ((fields.tm_hour * 60 + fields.tm_min) * 60 + fields.tm_sec) * 1000LL;
+    return true;
+}
+
+bool parseLocalTimestamp(const std::string& text, EpochMillis& time) {
+    std::tm fields{};
+    if (!readFields(text, fields)) {
+        return false;
+    }
+    // Let mktime work out whether daylight saving applied on that date
+    fields.tm_isdst = -1;
+    std::time_t seconds = std::mktime(&fields);
+    if (seconds == static_cast<std::time_t>(-1)) {
+        return false;
+    }
+    time = static_cast<EpochMillis>(seconds) * 1000;
+    return true;
+}
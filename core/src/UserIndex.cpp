@@ -0,0 +1,96 @@
+#include "UserIndex.h"
+#include "UserManager.h"
+
+UserIndex::UserIndex(int minRatedGames) : minRatedGames(minRatedGames) {}
+
+void UserIndex::addUser(const User& user) {
+    std::string_view name = StringInterner::shared().name(user.id);
+    Stats entry{user.gamesWon, user.gamesPlayed};
+
+    names.insert(name);
+    stats[user.id] = entry;
+    insertRanks(name, entry);
+}
+
+void UserIndex::updateUser(const User& user) {
+    auto it = stats.find(user.id);
+    if (it == stats.end()) {
+        addUser(user);
+        return;
+    }
+
+    std::string_view name = StringInterner::shared().name(user.id);
+    Stats entry{user.gamesWon, user.gamesPlayed};
+    if (it->second.wins == entry.wins && it->second.played == entry.played) {
+        return;
+    }
+    eraseRanks(name, it->second);
+    it->second = entry;
+    insertRanks(name, entry);
+}
+
+void UserIndex::removeUser(const User& user) {
+    auto it = stats.find(user.id);
+    if (it == stats.end()) {
+        return;
+    }
+
+    std::string_view name = StringInterner::shared().name(user.id);
+    eraseRanks(name, it->second);
+    names.erase(name);
+    stats.erase(it);
+}
+
+void UserIndex::clear() {
+    names.clear();
+    byWins.clear();
+    byWinRate.clear();
+    stats.clear();
+}
+
+std::vector<std::string> UserIndex::searchPrefix(const std::string& prefix,
+                                                 std::size_t limit) const {
+    std::vector<std::string> matches;
+    for (auto it = names.lower_bound(prefix); it != names.end() && matches.size() < limit; ++it) {
+        if (it->compare(0, prefix.size(), prefix) != 0) {
+            break;
+        }
+        matches.emplace_back(*it);
+    }
+    return matches;
+}
+
+std::vector<std::string> UserIndex::topByWins(std::size_t k) const {
+    std::vector<std::string> top;
+    for (auto it = byWins.begin(); it != byWins.end() && top.size() < k; ++it) {
+        top.emplace_back(it->name);
+    }
+    return top;
+}
+
+std::vector<std::string> UserIndex::topByWinRate(std::size_t k) const {
+    std::vector<std::string> top;
+    for (auto it = byWinRate.begin(); it != byWinRate.end() && top.size() < k; ++it) {
+        top.emplace_back(it->name);
+    }
+    return top;
+}
+
+void UserIndex::insertRanks(std::string_view name, const Stats& entry) {
+    byWins.insert(WinsKey{entry.wins, name});
+    if (entry.played >= minRatedGames && entry.played > 0) {
+        byWinRate.insert(rateKey(name, entry));
+    }
+}
+
+void UserIndex::eraseRanks(std::string_view name, const Stats& entry) {
+    byWins.erase(WinsKey{entry.wins, name});
+    if (entry.played >= minRatedGames && entry.played > 0) {
+        byWinRate.erase(rateKey(name, entry));
+    }
+}
+
+UserIndex::RateKey UserIndex::rateKey(std::string_view name, const Stats& entry) {
+    double rate = static_cast<double>(entry.wins) / static_cast<double>(entry.played);
+    return RateKey{rate, entry.wins, name};
+}
@@ -1,17 +1,77 @@
 #include "UserManager.h"
+#include "Metrics.h"
+#include "PersistenceService.h"
 #include <algorithm>
+#include <chrono>
+#include <random>
 
-UserHashTable::UserHashTable() {
+// Unknown users are checked against a hash of a random secret so that the
+// response time does not reveal whether the account exists. The hash must
+// cost what a real user's does, so it is made with the table's parameters.
+static PasswordDigest hashOfRandomSecret(const PasswordHasher::Params& params) {
+    std::random_device device;
+    std::string secret;
+    for (int i = 0; i < 4; i++) {
+        secret += std::to_string(device());
+    }
+    return PasswordDigest::fromCredential(PasswordHasher::hashPassword(secret, params));
+}
+
+// Shared by every table on the default parameters
+static const PasswordDigest& defaultUnknownUser() {
+    static const PasswordDigest digest = hashOfRandomSecret(PasswordHasher::Params());
+    return digest;
+}
+
+User::User(const std::string& username, const PasswordDigest& password)
+    : id(StringInterner::shared().intern(username)), password(password), gamesPlayed(0),
+      gamesWon(0), gamesLost(0), gamesTied(0) {}
+
+UserHashTable::UserHashTable() : UserHashTable("users.dat") {}
+
+UserHashTable::UserHashTable(const std::string& usersFile)
+    : names(StringInterner::shared()), usersFile(usersFile), unknownUser(defaultUnknownUser()) {
     loadUsers();
 }
 
 UserHashTable::~UserHashTable() {
     saveUsers();
+    // A queued snapshot reads the records, so it must be taken before they go
+    if (lastSave.valid()) {
+        lastSave.wait();
+    }
 }
 
-int UserHashTable::hashFunction(const std::string& key) {
-    std::hash<std::string> hasher;
-    return hasher(key) % BUCKET_SIZE;
+std::uint32_t UserHashTable::findSlot(const std::string& username) const {
+    return slotOf(names.find(username));
+}
+
+std::uint32_t UserHashTable::slotOf(UserId id) const {
+    if (id == INVALID_USER_ID || id >= slotById.size()) {
+        return NO_SLOT;
+    }
+    return slotById[id];
+}
+
+void UserHashTable::storeUser(const User& user) {
+    std::lock_guard<std::mutex> lock(recordsMutex);
+    User record = user;
+    std::uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+        records[slot] = std::move(record);
+    } else {
+        slot = static_cast<std::uint32_t>(records.size());
+        records.push_back(std::move(record));
+    }
+
+    UserId id = records[slot].id;
+    if (id >= slotById.size()) {
+        slotById.resize(id + 1, NO_SLOT);
+    }
+    slotById[id] = slot;
+    index.addUser(records[slot]);
 }
 
 bool UserHashTable::insertUser(const std::string& username, const std::string& passwordHash) {
@@ -19,80 +79,154 @@ bool UserHashTable::insertUser(const std::string& username, const std::string& p
         return false;
     }
 
-    int index = hashFunction(username);
-    User newUser(username, passwordHash);
-    table[index].emplace_back(username, newUser);
+    storeUser(User(username, PasswordDigest::fromCredential(passwordHash)));
     saveUsers();
     return true;
 }
 
 bool UserHashTable::authenticateUser(const std::string& username, const std::string& passwordHash) {
-    int index = hashFunction(username);
+    std::uint32_t slot = findSlot(username);
+    return slot != NO_SLOT && records[slot].password.matches(passwordHash);
+}
 
-    for (const auto& pair : table[index]) {
-        if (pair.first == username && pair.second.passwordHash == passwordHash) {
-            return true;
-        }
+bool UserHashTable::registerUser(const std::string& username, const std::string& password) {
+    if (userExists(username)) {
+        return false;
     }
-    return false;
+    return insertUser(username, PasswordHasher::hashPassword(password, passwordParams));
 }
 
-bool UserHashTable::userExists(const std::string& username) {
-    int index = hashFunction(username);
+bool UserHashTable::verifyPassword(const std::string& username, const std::string& password) {
+    std::uint32_t slot = findSlot(username);
+    if (slot == NO_SLOT) {
+        unknownUser.verify(password);
+        return false;
+    }
+    return records[slot].password.verify(password);
+}
 
-    for (const auto& pair : table[index]) {
-        if (pair.first == username) {
-            return true;
-        }
+std::future<bool> UserHashTable::verifyPasswordAsync(const std::string& username,
+                                                     const std::string& password,
+                                                     AsyncPasswordHasher& hasher) {
+    std::uint32_t slot = findSlot(username);
+    if (slot == NO_SLOT) {
+        // Nobody knows the secret behind this hash, so the result is always false
+        return hasher.verifyAsync(password, unknownUser);
     }
-    return false;
+    return hasher.verifyAsync(password, records[slot].password);
 }
 
-void UserHashTable::removeUser(const std::string& username) {
-    int index = hashFunction(username);
+bool UserHashTable::setPasswordParams(const PasswordHasher::Params& params) {
+    if (!PasswordHasher::validParams(params)) {
+        return false;
+    }
+    passwordParams = params;
+    // Built here rather than on the first unknown login, which would stand out by its cost
+    unknownUser = hashOfRandomSecret(params);
+    return true;
+}
+
+bool UserHashTable::userExists(const std::string& username) {
+    return findSlot(username) != NO_SLOT;
+}
 
-    auto& bucket = table[index];
-    bucket.remove_if([&username](const std::pair<std::string, User>& pair) {
-        return pair.first == username;
-    });
+void UserHashTable::eraseUser(std::uint32_t slot) {
+    std::lock_guard<std::mutex> lock(recordsMutex);
+    User& record = records[slot];
+    index.removeUser(record);
+    slotById[record.id] = NO_SLOT;
+    record = User();
+    freeSlots.push_back(slot);
+}
+
+void UserHashTable::removeUser(const std::string& username) {
+    std::uint32_t slot = findSlot(username);
+    if (slot != NO_SLOT) {
+        eraseUser(slot);
+    }
     saveUsers();
 }
 
-User* UserHashTable::getUser(const std::string& username) {
-    int index = hashFunction(username);
+std::vector<std::string> UserHashTable::insertUsers(const std::vector<User>& users) {
+    std::vector<std::string> inserted;
+    for (const auto& user : users) {
+        if (user.id != INVALID_USER_ID && slotOf(user.id) == NO_SLOT) {
+            storeUser(user);
+            inserted.emplace_back(user.name());
+        }
+    }
+    if (!inserted.empty()) {
+        saveUsers();
+    }
+    return inserted;
+}
 
-    for (auto& pair : table[index]) {
-        if (pair.first == username) {
-            return &pair.second;
+std::size_t UserHashTable::removeUsers(const std::vector<std::string>& usernames) {
+    std::size_t removed = 0;
+    for (const auto& username : usernames) {
+        std::uint32_t slot = findSlot(username);
+        if (slot != NO_SLOT) {
+            eraseUser(slot);
+            removed++;
         }
     }
-    return nullptr;
+    if (removed > 0) {
+        saveUsers();
+    }
+    return removed;
+}
+
+User* UserHashTable::getUser(const std::string& username) {
+    std::uint32_t slot = findSlot(username);
+    return (slot != NO_SLOT) ? &records[slot] : nullptr;
 }
 
 void UserHashTable::updateUser(const std::string& username, const User& user) {
-    int index = hashFunction(username);
+    std::uint32_t slot = findSlot(username);
+    if (slot == NO_SLOT) {
+        return;
+    }
 
-    for (auto& pair : table[index]) {
-        if (pair.first == username) {
-            pair.second = user;
-            saveUsers();
-            return;
-        }
+    User& record = records[slot];
+    {
+        std::lock_guard<std::mutex> lock(recordsMutex);
+        UserId id = record.id;
+        record = user;
+        record.id = id;
     }
+    index.updateUser(record);
+    saveUsers();
 }
 
 std::vector<std::string> UserHashTable::getAllUsers() {
     std::vector<std::string> users;
-    for (int i = 0; i < BUCKET_SIZE; i++) {
-        for (const auto& pair : table[i]) {
-            users.push_back(pair.first);
+    users.reserve(records.size() - freeSlots.size());
+    for (const auto& record : records) {
+        if (record.id != INVALID_USER_ID) {
+            users.emplace_back(record.name());
         }
     }
     return users;
 }
 
+std::vector<std::string> UserHashTable::searchUsers(const std::string& prefix, std::size_t limit) {
+    return index.searchPrefix(prefix, limit);
+}
+
+std::vector<std::string> UserHashTable::getTopByWins(std::size_t k) {
+    return index.topByWins(k);
+}
+
+std::vector<std::string> UserHashTable::getTopByWinRate(std::size_t k) {
+    return index.topByWinRate(k);
+}
+
 void UserHashTable::loadUsers() {
-    std::ifstream file("users.dat");
+    if (usersFile.empty()) {
+        return;
+    }
+    GAME_METRICS_TIMED(Metric::LOAD_USERS);
+    std::ifstream file(usersFile);
     if (!file.is_open()) {
         return;
     }
@@ -104,38 +238,85 @@ void UserHashTable::loadUsers() {
         int gamesPlayed, gamesWon, gamesLost, gamesTied;
 
         if (iss >> username >> passwordHash >> gamesPlayed >> gamesWon >> gamesLost >> gamesTied) {
-            User user(username, passwordHash);
+            User user(username, PasswordDigest::fromStored(passwordHash));
             user.gamesPlayed = gamesPlayed;
             user.gamesWon = gamesWon;
             user.gamesLost = gamesLost;
             user.gamesTied = gamesTied;
 
-            int index = hashFunction(username);
-            table[index].emplace_back(username, user);
+            if (!userExists(username)) {
+                storeUser(user);
+            }
         }
     }
     file.close();
 }
 
 void UserHashTable::saveUsers() {
-    std::ofstream file("users.dat");
+    if (usersFile.empty()) {
+        return;
+    }
+    GAME_METRICS_TIMED(Metric::SAVE_USERS);
+    writes++;
+    if (persistence != nullptr) {
+        std::lock_guard<std::mutex> lock(recordsMutex);
+        // A snapshot not yet taken by the writer will include this change too
+        if (!snapshotQueued) {
+            snapshotQueued = true;
+            lastSave = persistence->replaceWith(usersFile, [this]() { return snapshotUsers(); }).share();
+        }
+        saveFailed = false;
+        return;
+    }
+    std::ofstream file(usersFile);
     if (!file.is_open()) {
+        saveFailed = true;
         return;
     }
+    writeUsers(file);
+    file.close();
+    saveFailed = !file;
+}
+
+std::future<bool> UserHashTable::durable() {
+    if (lastSave.valid() && lastSave.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        saveFailed = saveFailed || !lastSave.get();
+        lastSave = std::shared_future<bool>();
+    }
+    if (saveFailed) {
+        saveUsers();
+    }
+    if (persistence != nullptr && !usersFile.empty()) {
+        return persistence->flush(usersFile);
+    }
+    std::promise<bool> done;
+    done.set_value(!saveFailed);
+    return done.get_future();
+}
 
-    for (int i = 0; i < BUCKET_SIZE; i++) {
-        for (const auto& pair : table[i]) {
-            const User& user = pair.second;
-            file << user.username << " " << user.passwordHash << " "
-                 << user.gamesPlayed << " " << user.gamesWon << " "
-                 << user.gamesLost << " " << user.gamesTied << "\n";
+void UserHashTable::writeUsers(std::ostream& out) const {
+    for (const auto& user : records) {
+        if (user.id == INVALID_USER_ID) {
+            continue;
         }
+        out << user.name() << " " << user.password.toString() << " "
+            << user.gamesPlayed << " " << user.gamesWon << " "
+            << user.gamesLost << " " << user.gamesTied << "\n";
     }
-    file.close();
+}
+
+std::string UserHashTable::snapshotUsers() {
+    std::lock_guard<std::mutex> lock(recordsMutex);
+    snapshotQueued = false;
+    std::ostringstream contents;
+    writeUsers(contents);
+    return contents.str();
 }
 
 void UserHashTable::clear() {
-    for (int i = 0; i < BUCKET_SIZE; i++) {
-        table[i].clear();
-    }
+    std::lock_guard<std::mutex> lock(recordsMutex);
+    records.clear();
+    slotById.clear();
+    freeSlots.clear();
+    index.clear();
 }
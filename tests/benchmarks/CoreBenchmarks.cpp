@@ -0,0 +1,291 @@
+#include <benchmark/benchmark.h>
+#include "GameBoard.h"
+#include "GameHistory.h"
+#include "UserManager.h"
+#include "SyntheticData.h"
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+// Run with --benchmark_out=<file> --benchmark_out_format=json to get a report
+// that can be diffed between builds. The largest arguments need several GB of
+// RAM; use --benchmark_filter to skip them on small machines.
+
+namespace {
+
+const std::size_t POSITION_COUNT = 4096;
+
+// Users a history of the given size is spread over
+std::size_t usersForRecords(std::size_t records) {
+    return std::max<std::size_t>(records / 20, 100);
+}
+
+std::map<std::size_t, std::string>& historyFiles() {
+    static std::map<std::size_t, std::string> files;
+    return files;
+}
+
+// History files are generated once per size and reused by every benchmark
+std::string historyFileFor(std::size_t records) {
+    auto& files = historyFiles();
+    auto it = files.find(records);
+    if (it != files.end()) {
+        return it->second;
+    }
+
+    std::string path = "bench_history_" + std::to_string(records) + ".dat";
+    synthetic::writeHistoryFile(path, synthetic::randomGames(records, usersForRecords(records)));
+    files[records] = path;
+    return path;
+}
+
+}  // namespace
+
+// === GameBoard ===
+
+static void BM_GameBoard_MakeMove(benchmark::State& state) {
+    GameBoard board;
+    int cell = 0;
+    for (auto _ : state) {
+        if (cell == 9) {
+            board.reset();
+            cell = 0;
+        }
+        benchmark::DoNotOptimize(board.makeMove(cell / 3, cell % 3, (cell % 2 == 0) ? 'X' : 'O'));
+        cell++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GameBoard_MakeMove);
+
+static void BM_GameBoard_CheckWin(benchmark::State& state) {
+    std::vector<GameBoard> positions = synthetic::randomPositions(POSITION_COUNT);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(positions[i].checkWin());
+        i = (i + 1) % positions.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GameBoard_CheckWin);
+
+static void BM_GameBoard_GetAvailableMoves(benchmark::State& state) {
+    std::vector<GameBoard> positions = synthetic::randomPositions(POSITION_COUNT);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(positions[i].getAvailableMoves());
+        i = (i + 1) % positions.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GameBoard_GetAvailableMoves);
+
+// === GameHistory ===
+
+static void BM_GameHistory_AddGameRecord(benchmark::State& state) {
+    std::size_t records = static_cast<std::size_t>(state.range(0));
+    GameHistory history("");
+    for (const auto& record : synthetic::randomGames(records, usersForRecords(records))) {
+        history.addGameRecord(record);
+    }
+    std::vector<GameRecord> incoming = synthetic::randomGames(1024, 100, synthetic::DEFAULT_SEED + 1);
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        history.addGameRecord(incoming[i]);
+        i = (i + 1) % incoming.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GameHistory_AddGameRecord)->Arg(10000)->Arg(1000000)->Arg(10000000);
+
+// Includes the full-file rewrite that every addGameRecord() performs today
+static void BM_GameHistory_AddGameRecordPersisted(benchmark::State& state) {
+    std::size_t records = static_cast<std::size_t>(state.range(0));
+    std::string path = "bench_history_add.dat";
+    std::vector<GameRecord> seed = synthetic::randomGames(records, usersForRecords(records));
+    synthetic::writeHistoryFile(path, seed);
+    GameHistory history(path);
+
+    for (auto _ : state) {
+        history.addGameRecord(seed.back());
+    }
+    state.SetItemsProcessed(state.iterations());
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_GameHistory_AddGameRecordPersisted)->Arg(1000)->Arg(10000);
+
+// Bulk import of a batch onto an existing file: one sequential append per batch
+static void BM_GameHistory_AddGameRecordsPersisted(benchmark::State& state) {
+    std::size_t batch = static_cast<std::size_t>(state.range(0));
+    std::string path = "bench_history_bulk.dat";
+    synthetic::writeHistoryFile(path, synthetic::randomGames(10000, usersForRecords(10000)));
+    std::vector<GameRecord> incoming = synthetic::randomGames(batch, 100, synthetic::DEFAULT_SEED + 1);
+    GameHistory history(path);
+
+    for (auto _ : state) {
+        history.addGameRecords(incoming.begin(), incoming.end());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch));
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_GameHistory_AddGameRecordsPersisted)->Arg(1000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BM_GameHistory_LoadHistory(benchmark::State& state) {
+    std::size_t records = static_cast<std::size_t>(state.range(0));
+    std::string path = historyFileFor(records);
+    for (auto _ : state) {
+        GameHistory history(path);
+        benchmark::DoNotOptimize(history.getAllGames().size());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(records));
+}
+BENCHMARK(BM_GameHistory_LoadHistory)
+    ->Arg(10000)
+    ->Arg(1000000)
+    ->Arg(10000000)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_GameHistory_GetUserGames(benchmark::State& state) {
+    std::size_t records = static_cast<std::size_t>(state.range(0));
+    std::size_t users = usersForRecords(records);
+    GameHistory history("");
+    for (const auto& record : synthetic::randomGames(records, users)) {
+        history.addGameRecord(record);
+    }
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(history.getUserGames(synthetic::userName(i % users)));
+        i += 7919;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GameHistory_GetUserGames)
+    ->Arg(10000)
+    ->Arg(1000000)
+    ->Arg(10000000)
+    ->Unit(benchmark::kMicrosecond);
+
+// An ad-hoc filter no index covers: every tie between two players
+static void BM_GameHistory_FindGames(benchmark::State& state) {
+    std::size_t records = static_cast<std::size_t>(state.range(0));
+    GameHistory history("");
+    for (const auto& record : synthetic::randomGames(records, usersForRecords(records))) {
+        history.addGameRecord(record);
+    }
+    GameFilter filter;
+    filter.matchMode = true;
+    filter.mode = GameMode::PLAYER_VS_PLAYER;
+    filter.matchResult = true;
+    filter.result = GameResult::TIE;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(history.countGames(filter));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(records));
+}
+BENCHMARK(BM_GameHistory_FindGames)
+    ->Arg(10000)
+    ->Arg(1000000)
+    ->Unit(benchmark::kMicrosecond);
+
+// === UserHashTable ===
+
+// Every name goes into StringInterner::shared(), which never shrinks, so a
+// process keeps the names of every size it ran: after the 10M case the smaller
+// sizes share the interner with 10M names. Run each size in its own process to
+// measure it alone, e.g. --benchmark_filter='UserHashTable.*/1000$'.
+const std::size_t MAX_USERS = 10000000;
+// Names the insert benchmark cycles through, numbered past every filled table
+const std::size_t INSERT_POOL = 4096;
+
+static void fillUsers(UserHashTable& table, std::size_t count) {
+    for (std::size_t i = 0; i < count; i++) {
+        table.insertUser(synthetic::userName(i), "hash" + std::to_string(i));
+    }
+}
+
+static void BM_UserHashTable_Insert(benchmark::State& state) {
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    UserHashTable table("");
+    fillUsers(table, count);
+
+    std::vector<std::string> names;
+    for (std::size_t i = 0; i < INSERT_POOL; i++) {
+        names.push_back(synthetic::userName(MAX_USERS + i));
+    }
+
+    // The same pool is reinserted, so the table stays near count users and
+    // the interner does not grow with the iteration count
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(table.insertUser(names[i], "hash"));
+        if (++i == names.size()) {
+            state.PauseTiming();
+            table.removeUsers(names);
+            i = 0;
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_UserHashTable_Insert)->RangeMultiplier(10)->Range(1000, MAX_USERS);
+
+static void BM_UserHashTable_Lookup(benchmark::State& state) {
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    UserHashTable table("");
+    fillUsers(table, count);
+
+    std::vector<std::string> names;
+    std::mt19937 rng(synthetic::DEFAULT_SEED);
+    for (int i = 0; i < 4096; i++) {
+        names.push_back(synthetic::userName(std::uniform_int_distribution<std::size_t>(0, count - 1)(rng)));
+    }
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(table.getUser(names[i]));
+        i = (i + 1) % names.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_UserHashTable_Lookup)->RangeMultiplier(10)->Range(1000, MAX_USERS);
+
+static void BM_UserHashTable_Authenticate(benchmark::State& state) {
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    UserHashTable table("");
+    fillUsers(table, count);
+
+    std::vector<std::pair<std::string, std::string>> credentials;
+    std::mt19937 rng(synthetic::DEFAULT_SEED);
+    for (int i = 0; i < 4096; i++) {
+        std::size_t user = std::uniform_int_distribution<std::size_t>(0, count - 1)(rng);
+        credentials.emplace_back(synthetic::userName(user), "hash" + std::to_string(user));
+    }
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(table.authenticateUser(credentials[i].first, credentials[i].second));
+        i = (i + 1) % credentials.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_UserHashTable_Authenticate)->RangeMultiplier(10)->Range(1000, MAX_USERS);
+
+int main(int argc, char** argv) {
+    benchmark::AddCustomContext("synthetic_seed", std::to_string(synthetic::DEFAULT_SEED));
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    for (const auto& entry : historyFiles()) {
+        std::remove(entry.second.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+#ifndef SYNTHETICDATA_H
+#define SYNTHETICDATA_H
+
+#include "GameBoard.h"
+#include "GameHistory.h"
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// Deterministic generators for benchmark inputs. Every generator takes its
+// own seed, so two builds benchmarked with the same arguments see identical data.
+namespace synthetic {
+
+const std::uint32_t DEFAULT_SEED = 20250611;
+
+inline std::string userName(std::size_t index) {
+    return "user" + std::to_string(index);
+}
+
+// Plays uniformly random legal moves until the game ends
+inline GameRecord randomGame(std::mt19937& rng, const std::string& player1,
+                             const std::string& player2) {
+    GameBoard board;
+    GameRecord record;
+    record.player1 = player1;
+    record.player2 = player2;
+    record.mode = GameMode::PLAYER_VS_PLAYER;
+    record.timestamp = "2025-06-11 12:00:00";
+
+    char player = 'X';
+    GameResult result = GameResult::ONGOING;
+    while (result == GameResult::ONGOING) {
+        auto moves = board.getAvailableMoves();
+        auto move = moves[std::uniform_int_distribution<std::size_t>(0, moves.size() - 1)(rng)];
+        board.makeMove(move.first, move.second, player);
+        record.moves.push_back(Move(move.first, move.second, player));
+        result = board.checkWin();
+        player = (player == 'X') ? 'O' : 'X';
+    }
+
+    record.result = result;
+    record.finalBoard = board.getBoard();
+    return record;
+}
+
+// count games between players drawn from a pool of userCount names
+inline std::vector<GameRecord> randomGames(std::size_t count, std::size_t userCount,
+                                           std::uint32_t seed = DEFAULT_SEED) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::size_t> pickUser(0, userCount - 1);
+    std::vector<GameRecord> games;
+    games.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        games.push_back(randomGame(rng, userName(pickUser(rng)), userName(pickUser(rng))));
+    }
+    return games;
+}
+
+// Boards reached after a random number of random moves, including finished ones
+inline std::vector<GameBoard> randomPositions(std::size_t count, std::uint32_t seed = DEFAULT_SEED) {
+    std::mt19937 rng(seed);
+    std::vector<GameBoard> positions;
+    positions.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        GameBoard board;
+        int plies = std::uniform_int_distribution<int>(0, 9)(rng);
+        char player = 'X';
+        for (int p = 0; p < plies && board.checkWin() == GameResult::ONGOING; p++) {
+            auto moves = board.getAvailableMoves();
+            auto move =
+                moves[std::uniform_int_distribution<std::size_t>(0, moves.size() - 1)(rng)];
+            board.makeMove(move.first, move.second, player);
+            player = (player == 'X') ? 'O' : 'X';
+        }
+        positions.push_back(board);
+    }
+    return positions;
+}
+
+// Replaces path with a history of records written by GameHistory itself, so
+// fixtures always match the current file format. addGameRecords() appends
+// the whole batch at once rather than rewriting the file per record.
+inline void writeHistoryFile(const std::string& path, const std::vector<GameRecord>& records) {
+    std::remove(path.c_str());
+    GameHistory history(path);
+    history.addGameRecords(records.begin(), records.end());
+}
+
+}  // namespace synthetic
+
+#endif // SYNTHETICDATA_H
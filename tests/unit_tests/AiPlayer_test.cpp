@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include "AiPlayer.h"
+#include "TestBoards.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class AiPlayerTest : public ::testing::Test {
+protected:
+    // Plays every X move against the AI's O replies; counts the games X won
+    static void playAllReplies(AiPlayer& ai, Difficulty difficulty, GameBoard board, int& games, int& xWins) {
+        for (const auto& cell : board.getAvailableMoves()) {
+            GameBoard next = board;
+            next.makeMove(cell.first, cell.second, 'X');
+            GameResult result = next.checkWin();
+            if (result == GameResult::ONGOING) {
+                AiMove move;
+                ASSERT_TRUE(ai.chooseMove(next, 'O', difficulty, move));
+                ASSERT_TRUE(next.makeMove(move.row, move.col, 'O'));
+                result = next.checkWin();
+            }
+            if (result == GameResult::ONGOING) {
+                playAllReplies(ai, difficulty, next, games, xWins);
+                continue;
+            }
+            games++;
+            xWins += (result == GameResult::PLAYER1_WIN);
+        }
+    }
+};
+
+// === EVALUATION TESTS ===
+TEST_F(AiPlayerTest, EvaluationCountsOpenLines) {
+    EXPECT_EQ(AiPlayer::evaluate(GameBoard(), 'X'), 0);
+    // The centre is on four lines, a corner on three
+    EXPECT_EQ(AiPlayer::evaluate(boardOf({"   ", " X ", "   "}), 'X'), 4);
+    EXPECT_EQ(AiPlayer::evaluate(boardOf({"   ", " X ", "   "}), 'O'), -4);
+    EXPECT_EQ(AiPlayer::evaluate(boardOf({"O  ", " X ", "   "}), 'X'), 3 - 2);
+    // Two marks in a line are worth four of one
+    EXPECT_EQ(AiPlayer::evaluate(boardOf({"XX ", "   ", "   "}), 'X'), 4 + 1 + 1 + 1);
+    EXPECT_EQ(AiPlayer::evaluate(boardOf({"XXX", "OO ", "   "}), 'X'), AlphaBetaEngine::WIN_SCORE);
+    EXPECT_EQ(AiPlayer::evaluate(boardOf({"XXX", "OO ", "   "}), 'O'), -AlphaBetaEngine::WIN_SCORE);
+}
+
+TEST_F(AiPlayerTest, EasyPlaysTheBestEvaluatedMove) {
+    AiPlayer ai;
+    std::vector<GameBoard> boards{GameBoard(), boardOf({"X  ", " O ", "   "}),
+                                  boardOf({"X  O", " O  ", "  X ", "    "}, 3),
+                                  boardOf({"X    ", " O   ", "  X  ", " O   ", "     "}, 4)};
+    for (const auto& board : boards) {
+        AiMove move;
+        ASSERT_TRUE(ai.chooseMove(board, 'X', Difficulty::EASY, move));
+        EXPECT_EQ(move.difficulty, Difficulty::EASY);
+        EXPECT_EQ(move.nodes, board.getAvailableMoves().size());
+        GameBoard chosen = board;
+        ASSERT_TRUE(chosen.makeMove(move.row, move.col, 'X'));
+        int best = AiPlayer::evaluate(chosen, 'X');
+        for (const auto& cell : board.getAvailableMoves()) {
+            GameBoard other = board;
+            other.makeMove(cell.first, cell.second, 'X');
+            EXPECT_LE(AiPlayer::evaluate(other, 'X'), best);
+        }
+    }
+}
+
+TEST_F(AiPlayerTest, EasyTakesAWin) {
+    AiPlayer ai;
+    AiMove move;
+    ASSERT_TRUE(ai.chooseMove(boardOf({"OO ", "XX ", "   "}), 'O', Difficulty::EASY, move));
+    EXPECT_EQ(move.row, 0);
+    EXPECT_EQ(move.col, 2);
+}
+
+// === TIER TESTS ===
+TEST_F(AiPlayerTest, MediumBlocksAThreat) {
+    AiPlayer ai;
+    AiMove move;
+    ASSERT_TRUE(ai.chooseMove(boardOf({"X  ", "OO ", "  X"}), 'X', Difficulty::MEDIUM, move));
+    EXPECT_EQ(move.difficulty, Difficulty::MEDIUM);
+    EXPECT_EQ(move.row, 1);
+    EXPECT_EQ(move.col, 2);
+}
+
+TEST_F(AiPlayerTest, HardNeverLoses) {
+    AiPlayer ai;
+    int games = 0;
+    int xWins = 0;
+    playAllReplies(ai, Difficulty::HARD, GameBoard(), games, xWins);
+    EXPECT_GT(games, 0);
+    EXPECT_EQ(xWins, 0);
+}
+
+TEST_F(AiPlayerTest, EasyCanBeBeaten) {
+    AiPlayer ai;
+    int games = 0;
+    int xWins = 0;
+    playAllReplies(ai, Difficulty::EASY, GameBoard(), games, xWins);
+    EXPECT_GT(xWins, 0);
+}
+
+TEST_F(AiPlayerTest, HardAnswersFromTheDatabase) {
+    const std::string path = "ai_player_test.tpd";
+    ASSERT_TRUE(PositionDatabase::generate(path, PositionDatabaseConfig()));
+    PositionDatabase database;
+    ASSERT_TRUE(database.open(path));
+    AiPlayer ai(&database);
+
+    AiMove move;
+    ASSERT_TRUE(ai.chooseMove(boardOf({"X X", " O ", "  O"}), 'X', Difficulty::HARD, move));
+    EXPECT_TRUE(move.fromDatabase);
+    EXPECT_EQ(move.nodes, 1u);
+    EXPECT_EQ(move.row, 0);
+    EXPECT_EQ(move.col, 1);
+
+    // Equal marks with O to move is a game O opened; the database only knows X opening it
+    ASSERT_TRUE(ai.chooseMove(boardOf({"X  ", " O ", "   "}), 'O', Difficulty::HARD, move));
+    EXPECT_FALSE(move.fromDatabase);
+    // Other board sizes are searched
+    ASSERT_TRUE(ai.chooseMove(GameBoard(4, 4, 3), 'X', Difficulty::HARD, move));
+    EXPECT_FALSE(move.fromDatabase);
+    database.close();
+    std::remove(path.c_str());
+}
+
+TEST_F(AiPlayerTest, CheaperTiersSearchLess) {
+    AiPlayerConfig config;
+    config.hardLimits = SearchLimits();
+    config.hardLimits.maxNodes = 20000;
+    AiPlayer ai(nullptr, config);
+    GameBoard board(9, 9, 4);
+    board.makeMove(4, 4, 'X');
+    board.makeMove(4, 5, 'O');
+    board.makeMove(3, 3, 'X');
+
+    AiMove easy;
+    AiMove medium;
+    AiMove hard;
+    ASSERT_TRUE(ai.chooseMove(board, 'O', Difficulty::EASY, easy));
+    ASSERT_TRUE(ai.chooseMove(board, 'O', Difficulty::MEDIUM, medium));
+    ASSERT_TRUE(ai.chooseMove(board, 'O', Difficulty::HARD, hard));
+    EXPECT_EQ(easy.nodes, 78u);
+    EXPECT_LT(easy.nodes, medium.nodes);
+    EXPECT_LT(medium.nodes, hard.nodes);
+}
+
+// === LOAD SHEDDING TESTS ===
+TEST_F(AiPlayerTest, CapDowngradesLaterMoves) {
+    AiPlayer ai;
+    EXPECT_EQ(ai.difficultyCap(), Difficulty::HARD);
+    ai.setDifficultyCap(Difficulty::EASY);
+    AiMove move;
+    ASSERT_TRUE(ai.chooseMove(GameBoard(), 'X', Difficulty::HARD, move));
+    EXPECT_EQ(move.difficulty, Difficulty::EASY);
+    EXPECT_EQ(move.nodes, 9u);
+
+    ai.setDifficultyCap(Difficulty::MEDIUM);
+    ASSERT_TRUE(ai.chooseMove(GameBoard(), 'X', Difficulty::HARD, move));
+    EXPECT_EQ(move.difficulty, Difficulty::MEDIUM);
+    // The cap never raises a game's difficulty
+    ASSERT_TRUE(ai.chooseMove(GameBoard(), 'X', Difficulty::EASY, move));
+    EXPECT_EQ(move.difficulty, Difficulty::EASY);
+}
+
+TEST_F(AiPlayerTest, BoardsTooLargeToSearchGetEasy) {
+    AiPlayer ai;
+    AiMove move;
+    GameBoard board(40, 40, 5);
+    board.makeMove(20, 20, 'X');
+    ASSERT_TRUE(ai.chooseMove(board, 'O', Difficulty::HARD, move));
+    EXPECT_EQ(move.difficulty, Difficulty::EASY);
+    EXPECT_EQ(board.getCell(move.row, move.col), ' ');
+}
+
+TEST_F(AiPlayerTest, RefusesFinishedGames) {
+    AiPlayer ai;
+    AiMove move;
+    EXPECT_FALSE(ai.chooseMove(boardOf({"XXX", "OO ", "   "}), 'O', Difficulty::EASY, move));
+    EXPECT_FALSE(ai.chooseMove(boardOf({"XOX", "XOO", "OXX"}), 'X', Difficulty::HARD, move));
+    EXPECT_FALSE(ai.chooseMove(GameBoard(), '?', Difficulty::EASY, move));
+}
+
+TEST_F(AiPlayerTest, ParsesDifficultyNames) {
+    Difficulty difficulty;
+    ASSERT_TRUE(AiPlayer::parseDifficulty("medium", difficulty));
+    EXPECT_EQ(difficulty, Difficulty::MEDIUM);
+    EXPECT_STREQ(AiPlayer::difficultyName(Difficulty::HARD), "hard");
+    EXPECT_FALSE(AiPlayer::parseDifficulty("Hard", difficulty));
+    EXPECT_FALSE(AiPlayer::parseDifficulty("", difficulty));
+}
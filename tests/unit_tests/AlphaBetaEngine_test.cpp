@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include "AlphaBetaEngine.h"
+#include "PositionDatabase.h"
+#include "TestBoards.h"
+#include <cstdio>
+#include <set>
+#include <string>
+#include <vector>
+
+class AlphaBetaEngineTest : public ::testing::Test {
+protected:
+    static SearchLimits unlimited() {
+        SearchLimits limits;
+        limits.maxNodes = 0;
+        return limits;
+    }
+
+    // The line must be made of distinct empty cells, starting with the chosen move
+    static void expectLegalLine(const GameBoard& board, const SearchResult& result) {
+        ASSERT_FALSE(result.principalVariation.empty());
+        EXPECT_EQ(result.principalVariation[0], result.row * board.getCols() + result.col);
+        std::set<int> seen;
+        for (int cell : result.principalVariation) {
+            EXPECT_TRUE(seen.insert(cell).second);
+            EXPECT_EQ(board.getCell(cell / board.getCols(), cell % board.getCols()), ' ');
+        }
+    }
+};
+
+// === MOVE CHOICE TESTS ===
+TEST_F(AlphaBetaEngineTest, TakesImmediateWin) {
+    AlphaBetaEngine engine;
+    SearchResult result;
+    ASSERT_TRUE(engine.chooseMove(boardOf({"XX ", "OO ", "   "}), 'X', SearchLimits(), result));
+    EXPECT_EQ(result.row, 0);
+    EXPECT_EQ(result.col, 2);
+    EXPECT_EQ(result.score, AlphaBetaEngine::WIN_SCORE - 1);
+    EXPECT_TRUE(result.solved);
+    EXPECT_EQ(result.depth, 1);
+}
+
+TEST_F(AlphaBetaEngineTest, BlocksOpponentWin) {
+    AlphaBetaEngine engine;
+    SearchResult result;
+    GameBoard board = boardOf({"X  ", "OO ", "  X"});
+    ASSERT_TRUE(engine.chooseMove(board, 'X', SearchLimits(), result));
+    EXPECT_EQ(result.row, 1);
+    EXPECT_EQ(result.col, 2);
+    expectLegalLine(board, result);
+}
+
+TEST_F(AlphaBetaEngineTest, SolvesTheEmptyBoardAsADraw) {
+    AlphaBetaEngine engine;
+    SearchResult result;
+    ASSERT_TRUE(engine.chooseMove(GameBoard(), 'X', unlimited(), result));
+    EXPECT_TRUE(result.solved);
+    EXPECT_EQ(result.score, 0);
+    EXPECT_EQ(result.depth, 9);
+    expectLegalLine(GameBoard(), result);
+}
+
+TEST_F(AlphaBetaEngineTest, AgreesWithTheSolvedDatabase) {
+    const std::string path = "alpha_beta_engine_test.tpd";
+    ASSERT_TRUE(PositionDatabase::generate(path, PositionDatabaseConfig()));
+    PositionDatabase database;
+    ASSERT_TRUE(database.open(path));
+
+    // Every position after three moves, with O to move
+    AlphaBetaEngine engine(16);
+    std::size_t checked = 0;
+    GameBoard empty;
+    for (const auto& first : empty.getAvailableMoves()) {
+        GameBoard one = empty;
+        one.makeMove(first.first, first.second, 'X');
+        for (const auto& second : one.getAvailableMoves()) {
+            GameBoard two = one;
+            two.makeMove(second.first, second.second, 'O');
+            for (const auto& third : two.getAvailableMoves()) {
+                GameBoard board = two;
+                board.makeMove(third.first, third.second, 'X');
+                PositionEntry expected;
+                ASSERT_TRUE(database.lookup(board, expected));
+                SearchResult result;
+                ASSERT_TRUE(engine.chooseMove(board, 'O', unlimited(), result));
+                ASSERT_TRUE(result.solved);
+                int value = result.score > 0 ? 2 : result.score < 0 ? 0 : 1;
+                EXPECT_EQ(value, static_cast<int>(expected.value));
+
+                // The chosen move keeps the value
+                GameBoard after = board;
+                after.makeMove(result.row, result.col, 'O');
+                PositionEntry reply;
+                ASSERT_TRUE(database.lookup(after, reply));
+                EXPECT_EQ(2 - static_cast<int>(reply.value), static_cast<int>(expected.value));
+                checked++;
+            }
+        }
+    }
+    EXPECT_EQ(checked, 504u);
+    database.close();
+    std::remove(path.c_str());
+}
+
+TEST_F(AlphaBetaEngineTest, FindsForcedWinOnRectangularBoard) {
+    // The first player wins 3,4,3
+    AlphaBetaEngine engine;
+    SearchResult result;
+    ASSERT_TRUE(engine.chooseMove(GameBoard(3, 4, 3), 'X', unlimited(), result));
+    EXPECT_TRUE(result.solved);
+    EXPECT_GT(result.score, AlphaBetaEngine::WIN_THRESHOLD);
+    expectLegalLine(GameBoard(3, 4, 3), result);
+}
+
+TEST_F(AlphaBetaEngineTest, FindsWinOnLargeBoard) {
+    GameBoard board(15, 15, 5);
+    board.makeMove(7, 5, 'X');
+    board.makeMove(0, 0, 'O');
+    board.makeMove(7, 6, 'X');
+    board.makeMove(0, 14, 'O');
+    board.makeMove(7, 7, 'X');
+    board.makeMove(14, 0, 'O');
+
+    // An open three becomes an open four that cannot be stopped
+    AlphaBetaEngine engine;
+    SearchResult result;
+    SearchLimits limits;
+    limits.maxNodes = 200000;
+    ASSERT_TRUE(engine.chooseMove(board, 'X', limits, result));
+    EXPECT_EQ(result.row, 7);
+    EXPECT_TRUE(result.col == 4 || result.col == 8);
+    EXPECT_GT(result.score, AlphaBetaEngine::WIN_THRESHOLD);
+    expectLegalLine(board, result);
+}
+
+// === BUDGET TESTS ===
+TEST_F(AlphaBetaEngineTest, NodeBudgetIsHonoured) {
+    AlphaBetaEngine engine;
+    SearchResult result;
+    SearchLimits limits;
+    limits.maxNodes = 5000;
+    GameBoard board(19, 19, 5);
+    board.makeMove(9, 9, 'X');
+    ASSERT_TRUE(engine.chooseMove(board, 'O', limits, result));
+    EXPECT_GE(result.depth, 1);
+    EXPECT_FALSE(result.solved);
+    EXPECT_EQ(board.getCell(result.row, result.col), ' ');
+    // The first iteration always finishes; later ones stop at the budget
+    EXPECT_LE(result.nodes, 5000u + 400u);
+    expectLegalLine(board, result);
+}
+
+TEST_F(AlphaBetaEngineTest, HardLimitStopsARunningIteration) {
+    GameBoard board(32, 32, 6);
+    board.makeMove(16, 16, 'X');
+    board.makeMove(16, 17, 'O');
+    SearchLimits limits;
+    limits.maxNodes = 0;
+    limits.hardMillis = 30;
+    AlphaBetaEngine engine;
+    SearchResult result;
+    ASSERT_TRUE(engine.chooseMove(board, 'X', limits, result));
+    EXPECT_GE(result.depth, 1);
+    EXPECT_LT(result.elapsedMillis, 500);
+    EXPECT_EQ(board.getCell(result.row, result.col), ' ');
+}
+
+TEST_F(AlphaBetaEngineTest, SoftLimitStartsNoNewIteration) {
+    GameBoard board(15, 15, 5);
+    board.makeMove(7, 7, 'X');
+    SearchLimits limits;
+    limits.maxNodes = 0;
+    limits.softMillis = 1;
+    limits.maxDepth = 3;
+    AlphaBetaEngine engine;
+    SearchResult deep;
+    ASSERT_TRUE(engine.chooseMove(board, 'O', limits, deep));
+    EXPECT_LE(deep.depth, 3);
+
+    limits.softMillis = 0;
+    limits.maxDepth = 2;
+    SearchResult shallow;
+    ASSERT_TRUE(engine.chooseMove(board, 'O', limits, shallow));
+    EXPECT_EQ(shallow.depth, 2);
+    EXPECT_EQ(shallow.principalVariation.size(), 2u);
+}
+
+TEST_F(AlphaBetaEngineTest, ReusedTableGivesTheSameMove) {
+    GameBoard board = boardOf({"X    ", " O   ", "  X  ", "     ", "     "}, 4);
+    SearchLimits limits;
+    limits.maxDepth = 4;
+    AlphaBetaEngine engine;
+    SearchResult first;
+    ASSERT_TRUE(engine.chooseMove(board, 'O', limits, first));
+    SearchResult second;
+    ASSERT_TRUE(engine.chooseMove(board, 'O', limits, second));
+    EXPECT_EQ(second.score, first.score);
+    EXPECT_LE(second.nodes, first.nodes);
+
+    engine.reset();
+    SearchResult fresh;
+    ASSERT_TRUE(engine.chooseMove(board, 'O', limits, fresh));
+    EXPECT_EQ(fresh.score, first.score);
+    EXPECT_EQ(fresh.row * 5 + fresh.col, first.row * 5 + first.col);
+}
+
+TEST_F(AlphaBetaEngineTest, RefusesFinishedGames) {
+    AlphaBetaEngine engine;
+    SearchResult result;
+    EXPECT_FALSE(engine.chooseMove(boardOf({"XXX", "OO ", "   "}), 'O', SearchLimits(), result));
+    EXPECT_FALSE(engine.chooseMove(boardOf({"XOX", "XOO", "OXX"}), 'X', SearchLimits(), result));
+    EXPECT_FALSE(engine.chooseMove(GameBoard(40, 40, 5), 'X', SearchLimits(), result));
+    EXPECT_EQ(result.row, -1);
+}
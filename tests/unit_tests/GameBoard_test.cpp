@@ -417,3 +417,48 @@ TEST_F(GameBoardTest, MultipleWinConditions) {
     board.makeMove(2, 0, 'X');
     EXPECT_EQ(board.checkWin(), GameResult::PLAYER1_WIN);
 }
+
+// === M,N,K BOARD TESTS ===
+TEST_F(GameBoardTest, CustomSizeBoard) {
+    GameBoard wide(4, 6, 4);
+    EXPECT_EQ(wide.getRows(), 4);
+    EXPECT_EQ(wide.getCols(), 6);
+    EXPECT_EQ(wide.getWinLength(), 4);
+    EXPECT_EQ(wide.getAvailableMoves().size(), 24u);
+    EXPECT_TRUE(wide.makeMove(3, 5, 'X'));
+    EXPECT_FALSE(wide.makeMove(4, 0, 'X'));
+}
+
+TEST_F(GameBoardTest, InvalidSizesFallBackToClassic) {
+    GameBoard fallback(0, -2, 9);
+    EXPECT_EQ(fallback.getRows(), 3);
+    EXPECT_EQ(fallback.getCols(), 3);
+    EXPECT_EQ(fallback.getWinLength(), 3);
+}
+
+TEST_F(GameBoardTest, LargeBoardNeedsFullLine) {
+    GameBoard large(7, 7, 5);
+    for (int i = 0; i < 4; ++i) {
+        large.makeMove(2, i + 1, 'O');
+    }
+    EXPECT_EQ(large.checkWin(), GameResult::ONGOING);
+    large.makeMove(2, 5, 'O');
+    EXPECT_EQ(large.checkWin(), GameResult::PLAYER2_WIN);
+}
+
+TEST_F(GameBoardTest, LargeBoardDiagonals) {
+    GameBoard large(6, 6, 4);
+    for (int i = 0; i < 4; ++i) {
+        large.makeMove(1 + i, 4 - i, 'X');
+    }
+    EXPECT_EQ(large.checkWin(), GameResult::PLAYER1_WIN);
+}
+
+TEST_F(GameBoardTest, SetBoardMustMatchCustomSize) {
+    GameBoard wide(2, 4, 2);
+    std::vector<std::vector<char>> cells = {{'X', ' ', ' ', ' '}, {' ', 'X', ' ', ' '}};
+    wide.setBoard(cells);
+    EXPECT_EQ(wide.checkWin(), GameResult::PLAYER1_WIN);
+    wide.setBoard(std::vector<std::vector<char>>(3, std::vector<char>(3, 'O')));
+    EXPECT_EQ(wide.getCell(0, 0), 'X');
+}
@@ -5,9 +5,41 @@
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <iterator>
+#include <thread>
+#include <cstdlib>
+#include <ctime>
+
+// Pins the process time zone for a scope; POSIX TZ rules need no zone database
+class ScopedTimeZone {
+public:
+    explicit ScopedTimeZone(const char* zone) {
+        const char* old = std::getenv("TZ");
+        hadZone = old != nullptr;
+        if (hadZone) {
+            previous = old;
+        }
+        setenv("TZ", zone, 1);
+        tzset();
+    }
+    ~ScopedTimeZone() {
+        if (hadZone) {
+            setenv("TZ", previous.c_str(), 1);
+        } else {
+            unsetenv("TZ");
+        }
+        tzset();
+    }
+
+private:
+    bool hadZone;
+    std::string previous;
+};
  
 class GameHistoryTest : public ::testing::Test {
 protected:
+    // Legacy stamps are local time; expectations below are written for UTC
+    ScopedTimeZone zone{"UTC0"};
     GameHistory history;
     GameRecord sampleRecord1, sampleRecord2, sampleRecord3;
 
@@ -282,12 +314,46 @@ TEST_F(GameHistoryTest, RecordWithEmptyBoard) {
 
 // === TIMESTAMP TESTS ===
 TEST_F(GameHistoryTest, TimestampPreservation) {
+    // The legacy writer used std::localtime: 12:30:45 EST is 17:30:45 UTC
+    ScopedTimeZone newYork("EST5EDT,M3.2.0,M11.1.0");
     std::string timestamp = "2025-12-25 12:30:45";
     GameRecord rec("user1", "user2", GameMode::PLAYER_VS_PLAYER, GameResult::PLAYER1_WIN,
                    std::vector<std::vector<char>>(3, std::vector<char>(3, 'X')), timestamp);
     history.addGameRecord(rec);
     auto games = history.getUserGames("user1");
-    EXPECT_EQ(games[0].timestamp, timestamp);
+    EXPECT_EQ(games[0].displayTimestamp(), timestamp);
+    EXPECT_TRUE(games[0].timestamp.empty());
+    EXPECT_EQ(games[0].time, 1766683845000LL);
+}
+
+TEST_F(GameHistoryTest, UnparseableTimestampIsKeptAsText) {
+    GameRecord rec = sampleRecord1;
+    rec.timestamp = "yesterday";
+    history.addGameRecord(rec);
+
+    GameHistory reloaded;
+    auto games = reloaded.getAllGames();
+    ASSERT_EQ(games.size(), 1u);
+    EXPECT_EQ(games[0].time, 0);
+    EXPECT_EQ(games[0].timestamp, "yesterday");
+}
+
+TEST_F(GameHistoryTest, EpochTimestampSurvivesReload) {
+    GameRecord rec = sampleRecord1;
+    rec.timestamp.clear();
+    rec.time = 1749643200000LL;
+    history.addGameRecord(rec);
+
+    GameHistory reloaded;
+    auto games = reloaded.getUserGames("alice");
+    ASSERT_EQ(games.size(), 1u);
+    EXPECT_EQ(games[0].time, 1749643200000LL);
+    EXPECT_TRUE(games[0].timestamp.empty());
+    EXPECT_EQ(games[0].displayTimestamp(), "2025-06-11 12:00:00");
+}
+
+TEST_F(GameHistoryTest, LegacyTimestampIsDisplayedAsIs) {
+    EXPECT_EQ(sampleRecord1.displayTimestamp(), "2025-06-11 12:00:00");
 }
 
 
@@ -299,6 +365,54 @@ TEST_F(GameHistoryTest, SaveHistoryCreatesFile) {
     file.close();
 }
 
+TEST_F(GameHistoryTest, MovesAndMoveTimesSurviveReload) {
+    GameRecord rec = sampleRecord1;
+    rec.time = 1749643205000LL;
+    rec.moves = {Move(0, 0, 'X', 1749643200000LL, 1), Move(1, 1, 'O', 1749643202500LL, 2),
+                 Move(2, 2, 'X', 1749643205000LL, 3)};
+    history.addGameRecord(rec);
+
+    GameHistory reloaded;
+    auto games = reloaded.getUserGames("alice");
+    ASSERT_EQ(games.size(), 1u);
+    ASSERT_EQ(games[0].moves.size(), 3u);
+    EXPECT_EQ(games[0].moves[1].row, 1);
+    EXPECT_EQ(games[0].moves[1].col, 1);
+    EXPECT_EQ(games[0].moves[1].player, 'O');
+    EXPECT_EQ(games[0].moves[1].time, 1749643202500LL);
+}
+
+TEST_F(GameHistoryTest, LoadsLegacyMoveFormat) {
+    {
+        std::ofstream file("game_history.dat");
+        file << "alice|bob|0|0|2025-06-11 12:00:00|XXXOO    |0,0,X;1,0,O;0,1,X;1,1,O;0,2,X;\n";
+    }
+    GameHistory legacy;
+    auto games = legacy.getUserGames("alice");
+    ASSERT_EQ(games.size(), 1u);
+    ASSERT_EQ(games[0].moves.size(), 5u);
+    EXPECT_EQ(games[0].moves[3].row, 1);
+    EXPECT_EQ(games[0].moves[3].player, 'O');
+    EXPECT_EQ(games[0].time, 1749643200000LL);
+    EXPECT_EQ(games[0].displayTimestamp(), "2025-06-11 12:00:00");
+}
+
+TEST_F(GameHistoryTest, PackedMovesAreSmallerOnDisk) {
+    GameRecord rec = sampleRecord1;
+    for (int i = 0; i < 9; ++i) {
+        rec.moves.push_back(Move(i / 3, i % 3, (i % 2 == 0) ? 'X' : 'O'));
+    }
+    history.addGameRecord(rec);
+
+    std::ifstream file("game_history.dat");
+    std::string line;
+    std::getline(file, line);
+    std::string movesField = line.substr(line.rfind('|') + 1);
+    EXPECT_EQ(movesField[0], '~');
+    // The readable form would take six characters per move
+    EXPECT_LT(movesField.size(), 9u * 6u);
+}
+
 TEST_F(GameHistoryTest, LoadHistoryFromFile) {
     history.addGameRecord(sampleRecord1);
     
@@ -308,7 +422,579 @@ TEST_F(GameHistoryTest, LoadHistoryFromFile) {
     EXPECT_EQ(games[0].player1, "alice");
 }
 
+TEST_F(GameHistoryTest, BulkModeDefersSaveUntilEnd) {
+    history.beginBulk();
+    history.addGameRecord(sampleRecord1);
+    history.beginBulk();
+    history.addGameRecord(sampleRecord2);
+    history.endBulk();
+    EXPECT_TRUE(history.inBulk());
+    EXPECT_FALSE(std::ifstream("game_history.dat").good());
+
+    history.endBulk();
+    EXPECT_FALSE(history.inBulk());
+    GameHistory reloaded;
+    EXPECT_EQ(reloaded.getAllGames().size(), 2u);
+}
+
+// === BULK IMPORT / EXPORT TESTS ===
+TEST_F(GameHistoryTest, AddGameRecordsAppendsRangeAndPersists) {
+    history.addGameRecord(sampleRecord1);
+    std::vector<GameRecord> batch{sampleRecord2, sampleRecord3, sampleRecord2};
+    history.addGameRecords(batch.begin(), batch.end());
 
+    auto games = history.getAllGames();
+    ASSERT_EQ(games.size(), 4u);
+    EXPECT_NE(games[3].player1Id, INVALID_USER_ID);
+    EXPECT_EQ(games[3].player1Id, games[1].player1Id);
+    EXPECT_EQ(history.getUserGames("eve").size(), 1u);
+
+    GameHistory reloaded;
+    auto reloadedGames = reloaded.getAllGames();
+    ASSERT_EQ(reloadedGames.size(), 4u);
+    EXPECT_EQ(reloadedGames[0].player1, "alice");
+    EXPECT_EQ(reloadedGames[2].player1, "eve");
+}
+
+TEST_F(GameHistoryTest, AddGameRecordsInsideBulkWritesOnce) {
+    std::vector<GameRecord> batch{sampleRecord1, sampleRecord2};
+    history.beginBulk();
+    history.addGameRecords(batch.begin(), batch.end());
+    EXPECT_FALSE(std::ifstream("game_history.dat").good());
+    history.addGameRecord(sampleRecord3);
+    history.endBulk();
+
+    GameHistory reloaded;
+    EXPECT_EQ(reloaded.getAllGames().size(), 3u);
+}
+
+TEST_F(GameHistoryTest, ExportsCsv) {
+    sampleRecord1.moves = {Move(0, 0, 'X', 0, 1), Move(1, 1, 'O', 0, 2)};
+    history.addGameRecord(sampleRecord1);
+    std::ostringstream out;
+    history.exportRecords(out, ExportFormat::CSV);
+
+    std::istringstream lines(out.str());
+    std::string header;
+    std::string row;
+    std::getline(lines, header);
+    std::getline(lines, row);
+    EXPECT_EQ(header, "player1,player2,mode,result,time,timestamp,board,moves");
+    EXPECT_EQ(row, "alice,bob,PLAYER_VS_PLAYER,PLAYER1_WIN,1749643200000,2025-06-11 12:00:00,XXXXXXXXX,\"0,0,X;1,1,O;\"");
+}
+
+TEST_F(GameHistoryTest, ExportsNdjsonWithEscaping) {
+    GameRecord record = sampleRecord3;
+    record.player1 = "say \"hi\"";
+    record.time = 1000;
+    record.moves = {Move(2, 1, 'X', 1000, 1)};
+    history.addGameRecord(record);
+    std::ostringstream out;
+    history.exportRecords(out, ExportFormat::NDJSON);
+
+    EXPECT_EQ(out.str(),
+              "{\"player1\":\"say \\\"hi\\\"\",\"player2\":\"ai\",\"mode\":\"PLAYER_VS_AI\","
+              "\"result\":\"AI_WIN\",\"time\":1000,\"timestamp\":\"1970-01-01 00:00:01\","
+              "\"board\":\"---------\",\"moves\":[{\"row\":2,\"col\":1,\"player\":\"X\",\"time\":1000}]}\n");
+}
+
+TEST_F(GameHistoryTest, ExportFileStreamsWithoutLoading) {
+    std::vector<GameRecord> batch(250, sampleRecord2);
+    history.addGameRecords(batch.begin(), batch.end());
+
+    std::ostringstream streamed;
+    std::size_t exported = 0;
+    ASSERT_TRUE(GameHistory::exportFile("game_history.dat", streamed, ExportFormat::CSV, &exported));
+    EXPECT_EQ(exported, 250u);
+
+    std::ostringstream inMemory;
+    history.exportRecords(inMemory, ExportFormat::CSV);
+    EXPECT_EQ(streamed.str(), inMemory.str());
+    EXPECT_FALSE(GameHistory::exportFile("no_such_history.dat", streamed, ExportFormat::CSV));
+}
+
+// === TIME RANGE TESTS ===
+TEST_F(GameHistoryTest, GamesBetweenUsesHalfOpenRange) {
+    history.addGameRecord(sampleRecord1);
+    history.addGameRecord(sampleRecord2);
+    history.addGameRecord(sampleRecord3);
+
+    const EpochMillis noon = 1749643200000LL;
+    const EpochMillis hour = 3600000LL;
+    auto games = history.getGamesBetween(noon, noon + 2 * hour);
+    ASSERT_EQ(games.size(), 2u);
+    EXPECT_EQ(games[0].player1, "alice");
+    EXPECT_EQ(games[1].player1, "bob");
+    EXPECT_EQ(history.countGamesBetween(noon + 1, noon + hour), 0u);
+    EXPECT_EQ(history.countGamesBetween(noon + hour, noon), 0u);
+    EXPECT_EQ(history.getGamesSince(noon + 2 * hour).size(), 1u);
+}
+
+TEST_F(GameHistoryTest, OutOfOrderRecordsAreReturnedOldestFirst) {
+    history.addGameRecord(sampleRecord3);
+    history.addGameRecord(sampleRecord1);
+    GameRecord untimed = sampleRecord2;
+    untimed.timestamp.clear();
+    history.addGameRecord(untimed);
+    std::vector<GameRecord> batch{sampleRecord2};
+    history.addGameRecords(batch.begin(), batch.end());
+
+    auto games = history.getGamesSince(0);
+    ASSERT_EQ(games.size(), 3u);
+    EXPECT_EQ(games[0].player1, "alice");
+    EXPECT_EQ(games[1].player1, "bob");
+    EXPECT_EQ(games[2].player1, "eve");
+
+    EpochMillis oldest = 0;
+    EpochMillis newest = 0;
+    ASSERT_TRUE(history.getTimeSpan(oldest, newest));
+    EXPECT_EQ(oldest, 1749643200000LL);
+    EXPECT_EQ(newest, 1749650400000LL);
+}
+
+TEST_F(GameHistoryTest, TimeIndexIsRebuiltOnLoad) {
+    std::vector<GameRecord> batch;
+    for (int i = 0; i < 100; i++) {
+        GameRecord record = sampleRecord1;
+        record.timestamp.clear();
+        record.time = 1000000LL + i * 1000LL;
+        batch.push_back(record);
+    }
+    history.addGameRecords(batch.begin(), batch.end());
+
+    GameHistory reloaded;
+    EXPECT_EQ(reloaded.countGamesBetween(1010000LL, 1020000LL), 10u);
+    auto window = reloaded.getGamesBetween(1050000LL, 1052500LL);
+    ASSERT_EQ(window.size(), 3u);
+    EXPECT_EQ(window[2].time, 1052000LL);
+
+    GameHistory empty("");
+    EpochMillis oldest = 0;
+    EpochMillis newest = 0;
+    EXPECT_FALSE(empty.getTimeSpan(oldest, newest));
+}
+
+// === FILTER TESTS ===
+TEST_F(GameHistoryTest, FindGamesCombinesFilters) {
+    GameHistory memoryOnly("");
+    // Spans several chunks, with a partial one at the end
+    for (int i = 0; i < 2500; i++) {
+        memoryOnly.addGameRecord(i % 3 == 0 ? sampleRecord3 : (i % 2 == 0 ? sampleRecord1 : sampleRecord2));
+    }
+    GameFilter filter;
+    EXPECT_EQ(memoryOnly.findGames(filter).size(), 2500u);
+
+    filter.player = StringInterner::shared().find("alice");
+    EXPECT_EQ(memoryOnly.countGames(filter), 1666u);
+    filter.matchResult = true;
+    filter.result = GameResult::PLAYER2_WIN;
+    auto games = memoryOnly.findGames(filter);
+    ASSERT_EQ(games.size(), 833u);
+    EXPECT_EQ(games.front().player1, "bob");
+    EXPECT_EQ(games.back().player2, "alice");
+
+    GameFilter aiGames;
+    aiGames.matchMode = true;
+    aiGames.mode = GameMode::PLAYER_VS_AI;
+    EXPECT_EQ(memoryOnly.countGames(aiGames), 834u);
+    EXPECT_EQ(memoryOnly.snapshot().findGames(aiGames).size(), 834u);
+    aiGames.matchResult = true;
+    aiGames.result = GameResult::TIE;
+    EXPECT_TRUE(memoryOnly.findGames(aiGames).empty());
+}
+
+TEST_F(GameHistoryTest, FilterMatchesRecords) {
+    GameFilter filter;
+    EXPECT_TRUE(filter.matches(sampleRecord1));
+    filter.matchMode = true;
+    filter.mode = GameMode::PLAYER_VS_AI;
+    EXPECT_FALSE(filter.matches(sampleRecord1));
+    EXPECT_TRUE(filter.matches(sampleRecord3));
+}
+
+// === DEDUPLICATION TESTS ===
+TEST_F(GameHistoryTest, RepeatedBoardsAndMovesAreWrittenOnce) {
+    sampleRecord1.moves = {Move(0, 0, 'X'), Move(1, 1, 'O'), Move(0, 1, 'X')};
+    history.addGameRecord(sampleRecord1);
+    history.addGameRecord(sampleRecord1);
+    history.addGameRecord(sampleRecord2);
+
+    std::ifstream file("game_history.dat");
+    std::string first, second, third;
+    std::getline(file, first);
+    std::getline(file, second);
+    std::getline(file, third);
+    EXPECT_NE(first.find("|XXXXXXXXX|~"), std::string::npos);
+    EXPECT_EQ(second.substr(second.size() - 6), "|#0|=0");
+    EXPECT_NE(third.find("|OOOOOOOOO|"), std::string::npos);
+
+    GameHistory reloaded;
+    auto games = reloaded.getAllGames();
+    ASSERT_EQ(games.size(), 3u);
+    EXPECT_EQ(games[1].finalBoard, sampleRecord1.finalBoard);
+    ASSERT_EQ(games[1].moves.size(), 3u);
+    EXPECT_EQ(games[1].moves[2].col, 1);
+    EXPECT_EQ(games[1].moves[2].player, 'X');
+    EXPECT_TRUE(games[2].moves.empty());
+}
+
+TEST_F(GameHistoryTest, RepeatedMovesKeepTheirOwnTimes) {
+    GameRecord record = sampleRecord1;
+    record.timestamp.clear();
+    for (int game = 0; game < 3; game++) {
+        record.time = 1749643200000LL + game * 60000LL;
+        record.moves = {Move(2, 2, 'X', record.time - 3000 - game, 1), Move(0, 0, 'O', record.time, 2)};
+        history.addGameRecord(record);
+    }
+
+    GameHistory reloaded;
+    auto games = reloaded.getAllGames();
+    ASSERT_EQ(games.size(), 3u);
+    EXPECT_EQ(games[2].moves[0].time, 1749643320000LL - 3002);
+    EXPECT_EQ(games[2].moves[1].time, 1749643320000LL);
+    EXPECT_EQ(games[2].moves[0].row, 2);
+
+    std::ostringstream streamed;
+    ASSERT_TRUE(GameHistory::exportFile("game_history.dat", streamed, ExportFormat::NDJSON));
+    std::ostringstream inMemory;
+    reloaded.exportRecords(inMemory, ExportFormat::NDJSON);
+    EXPECT_EQ(streamed.str(), inMemory.str());
+}
+
+TEST_F(GameHistoryTest, AppendsContinueTheFileDictionary) {
+    history.addGameRecord(sampleRecord3);
+    {
+        GameHistory second;
+        second.addGameRecord(sampleRecord3);
+    }
+    std::ifstream file("game_history.dat");
+    std::string line;
+    std::getline(file, line);
+    std::getline(file, line);
+    EXPECT_EQ(line.substr(line.size() - 6), "|#0|=0");
+
+    GameHistory reloaded;
+    auto games = reloaded.getUserGames("eve");
+    ASSERT_EQ(games.size(), 2u);
+    EXPECT_EQ(games[1].finalBoard, sampleRecord3.finalBoard);
+}
+
+TEST_F(GameHistoryTest, InMemoryRecordsComeBackExactly) {
+    GameHistory memoryOnly("");
+    GameRecord record = sampleRecord2;
+    record.timestamp = "not a time";
+    record.finalBoard = {{'X', 'O'}, {' ', ' ', 'X', 'O'}};
+    record.moves = {Move(0, 1, 'O', 0, 7), Move(-1, 9, 'Z'), Move(1, 2, 'X', 1234, 2)};
+    memoryOnly.addGameRecord(record);
+    memoryOnly.addGameRecord(sampleRecord2);
+
+    auto games = memoryOnly.getAllGames();
+    ASSERT_EQ(games.size(), 2u);
+    EXPECT_EQ(games[0].timestamp, "not a time");
+    EXPECT_EQ(games[0].time, 0);
+    EXPECT_EQ(games[0].finalBoard, record.finalBoard);
+    ASSERT_EQ(games[0].moves.size(), 3u);
+    for (std::size_t i = 0; i < 3; i++) {
+        EXPECT_EQ(games[0].moves[i].row, record.moves[i].row);
+        EXPECT_EQ(games[0].moves[i].col, record.moves[i].col);
+        EXPECT_EQ(games[0].moves[i].player, record.moves[i].player);
+        EXPECT_EQ(games[0].moves[i].moveNumber, record.moves[i].moveNumber);
+        EXPECT_EQ(games[0].moves[i].time, record.moves[i].time);
+    }
+    EXPECT_EQ(games[1].player1, "bob");
+    EXPECT_EQ(games[1].finalBoard, sampleRecord2.finalBoard);
+}
+
+// === RETENTION TESTS ===
+class GameHistoryRetentionTest : public ::testing::Test {
+protected:
+    const std::string path = "retention_history.dat";
+    const EpochMillis now = 1760000000000LL;
+    const EpochMillis day = 86400000LL;
+    std::vector<GameRecord> old;
+
+    void SetUp() override {
+        removeFiles();
+        for (int i = 0; i < 100; i++) {
+            GameRecord record("ann", (i % 2 == 0) ? "ben" : "cat", GameMode::PLAYER_VS_PLAYER,
+                              GameResult::TIE, std::vector<std::vector<char>>(3, std::vector<char>(3, 'X')), "");
+            record.time = now - 3 * day + i * 1000LL;
+            old.push_back(record);
+        }
+    }
+
+    void TearDown() override {
+        removeFiles();
+    }
+
+    void removeFiles() {
+        std::remove(path.c_str());
+        for (int i = 0; i < 3; i++) {
+            std::remove((path + ".cold" + std::to_string(i)).c_str());
+        }
+    }
+
+    GameRecord recent(const std::string& player, EpochMillis age) {
+        GameRecord record = old[0];
+        record.player1 = player;
+        record.time = now - age;
+        return record;
+    }
+};
+
+TEST_F(GameHistoryRetentionTest, CompactionMovesOldGamesToColdSegment) {
+    GameHistory history(path);
+    history.addGameRecords(old.begin(), old.end());
+    history.addGameRecord(recent("dan", 3600000LL));
+    RetentionPolicy policy;
+    policy.hotDays = 1;
+    policy.minSegmentRecords = 10;
+    history.setRetentionPolicy(policy);
+
+    ASSERT_TRUE(history.compact(now));
+    EXPECT_EQ(history.getAllGames().size(), 101u);
+    history.waitForCompaction();
+    EXPECT_EQ(history.hotGameCount(), 1u);
+    EXPECT_EQ(history.coldGameCount(), 100u);
+    EXPECT_TRUE(std::ifstream(path + ".cold0").good());
+
+    auto games = history.getAllGames();
+    ASSERT_EQ(games.size(), 101u);
+    EXPECT_EQ(games[0].time, old[0].time);
+    EXPECT_EQ(games[100].player1, "dan");
+    EXPECT_EQ(history.getUserGames("ben").size(), 51u);
+    EXPECT_EQ(history.getUserGames("ann").size(), 100u);
+    GameFilter danGames;
+    danGames.player = StringInterner::shared().find("dan");
+    EXPECT_EQ(history.countGames(danGames), 1u);
+
+    GameHistory reloaded(path);
+    EXPECT_EQ(reloaded.hotGameCount(), 1u);
+    EXPECT_EQ(reloaded.coldGameCount(), 100u);
+    EXPECT_EQ(reloaded.getAllGames().size(), 101u);
+}
+
+TEST_F(GameHistoryRetentionTest, CrashBeforeHotFileIsCutDownServesGamesOnce) {
+    {
+        GameHistory history(path);
+        history.addGameRecords(old.begin(), old.end());
+        history.addGameRecord(recent("dan", 3600000LL));
+    }
+    // The hot file as it was when the segment was renamed into place
+    std::string uncut;
+    {
+        std::ifstream in(path);
+        uncut.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    {
+        GameHistory history(path);
+        RetentionPolicy policy;
+        policy.hotDays = 1;
+        policy.minSegmentRecords = 10;
+        history.setRetentionPolicy(policy);
+        ASSERT_TRUE(history.compact(now));
+        history.waitForCompaction();
+        history.addGameRecord(recent("eve", 60000LL));
+    }
+    std::ofstream(path, std::ios::trunc) << uncut;
+
+    GameHistory reloaded(path);
+    EXPECT_EQ(reloaded.coldGameCount(), 100u);
+    EXPECT_EQ(reloaded.hotGameCount(), 1u);
+    auto games = reloaded.getAllGames();
+    ASSERT_EQ(games.size(), 101u);
+    EXPECT_EQ(games[100].player1, "dan");
+    EXPECT_EQ(reloaded.getUserGames("ann").size(), 100u);
+
+    // Loading finished the cut-down, so the next load needs no skipping
+    reloaded.addGameRecord(recent("eve", 60000LL));
+    GameHistory again(path);
+    EXPECT_EQ(again.hotGameCount(), 2u);
+    EXPECT_EQ(again.getAllGames().size(), 102u);
+}
+
+TEST_F(GameHistoryRetentionTest, ExportFileIncludesColdSegments) {
+    std::string uncut;
+    {
+        GameHistory history(path);
+        history.addGameRecords(old.begin(), old.end());
+        history.addGameRecord(recent("dan", 3600000LL));
+        std::ifstream in(path);
+        uncut.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        RetentionPolicy policy;
+        policy.hotDays = 1;
+        policy.minSegmentRecords = 10;
+        history.setRetentionPolicy(policy);
+        ASSERT_TRUE(history.compact(now));
+        history.waitForCompaction();
+        ASSERT_EQ(history.hotGameCount(), 1u);
+    }
+
+    std::ostringstream streamed;
+    std::size_t exported = 0;
+    ASSERT_TRUE(GameHistory::exportFile(path, streamed, ExportFormat::CSV, &exported));
+    EXPECT_EQ(exported, 101u);
+    std::ostringstream inMemory;
+    GameHistory(path).exportRecords(inMemory, ExportFormat::CSV);
+    EXPECT_EQ(streamed.str(), inMemory.str());
+
+    // A compaction that died before cutting the hot file down exports each game once
+    std::ofstream(path, std::ios::trunc) << uncut;
+    std::ostringstream again;
+    ASSERT_TRUE(GameHistory::exportFile(path, again, ExportFormat::CSV, &exported));
+    EXPECT_EQ(exported, 101u);
+    EXPECT_EQ(again.str(), streamed.str());
+}
+
+TEST_F(GameHistoryRetentionTest, TimeQueriesSpanBothTiers) {
+    GameHistory history(path);
+    history.addGameRecords(old.begin(), old.end());
+    history.addGameRecord(recent("dan", 2 * day));
+    history.addGameRecord(recent("eve", 3600000LL));
+    RetentionPolicy policy;
+    policy.hotDays = 2;
+    policy.minSegmentRecords = 10;
+    history.setRetentionPolicy(policy);
+    ASSERT_TRUE(history.compact(now));
+    history.waitForCompaction();
+    ASSERT_EQ(history.hotGameCount(), 2u);
+
+    auto window = history.getGamesBetween(old[95].time, now);
+    ASSERT_EQ(window.size(), 7u);
+    EXPECT_EQ(window[0].time, old[95].time);
+    EXPECT_EQ(window[5].player1, "dan");
+    EXPECT_EQ(window[6].player1, "eve");
+    EXPECT_NE(window[0].player1Id, INVALID_USER_ID);
+    EXPECT_EQ(history.countGamesBetween(old[10].time, old[20].time), 10u);
+    EXPECT_EQ(history.getGamesSince(now - day).size(), 1u);
+
+    EpochMillis oldest = 0;
+    EpochMillis newest = 0;
+    ASSERT_TRUE(history.getTimeSpan(oldest, newest));
+    EXPECT_EQ(oldest, old[0].time);
+    EXPECT_EQ(newest, now - 3600000LL);
+}
+
+TEST_F(GameHistoryRetentionTest, AdditionsCompactInBackground) {
+    GameHistory history(path);
+    RetentionPolicy policy;
+    policy.hotDays = 1;
+    policy.minSegmentRecords = 10;
+    history.setRetentionPolicy(policy);
+    // The sample games are years old by the wall clock, so all of them are due
+    history.addGameRecords(old.begin(), old.end());
+    history.addGameRecord(old[0]);
+    history.waitForCompaction();
+
+    EXPECT_EQ(history.coldGameCount(), 100u);
+    EXPECT_EQ(history.hotGameCount(), 1u);
+    EXPECT_EQ(history.getAllGames().size(), 101u);
+    GameHistory reloaded(path);
+    EXPECT_EQ(reloaded.hotGameCount(), 1u);
+    EXPECT_EQ(reloaded.getAllGames().size(), 101u);
+}
+
+TEST_F(GameHistoryRetentionTest, CompactsOnlyWhenEnoughGamesAreDue) {
+    GameHistory history(path);
+    history.addGameRecords(old.begin(), old.begin() + 5);
+    EXPECT_FALSE(history.compact(now));
+    RetentionPolicy policy;
+    policy.hotDays = 1;
+    history.setRetentionPolicy(policy);
+    EXPECT_FALSE(history.compact(now));
+    EXPECT_FALSE(history.compact(now - 10 * day));
+    EXPECT_EQ(history.hotGameCount(), 5u);
+
+    GameHistory memoryOnly("");
+    memoryOnly.setRetentionPolicy(policy);
+    memoryOnly.addGameRecords(old.begin(), old.end());
+    EXPECT_FALSE(memoryOnly.compact(now));
+}
+
+// === SNAPSHOT TESTS ===
+TEST_F(GameHistoryTest, SnapshotIsUnchangedByLaterAdditions) {
+    GameHistory memoryOnly("");
+    EXPECT_EQ(memoryOnly.snapshot().size(), 0u);
+    memoryOnly.addGameRecord(sampleRecord1);
+    HistorySnapshot first = memoryOnly.snapshot();
+
+    // Enough games to fill several chunks
+    std::vector<GameRecord> more(3000, sampleRecord3);
+    memoryOnly.addGameRecords(more.begin(), more.end());
+    memoryOnly.addGameRecord(sampleRecord2);
+    HistorySnapshot second = memoryOnly.snapshot();
+
+    ASSERT_EQ(first.size(), 1u);
+    EXPECT_EQ(first.getAllGames()[0].player1, "alice");
+    EXPECT_TRUE(first.getUserGames("eve").empty());
+    EXPECT_EQ(second.size(), 3002u);
+    EXPECT_EQ(second.getUserGames("eve").size(), 3000u);
+    auto games = second.getAllGames();
+    EXPECT_EQ(games.back().player1, "bob");
+    EXPECT_EQ(games.back().finalBoard, sampleRecord2.finalBoard);
+    EXPECT_EQ(games.back().result, GameResult::PLAYER2_WIN);
+    EXPECT_EQ(HistorySnapshot().getAllGames().size(), 0u);
+}
+
+TEST_F(GameHistoryRetentionTest, SnapshotOutlivesCompaction) {
+    GameHistory history(path);
+    history.addGameRecords(old.begin(), old.end());
+    history.addGameRecord(recent("dan", 3600000LL));
+    RetentionPolicy policy;
+    policy.hotDays = 1;
+    policy.minSegmentRecords = 10;
+    history.setRetentionPolicy(policy);
+
+    HistorySnapshot before = history.snapshot();
+    ASSERT_TRUE(history.compact(now));
+    history.waitForCompaction();
+    history.addGameRecord(recent("eve", 1000LL));
+    HistorySnapshot after = history.snapshot();
+
+    EXPECT_EQ(before.hotGameCount(), 101u);
+    ASSERT_EQ(before.getAllGames().size(), 101u);
+    EXPECT_EQ(before.getAllGames()[0].time, old[0].time);
+    EXPECT_EQ(after.hotGameCount(), 2u);
+    EXPECT_EQ(after.size(), 102u);
+    EXPECT_EQ(after.getUserGames("ann").size(), 100u);
+
+    auto window = after.getGamesBetween(old[95].time, now);
+    ASSERT_EQ(window.size(), 7u);
+    EXPECT_EQ(window[0].time, old[95].time);
+    EXPECT_EQ(window[5].player1, "dan");
+    EXPECT_EQ(window[6].player1, "eve");
+    EXPECT_EQ(before.getGamesBetween(old[95].time, now).size(), 6u);
+}
+
+TEST_F(GameHistoryTest, ReadersSnapshotWhileWriterAdds) {
+    GameHistory memoryOnly("");
+    const std::size_t total = 5000;
+    std::atomic<bool> consistent{true};
+    std::thread reader([&]() {
+        std::size_t seen = 0;
+        while (seen < total) {
+            HistorySnapshot view = memoryOnly.snapshot();
+            auto games = view.getAllGames();
+            // Every published version is a prefix of the final history
+            for (std::size_t i = 0; i < games.size(); i++) {
+                if (games[i].time != static_cast<EpochMillis>(1700000000000LL + i)) {
+                    consistent = false;
+                }
+            }
+            if (games.size() < seen || games.size() != view.size()) {
+                consistent = false;
+            }
+            seen = games.size();
+        }
+    });
+    GameRecord record = sampleRecord1;
+    for (std::size_t i = 0; i < total; i++) {
+        record.time = 1700000000000LL + i;
+        memoryOnly.addGameRecord(record);
+    }
+    reader.join();
+    EXPECT_TRUE(consistent);
+}
 
 // === PERFORMANCE TESTS ===
 TEST_F(GameHistoryTest, AddManyRecords) {
@@ -352,3 +1038,20 @@ TEST_F(GameHistoryTest, UserInBothPlayerPositions) {
     EXPECT_EQ(aliceGames.size(), 2);
 }
 
+// === PLAYER ID TESTS ===
+TEST_F(GameHistoryTest, RecordsCarryInternedPlayerIds) {
+    history.addGameRecord(sampleRecord1);
+    auto all = history.getAllGames();
+    ASSERT_EQ(all.size(), 1);
+    EXPECT_EQ(all[0].player1Id, StringInterner::shared().find("alice"));
+    EXPECT_EQ(all[0].player2Id, StringInterner::shared().find("bob"));
+}
+
+TEST_F(GameHistoryTest, LoadedRecordsCarryPlayerIds) {
+    history.addGameRecord(sampleRecord1);
+    GameHistory newHistory;
+    auto games = newHistory.getUserGames("bob");
+    ASSERT_EQ(games.size(), 1);
+    EXPECT_NE(games[0].player1Id, INVALID_USER_ID);
+    EXPECT_EQ(games[0].player2Id, StringInterner::shared().find("bob"));
+}
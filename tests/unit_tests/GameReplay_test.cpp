@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include "GameReplay.h"
+#include <vector>
+
+class GameReplayTest : public ::testing::Test {
+protected:
+    // X takes the top row: X(0,0) O(1,0) X(0,1) O(1,1) X(0,2)
+    GameRecord xWinsTopRow() {
+        GameRecord record;
+        record.moves = {Move(0, 0, 'X'), Move(1, 0, 'O'), Move(0, 1, 'X'), Move(1, 1, 'O'),
+                        Move(0, 2, 'X')};
+        return record;
+    }
+
+    GameRecord tieGame() {
+        GameRecord record;
+        record.moves = {Move(0, 0, 'X'), Move(1, 1, 'O'), Move(2, 2, 'X'), Move(0, 2, 'O'),
+                        Move(2, 0, 'X'), Move(1, 0, 'O'), Move(1, 2, 'X'), Move(2, 1, 'O'),
+                        Move(0, 1, 'X')};
+        return record;
+    }
+};
+
+// === SEEK TESTS ===
+TEST_F(GameReplayTest, ReplaysEveryPly) {
+    GameReplay replay(xWinsTopRow());
+    ASSERT_TRUE(replay.isValid());
+    EXPECT_EQ(replay.plyCount(), 5);
+    EXPECT_EQ(replay.cellAt(0, 0, 0), ' ');
+    EXPECT_EQ(replay.cellAt(1, 0, 0), 'X');
+    EXPECT_EQ(replay.cellAt(1, 1, 0), ' ');
+    EXPECT_EQ(replay.cellAt(2, 1, 0), 'O');
+    EXPECT_EQ(replay.cellAt(5, 0, 2), 'X');
+}
+
+TEST_F(GameReplayTest, PositionMatchesPlayingTheMoves) {
+    GameRecord record = tieGame();
+    GameReplay replay(record);
+    GameBoard board;
+    for (int ply = 0; ply <= replay.plyCount(); ply++) {
+        EXPECT_EQ(replay.positionAt(ply).getBoard(), board.getBoard()) << "ply " << ply;
+        EXPECT_EQ(replay.resultAt(ply), board.checkWin()) << "ply " << ply;
+        if (ply < replay.plyCount()) {
+            const Move& move = record.moves[static_cast<std::size_t>(ply)];
+            board.makeMove(move.row, move.col, move.player);
+        }
+    }
+}
+
+TEST_F(GameReplayTest, SeekCanGoBackwards) {
+    GameReplay replay(xWinsTopRow());
+    EXPECT_EQ(replay.resultAt(5), GameResult::PLAYER1_WIN);
+    EXPECT_EQ(replay.resultAt(4), GameResult::ONGOING);
+    EXPECT_EQ(replay.cellAt(4, 0, 2), ' ');
+}
+
+TEST_F(GameReplayTest, SeekClampsOutOfRangePlies) {
+    GameReplay replay(xWinsTopRow());
+    EXPECT_EQ(replay.cellAt(-3, 0, 0), ' ');
+    EXPECT_EQ(replay.cellAt(99, 0, 2), 'X');
+    EXPECT_EQ(replay.cellAt(5, 3, 3), ' ');
+}
+
+TEST_F(GameReplayTest, FinalResults) {
+    EXPECT_EQ(GameReplay(xWinsTopRow()).finalResult(), GameResult::PLAYER1_WIN);
+    EXPECT_EQ(GameReplay(tieGame()).finalResult(), GameResult::TIE);
+    EXPECT_EQ(GameReplay(GameRecord()).finalResult(), GameResult::ONGOING);
+}
+
+// === VALIDATION TESTS ===
+TEST_F(GameReplayTest, RejectsOccupiedCell) {
+    GameRecord record;
+    record.moves = {Move(0, 0, 'X'), Move(0, 0, 'O')};
+    GameReplay replay(record);
+    EXPECT_FALSE(replay.isValid());
+    EXPECT_EQ(replay.getError(), ReplayError::ILLEGAL_MOVE);
+    EXPECT_EQ(replay.getErrorPly(), 1);
+    // The legal prefix is still available
+    EXPECT_EQ(replay.plyCount(), 1);
+    EXPECT_EQ(replay.cellAt(1, 0, 0), 'X');
+}
+
+TEST_F(GameReplayTest, RejectsOffBoardMove) {
+    GameRecord record;
+    record.moves = {Move(3, 0, 'X')};
+    EXPECT_EQ(GameReplay(record).getError(), ReplayError::ILLEGAL_MOVE);
+}
+
+TEST_F(GameReplayTest, RejectsRepeatedPlayer) {
+    GameRecord record;
+    record.moves = {Move(0, 0, 'X'), Move(1, 1, 'X')};
+    GameReplay replay(record);
+    EXPECT_EQ(replay.getError(), ReplayError::WRONG_TURN);
+    EXPECT_EQ(replay.getErrorPly(), 1);
+}
+
+TEST_F(GameReplayTest, RejectsUnknownPlayer) {
+    GameRecord record;
+    record.moves = {Move(0, 0, 'Z')};
+    EXPECT_EQ(GameReplay(record).getError(), ReplayError::BAD_PLAYER);
+}
+
+TEST_F(GameReplayTest, RejectsMoveAfterWin) {
+    GameRecord record = xWinsTopRow();
+    record.moves.push_back(Move(2, 2, 'O'));
+    GameReplay replay(record);
+    EXPECT_EQ(replay.getError(), ReplayError::MOVE_AFTER_END);
+    EXPECT_EQ(replay.getErrorPly(), 5);
+}
+
+TEST_F(GameReplayTest, ReloadClearsPreviousError) {
+    GameRecord bad;
+    bad.moves = {Move(0, 0, 'X'), Move(0, 0, 'O')};
+    GameReplay replay(bad);
+    ASSERT_FALSE(replay.isValid());
+    EXPECT_TRUE(replay.load(tieGame()));
+    EXPECT_EQ(replay.getErrorPly(), -1);
+    EXPECT_EQ(replay.plyCount(), 9);
+}
+
+// === BATCH TESTS ===
+TEST_F(GameReplayTest, BatchReplayMatchesSequential) {
+    std::vector<GameRecord> records;
+    for (int i = 0; i < 2000; i++) {
+        records.push_back(i % 2 == 0 ? xWinsTopRow() : tieGame());
+    }
+    ReplayEngine engine(4);
+    std::vector<GameReplay> replays = engine.replayAll(records);
+    ASSERT_EQ(replays.size(), records.size());
+    for (std::size_t i = 0; i < replays.size(); i++) {
+        EXPECT_EQ(replays[i].finalResult(), i % 2 == 0 ? GameResult::PLAYER1_WIN : GameResult::TIE);
+    }
+}
+
+TEST_F(GameReplayTest, BatchFindsInvalidRecords) {
+    std::vector<GameRecord> records(1000, tieGame());
+    records[17].moves[3] = Move(0, 0, 'O');
+    records[900].moves[1].player = 'X';
+    ReplayEngine engine(3);
+    EXPECT_EQ(engine.findInvalid(records), (std::vector<std::size_t>{17, 900}));
+}
+
+TEST_F(GameReplayTest, BatchHandlesEmptyInput) {
+    ReplayEngine engine(2);
+    EXPECT_TRUE(engine.replayAll({}).empty());
+    EXPECT_TRUE(engine.findInvalid({}).empty());
+}
@@ -0,0 +1,256 @@
+#include <gtest/gtest.h>
+#include "GameSessionEngine.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Every heap allocation in this binary goes through here, so tests can check
+// that the engine's steady state stays off the allocator
+static std::atomic<std::size_t> heapAllocations(0);
+
+void* operator new(std::size_t size) {
+    heapAllocations++;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+class GameSessionEngineTest : public ::testing::Test {
+protected:
+    GameHistory history{""};
+
+    // X wins along the top row
+    void playTopRowWin(GameSessionEngine& engine, GameSessionId id) {
+        engine.submitMove(id, 0, 0, 'X').get();
+        engine.submitMove(id, 1, 0, 'O').get();
+        engine.submitMove(id, 0, 1, 'X').get();
+        engine.submitMove(id, 1, 1, 'O').get();
+    }
+};
+
+// === MOVE TESTS ===
+TEST_F(GameSessionEngineTest, AcceptsAlternatingMoves) {
+    GameSessionEngine engine(2);
+    GameSessionId id = engine.createGame("alice", "bob", GameMode::PLAYER_VS_PLAYER);
+
+    MoveReply first = engine.submitMove(id, 0, 0, 'X').get();
+    EXPECT_EQ(first.session, id);
+    EXPECT_EQ(first.status, MoveStatus::ACCEPTED);
+    EXPECT_EQ(first.result, GameResult::ONGOING);
+    EXPECT_EQ(engine.submitMove(id, 1, 1, 'O').get().status, MoveStatus::ACCEPTED);
+}
+
+TEST_F(GameSessionEngineTest, RejectsOutOfTurnMove) {
+    GameSessionEngine engine(2);
+    GameSessionId id = engine.createGame("alice", "bob", GameMode::PLAYER_VS_PLAYER);
+
+    EXPECT_EQ(engine.submitMove(id, 0, 0, 'O').get().status, MoveStatus::NOT_YOUR_TURN);
+    EXPECT_EQ(engine.submitMove(id, 0, 0, 'X').get().status, MoveStatus::ACCEPTED);
+    EXPECT_EQ(engine.submitMove(id, 0, 1, 'X').get().status, MoveStatus::NOT_YOUR_TURN);
+}
+
+TEST_F(GameSessionEngineTest, RejectsOccupiedAndOutOfBoundsCells) {
+    GameSessionEngine engine(1);
+    GameSessionId id = engine.createGame("alice", "bob", GameMode::PLAYER_VS_PLAYER);
+
+    EXPECT_EQ(engine.submitMove(id, 0, 0, 'X').get().status, MoveStatus::ACCEPTED);
+    EXPECT_EQ(engine.submitMove(id, 0, 0, 'O').get().status, MoveStatus::INVALID_MOVE);
+    EXPECT_EQ(engine.submitMove(id, 3, 0, 'O').get().status, MoveStatus::INVALID_MOVE);
+}
+
+TEST_F(GameSessionEngineTest, UnknownSessionIsReported) {
+    GameSessionEngine engine(1);
+    EXPECT_EQ(engine.submitMove(12345, 0, 0, 'X').get().status, MoveStatus::UNKNOWN_SESSION);
+}
+
+TEST_F(GameSessionEngineTest, CallbackTransportDeliversReply) {
+    GameSessionEngine engine(1);
+    GameSessionId id = engine.createGame("alice", "bob", GameMode::PLAYER_VS_PLAYER);
+
+    MoveReply received;
+    engine.submitMove(id, 2, 2, 'X', [&received](const MoveReply& reply) { received = reply; });
+    engine.flush();
+    EXPECT_EQ(received.session, id);
+    EXPECT_EQ(received.status, MoveStatus::ACCEPTED);
+}
+
+// === COMPLETION TESTS ===
+TEST_F(GameSessionEngineTest, FinishedGameIsRecordedInHistory) {
+    GameSessionEngine engine(2, &history);
+    GameSessionId id = engine.createGame("alice", "bob", GameMode::PLAYER_VS_PLAYER);
+    playTopRowWin(engine, id);
+
+    MoveReply last = engine.submitMove(id, 0, 2, 'X').get();
+    EXPECT_EQ(last.status, MoveStatus::GAME_FINISHED);
+    EXPECT_EQ(last.result, GameResult::PLAYER1_WIN);
+    engine.flush();
+
+    auto games = history.getAllGames();
+    ASSERT_EQ(games.size(), 1u);
+    EXPECT_EQ(games[0].player1, "alice");
+    EXPECT_EQ(games[0].player2, "bob");
+    EXPECT_EQ(games[0].result, GameResult::PLAYER1_WIN);
+    EXPECT_EQ(games[0].moves.size(), 5u);
+    EXPECT_GT(games[0].time, 0);
+    EXPECT_EQ(games[0].time, games[0].moves.back().time);
+    EXPECT_EQ(games[0].moves[0].moveNumber, 1);
+    EXPECT_EQ(engine.activeGames(), 0u);
+    EXPECT_EQ(engine.completedGames(), 1u);
+}
+
+TEST_F(GameSessionEngineTest, FinishedSessionAcceptsNoMoreMoves) {
+    GameSessionEngine engine(1);
+    GameSessionId id = engine.createGame("alice", "bob", GameMode::PLAYER_VS_PLAYER);
+    playTopRowWin(engine, id);
+    engine.submitMove(id, 0, 2, 'X').get();
+
+    EXPECT_EQ(engine.submitMove(id, 2, 2, 'O').get().status, MoveStatus::UNKNOWN_SESSION);
+}
+
+TEST_F(GameSessionEngineTest, AbandonedGameIsNotRecorded) {
+    GameSessionEngine engine(1, &history);
+    GameSessionId id = engine.createGame("alice", "bob", GameMode::PLAYER_VS_PLAYER);
+    engine.submitMove(id, 0, 0, 'X').get();
+    EXPECT_EQ(engine.activeGames(), 1u);
+
+    engine.abandonGame(id);
+    engine.flush();
+    EXPECT_EQ(engine.activeGames(), 0u);
+    EXPECT_TRUE(history.getAllGames().empty());
+}
+
+TEST_F(GameSessionEngineTest, FinishedBatchIsOneHistoryWrite) {
+    const std::string path = "session_engine_history_test.dat";
+    std::remove(path.c_str());
+    {
+        GameHistory fileHistory(path);
+        GameSessionEngine engine(1, &fileHistory);
+        std::vector<GameSessionId> ids;
+        for (int g = 0; g < 20; g++) {
+            ids.push_back(engine.createGame("alice", "bob", GameMode::PLAYER_VS_PLAYER));
+            playTopRowWin(engine, ids.back());
+        }
+        std::uint64_t before = fileHistory.fileWrites();
+
+        // Hold the worker inside one command so every winning move lands in the next batch
+        std::promise<void> release;
+        std::shared_future<void> released = release.get_future().share();
+        engine.submitMove(0, 0, 0, 'X', [released](const MoveReply&) { released.wait(); });
+        for (GameSessionId id : ids) {
+            engine.submitMove(id, 0, 2, 'X', [](const MoveReply&) {});
+        }
+        release.set_value();
+        engine.flush();
+
+        EXPECT_EQ(engine.completedGames(), 20u);
+        EXPECT_EQ(fileHistory.fileWrites(), before + 1);
+    }
+    GameHistory reloaded(path);
+    EXPECT_EQ(reloaded.getAllGames().size(), 20u);
+    std::remove(path.c_str());
+}
+
+// === ALLOCATION TESTS ===
+TEST_F(GameSessionEngineTest, SteadyStateChurnDoesNotAllocate) {
+    // Small enough that a whole round of commands fits the reserved inbox
+    const int GAMES = 40;
+    GameSessionEngine engine(1, nullptr, 256);
+    std::atomic<int> finished(0);
+    GameSessionEngine::MoveCallback onReply = [&finished](const MoveReply& reply) {
+        if (reply.status == MoveStatus::GAME_FINISHED) {
+            finished++;
+        }
+    };
+    std::vector<GameSessionId> ids;
+    ids.reserve(GAMES);
+
+    auto playRound = [&]() {
+        int target = finished.load() + GAMES;
+        ids.clear();
+        for (int g = 0; g < GAMES; g++) {
+            ids.push_back(engine.createGame("alice", "bob", GameMode::PLAYER_VS_PLAYER));
+        }
+        const int ROWS[] = {0, 1, 0, 1, 0};
+        const int COLS[] = {0, 0, 1, 1, 2};
+        for (int ply = 0; ply < 5; ply++) {
+            for (GameSessionId id : ids) {
+                engine.submitMove(id, ROWS[ply], COLS[ply], (ply % 2 == 0) ? 'X' : 'O', onReply);
+            }
+        }
+        while (finished.load() < target) {
+            std::this_thread::yield();
+        }
+    };
+
+    // The first round fills the pools; after that games only recycle
+    playRound();
+    engine.flush();
+    std::size_t before = heapAllocations.load();
+    for (int round = 0; round < 5; round++) {
+        playRound();
+    }
+    EXPECT_EQ(heapAllocations.load(), before);
+    EXPECT_EQ(engine.completedGames(), static_cast<std::size_t>(6 * GAMES));
+}
+
+// === CONCURRENCY TESTS ===
+TEST_F(GameSessionEngineTest, ManyGamesFromManyClients) {
+    const int CLIENTS = 4;
+    const int GAMES_PER_CLIENT = 250;
+    GameSessionEngine engine(4, &history);
+
+    std::atomic<int> finished(0);
+    std::vector<std::thread> clients;
+    for (int c = 0; c < CLIENTS; c++) {
+        clients.emplace_back([&engine, &finished, c]() {
+            std::vector<GameSessionId> ids;
+            for (int g = 0; g < GAMES_PER_CLIENT; g++) {
+                ids.push_back(engine.createGame("p" + std::to_string(c), "q" + std::to_string(c),
+                                                GameMode::PLAYER_VS_PLAYER));
+            }
+            // Interleave moves across every game this client owns; X wins down the first column
+            const int ROWS[] = {0, 0, 1, 1, 2};
+            const int COLS[] = {0, 1, 0, 1, 0};
+            for (int ply = 0; ply < 5; ply++) {
+                char player = (ply % 2 == 0) ? 'X' : 'O';
+                for (GameSessionId id : ids) {
+                    engine.submitMove(id, ROWS[ply], COLS[ply], player,
+                                      [&finished](const MoveReply& reply) {
+                                          if (reply.status == MoveStatus::GAME_FINISHED) {
+                                              finished++;
+                                          }
+                                      });
+                }
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    engine.flush();
+
+    EXPECT_EQ(finished.load(), CLIENTS * GAMES_PER_CLIENT);
+    EXPECT_EQ(engine.completedGames(), static_cast<std::size_t>(CLIENTS * GAMES_PER_CLIENT));
+    EXPECT_EQ(engine.activeGames(), 0u);
+    EXPECT_EQ(history.getAllGames().size(), static_cast<std::size_t>(CLIENTS * GAMES_PER_CLIENT));
+    EXPECT_EQ(history.getUserGames("p0").size(), static_cast<std::size_t>(GAMES_PER_CLIENT));
+}
+
+TEST_F(GameSessionEngineTest, DefaultsToOneWorkerPerCore) {
+    GameSessionEngine engine;
+    EXPECT_GE(engine.workerCount(), 1u);
+}
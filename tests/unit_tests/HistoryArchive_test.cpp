@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include "HistoryArchive.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class HistoryArchiveTest : public ::testing::Test {
+protected:
+    const std::string path = "history_archive_test.tta";
+    const std::string textPath = "history_archive_test.dat";
+    std::vector<GameRecord> records;
+
+    void SetUp() override {
+        const char* NAMES[] = {"alice", "bob", "carol", "dave"};
+        for (int i = 0; i < 2500; i++) {
+            GameRecord record;
+            record.player1 = NAMES[i % 4];
+            record.player2 = NAMES[(i + 1) % 4];
+            record.mode = GameMode::PLAYER_VS_PLAYER;
+            record.result = (i % 3 == 0) ? GameResult::TIE : GameResult::PLAYER1_WIN;
+            record.finalBoard.assign(3, std::vector<char>(3, ' '));
+            record.finalBoard[i % 3][0] = 'X';
+            record.finalBoard[1][1] = 'O';
+            record.time = 1700000000000LL + i * 60000LL;
+            record.moves = {Move(i % 3, 0, 'X', record.time - 2000, 1), Move(1, 1, 'O', record.time, 2)};
+            records.push_back(record);
+        }
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+        std::remove(textPath.c_str());
+    }
+
+    static void expectSame(const GameRecord& a, const GameRecord& b) {
+        EXPECT_EQ(a.player1, b.player1);
+        EXPECT_EQ(a.player2, b.player2);
+        EXPECT_EQ(a.mode, b.mode);
+        EXPECT_EQ(a.result, b.result);
+        EXPECT_EQ(a.time, b.time);
+        EXPECT_EQ(a.timestamp, b.timestamp);
+        EXPECT_EQ(a.finalBoard, b.finalBoard);
+        ASSERT_EQ(a.moves.size(), b.moves.size());
+        for (std::size_t i = 0; i < a.moves.size(); i++) {
+            EXPECT_EQ(a.moves[i].row, b.moves[i].row);
+            EXPECT_EQ(a.moves[i].col, b.moves[i].col);
+            EXPECT_EQ(a.moves[i].player, b.moves[i].player);
+            EXPECT_EQ(a.moves[i].time, b.moves[i].time);
+        }
+    }
+};
+
+// === ROUND TRIP TESTS ===
+TEST_F(HistoryArchiveTest, RoundTripsAcrossBlocks) {
+    ASSERT_TRUE(HistoryArchive::write(path, records, 1000));
+    HistoryArchive archive;
+    ASSERT_TRUE(archive.open(path));
+    EXPECT_EQ(archive.recordCount(), 2500u);
+    ASSERT_EQ(archive.blocks().size(), 3u);
+    EXPECT_EQ(archive.blocks()[2].firstRecord, 2000u);
+    EXPECT_EQ(archive.blocks()[2].count, 500u);
+
+    std::vector<GameRecord> all;
+    ASSERT_TRUE(archive.readRange(0, archive.recordCount(), all));
+    ASSERT_EQ(all.size(), records.size());
+    for (std::size_t i = 0; i < records.size(); i++) {
+        expectSame(all[i], records[i]);
+    }
+}
+
+TEST_F(HistoryArchiveTest, KeepsUnusualRecordsExactly) {
+    GameRecord legacy("eve", "ai", GameMode::PLAYER_VS_AI, GameResult::AI_WIN,
+                      std::vector<std::vector<char>>(3, std::vector<char>(3, '?')), "2025-06-11 14:00:00");
+    legacy.moves = {Move(200, 7, 'X'), Move(-1, 3, 'Z')};
+    GameRecord empty;
+    empty.mode = GameMode::PLAYER_VS_PLAYER;
+    empty.result = GameResult::ONGOING;
+    std::vector<GameRecord> unusual{legacy, empty, records[0]};
+
+    ASSERT_TRUE(HistoryArchive::write(path, unusual));
+    HistoryArchive archive;
+    ASSERT_TRUE(archive.open(path));
+    GameRecord read;
+    for (std::size_t i = 0; i < unusual.size(); i++) {
+        ASSERT_TRUE(archive.readRecord(i, read));
+        expectSame(read, unusual[i]);
+    }
+    EXPECT_EQ(read.moves[0].moveNumber, -1);
+}
+
+// === LOOKUP TESTS ===
+TEST_F(HistoryArchiveTest, ReadsSingleRecordsById) {
+    ASSERT_TRUE(HistoryArchive::write(path, records, 256));
+    HistoryArchive archive;
+    ASSERT_TRUE(archive.open(path));
+
+    GameRecord read;
+    for (std::uint64_t id : {2499u, 0u, 1300u, 255u, 256u}) {
+        ASSERT_TRUE(archive.readRecord(id, read));
+        expectSame(read, records[id]);
+    }
+    EXPECT_FALSE(archive.readRecord(2500, read));
+}
+
+TEST_F(HistoryArchiveTest, ReadRangeIsClippedToArchive) {
+    ASSERT_TRUE(HistoryArchive::write(path, records, 256));
+    HistoryArchive archive;
+    ASSERT_TRUE(archive.open(path));
+
+    std::vector<GameRecord> tail;
+    ASSERT_TRUE(archive.readRange(2400, 1000, tail));
+    ASSERT_EQ(tail.size(), 100u);
+    expectSame(tail.front(), records[2400]);
+    expectSame(tail.back(), records[2499]);
+}
+
+TEST_F(HistoryArchiveTest, ReadsTimeRange) {
+    ASSERT_TRUE(HistoryArchive::write(path, records, 256));
+    HistoryArchive archive;
+    ASSERT_TRUE(archive.open(path));
+    EXPECT_EQ(archive.blocks()[0].minTime, records[0].time);
+    EXPECT_EQ(archive.blocks()[0].maxTime, records[255].time);
+
+    std::vector<GameRecord> window;
+    ASSERT_TRUE(archive.readTimeRange(records[1000].time, records[1010].time, window));
+    ASSERT_EQ(window.size(), 10u);
+    expectSame(window.front(), records[1000]);
+    expectSame(window.back(), records[1009]);
+}
+
+// === FORMAT TESTS ===
+TEST_F(HistoryArchiveTest, RejectsOtherFiles) {
+    HistoryArchive archive;
+    EXPECT_FALSE(archive.open("no_such_archive.tta"));
+    std::ofstream(path) << "alice|bob|0|0|2025-06-11 12:00:00|XXXXXXXXX|\n";
+    EXPECT_FALSE(archive.open(path));
+    EXPECT_FALSE(archive.isOpen());
+}
+
+TEST_F(HistoryArchiveTest, EmptyArchiveOpens) {
+    ASSERT_TRUE(HistoryArchive::write(path, {}));
+    HistoryArchive archive;
+    ASSERT_TRUE(archive.open(path));
+    EXPECT_EQ(archive.recordCount(), 0u);
+    GameRecord read;
+    EXPECT_FALSE(archive.readRecord(0, read));
+}
+
+TEST_F(HistoryArchiveTest, IsMuchSmallerThanHistoryFile) {
+    {
+        GameHistory history(textPath);
+        history.addGameRecords(records.begin(), records.end());
+    }
+    ASSERT_TRUE(HistoryArchive::write(path, records));
+    std::ifstream text(textPath, std::ios::binary | std::ios::ate);
+    std::ifstream archive(path, std::ios::binary | std::ios::ate);
+    EXPECT_LT(static_cast<long long>(archive.tellg()) * 2, static_cast<long long>(text.tellg()));
+}
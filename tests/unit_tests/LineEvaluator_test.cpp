@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "LineEvaluator.h"
+#include "Random.h"
+#include "TestBoards.h"
+#include <string>
+#include <vector>
+
+class LineEvaluatorTest : public ::testing::Test {};
+
+// === SCORE TESTS ===
+TEST_F(LineEvaluatorTest, CountsOpenWindows) {
+    LineEvaluator lines;
+    lines.load(GameBoard());
+    EXPECT_EQ(lines.total(), 0);
+    // The centre is on four lines, a corner on three, and the corner kills two of X's
+    lines.load(boardOf({"O  ", " X ", "   "}));
+    EXPECT_EQ(lines.total(), 3 - 2);
+    lines.load(boardOf({"XX ", "   ", "   "}));
+    EXPECT_EQ(lines.total(), 4 + 1 + 1 + 1);
+    EXPECT_EQ(lines.lines('X'), 0);
+    lines.load(boardOf({"XXX", "OO ", "   "}));
+    EXPECT_EQ(lines.lines('X'), 1);
+    EXPECT_EQ(lines.lines('O'), 0);
+}
+
+TEST_F(LineEvaluatorTest, MovesKeepTheTotalOfALoad) {
+    GameBoard board(7, 7, 4);
+    LineEvaluator incremental;
+    incremental.load(board);
+    Random random(7);
+    char player = 'X';
+    for (int ply = 0; ply < 30; ply++) {
+        auto moves = board.getAvailableMoves();
+        auto cell = moves[random.below(static_cast<int>(moves.size()))];
+        bool wins;
+        long long before = incremental.total();
+        int linesBefore = incremental.lines(player);
+        long long gain = incremental.gain(cell.first * 7 + cell.second, player, wins);
+        board.makeMove(cell.first, cell.second, player);
+        incremental.add(cell.first * 7 + cell.second, player);
+
+        LineEvaluator loaded;
+        loaded.load(board);
+        EXPECT_EQ(incremental.total(), loaded.total());
+        EXPECT_EQ(incremental.lines(player), loaded.lines(player));
+        EXPECT_EQ(wins, incremental.lines(player) > linesBefore);
+        EXPECT_EQ(gain, (player == 'X' ? 1 : -1) * (incremental.total() - before));
+        player = (player == 'X') ? 'O' : 'X';
+    }
+}
+
+TEST_F(LineEvaluatorTest, RemoveUndoesAdd) {
+    LineEvaluator lines;
+    lines.load(boardOf({"X   ", " O  ", "    ", "    "}));
+    long long total = lines.total();
+    lines.add(5 + 1, 'X');
+    lines.remove(5 + 1, 'X');
+    EXPECT_EQ(lines.total(), total);
+    // Reloading another shape recomputes the windows
+    EXPECT_TRUE(lines.reshape(3, 3, 3));
+    EXPECT_FALSE(lines.reshape(3, 3, 3));
+    EXPECT_EQ(lines.total(), 0);
+}
+
+TEST_F(LineEvaluatorTest, GainSeesTheWinningCell) {
+    LineEvaluator lines;
+    lines.load(boardOf({"OO ", "XX ", "   "}));
+    bool wins;
+    lines.gain(2, 'O', wins);
+    EXPECT_TRUE(wins);
+    lines.gain(5, 'O', wins);
+    EXPECT_FALSE(wins);
+    lines.gain(5, 'X', wins);
+    EXPECT_TRUE(wins);
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include "MctsEngine.h"
+
+class MctsEngineTest : public ::testing::Test {
+protected:
+    MctsLimits iterations(std::uint64_t count) {
+        MctsLimits limits;
+        limits.maxIterations = count;
+        return limits;
+    }
+};
+
+// === MOVE CHOICE TESTS ===
+TEST_F(MctsEngineTest, TakesImmediateWin) {
+    GameBoard board;
+    board.makeMove(0, 0, 'X');
+    board.makeMove(1, 0, 'O');
+    board.makeMove(0, 1, 'X');
+    board.makeMove(1, 1, 'O');
+
+    MctsEngine engine;
+    MctsResult result;
+    ASSERT_TRUE(engine.chooseMove(board, 'X', iterations(2000), result));
+    EXPECT_EQ(result.row, 0);
+    EXPECT_EQ(result.col, 2);
+    EXPECT_GT(result.expectedScore, 0.9);
+}
+
+TEST_F(MctsEngineTest, BlocksOpponentWin) {
+    GameBoard board;
+    board.makeMove(0, 0, 'X');
+    board.makeMove(1, 1, 'O');
+    board.makeMove(2, 2, 'X');
+    board.makeMove(1, 0, 'O');
+
+    MctsEngine engine;
+    MctsResult result;
+    ASSERT_TRUE(engine.chooseMove(board, 'X', iterations(5000), result));
+    EXPECT_EQ(result.row, 1);
+    EXPECT_EQ(result.col, 2);
+}
+
+TEST_F(MctsEngineTest, FindsWinOnLargerBoard) {
+    // Four in a row needed; X has three open on row 3
+    GameBoard board(9, 9, 4);
+    board.makeMove(3, 2, 'X');
+    board.makeMove(0, 0, 'O');
+    board.makeMove(3, 3, 'X');
+    board.makeMove(0, 8, 'O');
+    board.makeMove(3, 4, 'X');
+    board.makeMove(8, 0, 'O');
+
+    MctsEngine engine(2);
+    MctsResult result;
+    ASSERT_TRUE(engine.chooseMove(board, 'X', iterations(20000), result));
+    EXPECT_EQ(result.row, 3);
+    EXPECT_TRUE(result.col == 1 || result.col == 5);
+}
+
+TEST_F(MctsEngineTest, RefusesFinishedGames) {
+    GameBoard board;
+    board.makeMove(0, 0, 'X');
+    board.makeMove(0, 1, 'X');
+    board.makeMove(0, 2, 'X');
+    MctsEngine engine;
+    MctsResult result;
+    EXPECT_FALSE(engine.chooseMove(board, 'O', iterations(100), result));
+}
+
+TEST_F(MctsEngineTest, RequiresABudget) {
+    MctsEngine engine;
+    MctsResult result;
+    MctsLimits none;
+    none.maxIterations = 0;
+    none.maxMillis = 0;
+    EXPECT_FALSE(engine.chooseMove(GameBoard(), 'X', none, result));
+}
+
+// === BUDGET TESTS ===
+TEST_F(MctsEngineTest, RespectsIterationBudget) {
+    MctsEngine engine(4);
+    MctsResult result;
+    ASSERT_TRUE(engine.chooseMove(GameBoard(15, 15, 5), 'X', iterations(3000), result));
+    EXPECT_EQ(result.iterations, 3000u);
+}
+
+TEST_F(MctsEngineTest, RespectsTimeBudget) {
+    MctsEngine engine(2);
+    MctsLimits limits;
+    limits.maxIterations = 0;
+    limits.maxMillis = 50;
+    MctsResult result;
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(engine.chooseMove(GameBoard(19, 19, 5), 'X', limits, result));
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    EXPECT_GT(result.iterations, 0u);
+    EXPECT_LT(elapsed.count(), 1000);
+}
+
+TEST_F(MctsEngineTest, SingleThreadIsDeterministic) {
+    GameBoard board(6, 6, 4);
+    MctsEngine first(1, 1.4, 42);
+    MctsEngine second(1, 1.4, 42);
+    MctsResult a, b;
+    ASSERT_TRUE(first.chooseMove(board, 'X', iterations(500), a));
+    ASSERT_TRUE(second.chooseMove(board, 'X', iterations(500), b));
+    EXPECT_EQ(a.row, b.row);
+    EXPECT_EQ(a.col, b.col);
+}
+
+// === TREE REUSE TESTS ===
+TEST_F(MctsEngineTest, ReusesTreeAfterTwoPlies) {
+    GameBoard board(5, 5, 4);
+    MctsEngine engine;
+    MctsResult first;
+    ASSERT_TRUE(engine.chooseMove(board, 'X', iterations(4000), first));
+    EXPECT_EQ(first.reusedVisits, 0u);
+
+    board.makeMove(first.row, first.col, 'X');
+    auto reply = board.getAvailableMoves()[0];
+    board.makeMove(reply.first, reply.second, 'O');
+    MctsResult second;
+    ASSERT_TRUE(engine.chooseMove(board, 'X', iterations(100), second));
+    EXPECT_GT(second.reusedVisits, 0u);
+}
+
+TEST_F(MctsEngineTest, UnrelatedPositionStartsFresh) {
+    MctsEngine engine;
+    MctsResult result;
+    ASSERT_TRUE(engine.chooseMove(GameBoard(5, 5, 4), 'X', iterations(1000), result));
+
+    GameBoard other(5, 5, 4);
+    other.makeMove(0, 0, 'O');
+    other.makeMove(4, 4, 'O');
+    other.makeMove(2, 2, 'X');
+    ASSERT_TRUE(engine.chooseMove(other, 'X', iterations(100), result));
+    EXPECT_EQ(result.reusedVisits, 0u);
+
+    engine.reset();
+    ASSERT_TRUE(engine.chooseMove(other, 'X', iterations(100), result));
+    EXPECT_EQ(result.reusedVisits, 0u);
+}
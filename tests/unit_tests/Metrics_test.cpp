@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include "Metrics.h"
+#include "GameBoard.h"
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+class MetricsTest : public ::testing::Test {
+protected:
+    MetricsRegistry& registry = MetricsRegistry::shared();
+
+    void SetUp() override {
+        registry.reset();
+    }
+};
+
+// === HISTOGRAM TESTS ===
+TEST_F(MetricsTest, SmallValuesGetExactBuckets) {
+    for (std::uint64_t v = 0; v < 16; v++) {
+        EXPECT_EQ(LatencyHistogram::bucketFor(v), static_cast<int>(v));
+        EXPECT_EQ(LatencyHistogram::lowerBound(static_cast<int>(v)), v);
+    }
+}
+
+TEST_F(MetricsTest, BucketsBoundTheirValuesWithinOneSixteenth) {
+    for (std::uint64_t v = 16; v < (std::uint64_t(1) << 36); v = v * 3 / 2 + 7) {
+        int bucket = LatencyHistogram::bucketFor(v);
+        std::uint64_t low = LatencyHistogram::lowerBound(bucket);
+        std::uint64_t high = LatencyHistogram::upperBound(bucket);
+        ASSERT_LE(low, v);
+        ASSERT_LT(v, high);
+        EXPECT_LE((high - low) * 16, low);
+    }
+}
+
+TEST_F(MetricsTest, HugeValuesLandInLastBucket) {
+    EXPECT_EQ(LatencyHistogram::bucketFor(~std::uint64_t(0)), LatencyHistogram::BUCKET_COUNT - 1);
+}
+
+// === RECORDING TESTS ===
+TEST_F(MetricsTest, SnapshotSumsCallsAndLatencies) {
+    registry.record(Metric::SAVE_USERS, 1000);
+    registry.record(Metric::SAVE_USERS, 1000);
+    registry.record(Metric::SAVE_USERS, 100000);
+    registry.count(Metric::SAVE_USERS);
+
+    MetricsSnapshot snapshot = registry.snapshot();
+    const MetricSnapshot& saves = snapshot[Metric::SAVE_USERS];
+    EXPECT_EQ(saves.calls, 4u);
+    EXPECT_EQ(saves.timed, 3u);
+    EXPECT_EQ(saves.totalNanos, 102000u);
+    EXPECT_GE(saves.percentile(0.5), 1000u);
+    EXPECT_LE(saves.percentile(0.5), 1064u);
+    EXPECT_GE(saves.percentile(1.0), 100000u);
+    EXPECT_EQ(snapshot[Metric::LOAD_USERS].calls, 0u);
+}
+
+TEST_F(MetricsTest, ThreadsCountIndependently) {
+    const int THREADS = 4;
+    const int CALLS = 10000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; t++) {
+        threads.emplace_back([this]() {
+            for (int i = 0; i < CALLS; i++) {
+                registry.record(Metric::AI_SEARCH, 500);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(registry.snapshot()[Metric::AI_SEARCH].calls, static_cast<std::uint64_t>(THREADS * CALLS));
+}
+
+TEST_F(MetricsTest, SamplesOneCallPerPeriod) {
+    int sampled = 0;
+    for (std::uint32_t i = 0; i < MetricsRegistry::SAMPLE_PERIOD * 10; i++) {
+        if (registry.sampleThisCall()) {
+            sampled++;
+        }
+    }
+    EXPECT_EQ(sampled, 10);
+}
+
+// === EXPORT TESTS ===
+TEST_F(MetricsTest, WritesPrometheusText) {
+    registry.record(Metric::LOAD_HISTORY, 300);
+    std::ostringstream out;
+    registry.writePrometheus(out);
+    std::string text = out.str();
+
+    EXPECT_NE(text.find("# TYPE game_core_operations_total counter"), std::string::npos);
+    EXPECT_NE(text.find("game_core_operations_total{operation=\"load_history\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE game_core_operation_latency_seconds histogram"), std::string::npos);
+    // 300ns falls under the 512ns bucket but not the 256ns one
+    EXPECT_NE(text.find("game_core_operation_latency_seconds_bucket{operation=\"load_history\",le=\"2.56e-07\"} 0\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("game_core_operation_latency_seconds_bucket{operation=\"load_history\",le=\"5.12e-07\"} 1\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("game_core_operation_latency_seconds_count{operation=\"load_history\"} 1\n"),
+              std::string::npos);
+}
+
+// === INSTRUMENTATION TESTS ===
+TEST_F(MetricsTest, GameBoardCallsAreCountedOnlyWhenCompiledIn) {
+    GameBoard board;
+    board.makeMove(0, 0, 'X');
+    board.checkWin();
+    MetricsSnapshot snapshot = registry.snapshot();
+#if GAME_CORE_METRICS
+    EXPECT_EQ(snapshot[Metric::MAKE_MOVE].calls, 1u);
+    EXPECT_EQ(snapshot[Metric::CHECK_WIN].calls, 1u);
+#else
+    EXPECT_EQ(snapshot[Metric::MAKE_MOVE].calls, 0u);
+    EXPECT_EQ(snapshot[Metric::CHECK_WIN].calls, 0u);
+#endif
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include "MoveCodec.h"
+#include <string>
+#include <vector>
+
+class MoveCodecTest : public ::testing::Test {
+protected:
+    std::vector<Move> timedGame() {
+        std::vector<Move> moves;
+        moves.push_back(Move(0, 0, 'X', 1000000, 1));
+        moves.push_back(Move(1, 1, 'O', 1000250, 2));
+        moves.push_back(Move(2, 2, 'X', 1003000, 3));
+        return moves;
+    }
+};
+
+// === PACKING TESTS ===
+TEST_F(MoveCodecTest, PackedMoveRoundTrip) {
+    for (int cell = 0; cell < 9; cell++) {
+        for (char player : {'X', 'O'}) {
+            std::uint8_t packed;
+            ASSERT_TRUE(MoveCodec::packMove(Move(cell / 3, cell % 3, player), packed));
+            Move move = MoveCodec::unpackMove(packed);
+            EXPECT_EQ(move.row, cell / 3);
+            EXPECT_EQ(move.col, cell % 3);
+            EXPECT_EQ(move.player, player);
+        }
+    }
+}
+
+TEST_F(MoveCodecTest, PackRejectsUnrepresentableMoves) {
+    std::uint8_t packed;
+    EXPECT_FALSE(MoveCodec::packMove(Move(-1, 0, 'X'), packed));
+    EXPECT_FALSE(MoveCodec::packMove(Move(0, 3, 'X'), packed));
+    EXPECT_FALSE(MoveCodec::packMove(Move(0, 0, 'Z'), packed));
+    EXPECT_FALSE(MoveCodec::packMove(Move(43, 0, 'X'), packed));
+}
+
+TEST_F(MoveCodecTest, WiderBoardsUseColumnCount) {
+    std::uint8_t packed;
+    ASSERT_TRUE(MoveCodec::packMove(Move(10, 10, 'O'), packed, 11));
+    Move move = MoveCodec::unpackMove(packed, 11);
+    EXPECT_EQ(move.row, 10);
+    EXPECT_EQ(move.col, 10);
+    // Cell 128 no longer fits in seven bits
+    EXPECT_FALSE(MoveCodec::packMove(Move(11, 7, 'O'), packed, 11));
+}
+
+// === VARINT TESTS ===
+TEST_F(MoveCodecTest, VarintRoundTrip) {
+    std::string bytes;
+    const std::uint64_t VALUES[] = {0, 1, 127, 128, 300, 1ULL << 35, ~0ULL};
+    for (std::uint64_t value : VALUES) {
+        MoveCodec::appendVarint(bytes, value);
+    }
+    std::size_t pos = 0;
+    for (std::uint64_t expected : VALUES) {
+        std::uint64_t value;
+        ASSERT_TRUE(MoveCodec::readVarint(bytes, pos, value));
+        EXPECT_EQ(value, expected);
+    }
+    EXPECT_EQ(pos, bytes.size());
+}
+
+TEST_F(MoveCodecTest, SmallVarintsTakeOneByte) {
+    std::string bytes;
+    MoveCodec::appendVarint(bytes, 127);
+    EXPECT_EQ(bytes.size(), 1u);
+    MoveCodec::appendSignedVarint(bytes, -64);
+    EXPECT_EQ(bytes.size(), 2u);
+}
+
+TEST_F(MoveCodecTest, SignedVarintRoundTrip) {
+    std::string bytes;
+    const std::int64_t VALUES[] = {0, -1, 1, -300, 300, INT64_MIN, INT64_MAX};
+    for (std::int64_t value : VALUES) {
+        MoveCodec::appendSignedVarint(bytes, value);
+    }
+    std::size_t pos = 0;
+    for (std::int64_t expected : VALUES) {
+        std::int64_t value;
+        ASSERT_TRUE(MoveCodec::readSignedVarint(bytes, pos, value));
+        EXPECT_EQ(value, expected);
+    }
+}
+
+TEST_F(MoveCodecTest, TruncatedVarintFails) {
+    std::string bytes;
+    MoveCodec::appendVarint(bytes, 1ULL << 40);
+    bytes.pop_back();
+    std::size_t pos = 0;
+    std::uint64_t value;
+    EXPECT_FALSE(MoveCodec::readVarint(bytes, pos, value));
+}
+
+// === MOVE LIST TESTS ===
+TEST_F(MoveCodecTest, MoveListRoundTripKeepsTimes) {
+    std::string bytes;
+    ASSERT_TRUE(MoveCodec::encodeMoves(timedGame(), 999000, bytes));
+
+    std::vector<Move> decoded;
+    std::size_t pos = 0;
+    ASSERT_TRUE(MoveCodec::decodeMoves(bytes, pos, 999000, decoded));
+    ASSERT_EQ(decoded.size(), 3u);
+    EXPECT_EQ(decoded[1].row, 1);
+    EXPECT_EQ(decoded[1].player, 'O');
+    EXPECT_EQ(decoded[0].time, 1000000);
+    EXPECT_EQ(decoded[2].time, 1003000);
+    EXPECT_EQ(pos, bytes.size());
+}
+
+TEST_F(MoveCodecTest, EncodingIsCompact) {
+    std::string bytes;
+    ASSERT_TRUE(MoveCodec::encodeMoves(timedGame(), 1000000, bytes));
+    // count + (cell byte + delta) per move; deltas of 0, 250 and 2750 ms
+    EXPECT_EQ(bytes.size(), 1u + 2u + 3u + 3u);
+}
+
+TEST_F(MoveCodecTest, UntimedMovesInheritPreviousTime) {
+    std::vector<Move> moves = {Move(0, 0, 'X'), Move(0, 1, 'O')};
+    std::string bytes;
+    ASSERT_TRUE(MoveCodec::encodeMoves(moves, 0, bytes));
+    EXPECT_EQ(bytes.size(), 5u);
+
+    std::vector<Move> decoded;
+    std::size_t pos = 0;
+    ASSERT_TRUE(MoveCodec::decodeMoves(bytes, pos, 0, decoded));
+    EXPECT_EQ(decoded[1].time, 0);
+}
+
+TEST_F(MoveCodecTest, FailedEncodeLeavesOutputUntouched) {
+    std::string bytes = "prefix";
+    std::vector<Move> moves = {Move(0, 0, 'X'), Move(0, 0, '?')};
+    EXPECT_FALSE(MoveCodec::encodeMoves(moves, 0, bytes));
+    EXPECT_EQ(bytes, "prefix");
+}
+
+TEST_F(MoveCodecTest, DecodeRejectsTruncatedInput) {
+    std::string bytes;
+    ASSERT_TRUE(MoveCodec::encodeMoves(timedGame(), 0, bytes));
+    bytes.resize(bytes.size() - 2);
+    std::vector<Move> decoded;
+    std::size_t pos = 0;
+    EXPECT_FALSE(MoveCodec::decodeMoves(bytes, pos, 0, decoded));
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include "MpscQueue.h"
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// === ORDER TESTS ===
+TEST(MpscQueueTest, PopsInPushOrder) {
+    MpscQueue<int> queue;
+    int value = 0;
+    EXPECT_FALSE(queue.pop(value));
+    for (int i = 0; i < 5; i++) {
+        queue.push(i);
+    }
+    for (int i = 0; i < 5; i++) {
+        ASSERT_TRUE(queue.pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.pop(value));
+}
+
+TEST(MpscQueueTest, MovesOnlyValues) {
+    MpscQueue<std::unique_ptr<std::string>> queue;
+    queue.push(std::make_unique<std::string>("move me"));
+    std::unique_ptr<std::string> value;
+    ASSERT_TRUE(queue.pop(value));
+    EXPECT_EQ(*value, "move me");
+}
+
+TEST(MpscQueueTest, DestructorFreesUnconsumedValues) {
+    auto shared = std::make_shared<int>(7);
+    {
+        MpscQueue<std::shared_ptr<int>> queue;
+        queue.push(shared);
+        queue.push(shared);
+        EXPECT_EQ(shared.use_count(), 3);
+    }
+    EXPECT_EQ(shared.use_count(), 1);
+}
+
+// === CONCURRENCY TESTS ===
+TEST(MpscQueueTest, ManyProducersOneConsumer) {
+    const int PRODUCERS = 4;
+    const int PER_PRODUCER = 20000;
+    MpscQueue<int> queue;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&queue, p]() {
+            for (int i = 0; i < PER_PRODUCER; i++) {
+                queue.push(p * PER_PRODUCER + i);
+            }
+        });
+    }
+
+    // Each producer's values must arrive in the order it pushed them
+    std::vector<int> next(PRODUCERS, 0);
+    int received = 0;
+    int value = 0;
+    while (received < PRODUCERS * PER_PRODUCER) {
+        if (!queue.pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        int producer = value / PER_PRODUCER;
+        ASSERT_EQ(value % PER_PRODUCER, next[producer]);
+        next[producer]++;
+        received++;
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_FALSE(queue.pop(value));
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include "ObjectPool.h"
+#include <cstddef>
+#include <memory_resource>
+#include <set>
+#include <string>
+#include <vector>
+
+// Counts bytes handed out so tests can tell when the pool goes to its resource
+class CountingResource : public std::pmr::memory_resource {
+public:
+    std::size_t allocations = 0;
+    std::size_t outstanding = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        allocations++;
+        outstanding += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        outstanding -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+struct Tracked {
+    static int live;
+    std::string name;
+    std::vector<int> values;
+    Tracked() { live++; }
+    ~Tracked() { live--; }
+};
+int Tracked::live = 0;
+
+class ObjectPoolTest : public ::testing::Test {
+protected:
+    CountingResource resource;
+};
+
+// === ACQUIRE / RELEASE TESTS ===
+TEST_F(ObjectPoolTest, AcquireReturnsDistinctObjects) {
+    ObjectPool<Tracked> pool(&resource, nullptr, 4);
+    std::set<Tracked*> seen;
+    for (int i = 0; i < 10; i++) {
+        seen.insert(pool.acquire());
+    }
+    EXPECT_EQ(seen.size(), 10u);
+    EXPECT_EQ(pool.capacity(), 12u);
+    EXPECT_EQ(pool.available(), 2u);
+}
+
+TEST_F(ObjectPoolTest, ReleasedObjectIsReusedWithItsState) {
+    ObjectPool<Tracked> pool(&resource, nullptr, 4);
+    Tracked* first = pool.acquire();
+    first->name = "a name long enough to live on the heap";
+    pool.release(first);
+
+    Tracked* second = pool.acquire();
+    EXPECT_EQ(second, first);
+    EXPECT_EQ(second->name, "a name long enough to live on the heap");
+}
+
+TEST_F(ObjectPoolTest, InitializerRunsOncePerObject) {
+    int calls = 0;
+    ObjectPool<Tracked> pool(&resource, [&calls](Tracked& t) {
+        calls++;
+        t.values.reserve(16);
+    }, 8);
+
+    Tracked* object = pool.acquire();
+    EXPECT_GE(object->values.capacity(), 16u);
+    pool.release(object);
+    pool.acquire();
+    EXPECT_EQ(calls, 8);
+}
+
+// === ALLOCATION TESTS ===
+TEST_F(ObjectPoolTest, SteadyStateChurnDoesNotAllocate) {
+    ObjectPool<Tracked> pool(&resource, nullptr, 16);
+    pool.reserve(32);
+    std::size_t before = resource.allocations;
+
+    std::vector<Tracked*> held;
+    held.reserve(32);
+    for (int round = 0; round < 100; round++) {
+        for (int i = 0; i < 32; i++) {
+            held.push_back(pool.acquire());
+        }
+        for (Tracked* t : held) {
+            pool.release(t);
+        }
+        held.clear();
+    }
+    EXPECT_EQ(resource.allocations, before);
+}
+
+TEST_F(ObjectPoolTest, ReserveGrowsBySlabs) {
+    ObjectPool<Tracked> pool(&resource, nullptr, 10);
+    pool.reserve(25);
+    EXPECT_EQ(pool.capacity(), 30u);
+    EXPECT_EQ(pool.available(), 30u);
+    pool.reserve(5);
+    EXPECT_EQ(pool.capacity(), 30u);
+}
+
+TEST_F(ObjectPoolTest, DestructorDestroysObjectsAndReturnsMemory) {
+    {
+        ObjectPool<Tracked> pool(&resource, nullptr, 8);
+        pool.acquire();
+        pool.reserve(20);
+        EXPECT_EQ(Tracked::live, 24);
+    }
+    EXPECT_EQ(Tracked::live, 0);
+    EXPECT_EQ(resource.outstanding, 0u);
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include "OpeningBook.h"
+#include <random>
+#include <vector>
+
+class OpeningBookTest : public ::testing::Test {
+protected:
+    OpeningBook book;
+
+    static GameRecord gameFromCells(const std::vector<int>& cells) {
+        GameRecord record;
+        char player = 'X';
+        for (int cell : cells) {
+            record.moves.push_back(Move(cell / 3, cell % 3, player));
+            player = (player == 'X') ? 'O' : 'X';
+        }
+        return record;
+    }
+
+    // X: 0, 1, 2 along the top row
+    GameRecord cornerWin() { return gameFromCells({0, 3, 1, 4, 2}); }
+    // The same game rotated 90 degrees: X down the right column
+    GameRecord rotatedCornerWin() { return gameFromCells({2, 1, 5, 4, 8}); }
+    // O takes the middle column
+    GameRecord centerLoss() { return gameFromCells({0, 4, 2, 1, 8, 7}); }
+    GameRecord tie() { return gameFromCells({0, 4, 8, 2, 6, 3, 5, 7, 1}); }
+
+    static std::vector<Move> prefix(const GameRecord& record, std::size_t length) {
+        return std::vector<Move>(record.moves.begin(), record.moves.begin() + length);
+    }
+};
+
+// === INSERT TESTS ===
+TEST_F(OpeningBookTest, CountsOutcomesAtRoot) {
+    EXPECT_TRUE(book.addGame(cornerWin()));
+    EXPECT_TRUE(book.addGame(centerLoss()));
+    EXPECT_TRUE(book.addGame(tie()));
+
+    OpeningStats stats = book.statsAfter({});
+    EXPECT_EQ(stats.games, 3u);
+    EXPECT_EQ(stats.firstPlayerWins, 1u);
+    EXPECT_EQ(stats.secondPlayerWins, 1u);
+    EXPECT_EQ(stats.ties, 1u);
+    EXPECT_EQ(book.gameCount(), 3u);
+}
+
+TEST_F(OpeningBookTest, IgnoresUnfinishedAndIllegalGames) {
+    EXPECT_FALSE(book.addGame(gameFromCells({0, 4})));
+    EXPECT_FALSE(book.addGame(gameFromCells({0, 0})));
+    EXPECT_FALSE(book.addGame(GameRecord()));
+    EXPECT_EQ(book.gameCount(), 0u);
+    EXPECT_EQ(book.nodeCount(), 1u);
+}
+
+// === SYMMETRY TESTS ===
+TEST_F(OpeningBookTest, SymmetricGamesShareNodes) {
+    book.addGame(cornerWin());
+    std::size_t nodes = book.nodeCount();
+    book.addGame(rotatedCornerWin());
+    EXPECT_EQ(book.nodeCount(), nodes);
+    EXPECT_EQ(book.statsAfter(cornerWin().moves).games, 2u);
+}
+
+TEST_F(OpeningBookTest, QueriesMatchAnyOrientation) {
+    book.addGame(cornerWin());
+    // Any corner is the same opening
+    for (int corner : {0, 2, 6, 8}) {
+        EXPECT_EQ(book.statsAfter({Move(corner / 3, corner % 3, 'X')}).games, 1u) << corner;
+    }
+    EXPECT_EQ(book.statsAfter({Move(1, 1, 'X')}).games, 0u);
+    EXPECT_EQ(book.statsAfter({Move(0, 1, 'X')}).games, 0u);
+}
+
+TEST_F(OpeningBookTest, UnknownSequenceHasNoGames) {
+    book.addGame(cornerWin());
+    EXPECT_EQ(book.statsAfter({Move(0, 0, 'X'), Move(2, 2, 'O')}).games, 0u);
+    EXPECT_EQ(book.statsAfter({Move(5, 5, 'X')}).games, 0u);
+}
+
+// === CONTINUATION TESTS ===
+TEST_F(OpeningBookTest, ContinuationsListEverySymmetricCell) {
+    book.addGame(cornerWin());
+    auto replies = book.continuations({});
+    // All four corners are reported, each with the folded statistics
+    ASSERT_EQ(replies.size(), 4u);
+    for (const auto& reply : replies) {
+        EXPECT_EQ(reply.stats.games, 1u);
+        EXPECT_EQ(reply.move.player, 'X');
+        EXPECT_DOUBLE_EQ(reply.score, 1.0);
+    }
+}
+
+TEST_F(OpeningBookTest, ContinuationsScoreFromMoverPerspective) {
+    book.addGame(cornerWin());    // X corner, O edge -> X wins
+    book.addGame(centerLoss());   // X corner, O center -> O wins
+    auto replies = book.continuations(prefix(cornerWin(), 1));
+    ASSERT_FALSE(replies.empty());
+    EXPECT_EQ(replies[0].move.player, 'O');
+    EXPECT_EQ(replies[0].move.row, 1);
+    EXPECT_EQ(replies[0].move.col, 1);
+    EXPECT_DOUBLE_EQ(replies[0].score, 1.0);
+    EXPECT_DOUBLE_EQ(replies.back().score, 0.0);
+}
+
+TEST_F(OpeningBookTest, BestMoveHonoursMinimumGames) {
+    book.addGame(cornerWin());
+    book.addGame(centerLoss());
+    book.addGame(centerLoss());
+
+    Move move;
+    ASSERT_TRUE(book.bestMove(prefix(cornerWin(), 1), move));
+    EXPECT_EQ(move.row, 1);
+    EXPECT_EQ(move.col, 1);
+    EXPECT_FALSE(book.bestMove(prefix(cornerWin(), 1), move, 3));
+}
+
+// === BUILD TESTS ===
+TEST_F(OpeningBookTest, ParallelBuildMatchesIncremental) {
+    std::mt19937 rng(7);
+    std::vector<GameRecord> records;
+    for (int i = 0; i < 3000; i++) {
+        std::vector<int> cells = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+        std::shuffle(cells.begin(), cells.end(), rng);
+        GameRecord record;
+        GameBoard board;
+        char player = 'X';
+        for (int cell : cells) {
+            if (board.checkWin() != GameResult::ONGOING) {
+                break;
+            }
+            board.makeMove(cell / 3, cell % 3, player);
+            record.moves.push_back(Move(cell / 3, cell % 3, player));
+            player = (player == 'X') ? 'O' : 'X';
+        }
+        records.push_back(record);
+    }
+
+    OpeningBook incremental;
+    for (const auto& record : records) {
+        incremental.addGame(record);
+    }
+    book.build(records, 4);
+
+    EXPECT_EQ(book.gameCount(), 3000u);
+    EXPECT_EQ(book.nodeCount(), incremental.nodeCount());
+    for (const auto& record : {records[0], records[1], records[2]}) {
+        for (std::size_t length = 0; length <= record.moves.size(); length++) {
+            OpeningStats a = book.statsAfter(prefix(record, length));
+            OpeningStats b = incremental.statsAfter(prefix(record, length));
+            EXPECT_EQ(a.games, b.games);
+            EXPECT_EQ(a.firstPlayerWins, b.firstPlayerWins);
+            EXPECT_EQ(a.ties, b.ties);
+        }
+    }
+}
+
+TEST_F(OpeningBookTest, BuildReplacesContents) {
+    book.addGame(tie());
+    book.build({cornerWin()}, 2);
+    EXPECT_EQ(book.gameCount(), 1u);
+    EXPECT_EQ(book.statsAfter({}).ties, 0u);
+}
+
+// === HISTORY INTEGRATION TESTS ===
+TEST_F(OpeningBookTest, HistoryUpdatesAttachedBook) {
+    GameHistory history("");
+    history.setOpeningBook(&book);
+    history.addGameRecord(cornerWin());
+    history.addGameRecord(tie());
+    EXPECT_EQ(book.gameCount(), 2u);
+
+    history.setOpeningBook(nullptr);
+    history.addGameRecord(tie());
+    EXPECT_EQ(book.gameCount(), 2u);
+}
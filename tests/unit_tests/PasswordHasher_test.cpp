@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include "PasswordHasher.h"
+#include "Sha256.h"
+#include <future>
+#include <string>
+#include <vector>
+
+class PasswordHasherTest : public ::testing::Test {
+protected:
+    // Small costs keep the suite fast; the algorithm is the same
+    PasswordHasher::Params fastParams{64, 1};
+};
+
+static std::string digestHex(const std::string& data) {
+    Sha256::Digest digest = Sha256::hash(data);
+    return Sha256::toHex(digest.data(), digest.size());
+}
+
+// === SHA-256 TESTS ===
+TEST_F(PasswordHasherTest, Sha256EmptyInput) {
+    EXPECT_EQ(digestHex(""), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+}
+
+TEST_F(PasswordHasherTest, Sha256Abc) {
+    EXPECT_EQ(digestHex("abc"), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+}
+
+TEST_F(PasswordHasherTest, Sha256TwoBlockMessage) {
+    EXPECT_EQ(digestHex("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"),
+              "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+}
+
+TEST_F(PasswordHasherTest, Sha256IncrementalMatchesOneShot) {
+    std::string message(1000, 'q');
+    Sha256 sha;
+    for (size_t i = 0; i < message.size(); i += 37) {
+        sha.update(message.substr(i, 37));
+    }
+    Sha256::Digest digest = sha.finish();
+    EXPECT_EQ(Sha256::toHex(digest.data(), digest.size()), digestHex(message));
+}
+
+// === HASH / VERIFY TESTS ===
+TEST_F(PasswordHasherTest, HashVerifiesCorrectPassword) {
+    std::string encoded = PasswordHasher::hashPassword("correct horse", fastParams);
+    EXPECT_TRUE(PasswordHasher::verifyPassword("correct horse", encoded));
+}
+
+TEST_F(PasswordHasherTest, HashRejectsWrongPassword) {
+    std::string encoded = PasswordHasher::hashPassword("correct horse", fastParams);
+    EXPECT_FALSE(PasswordHasher::verifyPassword("correct horsf", encoded));
+    EXPECT_FALSE(PasswordHasher::verifyPassword("", encoded));
+}
+
+TEST_F(PasswordHasherTest, HashIsSalted) {
+    std::string first = PasswordHasher::hashPassword("same", fastParams);
+    std::string second = PasswordHasher::hashPassword("same", fastParams);
+    EXPECT_NE(first, second);
+    EXPECT_TRUE(PasswordHasher::verifyPassword("same", first));
+    EXPECT_TRUE(PasswordHasher::verifyPassword("same", second));
+}
+
+TEST_F(PasswordHasherTest, EncodingCarriesParameters) {
+    std::string encoded = PasswordHasher::hashPassword("pw", PasswordHasher::Params(128, 2));
+    EXPECT_EQ(encoded.rfind("$balloon-sha256$s=128,t=2$", 0), 0u);
+    EXPECT_TRUE(PasswordHasher::isEncodedHash(encoded));
+    EXPECT_TRUE(PasswordHasher::verifyPassword("pw", encoded));
+}
+
+TEST_F(PasswordHasherTest, EncodingHasNoWhitespace) {
+    std::string encoded = PasswordHasher::hashPassword("with spaces in it", fastParams);
+    EXPECT_EQ(encoded.find(' '), std::string::npos);
+}
+
+TEST_F(PasswordHasherTest, DeriveIsDeterministic) {
+    std::string first = PasswordHasher::derive("pw", "salt", fastParams);
+    std::string second = PasswordHasher::derive("pw", "salt", fastParams);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(first.size(), 32u);
+    EXPECT_NE(first, PasswordHasher::derive("pw", "salu", fastParams));
+    EXPECT_NE(first, PasswordHasher::derive("pw", "salt", PasswordHasher::Params(64, 2)));
+}
+
+TEST_F(PasswordHasherTest, MalformedEncodingRejected) {
+    EXPECT_FALSE(PasswordHasher::isEncodedHash("plainhash"));
+    EXPECT_FALSE(PasswordHasher::isEncodedHash("$balloon-sha256$s=0,t=1$00$00"));
+    EXPECT_FALSE(PasswordHasher::isEncodedHash("$balloon-sha256$s=8,t=1$zz$00"));
+    EXPECT_FALSE(PasswordHasher::verifyPassword("pw", "plainhash"));
+}
+
+TEST_F(PasswordHasherTest, InvalidParamsAreRefused) {
+    EXPECT_EQ(PasswordHasher::hashPassword("pw", PasswordHasher::Params(0, 1)), "");
+    EXPECT_EQ(PasswordHasher::hashPassword("pw", PasswordHasher::Params(4, 0)), "");
+    EXPECT_EQ(PasswordHasher::hashPassword("pw", PasswordHasher::Params(4, 2000)), "");
+    EXPECT_EQ(PasswordHasher::hashPassword("pw", PasswordHasher::Params((1u << 24) + 1, 1)), "");
+    EXPECT_EQ(PasswordHasher::derive("pw", "salt", PasswordHasher::Params(0, 1)), "");
+
+    AsyncPasswordHasher hasher(1, PasswordHasher::Params(0, 1));
+    EXPECT_EQ(hasher.hashAsync("pw").get(), "");
+}
+
+TEST_F(PasswordHasherTest, EveryHashMadeCanBeVerified) {
+    // The bounds hashing accepts are the ones parsing accepts
+    for (const auto& params : {PasswordHasher::Params(1, 1), PasswordHasher::Params(4, 1000)}) {
+        std::string encoded = PasswordHasher::hashPassword("pw", params);
+        EXPECT_TRUE(PasswordHasher::verifyPassword("pw", encoded));
+        EXPECT_TRUE(PasswordDigest::fromCredential(encoded).verify("pw"));
+    }
+}
+
+// === CONSTANT TIME COMPARE TESTS ===
+TEST_F(PasswordHasherTest, ConstantTimeEquals) {
+    EXPECT_TRUE(PasswordHasher::constantTimeEquals("", ""));
+    EXPECT_TRUE(PasswordHasher::constantTimeEquals("abc", "abc"));
+    EXPECT_FALSE(PasswordHasher::constantTimeEquals("abc", "abd"));
+    EXPECT_FALSE(PasswordHasher::constantTimeEquals("abc", "abcd"));
+    EXPECT_FALSE(PasswordHasher::constantTimeEquals("abc", ""));
+}
+
+// === DIGEST TESTS ===
+TEST_F(PasswordHasherTest, DigestUnpacksBalloonHash) {
+    std::string encoded = PasswordHasher::hashPassword("secret", fastParams);
+    PasswordDigest digest = PasswordDigest::fromCredential(encoded);
+    EXPECT_EQ(digest.kind, PasswordDigest::Kind::BALLOON);
+    EXPECT_EQ(digest.params.spaceCost, 64u);
+    EXPECT_EQ(digest.toString(), encoded);
+    EXPECT_TRUE(digest.verify("secret"));
+    EXPECT_FALSE(digest.verify("Secret"));
+    EXPECT_TRUE(digest.matches(encoded));
+    EXPECT_FALSE(digest.matches(PasswordHasher::hashPassword("secret", fastParams)));
+}
+
+TEST_F(PasswordHasherTest, DigestKeepsOtherCredentialsAsSha256) {
+    PasswordDigest digest = PasswordDigest::fromCredential("clienthash");
+    EXPECT_EQ(digest.kind, PasswordDigest::Kind::OPAQUE);
+    EXPECT_EQ(digest.toString(), "$sha256$" + digestHex("clienthash"));
+    EXPECT_TRUE(digest.matches("clienthash"));
+    EXPECT_FALSE(digest.matches("clienthash2"));
+    EXPECT_FALSE(digest.verify("clienthash"));
+}
+
+TEST_F(PasswordHasherTest, DigestRoundTripsThroughStoredForm) {
+    PasswordDigest opaque = PasswordDigest::fromCredential("clienthash");
+    EXPECT_TRUE(PasswordDigest::fromStored(opaque.toString()).matches("clienthash"));
+
+    std::string encoded = PasswordHasher::hashPassword("secret", fastParams);
+    EXPECT_TRUE(PasswordDigest::fromStored(encoded).verify("secret"));
+
+    // Files from before digests hold the credential itself
+    EXPECT_TRUE(PasswordDigest::fromStored("legacyhash").matches("legacyhash"));
+    EXPECT_FALSE(PasswordDigest().matches(""));
+}
+
+// === ASYNC TESTS ===
+TEST_F(PasswordHasherTest, AsyncHashAndVerify) {
+    AsyncPasswordHasher hasher(2, fastParams);
+    std::string encoded = hasher.hashAsync("secret").get();
+    EXPECT_TRUE(hasher.verifyAsync("secret", encoded).get());
+    EXPECT_FALSE(hasher.verifyAsync("guess", encoded).get());
+}
+
+TEST_F(PasswordHasherTest, AsyncManyRequests) {
+    AsyncPasswordHasher hasher(4, fastParams);
+    std::vector<std::future<std::string>> hashes;
+    for (int i = 0; i < 32; ++i) {
+        hashes.push_back(hasher.hashAsync("pw" + std::to_string(i)));
+    }
+    std::vector<std::future<bool>> checks;
+    for (int i = 0; i < 32; ++i) {
+        checks.push_back(hasher.verifyAsync("pw" + std::to_string(i), hashes[i].get()));
+    }
+    for (auto& check : checks) {
+        EXPECT_TRUE(check.get());
+    }
+}
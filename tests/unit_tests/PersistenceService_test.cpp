@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+#include "PersistenceService.h"
+#include "GameHistory.h"
+#include "UserManager.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+class PersistenceServiceTest : public ::testing::Test {
+protected:
+    const std::string path = "persistence_test.dat";
+    const std::string historyPath = "persistence_history.dat";
+    const std::string usersPath = "persistence_users.dat";
+
+    void SetUp() override {
+        removeFiles();
+    }
+    void TearDown() override {
+        removeFiles();
+    }
+    void removeFiles() {
+        std::remove(path.c_str());
+        std::remove(historyPath.c_str());
+        std::remove(usersPath.c_str());
+    }
+
+    static std::string readFile(const std::string& name) {
+        std::ifstream file(name);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+};
+
+// === WRITE TESTS ===
+TEST_F(PersistenceServiceTest, AppendsInOrder) {
+    PersistenceService service;
+    service.append(path, "one\n");
+    service.append(path, "two\n");
+    EXPECT_TRUE(service.append(path, "three\n").get());
+    EXPECT_EQ(readFile(path), "one\ntwo\nthree\n");
+}
+
+TEST_F(PersistenceServiceTest, ReplaceSupersedesEarlierWrites) {
+    PersistenceService service;
+    service.append(path, "old\n");
+    service.replace(path, "fresh\n");
+    service.append(path, "after\n");
+    ASSERT_TRUE(service.flush().get());
+    EXPECT_EQ(readFile(path), "fresh\nafter\n");
+}
+
+TEST_F(PersistenceServiceTest, ReportsFailedWrites) {
+    PersistenceService service;
+    std::future<bool> failed = service.replace("no_such_dir/file.dat", "data");
+    EXPECT_FALSE(failed.get());
+    EXPECT_FALSE(service.flush().get());
+    // The failure is reported once; later barriers start clean
+    service.append(path, "ok\n");
+    EXPECT_TRUE(service.flush().get());
+}
+
+TEST_F(PersistenceServiceTest, FileStaysDamagedUntilReplaced) {
+    PersistenceService service;
+    const std::string missing = "no_such_dir/file.dat";
+    EXPECT_TRUE(service.flush(missing).get());
+    EXPECT_FALSE(service.append(missing, "lost\n").get());
+    EXPECT_FALSE(service.flush(missing).get());
+    // Other files and the plain barrier are unaffected
+    service.append(path, "ok\n");
+    EXPECT_TRUE(service.flush(path).get());
+
+    std::filesystem::create_directory("no_such_dir");
+    service.append(missing, "more\n");
+    // An append after a lost one still leaves the file short
+    EXPECT_FALSE(service.flush(missing).get());
+    service.replace(missing, "whole\n");
+    EXPECT_TRUE(service.flush(missing).get());
+    EXPECT_EQ(readFile(missing), "whole\n");
+    std::filesystem::remove_all("no_such_dir");
+}
+
+TEST_F(PersistenceServiceTest, DestructorWritesEverythingQueued) {
+    {
+        PersistenceService service;
+        for (int i = 0; i < 1000; i++) {
+            service.append(path, "x");
+        }
+    }
+    EXPECT_EQ(readFile(path).size(), 1000u);
+}
+
+TEST_F(PersistenceServiceTest, ManyProducersAreBatched) {
+    const int PRODUCERS = 4;
+    const int LINES = 2000;
+    PersistenceService service;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&service, this]() {
+            for (int i = 0; i < LINES; i++) {
+                service.append(path, "line\n");
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    ASSERT_TRUE(service.flush().get());
+
+    EXPECT_EQ(readFile(path).size(), static_cast<std::size_t>(PRODUCERS * LINES * 5));
+    // Writes are merged per batch, so far fewer file writes than jobs
+    EXPECT_LT(service.filesWritten(), static_cast<std::uint64_t>(PRODUCERS * LINES));
+}
+
+// === INTEGRATION TESTS ===
+TEST_F(PersistenceServiceTest, GameHistoryWritesThroughService) {
+    PersistenceService service;
+    std::vector<std::vector<char>> board(3, std::vector<char>(3, 'X'));
+    {
+        GameHistory history(historyPath);
+        history.setPersistence(&service);
+        for (int i = 0; i < 50; i++) {
+            history.addGameRecord(GameRecord("alice", "bob", GameMode::PLAYER_VS_PLAYER,
+                                             GameResult::PLAYER1_WIN, board, "2025-06-11 12:00:00"));
+        }
+        ASSERT_TRUE(service.flush().get());
+    }
+
+    GameHistory reloaded(historyPath);
+    EXPECT_EQ(reloaded.getAllGames().size(), 50u);
+}
+
+TEST_F(PersistenceServiceTest, UserTableWritesThroughService) {
+    PersistenceService service;
+    {
+        UserHashTable users(usersPath);
+        users.setPersistence(&service);
+        users.insertUser("alice", "hash1");
+        users.insertUser("bob", "hash2");
+        users.removeUser("alice");
+    }
+    ASSERT_TRUE(service.flush().get());
+
+    UserHashTable reloaded(usersPath);
+    EXPECT_FALSE(reloaded.userExists("alice"));
+    EXPECT_TRUE(reloaded.userExists("bob"));
+}
+
+TEST_F(PersistenceServiceTest, UserTableQueuesOneSnapshotPerBatch) {
+    PersistenceService service;
+    // Hold the writer inside a batch while the table changes
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    service.replaceWith(path, [&started, released]() {
+        started.set_value();
+        released.wait();
+        return std::string("held\n");
+    });
+    started.get_future().wait();
+
+    {
+        UserHashTable users(usersPath);
+        users.setPersistence(&service);
+        for (int i = 0; i < 100; i++) {
+            users.insertUser("user" + std::to_string(i), "hash");
+        }
+        users.removeUser("user0");
+        release.set_value();
+    }
+    ASSERT_TRUE(service.flush().get());
+    EXPECT_EQ(service.filesWritten(), 2u);
+
+    UserHashTable reloaded(usersPath);
+    EXPECT_EQ(reloaded.getAllUsers().size(), 99u);
+    EXPECT_FALSE(reloaded.userExists("user0"));
+}
+
+TEST_F(PersistenceServiceTest, FailedHistoryWriteIsRetriedWhole) {
+    const std::string directory = "persistence_history_dir";
+    const std::string file = directory + "/history.dat";
+    std::filesystem::remove_all(directory);
+    PersistenceService service;
+    std::vector<std::vector<char>> board(3, std::vector<char>(3, 'X'));
+    {
+        GameHistory history(file);
+        history.setPersistence(&service);
+        for (int i = 0; i < 3; i++) {
+            history.addGameRecord(GameRecord("alice", "bob", GameMode::PLAYER_VS_PLAYER,
+                                             GameResult::PLAYER1_WIN, board, "2025-06-11 12:00:00"));
+        }
+        EXPECT_FALSE(history.durable().get());
+
+        std::filesystem::create_directory(directory);
+        // The lost appends named dictionary entries the file never got; a plain
+        // append now would leave records the next load cannot decode
+        history.addGameRecord(GameRecord("carol", "bob", GameMode::PLAYER_VS_PLAYER,
+                                         GameResult::PLAYER1_WIN, board, "2025-06-11 12:00:00"));
+        EXPECT_TRUE(history.durable().get());
+    }
+    ASSERT_TRUE(service.flush(file).get());
+
+    GameHistory reloaded(file);
+    EXPECT_EQ(reloaded.getAllGames().size(), 4u);
+    std::filesystem::remove_all(directory);
+}
+
+TEST_F(PersistenceServiceTest, FailedUserSaveIsRetried) {
+    const std::string directory = "persistence_users_dir";
+    const std::string file = directory + "/users.dat";
+    std::filesystem::remove_all(directory);
+    PersistenceService service;
+    {
+        UserHashTable users(file);
+        users.setPersistence(&service);
+        users.insertUser("alice", "hash1");
+        EXPECT_FALSE(users.durable().get());
+
+        std::filesystem::create_directory(directory);
+        EXPECT_TRUE(users.durable().get());
+    }
+    ASSERT_TRUE(service.flush(file).get());
+
+    UserHashTable reloaded(file);
+    EXPECT_TRUE(reloaded.userExists("alice"));
+    std::filesystem::remove_all(directory);
+}
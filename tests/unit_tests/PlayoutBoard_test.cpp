@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include "PlayoutBoard.h"
+
+// === CONSTRUCTION TESTS ===
+TEST(PlayoutBoardTest, CopiesGameBoard) {
+    GameBoard source;
+    source.makeMove(1, 1, 'X');
+    source.makeMove(0, 2, 'O');
+    PlayoutBoard board(source);
+    EXPECT_EQ(board.rows(), 3);
+    EXPECT_EQ(board.cols(), 3);
+    EXPECT_EQ(board.cell(4), 'X');
+    EXPECT_EQ(board.cell(2), 'O');
+    EXPECT_EQ(board.emptyCount(), 7);
+}
+
+TEST(PlayoutBoardTest, RejectsOversizedBoards) {
+    EXPECT_TRUE(PlayoutBoard::fits(GameBoard(32, 32, 5)));
+    EXPECT_FALSE(PlayoutBoard::fits(GameBoard(33, 32, 5)));
+}
+
+// === MOVE TESTS ===
+TEST(PlayoutBoardTest, PlayReportsCompletedLine) {
+    PlayoutBoard board;
+    EXPECT_FALSE(board.play(0, 'X'));
+    EXPECT_FALSE(board.play(4, 'X'));
+    EXPECT_TRUE(board.play(8, 'X'));
+    EXPECT_EQ(board.result(), GameResult::PLAYER1_WIN);
+}
+
+TEST(PlayoutBoardTest, UndoRestoresEmptyCells) {
+    PlayoutBoard board;
+    board.play(3, 'O');
+    board.play(5, 'X');
+    board.undo(3);
+    EXPECT_TRUE(board.isEmpty(3));
+    EXPECT_EQ(board.emptyCount(), 8);
+
+    bool seen[9] = {};
+    for (int i = 0; i < board.emptyCount(); i++) {
+        seen[board.emptyCell(i)] = true;
+    }
+    EXPECT_TRUE(seen[3]);
+    EXPECT_FALSE(seen[5]);
+}
+
+TEST(PlayoutBoardTest, LongerLinesOnLargerBoards) {
+    PlayoutBoard board(GameBoard(7, 7, 4));
+    // Anti-diagonal from (0,6) down to (3,3)
+    EXPECT_FALSE(board.play(6, 'O'));
+    EXPECT_FALSE(board.play(12, 'O'));
+    EXPECT_FALSE(board.play(24, 'O'));
+    EXPECT_TRUE(board.play(18, 'O'));
+    EXPECT_EQ(board.result(), GameResult::PLAYER2_WIN);
+}
+
+TEST(PlayoutBoardTest, ResultAgreesWithGameBoard) {
+    std::vector<std::vector<char>> cells = {
+        {'X', 'O', 'X'},
+        {'X', 'O', 'O'},
+        {'O', 'X', 'X'}
+    };
+    GameBoard source;
+    source.setBoard(cells);
+    EXPECT_EQ(PlayoutBoard(source).result(), source.checkWin());
+}
@@ -0,0 +1,250 @@
+#include <gtest/gtest.h>
+#include "PositionDatabase.h"
+#include "TestBoards.h"
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+
+class PositionDatabaseTest : public ::testing::Test {
+protected:
+    const std::string path = "position_db_test.tpd";
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+
+    // Walks every reachable position once and checks that each best move is
+    // legal and leads to a position worth exactly the opposite, one ply shorter
+    void checkReachable(const PositionDatabase& database, GameBoard& board, char toMove,
+                        std::set<std::vector<std::vector<char>>>& seen, std::size_t& checked) {
+        if (!seen.insert(board.getBoard()).second) {
+            return;
+        }
+        PositionEntry entry;
+        ASSERT_TRUE(database.lookup(board, entry));
+        checked++;
+        bool over = board.checkWin() != GameResult::ONGOING;
+        if (over) {
+            EXPECT_EQ(entry.bestMove, -1);
+            EXPECT_EQ(entry.depth, 0);
+            return;
+        }
+        char next = (toMove == 'X') ? 'O' : 'X';
+        int cols = board.getCols();
+        ASSERT_GE(entry.bestMove, 0);
+        ASSERT_EQ(board.getCell(entry.bestMove / cols, entry.bestMove % cols), ' ');
+        GameBoard after = board;
+        after.makeMove(entry.bestMove / cols, entry.bestMove % cols, toMove);
+        PositionEntry reply;
+        ASSERT_TRUE(database.lookup(after, reply));
+        EXPECT_EQ(static_cast<int>(entry.value), 2 - static_cast<int>(reply.value));
+        EXPECT_EQ(entry.depth, reply.depth + 1);
+
+        for (const auto& move : board.getAvailableMoves()) {
+            GameBoard child = board;
+            child.makeMove(move.first, move.second, toMove);
+            checkReachable(database, child, next, seen, checked);
+        }
+    }
+};
+
+// === SOLVING TESTS ===
+TEST_F(PositionDatabaseTest, ClassicGameIsADraw) {
+    PositionDatabaseStats stats;
+    ASSERT_TRUE(PositionDatabase::generate(path, PositionDatabaseConfig(), &stats));
+    // The 765 essentially different positions of Tic Tac Toe
+    EXPECT_EQ(stats.solved, 765u);
+    EXPECT_EQ(stats.written, 765u);
+    EXPECT_EQ(stats.heuristic, 0u);
+
+    PositionDatabase database;
+    ASSERT_TRUE(database.open(path));
+    EXPECT_EQ(database.positionCount(), 765u);
+    EXPECT_EQ(database.rows(), 3);
+    EXPECT_EQ(database.maxDepth(), -1);
+    PositionEntry entry;
+    ASSERT_TRUE(database.lookup(GameBoard(), entry));
+    EXPECT_EQ(entry.value, PositionValue::DRAW);
+    EXPECT_EQ(entry.depth, 9);
+}
+
+TEST_F(PositionDatabaseTest, EveryReachablePositionIsConsistent) {
+    ASSERT_TRUE(PositionDatabase::generate(path, PositionDatabaseConfig()));
+    PositionDatabase database;
+    ASSERT_TRUE(database.open(path));
+    GameBoard board;
+    std::set<std::vector<std::vector<char>>> seen;
+    std::size_t checked = 0;
+    checkReachable(database, board, 'X', seen, checked);
+    EXPECT_EQ(checked, 5478u);
+}
+
+TEST_F(PositionDatabaseTest, TakesFastestWinAndBlocks) {
+    ASSERT_TRUE(PositionDatabase::generate(path, PositionDatabaseConfig()));
+    PositionDatabase database;
+    ASSERT_TRUE(database.open(path));
+
+    PositionEntry entry;
+    ASSERT_TRUE(database.lookup(boardOf({"XX ", "OO ", "   "}), entry));
+    EXPECT_EQ(entry.value, PositionValue::WIN);
+    EXPECT_EQ(entry.depth, 1);
+    EXPECT_EQ(entry.bestMove, 2);
+    // The same position turned a quarter, so the move has to be turned back
+    ASSERT_TRUE(database.lookup(boardOf({" OX", " OX", "   "}), entry));
+    EXPECT_EQ(entry.bestMove, 8);
+
+    // X threatens two lines; O can only put off the loss
+    ASSERT_TRUE(database.lookup(boardOf({"X X", " O ", "X O"}), entry));
+    EXPECT_EQ(entry.value, PositionValue::LOSS);
+    EXPECT_EQ(entry.depth, 2);
+}
+
+TEST_F(PositionDatabaseTest, ReadsGamesOpenedByO) {
+    ASSERT_TRUE(PositionDatabase::generate(path, PositionDatabaseConfig()));
+    PositionDatabase database;
+    ASSERT_TRUE(database.open(path));
+    PositionEntry entry;
+    // O has one mark more, so X is to move and completes the middle row
+    ASSERT_TRUE(database.lookup(boardOf({"OO ", "XX ", "  O"}), entry));
+    EXPECT_EQ(entry.value, PositionValue::WIN);
+    EXPECT_EQ(entry.depth, 1);
+    EXPECT_EQ(entry.bestMove, 5);
+}
+
+TEST_F(PositionDatabaseTest, RejectsPositionsThatCannotArise) {
+    ASSERT_TRUE(PositionDatabase::generate(path, PositionDatabaseConfig()));
+    PositionDatabase database;
+    ASSERT_TRUE(database.open(path));
+    PositionEntry entry;
+    EXPECT_FALSE(database.lookup(boardOf({"XXX", "OOO", "   "}), entry));
+    EXPECT_FALSE(database.lookup(boardOf({"XXX", "   ", "   "}), entry));
+    EXPECT_FALSE(database.lookup(boardOf({"X?O", "   ", "   "}), entry));
+    EXPECT_FALSE(database.lookup(GameBoard(4, 4, 3), entry));
+}
+
+// === DEPTH AND SIZE TESTS ===
+TEST_F(PositionDatabaseTest, DepthLimitKeepsShallowPositions) {
+    PositionDatabaseConfig config;
+    config.maxDepth = 2;
+    PositionDatabaseStats stats;
+    ASSERT_TRUE(PositionDatabase::generate(path, config, &stats));
+    // Deeper positions are searched, not visited one by one
+    EXPECT_EQ(stats.solved, 16u);
+    EXPECT_EQ(stats.written, 16u);
+    // The searches at the horizon solve Tic Tac Toe outright
+    EXPECT_EQ(stats.heuristic, 0u);
+
+    PositionDatabase database;
+    ASSERT_TRUE(database.open(path));
+    EXPECT_EQ(database.maxDepth(), 2);
+    PositionEntry entry;
+    EXPECT_TRUE(database.lookup(boardOf({"X  ", " O ", "   "}), entry));
+    EXPECT_EQ(entry.value, PositionValue::DRAW);
+    EXPECT_FALSE(entry.heuristic);
+    EXPECT_EQ(entry.depth, 7);
+    EXPECT_FALSE(database.lookup(boardOf({"X  ", " O ", "  X"}), entry));
+
+    // The same answers as a full solve
+    PositionDatabase full;
+    const std::string fullPath = "position_db_full_test.tpd";
+    ASSERT_TRUE(PositionDatabase::generate(fullPath, PositionDatabaseConfig()));
+    ASSERT_TRUE(full.open(fullPath));
+    PositionEntry expected;
+    for (const auto& rows : std::vector<std::vector<std::string>>{
+             {"   ", "   ", "   "}, {"X  ", "   ", "   "}, {" X ", "   ", "   "}, {"X  ", " O ", "   "},
+             {"XO ", "   ", "   "}, {" X ", "O  ", "   "}}) {
+        ASSERT_TRUE(database.lookup(boardOf(rows), entry));
+        ASSERT_TRUE(full.lookup(boardOf(rows), expected));
+        EXPECT_EQ(entry.value, expected.value);
+        EXPECT_EQ(entry.depth, expected.depth);
+    }
+    full.close();
+    std::remove(fullPath.c_str());
+}
+
+TEST_F(PositionDatabaseTest, DepthLimitReachesLargerBoards) {
+    PositionDatabaseConfig config;
+    config.rows = 5;
+    config.cols = 5;
+    config.winLength = 4;
+    config.maxDepth = 2;
+    config.horizonNodes = 2000;
+    // Far fewer than a full solve of 5,5,4 would visit
+    config.maxPositions = 1000;
+    PositionDatabaseStats stats;
+    ASSERT_TRUE(PositionDatabase::generate(path, config, &stats));
+    EXPECT_GT(stats.heuristic, 0u);
+    EXPECT_EQ(stats.written, stats.solved);
+
+    PositionDatabase database;
+    ASSERT_TRUE(database.open(path));
+    PositionEntry entry;
+    ASSERT_TRUE(database.lookup(GameBoard(5, 5, 4), entry));
+    EXPECT_TRUE(entry.heuristic);
+    ASSERT_GE(entry.bestMove, 0);
+    ASSERT_LT(entry.bestMove, 25);
+    ASSERT_TRUE(database.lookup(boardOf({"X    ", "     ", "  O  ", "     ", "     "}, 4), entry));
+    EXPECT_GE(entry.bestMove, 0);
+    EXPECT_FALSE(database.lookup(boardOf({"X    ", "     ", "  O  ", "     ", "    X"}, 4), entry));
+}
+
+TEST_F(PositionDatabaseTest, SolvesRectangularBoards) {
+    PositionDatabaseConfig config;
+    config.rows = 3;
+    config.cols = 4;
+    config.winLength = 3;
+    ASSERT_TRUE(PositionDatabase::generate(path, config));
+    PositionDatabase database;
+    ASSERT_TRUE(database.open(path));
+    PositionEntry entry;
+    ASSERT_TRUE(database.lookup(GameBoard(3, 4, 3), entry));
+    // The first player wins 3,4,3
+    EXPECT_EQ(entry.value, PositionValue::WIN);
+
+    // Following the stored best moves wins in exactly the promised number of plies
+    GameBoard board(3, 4, 3);
+    char toMove = 'X';
+    for (int ply = 0; ply < entry.depth; ply++) {
+        PositionEntry step;
+        ASSERT_TRUE(database.lookup(board, step));
+        ASSERT_TRUE(board.makeMove(step.bestMove / 4, step.bestMove % 4, toMove));
+        toMove = (toMove == 'X') ? 'O' : 'X';
+    }
+    EXPECT_EQ(board.checkWin(), GameResult::PLAYER1_WIN);
+}
+
+TEST_F(PositionDatabaseTest, RefusesWhatItCannotSolve) {
+    PositionDatabaseConfig config;
+    config.rows = 5;
+    config.cols = 7;
+    EXPECT_FALSE(PositionDatabase::generate(path, config));
+    config = PositionDatabaseConfig();
+    config.maxPositions = 100;
+    EXPECT_FALSE(PositionDatabase::generate(path, config));
+}
+
+TEST_F(PositionDatabaseTest, OpenRejectsOtherFiles) {
+    PositionDatabase database;
+    EXPECT_FALSE(database.open("no_such_position_db.tpd"));
+    std::ofstream(path) << "not a position database, just some text that is long enough for a header";
+    EXPECT_FALSE(database.open(path));
+    EXPECT_FALSE(database.isOpen());
+    PositionEntry entry;
+    EXPECT_FALSE(database.lookup(GameBoard(), entry));
+}
+
+TEST_F(PositionDatabaseTest, OpenRejectsHugeDimensions) {
+    ASSERT_TRUE(PositionDatabase::generate(path, PositionDatabaseConfig()));
+    // 65536 x 65536 cells wrap a 32-bit product around to zero
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        const char dimensions[8] = {0, 0, 1, 0, 0, 0, 1, 0};
+        file.seekp(8);
+        file.write(dimensions, sizeof(dimensions));
+    }
+    PositionDatabase database;
+    EXPECT_FALSE(database.open(path));
+    EXPECT_FALSE(database.isOpen());
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "ScanKernels.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+class ScanKernelsTest : public ::testing::Test {
+protected:
+    std::vector<std::uint32_t> ids;
+    std::vector<std::uint32_t> otherIds;
+    std::vector<std::uint8_t> codes;
+
+    void SetUp() override {
+        std::mt19937 random(42);
+        for (int i = 0; i < 2000; i++) {
+            ids.push_back(random() % 7);
+            otherIds.push_back(random() % 7);
+            codes.push_back(static_cast<std::uint8_t>(random() % 5));
+        }
+    }
+
+    void TearDown() override {
+        ScanKernels::setLevel(ScanKernels::Level::AVX2);
+    }
+
+    static std::vector<ScanKernels::Level> levels() {
+        std::vector<ScanKernels::Level> available{ScanKernels::Level::SCALAR};
+        if (ScanKernels::supportedLevel() >= ScanKernels::Level::SSE2) {
+            available.push_back(ScanKernels::Level::SSE2);
+        }
+        if (ScanKernels::supportedLevel() >= ScanKernels::Level::AVX2) {
+            available.push_back(ScanKernels::Level::AVX2);
+        }
+        return available;
+    }
+
+    template <typename Match>
+    static std::vector<std::uint64_t> expected(std::size_t rows, Match match) {
+        std::vector<std::uint64_t> bits(ScanKernels::bitmapWords(rows), 0);
+        for (std::size_t i = 0; i < rows; i++) {
+            if (match(i)) {
+                bits[i / 64] |= 1ULL << (i % 64);
+            }
+        }
+        return bits;
+    }
+};
+
+// === SELECTION TESTS ===
+TEST_F(ScanKernelsTest, EveryLevelMatchesScalarResults) {
+    for (auto level : levels()) {
+        EXPECT_EQ(ScanKernels::setLevel(level), level);
+        for (std::size_t rows : {0u, 1u, 63u, 64u, 65u, 1000u, 2000u}) {
+            std::vector<std::uint64_t> bits(ScanKernels::bitmapWords(rows), ~0ULL);
+            ScanKernels::selectEqual(ids.data(), rows, 3u, bits.data());
+            EXPECT_EQ(bits, expected(rows, [&](std::size_t i) { return ids[i] == 3; }));
+
+            ScanKernels::selectEqual(codes.data(), rows, static_cast<std::uint8_t>(4), bits.data());
+            EXPECT_EQ(bits, expected(rows, [&](std::size_t i) { return codes[i] == 4; }));
+
+            ScanKernels::selectEither(ids.data(), otherIds.data(), rows, 5u, bits.data());
+            EXPECT_EQ(bits, expected(rows, [&](std::size_t i) {
+                return ids[i] == 5 || otherIds[i] == 5;
+            }));
+        }
+    }
+}
+
+TEST_F(ScanKernelsTest, HandlesExtremeValues) {
+    std::vector<std::uint32_t> wide(130, 0xFFFFFFFFu);
+    std::vector<std::uint8_t> narrow(130, 0xFF);
+    wide[129] = 0;
+    narrow[0] = 0x7F;
+    for (auto level : levels()) {
+        ScanKernels::setLevel(level);
+        std::vector<std::uint64_t> bits(3);
+        ScanKernels::selectEqual(wide.data(), wide.size(), 0xFFFFFFFFu, bits.data());
+        EXPECT_EQ(ScanKernels::count(bits.data(), bits.size()), 129u);
+        ScanKernels::selectEqual(narrow.data(), narrow.size(), static_cast<std::uint8_t>(0xFF), bits.data());
+        EXPECT_EQ(ScanKernels::count(bits.data(), bits.size()), 129u);
+        EXPECT_EQ(bits[0] & 1, 0u);
+    }
+}
+
+// === BITMAP TESTS ===
+TEST_F(ScanKernelsTest, SelectAllClearsBitsPastLastRow) {
+    std::vector<std::uint64_t> bits(2, 0);
+    ScanKernels::selectAll(70, bits.data());
+    EXPECT_EQ(bits[0], ~0ULL);
+    EXPECT_EQ(bits[1], 0x3FULL);
+    EXPECT_EQ(ScanKernels::count(bits.data(), bits.size()), 70u);
+}
+
+TEST_F(ScanKernelsTest, IntersectAndVisitInRowOrder) {
+    std::size_t rows = ids.size();
+    std::size_t words = ScanKernels::bitmapWords(rows);
+    std::vector<std::uint64_t> bits(words);
+    std::vector<std::uint64_t> other(words);
+    ScanKernels::selectEqual(ids.data(), rows, 2u, bits.data());
+    ScanKernels::selectEqual(codes.data(), rows, static_cast<std::uint8_t>(1), other.data());
+    ScanKernels::intersect(bits.data(), other.data(), words);
+
+    std::vector<std::size_t> visited;
+    ScanKernels::forEachSelected(bits.data(), words, [&](std::size_t row) { visited.push_back(row); });
+    std::vector<std::size_t> wanted;
+    for (std::size_t i = 0; i < rows; i++) {
+        if (ids[i] == 2 && codes[i] == 1) {
+            wanted.push_back(i);
+        }
+    }
+    EXPECT_EQ(visited, wanted);
+    EXPECT_EQ(ScanKernels::count(bits.data(), words), wanted.size());
+}
+
+// === LEVEL TESTS ===
+TEST_F(ScanKernelsTest, SetLevelIsCappedBySupport) {
+    EXPECT_EQ(ScanKernels::setLevel(ScanKernels::Level::SCALAR), ScanKernels::Level::SCALAR);
+    EXPECT_EQ(ScanKernels::level(), ScanKernels::Level::SCALAR);
+    EXPECT_EQ(ScanKernels::setLevel(ScanKernels::Level::AVX2), ScanKernels::supportedLevel());
+}
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include "SelfPlay.h"
+#include "GameReplay.h"
+#include <vector>
+
+class SelfPlayTest : public ::testing::Test {
+protected:
+    std::vector<SelfPlayPolicy> randomVsGreedy{SelfPlayPolicy("random", PolicyKind::RANDOM),
+                                               SelfPlayPolicy("greedy", PolicyKind::GREEDY)};
+
+    SelfPlayConfig gamesOf(std::size_t count) {
+        SelfPlayConfig config;
+        config.games = count;
+        return config;
+    }
+};
+
+// === POLICY PARSING TESTS ===
+TEST_F(SelfPlayTest, ParsesPolicyNames) {
+    SelfPlayPolicy policy;
+    ASSERT_TRUE(SelfPlay::parsePolicy("greedy", policy));
+    EXPECT_EQ(policy.kind, PolicyKind::GREEDY);
+    ASSERT_TRUE(SelfPlay::parsePolicy("mcts:500", policy));
+    EXPECT_EQ(policy.kind, PolicyKind::MCTS);
+    EXPECT_EQ(policy.iterations, 500u);
+    EXPECT_EQ(policy.name, "mcts:500");
+    ASSERT_TRUE(SelfPlay::parsePolicy("medium", policy));
+    EXPECT_EQ(policy.kind, PolicyKind::AI);
+    EXPECT_EQ(policy.difficulty, Difficulty::MEDIUM);
+
+    EXPECT_FALSE(SelfPlay::parsePolicy("minimax", policy));
+    EXPECT_FALSE(SelfPlay::parsePolicy("mcts:", policy));
+    EXPECT_FALSE(SelfPlay::parsePolicy("mcts:0", policy));
+    EXPECT_FALSE(SelfPlay::parsePolicy("mcts:12a", policy));
+}
+
+// === SUMMARY TESTS ===
+TEST_F(SelfPlayTest, SummariesAddUp) {
+    SelfPlay selfPlay(2);
+    SelfPlayReport report = selfPlay.run(randomVsGreedy, gamesOf(2000));
+
+    ASSERT_EQ(report.policies.size(), 2u);
+    EXPECT_EQ(report.games, 2000u);
+    const PolicyStats& random = report.policies[0];
+    const PolicyStats& greedy = report.policies[1];
+    EXPECT_EQ(random.name, "random");
+    EXPECT_EQ(random.games, 2000u);
+    EXPECT_EQ(random.wins + random.losses + random.ties, random.games);
+    EXPECT_EQ(random.wins, greedy.losses);
+    EXPECT_EQ(random.ties, greedy.ties);
+    // Both orders of the pairing are played equally often
+    EXPECT_EQ(random.gamesAsFirst, 1000u);
+    EXPECT_EQ(greedy.gamesAsFirst, 1000u);
+}
+
+TEST_F(SelfPlayTest, GreedyBeatsRandom) {
+    SelfPlay selfPlay(2);
+    SelfPlayReport report = selfPlay.run(randomVsGreedy, gamesOf(2000));
+    EXPECT_GT(report.policies[1].winRate(), 0.5);
+    EXPECT_LT(report.policies[0].winRate(), 0.2);
+}
+
+TEST_F(SelfPlayTest, SinglePolicyPlaysItself) {
+    SelfPlay selfPlay(2);
+    SelfPlayReport report = selfPlay.run({SelfPlayPolicy("random", PolicyKind::RANDOM)}, gamesOf(100));
+    const PolicyStats& stats = report.policies[0];
+    // Each game counts once, from the first mover's side
+    EXPECT_EQ(report.games, 100u);
+    EXPECT_EQ(stats.games, 100u);
+    EXPECT_EQ(stats.gamesAsFirst, 100u);
+    EXPECT_EQ(stats.wins + stats.losses + stats.ties, stats.games);
+    EXPECT_EQ(stats.winsAsFirst, stats.wins);
+    EXPECT_GT(stats.wins, 0u);
+    EXPECT_GT(stats.losses, 0u);
+}
+
+TEST_F(SelfPlayTest, ResultsDoNotDependOnThreadCount) {
+    SelfPlay single(1);
+    SelfPlay several(4);
+    SelfPlayReport a = single.run(randomVsGreedy, gamesOf(3000));
+    SelfPlayReport b = several.run(randomVsGreedy, gamesOf(3000));
+    for (std::size_t i = 0; i < a.policies.size(); i++) {
+        EXPECT_EQ(a.policies[i].wins, b.policies[i].wins);
+        EXPECT_EQ(a.policies[i].ties, b.policies[i].ties);
+    }
+}
+
+TEST_F(SelfPlayTest, MctsBeatsRandom) {
+    SelfPlay selfPlay(2);
+    std::vector<SelfPlayPolicy> policies{SelfPlayPolicy("mcts", PolicyKind::MCTS, 300),
+                                         SelfPlayPolicy("random", PolicyKind::RANDOM)};
+    SelfPlayReport report = selfPlay.run(policies, gamesOf(40));
+    EXPECT_GT(report.policies[0].wins, report.policies[0].losses);
+    EXPECT_GT(report.policies[0].winRate(), report.policies[1].winRate());
+}
+
+TEST_F(SelfPlayTest, HardAiNeverLoses) {
+    SelfPlay selfPlay(2);
+    std::vector<SelfPlayPolicy> policies;
+    for (const char* name : {"hard", "easy", "random"}) {
+        SelfPlayPolicy policy;
+        ASSERT_TRUE(SelfPlay::parsePolicy(name, policy));
+        policies.push_back(policy);
+    }
+    SelfPlayReport report = selfPlay.run(policies, gamesOf(60));
+    EXPECT_EQ(report.policies[0].losses, 0u);
+    EXPECT_GT(report.policies[0].wins, 0u);
+}
+
+// === HISTORY TESTS ===
+TEST_F(SelfPlayTest, RecordsValidGamesInHistory) {
+    GameHistory history("");
+    SelfPlay selfPlay(4);
+    SelfPlayReport report = selfPlay.run(randomVsGreedy, gamesOf(500), &history);
+
+    auto games = history.getAllGames();
+    ASSERT_EQ(games.size(), 500u);
+    EXPECT_EQ(report.recorded, 500u);
+    EXPECT_FALSE(history.inBulk());
+    EXPECT_EQ(games[0].player1, "random");
+    EXPECT_EQ(games[1].player1, "greedy");
+    for (const auto& game : games) {
+        GameReplay replay(game);
+        ASSERT_TRUE(replay.isValid());
+        EXPECT_EQ(replay.finalResult(), game.result);
+        EXPECT_GT(game.time, 0);
+    }
+    EXPECT_EQ(history.getUserGames("greedy").size(), 500u);
+}
+
+TEST_F(SelfPlayTest, LargerBoardsAreSummarizedButNotRecorded) {
+    GameHistory history("");
+    SelfPlay selfPlay(2);
+    SelfPlayConfig config = gamesOf(50);
+    config.rows = 7;
+    config.cols = 7;
+    config.winLength = 4;
+    SelfPlayReport report = selfPlay.run(randomVsGreedy, config, &history);
+
+    EXPECT_EQ(report.games, 50u);
+    EXPECT_EQ(report.recorded, 0u);
+    EXPECT_TRUE(history.getAllGames().empty());
+    EXPECT_EQ(report.policies[0].games, 50u);
+}
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+#include "SessionManager.h"
+#include "UserManager.h"
+#include <atomic>
+#include <cstdio>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+class SessionManagerTest : public ::testing::Test {
+protected:
+    std::int64_t fakeNow = 1000;
+    SessionManager::Clock clock = [this]() { return fakeNow; };
+};
+
+// === TOKEN TESTS ===
+TEST_F(SessionManagerTest, TokenStringRoundTrip) {
+    SessionToken token(0x0123456789abcdefULL, 0xfedcba9876543210ULL);
+    std::string text = token.toString();
+    EXPECT_EQ(text, "0123456789abcdeffedcba9876543210");
+
+    SessionToken parsed;
+    ASSERT_TRUE(SessionToken::fromString(text, parsed));
+    EXPECT_EQ(parsed, token);
+}
+
+TEST_F(SessionManagerTest, TokenFromStringRejectsGarbage) {
+    SessionToken parsed;
+    EXPECT_FALSE(SessionToken::fromString("", parsed));
+    EXPECT_FALSE(SessionToken::fromString("xyz", parsed));
+    EXPECT_FALSE(SessionToken::fromString(std::string(32, 'g'), parsed));
+}
+
+TEST_F(SessionManagerTest, DefaultTokenIsInvalid) {
+    SessionToken token;
+    EXPECT_FALSE(token.isValid());
+}
+
+// === CREATE / RESOLVE TESTS ===
+TEST_F(SessionManagerTest, CreateAndResolve) {
+    SessionManager sessions(64, 1000, clock);
+    SessionToken token = sessions.createSession(7);
+    EXPECT_TRUE(token.isValid());
+
+    UserId user = INVALID_USER_ID;
+    ASSERT_TRUE(sessions.resolve(token, user));
+    EXPECT_EQ(user, 7u);
+}
+
+TEST_F(SessionManagerTest, TokensAreUnique) {
+    SessionManager sessions(1024, 1000, clock);
+    std::set<std::string> seen;
+    for (int i = 0; i < 500; ++i) {
+        seen.insert(sessions.createSession(1).toString());
+    }
+    EXPECT_EQ(seen.size(), 500);
+}
+
+TEST_F(SessionManagerTest, UnknownTokenDoesNotResolve) {
+    SessionManager sessions(64, 1000, clock);
+    sessions.createSession(1);
+    UserId user;
+    EXPECT_FALSE(sessions.resolve(SessionToken(1, 2), user));
+    EXPECT_FALSE(sessions.resolve(SessionToken(), user));
+}
+
+TEST_F(SessionManagerTest, SessionExpires) {
+    SessionManager sessions(64, 1000, clock);
+    SessionToken token = sessions.createSession(3);
+    UserId user;
+
+    fakeNow += 999;
+    EXPECT_TRUE(sessions.resolve(token, user));
+    fakeNow += 1;
+    EXPECT_FALSE(sessions.resolve(token, user));
+    EXPECT_EQ(sessions.activeSessions(), 0u);
+}
+
+TEST_F(SessionManagerTest, RevokeEndsSession) {
+    SessionManager sessions(64, 1000, clock);
+    SessionToken token = sessions.createSession(4);
+    SessionToken other = sessions.createSession(5);
+    sessions.revoke(token);
+
+    UserId user;
+    EXPECT_FALSE(sessions.resolve(token, user));
+    ASSERT_TRUE(sessions.resolve(other, user));
+    EXPECT_EQ(user, 5u);
+}
+
+TEST_F(SessionManagerTest, ActiveSessionsCount) {
+    SessionManager sessions(64, 1000, clock);
+    for (int i = 0; i < 10; ++i) {
+        sessions.createSession(static_cast<UserId>(i));
+    }
+    EXPECT_EQ(sessions.activeSessions(), 10u);
+}
+
+TEST_F(SessionManagerTest, FullTableEvictsOldest) {
+    SessionManager sessions(4, 1000, clock);
+    SessionToken oldest = sessions.createSession(1);
+    for (int i = 0; i < 20; ++i) {
+        fakeNow += 1;
+        sessions.createSession(2);
+    }
+    UserId user;
+    EXPECT_FALSE(sessions.resolve(oldest, user));
+    EXPECT_EQ(sessions.activeSessions(), 4u);
+}
+
+// === AUTHENTICATION TESTS ===
+TEST_F(SessionManagerTest, OpenSessionAuthenticates) {
+    std::remove("users.dat");
+    {
+        UserHashTable users;
+        users.clear();
+        users.insertUser("player", "secret");
+        SessionManager sessions;
+
+        SessionToken token;
+        EXPECT_FALSE(sessions.openSession(users, "player", "wrong", token));
+        ASSERT_TRUE(sessions.openSession(users, "player", "secret", token));
+
+        UserId user;
+        ASSERT_TRUE(sessions.resolve(token, user));
+        EXPECT_EQ(user, users.getUser("player")->id);
+    }
+    std::remove("users.dat");
+}
+
+// === CONCURRENCY TESTS ===
+TEST_F(SessionManagerTest, ConcurrentCreateAndResolve) {
+    SessionManager sessions(1 << 16);
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&sessions, &failures, t]() {
+            for (int i = 0; i < 1000; ++i) {
+                UserId id = static_cast<UserId>(t * 1000 + i);
+                SessionToken token = sessions.createSession(id);
+                UserId resolved;
+                if (!sessions.resolve(token, resolved) || resolved != id) {
+                    failures++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(failures.load(), 0);
+}
+
+TEST_F(SessionManagerTest, ConcurrentCreatesNeverShareASlot) {
+    // Four slots and four sessions: every create finds a free slot, so no
+    // token may be lost, however the probes interleave
+    const int threadCount = 4;
+    for (int round = 0; round < 200; ++round) {
+        SessionManager sessions(4, 1000, clock);
+        std::atomic<int> ready{0};
+        std::vector<SessionToken> tokens(threadCount);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&sessions, &ready, &tokens, t, threadCount]() {
+                ready++;
+                while (ready.load() < threadCount) {
+                    std::this_thread::yield();
+                }
+                tokens[t] = sessions.createSession(static_cast<UserId>(t));
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (int t = 0; t < threadCount; ++t) {
+            UserId user;
+            ASSERT_TRUE(sessions.resolve(tokens[t], user)) << "round " << round;
+            EXPECT_EQ(user, static_cast<UserId>(t));
+        }
+    }
+}
@@ -0,0 +1,382 @@
+#include <gtest/gtest.h>
+#include "ShardedUserStore.h"
+#include <cstdio>
+#include <future>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+class ShardedUserStoreTest : public ::testing::Test {
+protected:
+    void SetUp() override { removeShardFiles(); }
+    void TearDown() override { removeShardFiles(); }
+
+    void removeShardFiles() {
+        for (const char* name : {"a", "b", "c", "d"}) {
+            std::remove((std::string("test_shard_") + name + ".dat").c_str());
+        }
+    }
+};
+
+// === HASH RING TESTS ===
+TEST_F(ShardedUserStoreTest, RingEmptyReturnsNoShard) {
+    ConsistentHashRing ring;
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(ring.shardFor("alice"), -1);
+}
+
+TEST_F(ShardedUserStoreTest, RingIsDeterministic) {
+    ConsistentHashRing first, second;
+    for (int shard = 0; shard < 3; ++shard) {
+        first.addShard(shard, "s" + std::to_string(shard));
+        second.addShard(shard, "s" + std::to_string(shard));
+    }
+    for (int i = 0; i < 100; ++i) {
+        std::string key = "user" + std::to_string(i);
+        EXPECT_EQ(first.shardFor(key), second.shardFor(key));
+    }
+}
+
+TEST_F(ShardedUserStoreTest, RingSpreadsKeys) {
+    ConsistentHashRing ring;
+    for (int shard = 0; shard < 4; ++shard) {
+        ring.addShard(shard, "s" + std::to_string(shard));
+    }
+    std::map<int, int> counts;
+    for (int i = 0; i < 4000; ++i) {
+        counts[ring.shardFor("user" + std::to_string(i))]++;
+    }
+    ASSERT_EQ(counts.size(), 4);
+    for (const auto& entry : counts) {
+        EXPECT_GT(entry.second, 500);
+    }
+}
+
+TEST_F(ShardedUserStoreTest, RingAddingShardMovesOnlyItsKeys) {
+    ConsistentHashRing ring;
+    ring.addShard(0, "s0");
+    ring.addShard(1, "s1");
+    std::map<std::string, int> before;
+    for (int i = 0; i < 1000; ++i) {
+        std::string key = "user" + std::to_string(i);
+        before[key] = ring.shardFor(key);
+    }
+
+    ring.addShard(2, "s2");
+    int moved = 0;
+    for (const auto& entry : before) {
+        int now = ring.shardFor(entry.first);
+        if (now != entry.second) {
+            EXPECT_EQ(now, 2);
+            moved++;
+        }
+    }
+    EXPECT_GT(moved, 0);
+    EXPECT_LT(moved, 600);
+}
+
+TEST_F(ShardedUserStoreTest, RingRemoveShardKeepsOtherOwners) {
+    ConsistentHashRing ring;
+    ring.addShard(0, "s0");
+    ring.addShard(1, "s1");
+    ring.addShard(2, "s2");
+    std::map<std::string, int> before;
+    for (int i = 0; i < 500; ++i) {
+        std::string key = "user" + std::to_string(i);
+        before[key] = ring.shardFor(key);
+    }
+
+    ring.removeShard(1);
+    for (const auto& entry : before) {
+        if (entry.second != 1) {
+            EXPECT_EQ(ring.shardFor(entry.first), entry.second);
+        } else {
+            EXPECT_NE(ring.shardFor(entry.first), 1);
+        }
+    }
+}
+
+// === LOCAL SHARD ROUTER TESTS ===
+TEST_F(ShardedUserStoreTest, RouterWithoutShardsRejectsUsers) {
+    ShardedUserStore store(ShardedUserStore::localShards("test_shard_"));
+    EXPECT_FALSE(store.insertUser("alice", "hash"));
+    EXPECT_FALSE(store.userExists("alice"));
+}
+
+TEST_F(ShardedUserStoreTest, RouterInsertAndAuthenticate) {
+    ShardedUserStore store(ShardedUserStore::localShards("test_shard_"));
+    store.addShard("a");
+    store.addShard("b");
+    EXPECT_TRUE(store.insertUser("alice", "hash1"));
+    EXPECT_FALSE(store.insertUser("alice", "hash2"));
+    EXPECT_TRUE(store.authenticateUser("alice", "hash1"));
+    EXPECT_FALSE(store.authenticateUser("alice", "hash2"));
+}
+
+TEST_F(ShardedUserStoreTest, RouterDuplicateShardNameRejected) {
+    ShardedUserStore store(ShardedUserStore::localShards("test_shard_"));
+    EXPECT_TRUE(store.addShard("a"));
+    EXPECT_FALSE(store.addShard("a"));
+    EXPECT_EQ(store.getShardNames().size(), 1);
+}
+
+TEST_F(ShardedUserStoreTest, RouterGetAndUpdateUser) {
+    ShardedUserStore store(ShardedUserStore::localShards("test_shard_"));
+    store.addShard("a");
+    store.addShard("b");
+    store.insertUser("bob", "hash");
+
+    User user;
+    ASSERT_TRUE(store.getUser("bob", user));
+    user.gamesPlayed = 4;
+    user.gamesWon = 3;
+    store.updateUser("bob", user);
+
+    User updated;
+    ASSERT_TRUE(store.getUser("bob", updated));
+    EXPECT_EQ(updated.gamesPlayed, 4);
+    EXPECT_EQ(updated.gamesWon, 3);
+}
+
+TEST_F(ShardedUserStoreTest, RouterRemoveUser) {
+    ShardedUserStore store(ShardedUserStore::localShards("test_shard_"));
+    store.addShard("a");
+    store.insertUser("carol", "hash");
+    store.removeUser("carol");
+    EXPECT_FALSE(store.userExists("carol"));
+}
+
+TEST_F(ShardedUserStoreTest, AddShardRebalancesUsers) {
+    ShardedUserStore store(ShardedUserStore::localShards("test_shard_"));
+    store.addShard("a");
+    for (int i = 0; i < 200; ++i) {
+        store.insertUser("user" + std::to_string(i), "hash" + std::to_string(i));
+    }
+
+    store.addShard("b");
+    store.addShard("c");
+
+    std::set<std::string> owners;
+    for (int i = 0; i < 200; ++i) {
+        std::string name = "user" + std::to_string(i);
+        EXPECT_TRUE(store.authenticateUser(name, "hash" + std::to_string(i)));
+        owners.insert(store.shardFor(name));
+    }
+    EXPECT_EQ(owners.size(), 3);
+    EXPECT_EQ(store.getAllUsers().size(), 200);
+}
+
+TEST_F(ShardedUserStoreTest, RemoveShardMigratesUsers) {
+    ShardedUserStore store(ShardedUserStore::localShards("test_shard_"));
+    store.addShard("a");
+    store.addShard("b");
+    store.addShard("c");
+    for (int i = 0; i < 100; ++i) {
+        store.insertUser("user" + std::to_string(i), "hash");
+    }
+
+    EXPECT_TRUE(store.removeShard("b"));
+    EXPECT_FALSE(store.removeShard("b"));
+    EXPECT_EQ(store.getShardNames().size(), 2);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(store.userExists("user" + std::to_string(i)));
+    }
+}
+
+// Counts the calls a rebalance makes on each shard
+class CountingShard : public LocalUserShard {
+public:
+    CountingShard(const std::string& usersFile, std::map<std::string, int>& calls)
+        : LocalUserShard(usersFile), calls(calls) {}
+
+    bool insertUser(const User& user) override {
+        calls["insertUser"]++;
+        return LocalUserShard::insertUser(user);
+    }
+    bool removeUser(const std::string& username) override {
+        calls["removeUser"]++;
+        return LocalUserShard::removeUser(username);
+    }
+    std::vector<std::string> insertUsers(const std::vector<User>& users) override {
+        calls["insertUsers"]++;
+        return LocalUserShard::insertUsers(users);
+    }
+    std::size_t removeUsers(const std::vector<std::string>& usernames) override {
+        calls["removeUsers"]++;
+        return LocalUserShard::removeUsers(usernames);
+    }
+
+private:
+    std::map<std::string, int>& calls;
+};
+
+TEST_F(ShardedUserStoreTest, RebalanceMovesUsersInBatches) {
+    std::map<std::string, int> calls;
+    ShardedUserStore store([&calls](const std::string& shardName) -> std::unique_ptr<UserShard> {
+        return std::make_unique<CountingShard>("test_shard_" + shardName + ".dat", calls);
+    });
+    store.addShard("a");
+    for (int i = 0; i < 100; ++i) {
+        store.insertUser("user" + std::to_string(i), "hash");
+    }
+    calls.clear();
+
+    // One batch out of each existing shard and one into the new one
+    store.addShard("b");
+    store.addShard("c");
+    EXPECT_EQ(calls["insertUsers"], 1 + 2);
+    EXPECT_EQ(calls["removeUsers"], 1 + 2);
+    store.removeShard("b");
+    EXPECT_EQ(calls["insertUsers"], 3 + 2);
+    EXPECT_EQ(calls["removeUsers"], 3 + 1);
+    EXPECT_EQ(calls["insertUser"], 0);
+    EXPECT_EQ(calls["removeUser"], 0);
+    EXPECT_EQ(store.getAllUsers().size(), 100u);
+}
+
+// Stores only the first half of every batch, like a shard failing midway
+class HalfFullShard : public LocalUserShard {
+public:
+    explicit HalfFullShard(const std::string& usersFile) : LocalUserShard(usersFile) {}
+
+    std::vector<std::string> insertUsers(const std::vector<User>& users) override {
+        return LocalUserShard::insertUsers(std::vector<User>(users.begin(), users.begin() + users.size() / 2));
+    }
+};
+
+static std::unique_ptr<UserShard> shardOrBroken(const std::string& shardName) {
+    if (shardName == "broken") {
+        return std::make_unique<HalfFullShard>("test_shard_" + shardName + ".dat");
+    }
+    return std::make_unique<LocalUserShard>("test_shard_" + shardName + ".dat");
+}
+
+TEST_F(ShardedUserStoreTest, FailedAddKeepsEveryUser) {
+    ShardedUserStore store(shardOrBroken);
+    store.addShard("a");
+    for (int i = 0; i < 100; ++i) {
+        store.insertUser("user" + std::to_string(i), "hash");
+    }
+
+    EXPECT_FALSE(store.addShard("broken"));
+    EXPECT_EQ(store.getShardNames(), std::vector<std::string>{"a"});
+    EXPECT_EQ(store.getAllUsers().size(), 100u);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(store.authenticateUser("user" + std::to_string(i), "hash"));
+    }
+}
+
+TEST_F(ShardedUserStoreTest, FailedRemoveKeepsEveryUser) {
+    ShardedUserStore store(shardOrBroken);
+    store.addShard("broken");
+    store.addShard("a");
+    for (int i = 0; i < 100; ++i) {
+        store.insertUser("user" + std::to_string(i), "hash");
+    }
+
+    // Everyone on "a" would move to "broken", which takes only half
+    EXPECT_FALSE(store.removeShard("a"));
+    EXPECT_EQ(store.getShardNames().size(), 2u);
+    EXPECT_EQ(store.getAllUsers().size(), 100u);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(store.authenticateUser("user" + std::to_string(i), "hash"));
+    }
+}
+
+TEST_F(ShardedUserStoreTest, LastShardCannotBeRemoved) {
+    ShardedUserStore store(ShardedUserStore::localShards("test_shard_"));
+    store.addShard("a");
+    store.insertUser("alice", "hash");
+    EXPECT_FALSE(store.removeShard("a"));
+    EXPECT_TRUE(store.userExists("alice"));
+}
+
+TEST_F(ShardedUserStoreTest, ShardsPersistToOwnFiles) {
+    {
+        ShardedUserStore store(ShardedUserStore::localShards("test_shard_"));
+        store.addShard("a");
+        store.addShard("b");
+        for (int i = 0; i < 50; ++i) {
+            store.insertUser("user" + std::to_string(i), "hash");
+        }
+    }
+
+    ShardedUserStore reopened(ShardedUserStore::localShards("test_shard_"));
+    reopened.addShard("a");
+    reopened.addShard("b");
+    EXPECT_EQ(reopened.getAllUsers().size(), 50);
+    EXPECT_TRUE(reopened.userExists("user7"));
+}
+
+// === PROCESS SHARD TESTS ===
+#ifndef _WIN32
+TEST_F(ShardedUserStoreTest, ProcessShardsServeRequests) {
+    ShardedUserStore store(ShardedUserStore::processShards("test_shard_"));
+    ASSERT_TRUE(store.addShard("a"));
+    ASSERT_TRUE(store.addShard("b"));
+
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_TRUE(store.insertUser("user" + std::to_string(i), "hash" + std::to_string(i)));
+    }
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_TRUE(store.authenticateUser("user" + std::to_string(i), "hash" + std::to_string(i)));
+    }
+    EXPECT_FALSE(store.authenticateUser("user1", "wrong"));
+
+    User user;
+    ASSERT_TRUE(store.getUser("user3", user));
+    EXPECT_EQ(user.name(), "user3");
+}
+
+TEST_F(ShardedUserStoreTest, ProcessShardsRebalance) {
+    ShardedUserStore store(ShardedUserStore::processShards("test_shard_"));
+    store.addShard("a");
+    for (int i = 0; i < 60; ++i) {
+        store.insertUser("user" + std::to_string(i), "hash");
+    }
+    ASSERT_TRUE(store.addShard("b"));
+    ASSERT_TRUE(store.addShard("c"));
+    EXPECT_EQ(store.getAllUsers().size(), 60);
+    for (int i = 0; i < 60; ++i) {
+        EXPECT_TRUE(store.userExists("user" + std::to_string(i)));
+    }
+}
+
+TEST_F(ShardedUserStoreTest, ProcessShardRunsInChildProcess) {
+    auto shard = ProcessUserShard::spawn("test_shard_d.dat");
+    ASSERT_NE(shard, nullptr);
+    EXPECT_GT(shard->processId(), 0);
+    EXPECT_NE(shard->processId(), static_cast<int>(getpid()));
+    EXPECT_TRUE(shard->insertUser(User("dana", PasswordDigest::fromCredential("hash"))));
+    EXPECT_TRUE(shard->userExists("dana"));
+}
+
+TEST_F(ShardedUserStoreTest, ProcessShardsMoveUsersInBatches) {
+    auto shard = ProcessUserShard::spawn("test_shard_d.dat");
+    ASSERT_NE(shard, nullptr);
+    User won("erin", PasswordDigest::fromCredential("hash"));
+    won.gamesWon = 4;
+    User fred("fred", PasswordDigest::fromCredential("hash"));
+    User clash("erin", PasswordDigest::fromCredential("other"));
+    std::vector<std::string> moved = {"erin", "fred"};
+    EXPECT_EQ(shard->insertUsers({won, fred, clash}), moved);
+    User stored;
+    ASSERT_TRUE(shard->getUser("erin", stored));
+    EXPECT_EQ(stored.gamesWon, 4);
+    EXPECT_EQ(shard->removeUsers({"erin", "nobody"}), 1u);
+    EXPECT_EQ(shard->getAllUsers().size(), 1u);
+}
+
+TEST_F(ShardedUserStoreTest, ProcessShardIsNotForkedWhileThreadsRun) {
+    std::promise<void> release;
+    std::thread worker([&release]() { release.get_future().wait(); });
+    EXPECT_EQ(ProcessUserShard::spawn("test_shard_d.dat"), nullptr);
+    release.set_value();
+    worker.join();
+    EXPECT_NE(ProcessUserShard::spawn("test_shard_d.dat"), nullptr);
+}
+#endif
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include "StringInterner.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+class StringInternerTest : public ::testing::Test {
+protected:
+    StringInterner interner;
+};
+
+// === INTERN TESTS ===
+TEST_F(StringInternerTest, InternAssignsDenseIds) {
+    EXPECT_EQ(interner.intern("alice"), 0u);
+    EXPECT_EQ(interner.intern("bob"), 1u);
+    EXPECT_EQ(interner.intern("carol"), 2u);
+    EXPECT_EQ(interner.size(), 3u);
+}
+
+TEST_F(StringInternerTest, InternSameNameReturnsSameId) {
+    UserId first = interner.intern("alice");
+    UserId second = interner.intern(std::string("alice"));
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(interner.size(), 1u);
+}
+
+TEST_F(StringInternerTest, InternEmptyName) {
+    UserId id = interner.intern("");
+    EXPECT_NE(id, INVALID_USER_ID);
+    EXPECT_EQ(interner.find(""), id);
+    EXPECT_TRUE(interner.name(id).empty());
+}
+
+TEST_F(StringInternerTest, InternLongName) {
+    std::string longName(100000, 'z');
+    UserId id = interner.intern(longName);
+    EXPECT_EQ(interner.name(id), longName);
+    // Small names after a large one still land in the shared chunk
+    UserId small = interner.intern("small");
+    EXPECT_EQ(interner.name(small), "small");
+}
+
+TEST_F(StringInternerTest, NamesSurviveManyChunks) {
+    for (int i = 0; i < 20000; ++i) {
+        interner.intern("player_name_" + std::to_string(i));
+    }
+    EXPECT_EQ(interner.name(0), "player_name_0");
+    EXPECT_EQ(interner.name(19999), "player_name_19999");
+}
+
+// === FIND / NAME TESTS ===
+TEST_F(StringInternerTest, FindUnknownName) {
+    interner.intern("alice");
+    EXPECT_EQ(interner.find("mallory"), INVALID_USER_ID);
+}
+
+TEST_F(StringInternerTest, FindDoesNotIntern) {
+    interner.find("ghost");
+    EXPECT_EQ(interner.size(), 0u);
+}
+
+TEST_F(StringInternerTest, NameOfUnknownIdIsEmpty) {
+    EXPECT_TRUE(interner.name(42).empty());
+    EXPECT_TRUE(interner.name(INVALID_USER_ID).empty());
+}
+
+TEST_F(StringInternerTest, SharedInstanceIsSingleton) {
+    EXPECT_EQ(&StringInterner::shared(), &StringInterner::shared());
+}
+
+// === CONCURRENCY TESTS ===
+TEST_F(StringInternerTest, ConcurrentInternAgrees) {
+    std::vector<std::vector<UserId>> results(4);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([this, t, &results]() {
+            for (int i = 0; i < 1000; ++i) {
+                results[t].push_back(interner.intern("user" + std::to_string(i)));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(interner.size(), 1000u);
+    for (int t = 1; t < 4; ++t) {
+        EXPECT_EQ(results[t], results[0]);
+    }
+}
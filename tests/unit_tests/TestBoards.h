@@ -0,0 +1,19 @@
+#ifndef TESTBOARDS_H
+#define TESTBOARDS_H
+
+#include "GameBoard.h"
+#include <string>
+#include <vector>
+
+// Builds a board from one string per row, e.g. {"X O", " X ", "  O"}
+inline GameBoard boardOf(const std::vector<std::string>& rows, int winLength = 3) {
+    GameBoard board(static_cast<int>(rows.size()), static_cast<int>(rows[0].size()), winLength);
+    std::vector<std::vector<char>> cells;
+    for (const auto& row : rows) {
+        cells.emplace_back(row.begin(), row.end());
+    }
+    board.setBoard(cells);
+    return board;
+}
+
+#endif // TESTBOARDS_H
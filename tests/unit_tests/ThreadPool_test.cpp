@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include "ThreadPool.h"
+#include <atomic>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// === CONSTRUCTOR TESTS ===
+TEST(ThreadPoolTest, ExplicitThreadCount) {
+    ThreadPool pool(3);
+    EXPECT_EQ(pool.size(), 3u);
+}
+
+TEST(ThreadPoolTest, DefaultThreadCountIsPositive) {
+    ThreadPool pool;
+    EXPECT_GT(pool.size(), 0u);
+}
+
+// === SUBMIT TESTS ===
+TEST(ThreadPoolTest, SubmitReturnsValue) {
+    ThreadPool pool(2);
+    auto future = pool.submit([]() { return 6 * 7; });
+    EXPECT_EQ(future.get(), 42);
+}
+
+TEST(ThreadPoolTest, SubmitVoidTask) {
+    ThreadPool pool(2);
+    std::atomic<int> counter{0};
+    auto future = pool.submit([&counter]() { counter++; });
+    future.get();
+    EXPECT_EQ(counter.load(), 1);
+}
+
+TEST(ThreadPoolTest, SubmitMoveOnlyResult) {
+    ThreadPool pool(1);
+    auto future = pool.submit([]() { return std::make_unique<std::string>("moved"); });
+    EXPECT_EQ(*future.get(), "moved");
+}
+
+TEST(ThreadPoolTest, ManyTasksAllRun) {
+    ThreadPool pool(4);
+    std::atomic<int> counter{0};
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 1000; ++i) {
+        futures.push_back(pool.submit([&counter]() { counter++; }));
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+    EXPECT_EQ(counter.load(), 1000);
+}
+
+TEST(ThreadPoolTest, ExceptionPropagatesThroughFuture) {
+    ThreadPool pool(1);
+    auto future = pool.submit([]() -> int { throw std::runtime_error("boom"); });
+    EXPECT_THROW(future.get(), std::runtime_error);
+}
+
+// === SHUTDOWN TESTS ===
+TEST(ThreadPoolTest, DestructorFinishesQueuedTasks) {
+    std::atomic<int> counter{0};
+    {
+        ThreadPool pool(1);
+        for (int i = 0; i < 100; ++i) {
+            pool.submit([&counter]() { counter++; });
+        }
+    }
+    EXPECT_EQ(counter.load(), 100);
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include "Timestamp.h"
+#include <cstdlib>
+#include <ctime>
+#include <string>
+
+// === FORMAT TESTS ===
+TEST(TimestampTest, FormatsEpoch) {
+    EXPECT_EQ(formatTimestamp(0), "1970-01-01 00:00:00");
+}
+
+TEST(TimestampTest, FormatsKnownDate) {
+    // 2025-06-11 12:00:00 UTC
+    EXPECT_EQ(formatTimestamp(1749643200000LL), "2025-06-11 12:00:00");
+}
+
+TEST(TimestampTest, FormatDropsMilliseconds) {
+    EXPECT_EQ(formatTimestamp(1749643200999LL), "2025-06-11 12:00:00");
+}
+
+TEST(TimestampTest, FormatsLeapDay) {
+    EXPECT_EQ(formatTimestamp(951782400000LL), "2000-02-29 00:00:00");
+}
+
+TEST(TimestampTest, FormatsBeforeEpoch) {
+    EXPECT_EQ(formatTimestamp(-1000), "1969-12-31 23:59:59");
+}
+
+// === PARSE TESTS ===
+TEST(TimestampTest, ParseInvertsFormat) {
+    const EpochMillis TIMES[] = {0, 951782400000LL, 1749643200000LL, 4102444799000LL};
+    for (EpochMillis time : TIMES) {
+        EpochMillis parsed;
+        ASSERT_TRUE(parseTimestamp(formatTimestamp(time), parsed));
+        EXPECT_EQ(parsed, time);
+    }
+}
+
+TEST(TimestampTest, ParseRejectsMalformedText) {
+    EpochMillis parsed;
+    EXPECT_FALSE(parseTimestamp("", parsed));
+    EXPECT_FALSE(parseTimestamp("2025-06-11", parsed));
+    EXPECT_FALSE(parseTimestamp("2025/06/11 12:00:00", parsed));
+    EXPECT_FALSE(parseTimestamp("2025-13-11 12:00:00", parsed));
+    EXPECT_FALSE(parseTimestamp("2025-06-11 1a:00:00", parsed));
+}
+
+TEST(TimestampTest, LocalParseFollowsTheTimeZone) {
+    const char* old = std::getenv("TZ");
+    std::string previous = old != nullptr ? old : "";
+    setenv("TZ", "EST5EDT,M3.2.0,M11.1.0", 1);
+    tzset();
+    EpochMillis parsed;
+    // Daylight saving in June, standard time in December
+    ASSERT_TRUE(parseLocalTimestamp("2025-06-11 12:00:00", parsed));
+    EXPECT_EQ(parsed, 1749643200000LL + 4 * 3600000LL);
+    EXPECT_EQ(formatLocalTimestamp(parsed), "2025-06-11 12:00:00");
+    ASSERT_TRUE(parseLocalTimestamp("2025-12-25 12:30:45", parsed));
+    EXPECT_EQ(parsed, 1766665845000LL + 5 * 3600000LL);
+    EXPECT_EQ(formatLocalTimestamp(parsed), "2025-12-25 12:30:45");
+    EXPECT_FALSE(parseLocalTimestamp("2025-13-11 12:00:00", parsed));
+    if (old != nullptr) {
+        setenv("TZ", previous.c_str(), 1);
+    } else {
+        unsetenv("TZ");
+    }
+    tzset();
+}
+
+// === CLOCK TESTS ===
+TEST(TimestampTest, CurrentTimeIsAfter2025) {
+    EXPECT_GT(currentEpochMillis(), 1735689600000LL);
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include "UserIndex.h"
+#include "UserManager.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class UserIndexTest : public ::testing::Test {
+protected:
+    UserIndex index;
+
+    User makeUser(const std::string& name, int played, int won) {
+        User user(name, PasswordDigest::fromCredential("hash"));
+        user.gamesPlayed = played;
+        user.gamesWon = won;
+        return user;
+    }
+};
+
+// === PREFIX SEARCH TESTS ===
+TEST_F(UserIndexTest, PrefixSearchSorted) {
+    index.addUser(makeUser("carol", 0, 0));
+    index.addUser(makeUser("alice", 0, 0));
+    index.addUser(makeUser("alfred", 0, 0));
+    index.addUser(makeUser("bob", 0, 0));
+
+    std::vector<std::string> expected = {"alfred", "alice"};
+    EXPECT_EQ(index.searchPrefix("al", 10), expected);
+}
+
+TEST_F(UserIndexTest, PrefixSearchRespectsLimit) {
+    for (int i = 0; i < 20; ++i) {
+        index.addUser(makeUser("player" + std::to_string(10 + i), 0, 0));
+    }
+    auto matches = index.searchPrefix("player", 5);
+    ASSERT_EQ(matches.size(), 5);
+    EXPECT_EQ(matches[0], "player10");
+    EXPECT_EQ(matches[4], "player14");
+}
+
+TEST_F(UserIndexTest, PrefixSearchNoMatch) {
+    index.addUser(makeUser("alice", 0, 0));
+    EXPECT_TRUE(index.searchPrefix("zz", 10).empty());
+}
+
+TEST_F(UserIndexTest, EmptyPrefixListsEveryone) {
+    index.addUser(makeUser("b", 0, 0));
+    index.addUser(makeUser("a", 0, 0));
+    std::vector<std::string> expected = {"a", "b"};
+    EXPECT_EQ(index.searchPrefix("", 10), expected);
+}
+
+TEST_F(UserIndexTest, RemovedUserNotFound) {
+    User user = makeUser("gone", 3, 1);
+    index.addUser(user);
+    index.removeUser(user);
+    EXPECT_TRUE(index.searchPrefix("gone", 10).empty());
+    EXPECT_TRUE(index.topByWins(10).empty());
+    EXPECT_EQ(index.size(), 0u);
+}
+
+// === LEADERBOARD TESTS ===
+TEST_F(UserIndexTest, TopByWinsOrdered) {
+    index.addUser(makeUser("low", 10, 1));
+    index.addUser(makeUser("high", 10, 9));
+    index.addUser(makeUser("mid", 10, 5));
+
+    std::vector<std::string> expected = {"high", "mid"};
+    EXPECT_EQ(index.topByWins(2), expected);
+}
+
+TEST_F(UserIndexTest, TopByWinsTiesBrokenByName) {
+    index.addUser(makeUser("zed", 4, 2));
+    index.addUser(makeUser("amy", 4, 2));
+    std::vector<std::string> expected = {"amy", "zed"};
+    EXPECT_EQ(index.topByWins(2), expected);
+}
+
+TEST_F(UserIndexTest, UpdateMovesRank) {
+    User first = makeUser("first", 5, 5);
+    User second = makeUser("second", 5, 1);
+    index.addUser(first);
+    index.addUser(second);
+
+    second.gamesPlayed = 20;
+    second.gamesWon = 15;
+    index.updateUser(second);
+
+    EXPECT_EQ(index.topByWins(1)[0], "second");
+    EXPECT_EQ(index.topByWins(10).size(), 2);
+}
+
+TEST_F(UserIndexTest, TopByWinRate) {
+    index.addUser(makeUser("busy", 100, 60));
+    index.addUser(makeUser("perfect", 3, 3));
+    index.addUser(makeUser("new", 0, 0));
+
+    std::vector<std::string> expected = {"perfect", "busy"};
+    EXPECT_EQ(index.topByWinRate(10), expected);
+}
+
+TEST_F(UserIndexTest, WinRateMinimumGames) {
+    UserIndex rated(10);
+    rated.addUser(makeUser("veteran", 50, 30));
+    rated.addUser(makeUser("lucky", 2, 2));
+    std::vector<std::string> expected = {"veteran"};
+    EXPECT_EQ(rated.topByWinRate(10), expected);
+}
+
+// === USER TABLE INTEGRATION TESTS ===
+class UserTableIndexTest : public ::testing::Test {
+protected:
+    UserHashTable users;
+    void SetUp() override {
+        users.clear();
+        std::remove("users.dat");
+    }
+    void TearDown() override { std::remove("users.dat"); }
+};
+
+TEST_F(UserTableIndexTest, TableSearchFollowsInsertAndRemove) {
+    users.insertUser("anna", "h");
+    users.insertUser("andy", "h");
+    users.insertUser("bert", "h");
+    users.removeUser("andy");
+
+    std::vector<std::string> expected = {"anna"};
+    EXPECT_EQ(users.searchUsers("an", 10), expected);
+}
+
+TEST_F(UserTableIndexTest, TableLeaderboardFollowsUpdates) {
+    users.insertUser("one", "h");
+    users.insertUser("two", "h");
+    User updated = *users.getUser("two");
+    updated.gamesPlayed = 3;
+    updated.gamesWon = 3;
+    users.updateUser("two", updated);
+
+    EXPECT_EQ(users.getTopByWins(1)[0], "two");
+    EXPECT_EQ(users.getTopByWinRate(1)[0], "two");
+}
+
+TEST_F(UserTableIndexTest, TableIndexRebuiltOnLoad) {
+    users.insertUser("loaded", "h");
+    User updated = *users.getUser("loaded");
+    updated.gamesPlayed = 1;
+    updated.gamesWon = 1;
+    users.updateUser("loaded", updated);
+
+    UserHashTable reloaded;
+    EXPECT_EQ(reloaded.searchUsers("load", 10).size(), 1);
+    EXPECT_EQ(reloaded.getTopByWins(1)[0], "loaded");
+}
+
+TEST_F(UserTableIndexTest, TableClearEmptiesIndex) {
+    users.insertUser("x", "h");
+    users.clear();
+    EXPECT_TRUE(users.searchUsers("", 10).empty());
+    EXPECT_TRUE(users.getTopByWins(10).empty());
+}
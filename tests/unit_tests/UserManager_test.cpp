@@ -196,8 +196,9 @@ TEST_F(UserManagerTest, GetUserReturnsValidPointer) {
     users.insertUser("dave", "hash");
     User* user = users.getUser("dave");
     ASSERT_NE(user, nullptr);
-    EXPECT_EQ(user->username, "dave");
-    EXPECT_EQ(user->passwordHash, "hash");
+    EXPECT_EQ(user->name(), "dave");
+    EXPECT_TRUE(user->password.matches("hash"));
+    EXPECT_FALSE(user->password.matches("hash2"));
 }
 
 TEST_F(UserManagerTest, GetUserReturnsNullForNonexistent) {
@@ -243,7 +244,7 @@ TEST_F(UserManagerTest, UpdateUserStatistics) {
 }
 
 TEST_F(UserManagerTest, UpdateNonexistentUser) {
-    User fakeUser("ghost", "hash");
+    User fakeUser("ghost", PasswordDigest::fromCredential("hash"));
     EXPECT_NO_THROW(users.updateUser("ghost", fakeUser));
     EXPECT_FALSE(users.userExists("ghost"));
 }
@@ -251,7 +252,7 @@ TEST_F(UserManagerTest, UpdateNonexistentUser) {
 TEST_F(UserManagerTest, UpdateUserPassword) {
     users.insertUser("user", "oldhash");
     User* user = users.getUser("user");
-    user->passwordHash = "newhash";
+    user->password = PasswordDigest::fromCredential("newhash");
     users.updateUser("user", *user);
     
     EXPECT_FALSE(users.authenticateUser("user", "oldhash"));
@@ -388,3 +389,124 @@ TEST_F(UserManagerTest, NullCharacterHandling) {
     EXPECT_TRUE(users.userExists(usernameWithNull));
 }
 
+
+// === USER ID TESTS ===
+TEST_F(UserManagerTest, InsertedUserGetsSharedId) {
+    users.insertUser("idholder", "hash");
+    User* user = users.getUser("idholder");
+    ASSERT_NE(user, nullptr);
+    EXPECT_NE(user->id, INVALID_USER_ID);
+    EXPECT_EQ(user->id, StringInterner::shared().find("idholder"));
+}
+
+TEST_F(UserManagerTest, UpdateUserKeepsId) {
+    users.insertUser("stable", "hash");
+    UserId id = users.getUser("stable")->id;
+    User replacement("stable", PasswordDigest::fromCredential("newhash"));
+    users.updateUser("stable", replacement);
+    EXPECT_EQ(users.getUser("stable")->id, id);
+}
+
+TEST_F(UserManagerTest, RemovedSlotIsReused) {
+    users.insertUser("first", "hash");
+    users.removeUser("first");
+    users.insertUser("second", "hash");
+    EXPECT_FALSE(users.userExists("first"));
+    EXPECT_TRUE(users.authenticateUser("second", "hash"));
+    EXPECT_EQ(users.getAllUsers().size(), 1);
+}
+
+TEST_F(UserManagerTest, BatchesSaveOnce) {
+    std::vector<User> batch;
+    for (int i = 0; i < 20; ++i) {
+        batch.emplace_back("batch" + std::to_string(i), PasswordDigest::fromCredential("hash"));
+        batch.back().gamesWon = i;
+    }
+    batch.emplace_back("batch3", PasswordDigest::fromCredential("duplicate"));
+    std::uint64_t before = users.fileWrites();
+    EXPECT_EQ(users.insertUsers(batch).size(), 20u);
+    EXPECT_EQ(users.fileWrites(), before + 1);
+    EXPECT_EQ(users.getUser("batch7")->gamesWon, 7);
+    EXPECT_TRUE(users.authenticateUser("batch3", "hash"));
+
+    EXPECT_EQ(users.removeUsers({"batch1", "batch2", "nobody"}), 2u);
+    EXPECT_EQ(users.fileWrites(), before + 2);
+    EXPECT_FALSE(users.userExists("batch1"));
+    EXPECT_EQ(users.getAllUsers().size(), 18u);
+}
+
+// === PASSWORD HASHING TESTS ===
+TEST_F(UserManagerTest, RegisterUserStoresSaltedHash) {
+    users.setPasswordParams(PasswordHasher::Params(64, 1));
+    EXPECT_TRUE(users.registerUser("hashed", "plaintext"));
+    User* user = users.getUser("hashed");
+    ASSERT_NE(user, nullptr);
+    EXPECT_EQ(user->password.kind, PasswordDigest::Kind::BALLOON);
+    EXPECT_TRUE(PasswordHasher::isEncodedHash(user->password.toString()));
+    EXPECT_TRUE(user->password.verify("plaintext"));
+}
+
+TEST_F(UserManagerTest, RegisterUserDuplicateFails) {
+    users.setPasswordParams(PasswordHasher::Params(64, 1));
+    EXPECT_TRUE(users.registerUser("dup", "one"));
+    EXPECT_FALSE(users.registerUser("dup", "two"));
+    EXPECT_TRUE(users.verifyPassword("dup", "one"));
+}
+
+TEST_F(UserManagerTest, VerifyPassword) {
+    users.setPasswordParams(PasswordHasher::Params(64, 1));
+    users.registerUser("verify", "right");
+    EXPECT_TRUE(users.verifyPassword("verify", "right"));
+    EXPECT_FALSE(users.verifyPassword("verify", "wrong"));
+    EXPECT_FALSE(users.verifyPassword("nobody", "right"));
+}
+
+TEST_F(UserManagerTest, VerifyPasswordAsync) {
+    users.setPasswordParams(PasswordHasher::Params(64, 1));
+    users.registerUser("async", "right");
+    AsyncPasswordHasher hasher(2);
+    auto good = users.verifyPasswordAsync("async", "right", hasher);
+    auto bad = users.verifyPasswordAsync("async", "wrong", hasher);
+    auto missing = users.verifyPasswordAsync("nobody", "right", hasher);
+    EXPECT_TRUE(good.get());
+    EXPECT_FALSE(bad.get());
+    EXPECT_FALSE(missing.get());
+}
+
+TEST_F(UserManagerTest, RegisteredUserPersists) {
+    users.setPasswordParams(PasswordHasher::Params(64, 1));
+    users.registerUser("saved", "pw");
+    UserHashTable newTable;
+    EXPECT_TRUE(newTable.verifyPassword("saved", "pw"));
+}
+
+TEST_F(UserManagerTest, SavedFileHoldsDigestsNotCredentials) {
+    users.insertUser("opaque", "clientsecret");
+    std::ifstream file("users.dat");
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(contents.find("clientsecret"), std::string::npos);
+
+    UserHashTable newTable;
+    EXPECT_TRUE(newTable.authenticateUser("opaque", "clientsecret"));
+}
+
+TEST_F(UserManagerTest, LoadsCredentialsFromOlderFiles) {
+    {
+        std::ofstream file("users.dat");
+        file << "old legacyhash 3 1 1 1\n";
+    }
+    UserHashTable newTable;
+    EXPECT_TRUE(newTable.authenticateUser("old", "legacyhash"));
+    EXPECT_EQ(newTable.getUser("old")->gamesPlayed, 3);
+}
+
+TEST_F(UserManagerTest, InvalidPasswordParamsAreRejected) {
+    EXPECT_TRUE(users.setPasswordParams(PasswordHasher::Params(64, 1)));
+    EXPECT_FALSE(users.setPasswordParams(PasswordHasher::Params(0, 1)));
+    EXPECT_FALSE(users.setPasswordParams(PasswordHasher::Params(4, 2000)));
+
+    // Users registered afterwards are still hashed with the last valid params
+    EXPECT_TRUE(users.registerUser("locked", "pw"));
+    EXPECT_EQ(users.getUser("locked")->password.params.timeCost, 1u);
+    EXPECT_TRUE(users.verifyPassword("locked", "pw"));
+}
@@ -0,0 +1,99 @@
+#include "PositionDatabase.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+void printUsage() {
+    std::cerr << "usage: position_db --out FILE [--board RxCxK] [--depth N] [--horizon-nodes N]\n"
+              << "                   [--max-positions N]\n";
+}
+
+bool parseCount(const char* text, std::uint64_t& value) {
+    char* end = nullptr;
+    unsigned long long parsed = std::strtoull(text, &end, 10);
+    if (end == text || *end != '\0') {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+bool parseBoard(const std::string& text, PositionDatabaseConfig& config) {
+    char x1 = 0;
+    char x2 = 0;
+    std::istringstream in(text);
+    if (!(in >> config.rows >> x1 >> config.cols >> x2 >> config.winLength) || x1 != 'x' || x2 != 'x') {
+        return false;
+    }
+    return in.peek() == EOF;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    PositionDatabaseConfig config;
+    std::string path;
+
+    for (int i = 1; i < argc; i++) {
+        std::string flag = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        const char* value = argv[++i];
+        std::uint64_t number = 0;
+        bool ok = true;
+        if (flag == "--out") {
+            path = value;
+        } else if (flag == "--board") {
+            ok = parseBoard(value, config);
+        } else if (flag == "--depth") {
+            ok = parseCount(value, number);
+            config.maxDepth = static_cast<int>(number);
+        } else if (flag == "--horizon-nodes") {
+            ok = parseCount(value, number);
+            config.horizonNodes = number;
+        } else if (flag == "--max-positions") {
+            ok = parseCount(value, number);
+            config.maxPositions = static_cast<std::size_t>(number);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            printUsage();
+            return 1;
+        }
+    }
+    if (path.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    PositionDatabaseStats stats;
+    if (!PositionDatabase::generate(path, config, &stats)) {
+        std::cerr << "could not build " << path
+                  << " (board over " << PositionDatabase::MAX_CELLS
+                  << " cells, more than --max-positions positions, or a write error)\n";
+        return 1;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    PositionDatabase database;
+    PositionEntry root;
+    const char* names[] = {"loss", "draw", "win"};
+    if (database.open(path) && database.lookupKey(0, root)) {
+        std::printf("empty board: %s for the first player in %d plies%s\n", names[static_cast<int>(root.value)],
+                    root.depth, root.heuristic ? " (estimated)" : "");
+    }
+    std::printf("%llu positions solved, %llu written (%llu estimated), %llu bytes in %lld ms\n",
+                static_cast<unsigned long long>(stats.solved), static_cast<unsigned long long>(stats.written),
+                static_cast<unsigned long long>(stats.heuristic), static_cast<unsigned long long>(stats.fileBytes),
+                static_cast<long long>(elapsed.count()));
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include "SelfPlay.h"
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+void printUsage() {
+    std::cerr << "usage: self_play [--games N] [--threads N] [--board RxCxK] [--seed N]\n"
+              << "                 [--policies random,greedy,mcts:200,easy,medium,hard] [--history FILE]\n";
+}
+
+bool parseCount(const char* text, std::uint64_t& value) {
+    char* end = nullptr;
+    unsigned long long parsed = std::strtoull(text, &end, 10);
+    if (end == text || *end != '\0') {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+bool parseBoard(const std::string& text, SelfPlayConfig& config) {
+    char x1 = 0;
+    char x2 = 0;
+    std::istringstream in(text);
+    if (!(in >> config.rows >> x1 >> config.cols >> x2 >> config.winLength) || x1 != 'x' || x2 != 'x') {
+        return false;
+    }
+    return in.peek() == EOF;
+}
+
+bool parsePolicies(const std::string& text, std::vector<SelfPlayPolicy>& policies) {
+    std::istringstream in(text);
+    std::string name;
+    while (std::getline(in, name, ',')) {
+        SelfPlayPolicy policy;
+        if (!SelfPlay::parsePolicy(name, policy)) {
+            std::cerr << "unknown policy: " << name << "\n";
+            return false;
+        }
+        policies.push_back(policy);
+    }
+    return !policies.empty();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    SelfPlayConfig config;
+    config.games = 100000;
+    std::uint64_t threads = 0;
+    std::string historyFile;
+    std::vector<SelfPlayPolicy> policies;
+
+    for (int i = 1; i < argc; i++) {
+        std::string flag = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        const char* value = argv[++i];
+        std::uint64_t number = 0;
+        bool ok = true;
+        if (flag == "--games") {
+            ok = parseCount(value, number);
+            config.games = static_cast<std::size_t>(number);
+        } else if (flag == "--threads") {
+            ok = parseCount(value, threads);
+        } else if (flag == "--seed") {
+            ok = parseCount(value, config.seed);
+        } else if (flag == "--board") {
+            ok = parseBoard(value, config);
+        } else if (flag == "--policies") {
+            ok = parsePolicies(value, policies);
+        } else if (flag == "--history") {
+            historyFile = value;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            printUsage();
+            return 1;
+        }
+    }
+    if (policies.empty()) {
+        policies.push_back(SelfPlayPolicy("random", PolicyKind::RANDOM));
+        policies.push_back(SelfPlayPolicy("greedy", PolicyKind::GREEDY));
+    }
+
+    SelfPlay selfPlay(static_cast<std::size_t>(threads));
+    SelfPlayReport report;
+    if (historyFile.empty()) {
+        report = selfPlay.run(policies, config);
+    } else {
+        GameHistory history(historyFile);
+        report = selfPlay.run(policies, config, &history);
+    }
+
+    double minutes = report.elapsedMillis / 60000.0;
+    std::printf("%llu games in %lld ms (%.0f games/min), %llu recorded\n",
+                static_cast<unsigned long long>(report.games), static_cast<long long>(report.elapsedMillis),
+                minutes > 0 ? report.games / minutes : 0.0, static_cast<unsigned long long>(report.recorded));
+    std::printf("%-16s %10s %10s %10s %10s %9s %12s\n", "policy", "games", "wins", "losses", "ties",
+                "win rate", "first-move");
+    for (const auto& stats : report.policies) {
+        double firstRate = stats.gamesAsFirst == 0 ? 0.0
+                                                   : static_cast<double>(stats.winsAsFirst) / stats.gamesAsFirst;
+        std::printf("%-16s %10llu %10llu %10llu %10llu %8.1f%% %11.1f%%\n", stats.name.c_str(),
+                    static_cast<unsigned long long>(stats.games), static_cast<unsigned long long>(stats.wins),
+                    static_cast<unsigned long long>(stats.losses), static_cast<unsigned long long>(stats.ties),
+                    stats.winRate() * 100.0, firstRate * 100.0);
+    }
+    return 0;
+}